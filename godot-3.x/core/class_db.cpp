@@ -1137,6 +1137,23 @@ StringName ClassDB::get_property_getter(StringName p_class, const StringName &p_
 	return StringName();
 }
 
+const ClassDB::PropertySetGet *ClassDB::get_property_setget(const StringName &p_class, const StringName &p_property) {
+	OBJTYPE_RLOCK;
+
+	ClassInfo *type = classes.getptr(p_class);
+	ClassInfo *check = type;
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			return psg;
+		}
+
+		check = check->inherits_ptr;
+	}
+
+	return nullptr;
+}
+
 bool ClassDB::has_property(const StringName &p_class, const StringName &p_property, bool p_no_inheritance) {
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
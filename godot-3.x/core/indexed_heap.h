@@ -0,0 +1,134 @@
+/*************************************************************************/
+/*  indexed_heap.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include "core/local_vector.h"
+
+// Binary min-heap that reports the position of every element it moves through Indexer,
+// so an element whose priority improved can be moved up in O(log n) instead of being
+// searched for first (the "decrease-key" operation used by Dijkstra and A*).
+//
+// Comparator(a, b) returns true when a must be closer to the top than b.
+// Indexer(element, index) stores the index of an element inside the heap, it is called
+// with INDEXED_HEAP_INVALID_INDEX once the element leaves it.
+//
+// The storage is kept between clears, so a heap reused across searches does not allocate.
+
+#define INDEXED_HEAP_INVALID_INDEX UINT32_MAX
+
+template <class T, class Comparator, class Indexer>
+class IndexedHeap {
+	LocalVector<T> buffer;
+	Comparator compare;
+	Indexer indexer;
+
+	void _shift_up(uint32_t p_index) {
+		T element = buffer[p_index];
+		while (p_index > 0) {
+			uint32_t parent = (p_index - 1) / 2;
+			if (!compare(element, buffer[parent])) {
+				break;
+			}
+			buffer[p_index] = buffer[parent];
+			indexer(buffer[p_index], p_index);
+			p_index = parent;
+		}
+		buffer[p_index] = element;
+		indexer(element, p_index);
+	}
+
+	void _shift_down(uint32_t p_index) {
+		T element = buffer[p_index];
+		uint32_t size = buffer.size();
+		while (true) {
+			uint32_t child = p_index * 2 + 1;
+			if (child >= size) {
+				break;
+			}
+			if (child + 1 < size && compare(buffer[child + 1], buffer[child])) {
+				child++;
+			}
+			if (!compare(buffer[child], element)) {
+				break;
+			}
+			buffer[p_index] = buffer[child];
+			indexer(buffer[p_index], p_index);
+			p_index = child;
+		}
+		buffer[p_index] = element;
+		indexer(element, p_index);
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t size() const { return buffer.size(); }
+	_FORCE_INLINE_ bool is_empty() const { return buffer.size() == 0; }
+	_FORCE_INLINE_ const T &top() const { return buffer[0]; }
+
+	void push(const T &p_element) {
+		buffer.push_back(p_element);
+		_shift_up(buffer.size() - 1);
+	}
+
+	T pop() {
+		CRASH_COND(buffer.size() == 0);
+		T top = buffer[0];
+		uint32_t last = buffer.size() - 1;
+		if (last > 0) {
+			buffer[0] = buffer[last];
+			buffer.resize(last);
+			_shift_down(0);
+		} else {
+			buffer.resize(0);
+		}
+		indexer(top, INDEXED_HEAP_INVALID_INDEX);
+		return top;
+	}
+
+	// Restores the heap order after the priority of the element at p_index improved.
+	void shift(uint32_t p_index) {
+		ERR_FAIL_UNSIGNED_INDEX(p_index, buffer.size());
+		_shift_up(p_index);
+	}
+
+	void clear() {
+		for (uint32_t i = 0; i < buffer.size(); i++) {
+			indexer(buffer[i], INDEXED_HEAP_INVALID_INDEX);
+		}
+		buffer.resize(0);
+	}
+
+	void reserve(uint32_t p_size) {
+		buffer.reserve(p_size);
+	}
+};
+
+#endif // INDEXED_HEAP_H
@@ -7,20 +7,22 @@ class MethodBind$argc$$ifret R$$ifconst C$ : public MethodBind {
 public:
 
 	$ifret R$ $ifnoret void$ (T::*method)($arg, P@$) $ifconst const$;
-#ifdef DEBUG_METHODS_ENABLED
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 	virtual Variant::Type _gen_argument_type(int p_arg) const { return _get_argument_type(p_arg); }
-	virtual GodotTypeInfo::Metadata get_argument_meta(int p_arg) const {
-		$ifret if (p_arg==-1) return GetTypeInfo<R>::METADATA;$
-		$arg if (p_arg==(@-1)) return GetTypeInfo<P@>::METADATA;
-		$
-		return GodotTypeInfo::METADATA_NONE;
-	}
 	Variant::Type _get_argument_type(int p_argument) const {
 		$ifret if (p_argument==-1) return (Variant::Type)GetTypeInfo<R>::VARIANT_TYPE;$
 		$arg if (p_argument==(@-1)) return (Variant::Type)GetTypeInfo<P@>::VARIANT_TYPE;
 		$
 		return Variant::NIL;
 	}
+#endif
+#ifdef DEBUG_METHODS_ENABLED
+	virtual GodotTypeInfo::Metadata get_argument_meta(int p_arg) const {
+		$ifret if (p_arg==-1) return GetTypeInfo<R>::METADATA;$
+		$arg if (p_arg==(@-1)) return GetTypeInfo<P@>::METADATA;
+		$
+		return GodotTypeInfo::METADATA_NONE;
+	}
 	virtual PropertyInfo _gen_argument_type_info(int p_argument) const {
 		$ifret if (p_argument==-1) return GetTypeInfo<R>::get_class_info();$
 		$arg if (p_argument==(@-1)) return GetTypeInfo<P@>::get_class_info();
@@ -69,6 +71,8 @@ public:
 	MethodBind$argc$$ifret R$$ifconst C$ () {
 #ifdef DEBUG_METHODS_ENABLED
 		_set_const($ifconst true$$ifnoconst false$);
+#endif
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 		_generate_argument_types($argc$);
 #else
 		set_argument_count($argc$);
@@ -98,21 +102,22 @@ public:
 	StringName type_name;
 	$ifret R$ $ifnoret void$ (__UnexistingClass::*method)($arg, P@$) $ifconst const$;
 
-#ifdef DEBUG_METHODS_ENABLED
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 	virtual Variant::Type _gen_argument_type(int p_arg) const { return _get_argument_type(p_arg); }
-	virtual GodotTypeInfo::Metadata get_argument_meta(int p_arg) const {
-		$ifret if (p_arg==-1) return GetTypeInfo<R>::METADATA;$
-		$arg if (p_arg==(@-1)) return GetTypeInfo<P@>::METADATA;
-		$
-		return GodotTypeInfo::METADATA_NONE;
-	}
-
 	Variant::Type _get_argument_type(int p_argument) const {
 		$ifret if (p_argument==-1) return (Variant::Type)GetTypeInfo<R>::VARIANT_TYPE;$
 		$arg if (p_argument==(@-1)) return (Variant::Type)GetTypeInfo<P@>::VARIANT_TYPE;
 		$
 		return Variant::NIL;
 	}
+#endif
+#ifdef DEBUG_METHODS_ENABLED
+	virtual GodotTypeInfo::Metadata get_argument_meta(int p_arg) const {
+		$ifret if (p_arg==-1) return GetTypeInfo<R>::METADATA;$
+		$arg if (p_arg==(@-1)) return GetTypeInfo<P@>::METADATA;
+		$
+		return GodotTypeInfo::METADATA_NONE;
+	}
 
 	virtual PropertyInfo _gen_argument_type_info(int p_argument) const {
 		$ifret if (p_argument==-1) return GetTypeInfo<R>::get_class_info();$
@@ -163,6 +168,8 @@ public:
 	MethodBind$argc$$ifret R$$ifconst C$ () {
 #ifdef DEBUG_METHODS_ENABLED
 		_set_const($ifconst true$$ifnoconst false$);
+#endif
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 		_generate_argument_types($argc$);
 #else
 		set_argument_count($argc$);
@@ -198,20 +205,22 @@ class FunctionBind$argc$$ifret R$$ifconst C$ : public MethodBind {
 public:
 
 	$ifret R$ $ifnoret void$ (*method) ($ifconst const$ T *$ifargs , $$arg, P@$);
-#ifdef DEBUG_METHODS_ENABLED
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 	virtual Variant::Type _gen_argument_type(int p_arg) const { return _get_argument_type(p_arg); }
-	virtual GodotTypeInfo::Metadata get_argument_meta(int p_arg) const {
-		$ifret if (p_arg==-1) return GetTypeInfo<R>::METADATA;$
-		$arg if (p_arg==(@-1)) return GetTypeInfo<P@>::METADATA;
-		$
-		return GodotTypeInfo::METADATA_NONE;
-	}
 	Variant::Type _get_argument_type(int p_argument) const {
 		$ifret if (p_argument==-1) return (Variant::Type)GetTypeInfo<R>::VARIANT_TYPE;$
 		$arg if (p_argument==(@-1)) return (Variant::Type)GetTypeInfo<P@>::VARIANT_TYPE;
 		$
 		return Variant::NIL;
 	}
+#endif
+#ifdef DEBUG_METHODS_ENABLED
+	virtual GodotTypeInfo::Metadata get_argument_meta(int p_arg) const {
+		$ifret if (p_arg==-1) return GetTypeInfo<R>::METADATA;$
+		$arg if (p_arg==(@-1)) return GetTypeInfo<P@>::METADATA;
+		$
+		return GodotTypeInfo::METADATA_NONE;
+	}
 	virtual PropertyInfo _gen_argument_type_info(int p_argument) const {
 		$ifret if (p_argument==-1) return GetTypeInfo<R>::get_class_info();$
 		$arg if (p_argument==(@-1)) return GetTypeInfo<P@>::get_class_info();
@@ -260,6 +269,8 @@ public:
 	FunctionBind$argc$$ifret R$$ifconst C$ () {
 #ifdef DEBUG_METHODS_ENABLED
 		_set_const($ifconst true$$ifnoconst false$);
+#endif
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 		_generate_argument_types($argc$);
 #else
 		set_argument_count($argc$);
@@ -54,13 +54,14 @@ void AStar::add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale) {
 	bool p_exists = points.lookup(p_id, found_pt);
 
 	if (!p_exists) {
-		Point *pt = memnew(Point);
+		Point *pt = point_allocator.alloc();
 		pt->id = p_id;
 		pt->pos = p_pos;
 		pt->weight_scale = p_weight_scale;
 		pt->prev_point = nullptr;
 		pt->open_pass = 0;
 		pt->closed_pass = 0;
+		pt->open_list_index = INDEXED_HEAP_INVALID_INDEX;
 		pt->enabled = true;
 		points.set(p_id, pt);
 	} else {
@@ -123,7 +124,7 @@ void AStar::remove_point(int p_id) {
 		(*it.value)->unlinked_neighbours.remove(p->id);
 	}
 
-	memdelete(p);
+	point_allocator.free(p);
 	points.remove(p_id);
 	last_free_id = p_id;
 }
@@ -245,7 +246,7 @@ bool AStar::are_points_connected(int p_id, int p_with_id, bool bidirectional) co
 void AStar::clear() {
 	last_free_id = 0;
 	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
-		memdelete(*(it.value));
+		point_allocator.free(*(it.value));
 	}
 	segments.clear();
 	points.clear();
@@ -328,23 +329,19 @@ bool AStar::_solve(Point *begin_point, Point *end_point) {
 
 	bool found_route = false;
 
-	Vector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
-
 	begin_point->g_score = 0;
 	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
+	open_list.push(begin_point);
 
-	while (!open_list.empty()) {
-		Point *p = open_list[0]; // The currently processed point
+	while (!open_list.is_empty()) {
+		Point *p = open_list.top(); // The currently processed point
 
 		if (p == end_point) {
 			found_route = true;
 			break;
 		}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptrw()); // Remove the current point from the open list
-		open_list.remove(open_list.size() - 1);
+		open_list.pop(); // Remove the current point from the open list
 		p->closed_pass = pass; // Mark the point as closed
 
 		for (OAHashMap<int, Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
@@ -360,7 +357,6 @@ bool AStar::_solve(Point *begin_point, Point *end_point) {
 
 			if (e->open_pass != pass) { // The point wasn't inside the open list.
 				e->open_pass = pass;
-				open_list.push_back(e);
 				new_point = true;
 			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
 				continue;
@@ -370,14 +366,16 @@ bool AStar::_solve(Point *begin_point, Point *end_point) {
 			e->g_score = tentative_g_score;
 			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptrw());
-			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptrw());
+			if (new_point) {
+				open_list.push(e);
+			} else { // The point is still in the open list, as closed points are skipped.
+				open_list.shift(e->open_list_index);
 			}
 		}
 	}
 
+	open_list.clear();
+
 	return found_route;
 }
 
@@ -561,7 +559,8 @@ void AStar::_bind_methods() {
 	BIND_VMETHOD(MethodInfo(Variant::REAL, "_compute_cost", PropertyInfo(Variant::INT, "from_id"), PropertyInfo(Variant::INT, "to_id")));
 }
 
-AStar::AStar() {
+AStar::AStar() :
+		point_allocator(256) {
 	last_free_id = 0;
 	pass = 1;
 }
@@ -797,23 +796,21 @@ bool AStar2D::_solve(AStar::Point *begin_point, AStar::Point *end_point) {
 
 	bool found_route = false;
 
-	Vector<AStar::Point *> open_list;
-	SortArray<AStar::Point *, AStar::SortPoints> sorter;
+	AStar::OpenList &open_list = astar.open_list;
 
 	begin_point->g_score = 0;
 	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
+	open_list.push(begin_point);
 
-	while (!open_list.empty()) {
-		AStar::Point *p = open_list[0]; // The currently processed point
+	while (!open_list.is_empty()) {
+		AStar::Point *p = open_list.top(); // The currently processed point
 
 		if (p == end_point) {
 			found_route = true;
 			break;
 		}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptrw()); // Remove the current point from the open list
-		open_list.remove(open_list.size() - 1);
+		open_list.pop(); // Remove the current point from the open list
 		p->closed_pass = astar.pass; // Mark the point as closed
 
 		for (OAHashMap<int, AStar::Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
@@ -829,7 +826,6 @@ bool AStar2D::_solve(AStar::Point *begin_point, AStar::Point *end_point) {
 
 			if (e->open_pass != astar.pass) { // The point wasn't inside the open list.
 				e->open_pass = astar.pass;
-				open_list.push_back(e);
 				new_point = true;
 			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
 				continue;
@@ -839,14 +835,16 @@ bool AStar2D::_solve(AStar::Point *begin_point, AStar::Point *end_point) {
 			e->g_score = tentative_g_score;
 			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptrw());
-			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptrw());
+			if (new_point) {
+				open_list.push(e);
+			} else { // The point is still in the open list, as closed points are skipped.
+				open_list.shift(e->open_list_index);
 			}
 		}
 	}
 
+	open_list.clear();
+
 	return found_route;
 }
 
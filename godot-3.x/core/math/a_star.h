@@ -31,7 +31,9 @@
 #ifndef ASTAR_H
 #define ASTAR_H
 
+#include "core/indexed_heap.h"
 #include "core/oa_hash_map.h"
+#include "core/paged_allocator.h"
 #include "core/reference.h"
 
 /**
@@ -63,20 +65,29 @@ class AStar : public Reference {
 		real_t f_score;
 		uint64_t open_pass;
 		uint64_t closed_pass;
+		uint32_t open_list_index;
 	};
 
 	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
+		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is better than Point B.
+			if (A->f_score < B->f_score) {
 				return true;
-			} else if (A->f_score < B->f_score) {
+			} else if (A->f_score > B->f_score) {
 				return false;
 			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+				return A->g_score > B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
 			}
 		}
 	};
 
+	struct OpenListIndexer {
+		_FORCE_INLINE_ void operator()(Point *p_point, uint32_t p_index) const {
+			p_point->open_list_index = p_index;
+		}
+	};
+
+	typedef IndexedHeap<Point *, SortPoints, OpenListIndexer> OpenList;
+
 	struct Segment {
 		union {
 			struct {
@@ -115,9 +126,14 @@ class AStar : public Reference {
 	int last_free_id;
 	uint64_t pass;
 
+	// The points are allocated in pages, so the ones added together stay close in memory.
+	PagedAllocator<Point> point_allocator;
 	OAHashMap<int, Point *> points;
 	Set<Segment> segments;
 
+	// Kept between the searches so they do not allocate.
+	OpenList open_list;
+
 	bool _solve(Point *begin_point, Point *end_point);
 
 protected:
@@ -392,6 +392,12 @@ public:
 
 	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF) {
 		BVH_LOCKED_FUNCTION
+		return cull_convex_concurrent(p_convex, p_result_array, p_result_max, p_tester, p_tree_collision_mask);
+	}
+
+	// Same as cull_convex, but takes no lock, so several threads can cull at once.
+	// The caller must guarantee that nothing modifies the tree while these culls run.
+	int cull_convex_concurrent(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF) {
 		if (!p_convex.size()) {
 			return 0;
 		}
@@ -414,6 +420,11 @@ public:
 		params.hull.points = &convex_points[0];
 		params.hull.num_points = convex_points.size();
 
+		// Nothing else in the tree is written by a convex cull, so with the hits kept per thread
+		// several culls can read the same tree concurrently, as long as it isn't being modified.
+		static thread_local LocalVector<uint32_t, uint32_t, true> hits;
+		params.hits = &hits;
+
 		tree.cull_convex(params);
 
 		return params.result_count_overall;
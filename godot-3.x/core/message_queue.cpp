@@ -34,27 +34,118 @@
 #include "core/script_language.h"
 
 MessageQueue *MessageQueue::singleton = nullptr;
+thread_local MessageQueue::ThreadProducer MessageQueue::thread_producer;
+uint32_t MessageQueue::instance_count = 0;
 
 MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
+MessageQueue::Producer *MessageQueue::_get_producer() {
+	if (likely(thread_producer.queue_instance == instance)) {
+		return thread_producer.producer;
+	}
+
+	Producer *producer = memnew(Producer);
+	producers_mutex.lock();
+	producer->next = producers;
+	producers = producer;
+	producers_mutex.unlock();
+
+	thread_producer.queue_instance = instance;
+	thread_producer.producer = producer;
+	return producer;
+}
+
+MessageQueue::Page *MessageQueue::_alloc_page(uint32_t p_min_size) {
+	Page *page = nullptr;
+
+	if (p_min_size <= PAGE_SIZE) {
+		page_pool_mutex.lock();
+		page = page_pool;
+		if (page) {
+			page_pool = page->next;
+			page_pool_size--;
+		}
+		page_pool_mutex.unlock();
+	}
+
+	if (!page) {
+		uint32_t size = MAX((uint32_t)PAGE_SIZE, p_min_size);
+		page = (Page *)memalloc(sizeof(Page) + size);
+		page->size = size;
+	}
+
+	page->next = nullptr;
+	page->end = 0;
+	return page;
+}
+
+void MessageQueue::_free_page(Page *p_page) {
+	if (p_page->size == PAGE_SIZE) {
+		page_pool_mutex.lock();
+		if (page_pool_size < page_pool_max) {
+			p_page->next = page_pool;
+			page_pool = p_page;
+			page_pool_size++;
+			p_page = nullptr;
+		}
+		page_pool_mutex.unlock();
+	}
+
+	if (p_page) {
+		memfree(p_page);
+	}
+}
+
+// Returns room for a message at the end of the calling thread's chain, with the producer
+// locked. The caller fills in the message and unlocks r_producer.
+MessageQueue::Message *MessageQueue::_alloc_message(uint32_t p_room_needed, Producer *&r_producer) {
+	Producer *producer = _get_producer();
+	producer->mutex.lock();
+
+	if (producer->pending_bytes + p_room_needed > (uint64_t)MAX_PENDING_SIZE_MB * 1024 * 1024) {
+		producer->mutex.unlock();
+		return nullptr;
+	}
+
+	Page *page = producer->last;
+	if (!page || page->end + p_room_needed > page->size) {
+		page = _alloc_page(p_room_needed);
+		if (producer->last) {
+			producer->last->next = page;
+		} else {
+			producer->first = page;
+		}
+		producer->last = page;
+	}
+
+	Message *msg = memnew_placement(page->get_data() + page->end, Message);
+	msg->order = message_order.postincrement();
+
+	page->end += p_room_needed;
+	producer->pending_bytes += p_room_needed;
+
+	r_producer = producer;
+	return msg;
+}
+
 Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
-	_THREAD_SAFE_METHOD_
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
 
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+	Producer *producer = nullptr;
+	Message *msg = _alloc_message(room_needed, producer);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+	if (!msg) {
 		String type;
 		if (ObjectDB::get_instance(p_id)) {
 			type = ObjectDB::get_instance(p_id)->get_class();
 		}
 		print_line("Failed method: " + type + ":" + p_method + " target ID: " + itos(p_id));
 		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
+		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Check for deferred calls that keep deferring themselves.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
 	msg->args = p_argcount;
 	msg->instance_id = p_id;
 	msg->target = p_method;
@@ -63,14 +154,14 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const V
 		msg->type |= FLAG_SHOW_ERROR;
 	}
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(msg + 1);
 	for (int i = 0; i < p_argcount; i++) {
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
+		Variant *v = memnew_placement(&args[i], Variant);
 		*v = *p_args[i];
 	}
 
+	producer->mutex.unlock();
+
 	return OK;
 }
 
@@ -90,56 +181,54 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, VARIANT
 }
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	_THREAD_SAFE_METHOD_
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
 
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
+	Producer *producer = nullptr;
+	Message *msg = _alloc_message(room_needed, producer);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+	if (!msg) {
 		String type;
 		if (ObjectDB::get_instance(p_id)) {
 			type = ObjectDB::get_instance(p_id)->get_class();
 		}
 		print_line("Failed set: " + type + ":" + p_prop + " target ID: " + itos(p_id));
 		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
+		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Check for deferred calls that keep deferring themselves.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
 	msg->args = 1;
 	msg->instance_id = p_id;
 	msg->target = p_prop;
 	msg->type = TYPE_SET;
 
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
+	Variant *v = memnew_placement(msg + 1, Variant);
 	*v = p_value;
 
+	producer->mutex.unlock();
+
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
+	uint32_t room_needed = sizeof(Message);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+	Producer *producer = nullptr;
+	Message *msg = _alloc_message(room_needed, producer);
+
+	if (!msg) {
 		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
 		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
+		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Check for deferred calls that keep deferring themselves.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
-
 	msg->type = TYPE_NOTIFICATION;
 	msg->instance_id = p_id;
 	//msg->target;
 	msg->notification = p_notification;
 
-	buffer_end += sizeof(Message);
+	producer->mutex.unlock();
 
 	return OK;
 }
@@ -160,55 +249,65 @@ void MessageQueue::statistics() {
 	Map<int, int> notify_count;
 	Map<StringName, int> call_count;
 	int null_count = 0;
+	uint64_t total_bytes = 0;
 
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
+	producers_mutex.lock();
 
-		Object *target = ObjectDB::get_instance(message->instance_id);
+	for (Producer *producer = producers; producer; producer = producer->next) {
+		producer->mutex.lock();
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					if (!call_count.has(message->target)) {
-						call_count[message->target] = 0;
-					}
+		for (Page *page = producer->first; page; page = page->next) {
+			uint32_t read_pos = 0;
+			while (read_pos < page->end) {
+				Message *message = (Message *)(page->get_data() + read_pos);
 
-					call_count[message->target]++;
+				Object *target = ObjectDB::get_instance(message->instance_id);
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					if (!notify_count.has(message->notification)) {
-						notify_count[message->notification] = 0;
-					}
+				if (target != nullptr) {
+					switch (message->type & FLAG_MASK) {
+						case TYPE_CALL: {
+							if (!call_count.has(message->target)) {
+								call_count[message->target] = 0;
+							}
 
-					notify_count[message->notification]++;
+							call_count[message->target]++;
 
-				} break;
-				case TYPE_SET: {
-					if (!set_count.has(message->target)) {
-						set_count[message->target] = 0;
+						} break;
+						case TYPE_NOTIFICATION: {
+							if (!notify_count.has(message->notification)) {
+								notify_count[message->notification] = 0;
+							}
+
+							notify_count[message->notification]++;
+
+						} break;
+						case TYPE_SET: {
+							if (!set_count.has(message->target)) {
+								set_count[message->target] = 0;
+							}
+
+							set_count[message->target]++;
+
+						} break;
 					}
 
-					set_count[message->target]++;
+				} else {
+					//object was deleted
+					null_count++;
+				}
 
-				} break;
+				read_pos += _get_message_size(message);
 			}
 
-		} else {
-			//object was deleted
-			print_line("Object was deleted while awaiting a callback");
-
-			null_count++;
+			total_bytes += page->end;
 		}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+		producer->mutex.unlock();
 	}
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
+	producers_mutex.unlock();
+
+	print_line("TOTAL BYTES: " + itos(total_bytes));
 	print_line("NULL count: " + itos(null_count));
 
 	for (Map<StringName, int>::Element *E = set_count.front(); E; E = E->next()) {
@@ -244,33 +343,81 @@ void MessageQueue::_call_function(Object *p_target, const StringName &p_func, co
 	}
 }
 
-void MessageQueue::flush() {
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
+void MessageQueue::_destroy_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
 	}
 
-	uint32_t read_pos = 0;
+	p_message->~Message();
+}
+
+// Moves the pending chain of every producer to r_chains and returns their size in bytes.
+// Producers of threads that have exited are released once their chain is taken.
+// The bytes stay counted as pending until flush() ends.
+uint64_t MessageQueue::_take_pages(LocalVector<Chain> &r_chains) {
+	uint64_t bytes = 0;
 
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
+	MutexLock lock(producers_mutex);
 
-	ERR_FAIL_COND(flushing); //already flushing, you did something odd
-	flushing = true;
+	Producer **prev = &producers;
+	while (*prev) {
+		Producer *producer = *prev;
 
-	while (read_pos < buffer_end) {
-		//lock on each iteration, so a call can re-add itself to the message queue
+		producer->mutex.lock();
+		if (producer->first) {
+			Chain chain;
+			chain.page = producer->first;
+			r_chains.push_back(chain);
 
-		Message *message = (Message *)&buffer[read_pos];
+			bytes += producer->pending_bytes - producer->taken_bytes;
+			producer->first = nullptr;
+			producer->last = nullptr;
+			producer->taken_bytes = producer->pending_bytes;
+		}
+		bool exited = producer->thread_exited;
+		producer->mutex.unlock();
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
+		if (exited) {
+			*prev = producer->next;
+			memdelete(producer);
+		} else {
+			prev = &producer->next;
 		}
+	}
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
+	return bytes;
+}
 
-		_THREAD_SAFE_UNLOCK_
+void MessageQueue::flush() {
+	{
+		MutexLock lock(producers_mutex);
+		ERR_FAIL_COND(flushing); //already flushing, you did something odd
+		flushing = true;
+	}
+
+	LocalVector<Chain> chains;
+	uint64_t flushed_bytes = _take_pages(chains);
+	uint32_t flushed_messages = 0;
+
+	while (chains.size()) {
+		// Each chain is in push order already, so merging by the oldest head message
+		// keeps the order across threads.
+		uint32_t oldest = 0;
+		const Message *oldest_message = (const Message *)(chains[0].page->get_data() + chains[0].read_pos);
+		for (uint32_t i = 1; i < chains.size(); i++) {
+			const Message *head = (const Message *)(chains[i].page->get_data() + chains[i].read_pos);
+			if ((int32_t)(head->order - oldest_message->order) < 0) {
+				oldest = i;
+				oldest_message = head;
+			}
+		}
+
+		Chain &chain = chains[oldest];
+		Message *message = (Message *)(chain.page->get_data() + chain.read_pos);
+		chain.read_pos += _get_message_size(message);
 
 		Object *target = ObjectDB::get_instance(message->instance_id);
 
@@ -298,60 +445,115 @@ void MessageQueue::flush() {
 			}
 		}
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
+		_destroy_message(message);
+		flushed_messages++;
+
+		if (chain.read_pos >= chain.page->end) {
+			Page *next = chain.page->next;
+			_free_page(chain.page);
+
+			if (next) {
+				chain.page = next;
+				chain.read_pos = 0;
+			} else {
+				chains.remove_unordered(oldest);
 			}
 		}
 
-		message->~Message();
-
-		_THREAD_SAFE_LOCK_
+		if (chains.empty()) {
+			// Messages pushed in the meantime, including by the calls above, are flushed too.
+			flushed_bytes += _take_pages(chains);
+		}
 	}
 
-	buffer_end = 0; // reset buffer
+	MutexLock lock(producers_mutex);
+	for (Producer *producer = producers; producer; producer = producer->next) {
+		producer->mutex.lock();
+		producer->pending_bytes -= producer->taken_bytes;
+		producer->taken_bytes = 0;
+		producer->mutex.unlock();
+	}
+	if (flushed_bytes > buffer_max_used) {
+		buffer_max_used = flushed_bytes;
+	}
+	frame_messages += flushed_messages;
+	frame_bytes += flushed_bytes;
 	flushing = false;
-	_THREAD_SAFE_UNLOCK_
 }
 
 bool MessageQueue::is_flushing() const {
 	return flushing;
 }
 
+void MessageQueue::end_frame() {
+	MutexLock lock(producers_mutex);
+	last_frame_messages = frame_messages;
+	last_frame_bytes = frame_bytes;
+	frame_messages = 0;
+	frame_bytes = 0;
+}
+
+void MessageQueue::thread_exit() {
+	if (!singleton || thread_producer.queue_instance != singleton->instance) {
+		return;
+	}
+
+	Producer *producer = thread_producer.producer;
+	producer->mutex.lock();
+	producer->thread_exited = true;
+	producer->mutex.unlock();
+
+	thread_producer.queue_instance = 0;
+	thread_producer.producer = nullptr;
+}
+
 MessageQueue::MessageQueue() {
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A MessageQueue singleton already exists.");
 	singleton = this;
-	flushing = false;
+	instance = ++instance_count;
 
-	buffer_end = 0;
-	buffer_max_used = 0;
-	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
+	// The queue grows as needed, this only limits how much memory is kept around for reuse.
+	uint32_t reserved_size_kb = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/max_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"));
-	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
+	page_pool_max = MAX(1u, reserved_size_kb * 1024 / PAGE_SIZE);
 }
 
 MessageQueue::~MessageQueue() {
-	uint32_t read_pos = 0;
-
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++) {
-				args[i].~Variant();
+	LocalVector<Chain> chains;
+	_take_pages(chains);
+
+	for (uint32_t i = 0; i < chains.size(); i++) {
+		Page *page = chains[i].page;
+		while (page) {
+			uint32_t read_pos = 0;
+			while (read_pos < page->end) {
+				Message *message = (Message *)(page->get_data() + read_pos);
+				read_pos += _get_message_size(message);
+				_destroy_message(message);
 			}
-		}
-		message->~Message();
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
+			Page *next = page->next;
+			memfree(page);
+			page = next;
 		}
 	}
 
+	while (producers) {
+		Producer *next = producers->next;
+		memdelete(producers);
+		producers = next;
+	}
+
+	while (page_pool) {
+		Page *next = page_pool->next;
+		memfree(page_pool);
+		page_pool = next;
+	}
+
+	if (thread_producer.queue_instance == instance) {
+		thread_producer.queue_instance = 0;
+		thread_producer.producer = nullptr;
+	}
+
 	singleton = nullptr;
-	memdelete_arr(buffer);
 }
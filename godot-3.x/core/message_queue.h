@@ -31,14 +31,20 @@
 #ifndef MESSAGE_QUEUE_H
 #define MESSAGE_QUEUE_H
 
+#include "core/local_vector.h"
 #include "core/object.h"
-#include "core/os/thread_safe.h"
+#include "core/os/mutex.h"
+#include "core/safe_refcount.h"
 
+// Queue of deferred calls, notifications and property sets, flushed by the main loop.
+// Every thread pushes into its own chain of pages, so producers never wait on each other.
+// The chains are merged back in push order when the queue is flushed, and grow as needed.
 class MessageQueue {
-	_THREAD_SAFE_CLASS_
-
 	enum {
-		DEFAULT_QUEUE_SIZE_KB = 4096
+		DEFAULT_QUEUE_SIZE_KB = 4096,
+		PAGE_SIZE = 64 * 1024,
+		// Only reached by runaway code, such as a deferred call that keeps deferring itself.
+		MAX_PENDING_SIZE_MB = 256,
 	};
 
 	enum {
@@ -53,6 +59,7 @@ class MessageQueue {
 	struct Message {
 		ObjectID instance_id;
 		StringName target;
+		uint32_t order;
 		int16_t type;
 		union {
 			int16_t notification;
@@ -60,17 +67,79 @@ class MessageQueue {
 		};
 	};
 
-	uint8_t *buffer;
-	uint32_t buffer_end;
-	uint32_t buffer_max_used;
-	uint32_t buffer_size;
+	struct Page {
+		Page *next;
+		uint32_t size;
+		uint32_t end;
+
+		_FORCE_INLINE_ uint8_t *get_data() { return (uint8_t *)(this + 1); }
+	};
+
+	struct Producer {
+		BinaryMutex mutex;
+		Page *first = nullptr;
+		Page *last = nullptr;
+		uint64_t pending_bytes = 0;
+		// Part of pending_bytes already taken by the current flush. Kept counted until the
+		// flush ends, so calls that keep deferring themselves still run into the limit.
+		uint64_t taken_bytes = 0;
+		bool thread_exited = false;
+		Producer *next = nullptr;
+	};
+
+	struct ThreadProducer {
+		uint32_t queue_instance = 0;
+		Producer *producer = nullptr;
+	};
+
+	struct Chain {
+		Page *page = nullptr;
+		uint32_t read_pos = 0;
+	};
+
+	static thread_local ThreadProducer thread_producer;
+	static uint32_t instance_count;
+
+	uint32_t instance = 0;
+
+	Mutex producers_mutex;
+	Producer *producers = nullptr;
+
+	BinaryMutex page_pool_mutex;
+	Page *page_pool = nullptr;
+	uint32_t page_pool_size = 0;
+	uint32_t page_pool_max = 0;
+
+	SafeNumeric<uint32_t> message_order;
+
+	uint64_t buffer_max_used = 0;
+	uint32_t frame_messages = 0;
+	uint64_t frame_bytes = 0;
+	uint32_t last_frame_messages = 0;
+	uint64_t last_frame_bytes = 0;
+
+	bool flushing = false;
+
+	Producer *_get_producer();
+	Message *_alloc_message(uint32_t p_room_needed, Producer *&r_producer);
+	Page *_alloc_page(uint32_t p_min_size);
+	void _free_page(Page *p_page);
+	uint64_t _take_pages(LocalVector<Chain> &r_chains);
+
+	_FORCE_INLINE_ static uint32_t _get_message_size(const Message *p_message) {
+		uint32_t size = sizeof(Message);
+		if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+			size += sizeof(Variant) * p_message->args;
+		}
+		return size;
+	}
+
+	static void _destroy_message(Message *p_message);
 
 	void _call_function(Object *p_target, const StringName &p_func, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	static MessageQueue *singleton;
 
-	bool flushing;
-
 public:
 	static MessageQueue *get_singleton();
 
@@ -90,6 +159,14 @@ public:
 
 	int get_max_buffer_usage() const;
 
+	// Messages flushed and bytes they used during the last frame.
+	uint32_t get_last_frame_message_count() const { return last_frame_messages; }
+	uint64_t get_last_frame_bytes() const { return last_frame_bytes; }
+	void end_frame();
+
+	// Releases the calling thread's producer once its pending messages are flushed.
+	static void thread_exit();
+
 	MessageQueue();
 	~MessageQueue();
 };
@@ -78,7 +78,7 @@ void MethodBind::set_default_arguments(const Vector<Variant> &p_defargs) {
 	default_argument_count = default_arguments.size();
 }
 
-#ifdef DEBUG_METHODS_ENABLED
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 void MethodBind::_generate_argument_types(int p_count) {
 	set_argument_count(p_count);
 
@@ -100,7 +100,7 @@ MethodBind::MethodBind() {
 	hint_flags = METHOD_FLAGS_DEFAULT;
 	argument_count = 0;
 	default_argument_count = 0;
-#ifdef DEBUG_METHODS_ENABLED
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 	argument_types = nullptr;
 #endif
 	_const = false;
@@ -108,7 +108,7 @@ MethodBind::MethodBind() {
 }
 
 MethodBind::~MethodBind() {
-#ifdef DEBUG_METHODS_ENABLED
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 	if (argument_types) {
 		memdelete_arr(argument_types);
 	}
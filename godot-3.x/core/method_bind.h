@@ -42,6 +42,12 @@
 #define DEBUG_METHODS_ENABLED
 #endif
 
+// Argument types are also kept when ptrcall is enabled, so callers can check
+// that their values are in the layout ptrcall() expects for each argument.
+#if defined(DEBUG_METHODS_ENABLED) || defined(PTRCALL_ENABLED)
+#define METHOD_ARGUMENT_TYPES_ENABLED
+#endif
+
 #include "core/type_info.h"
 
 enum MethodFlags {
@@ -209,16 +215,20 @@ class MethodBind {
 	bool _returns;
 
 protected:
-#ifdef DEBUG_METHODS_ENABLED
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 	Variant::Type *argument_types;
+#endif
+#ifdef DEBUG_METHODS_ENABLED
 	Vector<StringName> arg_names;
 #endif
 	void _set_const(bool p_const);
 	void _set_returns(bool p_returns);
-#ifdef DEBUG_METHODS_ENABLED
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 	virtual Variant::Type _gen_argument_type(int p_arg) const = 0;
-	virtual PropertyInfo _gen_argument_type_info(int p_arg) const = 0;
 	void _generate_argument_types(int p_count);
+#endif
+#ifdef DEBUG_METHODS_ENABLED
+	virtual PropertyInfo _gen_argument_type_info(int p_arg) const = 0;
 
 #endif
 	void set_argument_count(int p_count) { argument_count = p_count; }
@@ -247,13 +257,16 @@ public:
 		}
 	}
 
-#ifdef DEBUG_METHODS_ENABLED
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 
 	_FORCE_INLINE_ Variant::Type get_argument_type(int p_argument) const {
 		ERR_FAIL_COND_V(p_argument < -1 || p_argument > argument_count, Variant::NIL);
 		return argument_types[p_argument + 1];
 	}
 
+#endif
+#ifdef DEBUG_METHODS_ENABLED
+
 	PropertyInfo get_argument_info(int p_argument) const;
 	PropertyInfo get_return_info() const;
 
@@ -335,20 +348,24 @@ public:
 
 	void set_method_info(const MethodInfo &p_info, bool p_return_nil_is_variant) {
 		set_argument_count(p_info.arguments.size());
-#ifdef DEBUG_METHODS_ENABLED
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 		Variant::Type *at = memnew_arr(Variant::Type, p_info.arguments.size() + 1);
 		at[0] = p_info.return_val.type;
+		for (int i = 0; i < p_info.arguments.size(); i++) {
+			at[i + 1] = p_info.arguments[i].type;
+		}
+		argument_types = at;
+#endif
+#ifdef DEBUG_METHODS_ENABLED
 		if (p_info.arguments.size()) {
 			Vector<StringName> names;
 			names.resize(p_info.arguments.size());
 			for (int i = 0; i < p_info.arguments.size(); i++) {
-				at[i + 1] = p_info.arguments[i].type;
 				names.write[i] = p_info.arguments[i].name;
 			}
 
 			set_argument_names(names);
 		}
-		argument_types = at;
 		arguments = p_info;
 		if (p_return_nil_is_variant) {
 			arguments.return_val.usage |= PROPERTY_USAGE_NIL_IS_VARIANT;
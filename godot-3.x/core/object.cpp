@@ -42,18 +42,6 @@
 
 #ifdef DEBUG_ENABLED
 
-struct _ObjectDebugLock {
-	Object *obj;
-
-	_ObjectDebugLock(Object *p_obj) {
-		obj = p_obj;
-		obj->_lock_index.ref();
-	}
-	~_ObjectDebugLock() {
-		obj->_lock_index.unref();
-	}
-};
-
 #define OBJ_DEBUG_LOCK _ObjectDebugLock _debug_lock(this);
 
 #else
@@ -1999,68 +1987,117 @@ void postinitialize_handler(Object *p_object) {
 	p_object->_postinitialize();
 }
 
-HashMap<ObjectID, Object *> ObjectDB::instances;
-ObjectID ObjectDB::instance_counter = 1;
-HashMap<Object *, ObjectID, ObjectDB::ObjectPtrHash> ObjectDB::instance_checks;
+SafeNumeric<ObjectDB::Slot *> ObjectDB::slot_blocks[SLOT_BLOCK_COUNT];
+SafeNumeric<uint32_t> ObjectDB::slot_count;
+SafeNumeric<uint32_t> ObjectDB::object_count;
+SafeNumeric<uint64_t> ObjectDB::free_list;
+BinaryMutex ObjectDB::block_mutex;
+
+ObjectDB::Slot *ObjectDB::_get_slot(uint32_t p_index) {
+	uint32_t block_index = p_index >> SLOT_BLOCK_BITS;
+	Slot *block = slot_blocks[block_index].get();
+	if (unlikely(!block)) {
+		// Only the first slot of a block comes here normally, but other threads may
+		// already have been handed slots of the same block.
+		MutexLock lock(block_mutex);
+		block = slot_blocks[block_index].get();
+		if (!block) {
+			block = memnew_arr(Slot, SLOT_BLOCK_SIZE);
+			slot_blocks[block_index].set(block);
+		}
+	}
+	return &block[p_index & SLOT_BLOCK_MASK];
+}
+
 ObjectID ObjectDB::add_instance(Object *p_object) {
 	ERR_FAIL_COND_V(p_object->get_instance_id() != 0, 0);
 
-	rw_lock.write_lock();
-	ObjectID instance_id = ++instance_counter;
-	instances[instance_id] = p_object;
-	instance_checks[p_object] = instance_id;
+	uint32_t index;
+	Slot *slot;
+	uint64_t head = free_list.get();
+	while (true) {
+		if ((head & 0xFFFFFFFF) == 0) {
+			index = slot_count.postincrement();
+			CRASH_COND_MSG(index >= SLOT_MAX, "Too many objects, the ObjectDB is full.");
+			slot = _get_slot(index);
+			break;
+		}
+		index = (head & 0xFFFFFFFF) - 1;
+		slot = _get_slot(index);
+		uint64_t next = (((head >> 32) + 1) << 32) | slot->next_free.get();
+		if (free_list.compare_exchange(head, next)) {
+			break;
+		}
+	}
 
-	rw_lock.write_unlock();
+	ObjectID instance_id = (((ObjectID)slot->generation + 1) << SLOT_BITS) | index;
+	slot->object.set(p_object);
+	slot->id.set(instance_id);
+	object_count.increment();
 
 	return instance_id;
 }
 
 void ObjectDB::remove_instance(Object *p_object) {
-	rw_lock.write_lock();
-
-	instances.erase(p_object->get_instance_id());
-	instance_checks.erase(p_object);
-
-	rw_lock.write_unlock();
+	ObjectID instance_id = p_object->get_instance_id();
+	uint32_t index = instance_id & SLOT_MASK;
+	Slot *block = slot_blocks[index >> SLOT_BLOCK_BITS].get();
+	if (!block) {
+		return; // Leaked instance freed after cleanup().
+	}
+	Slot *slot = &block[index & SLOT_BLOCK_MASK];
+	ERR_FAIL_COND(slot->id.get() != instance_id);
+
+	slot->id.set(0);
+	slot->object.set(nullptr);
+	// IDs use generation + 1, so they are never 0.
+	slot->generation = slot->generation + 1 < GENERATION_MASK ? slot->generation + 1 : 0;
+	object_count.decrement();
+
+	uint64_t head = free_list.get();
+	while (true) {
+		slot->next_free.set(head & 0xFFFFFFFF);
+		uint64_t next = (head & 0xFFFFFFFF00000000) | (index + 1);
+		if (free_list.compare_exchange(head, next)) {
+			break;
+		}
+	}
 }
-Object *ObjectDB::get_instance(ObjectID p_instance_id) {
-	rw_lock.read_lock();
-	Object **obj = instances.getptr(p_instance_id);
-	rw_lock.read_unlock();
 
-	if (!obj) {
-		return nullptr;
+bool ObjectDB::instance_validate(Object *p_ptr) {
+	uint32_t count = slot_count.get();
+	for (uint32_t i = 0; i < count; i++) {
+		Slot *block = slot_blocks[i >> SLOT_BLOCK_BITS].get();
+		if (block && block[i & SLOT_BLOCK_MASK].object.get() == p_ptr) {
+			return true;
+		}
 	}
-	return *obj;
+	return false;
 }
 
 void ObjectDB::debug_objects(DebugFunc p_func) {
-	rw_lock.read_lock();
-
-	const ObjectID *K = nullptr;
-	while ((K = instances.next(K))) {
-		p_func(instances[*K]);
+	uint32_t count = slot_count.get();
+	for (uint32_t i = 0; i < count; i++) {
+		Slot *block = slot_blocks[i >> SLOT_BLOCK_BITS].get();
+		if (!block) {
+			continue;
+		}
+		Object *object = block[i & SLOT_BLOCK_MASK].object.get();
+		if (object) {
+			p_func(object);
+		}
 	}
-
-	rw_lock.read_unlock();
 }
 
 void Object::get_argument_options(const StringName &p_function, int p_idx, List<String> *r_options) const {
 }
 
 int ObjectDB::get_object_count() {
-	rw_lock.read_lock();
-	int count = instances.size();
-	rw_lock.read_unlock();
-
-	return count;
+	return object_count.get();
 }
 
-RWLock ObjectDB::rw_lock;
-
 void ObjectDB::cleanup() {
-	rw_lock.write_lock();
-	if (instances.size()) {
+	if (object_count.get()) {
 		WARN_PRINT("ObjectDB instances leaked at exit (run with --verbose for details).");
 		if (OS::get_singleton()->is_stdout_verbose()) {
 			// Ensure calling the native classes because if a leaked instance has a script
@@ -2070,21 +2107,34 @@ void ObjectDB::cleanup() {
 			MethodBind *resource_get_path = ClassDB::get_method("Resource", "get_path");
 			Variant::CallError call_error;
 
-			const ObjectID *K = nullptr;
-			while ((K = instances.next(K))) {
+			uint32_t count = slot_count.get();
+			for (uint32_t i = 0; i < count; i++) {
+				Slot *block = slot_blocks[i >> SLOT_BLOCK_BITS].get();
+				Object *object = block ? block[i & SLOT_BLOCK_MASK].object.get() : nullptr;
+				if (!object) {
+					continue;
+				}
 				String extra_info;
-				if (instances[*K]->is_class("Node")) {
-					extra_info = " - Node name: " + String(node_get_name->call(instances[*K], nullptr, 0, call_error));
+				if (object->is_class("Node")) {
+					extra_info = " - Node name: " + String(node_get_name->call(object, nullptr, 0, call_error));
 				}
-				if (instances[*K]->is_class("Resource")) {
-					extra_info = " - Resource path: " + String(resource_get_path->call(instances[*K], nullptr, 0, call_error));
+				if (object->is_class("Resource")) {
+					extra_info = " - Resource path: " + String(resource_get_path->call(object, nullptr, 0, call_error));
 				}
-				print_line("Leaked instance: " + String(instances[*K]->get_class()) + ":" + itos(*K) + extra_info);
+				print_line("Leaked instance: " + String(object->get_class()) + ":" + itos(object->get_instance_id()) + extra_info);
 			}
 			print_line("Hint: Leaked instances typically happen when nodes are removed from the scene tree (with `remove_child()`) but not freed (with `free()` or `queue_free()`).");
 		}
 	}
-	instances.clear();
-	instance_checks.clear();
-	rw_lock.write_unlock();
+
+	for (int i = 0; i < SLOT_BLOCK_COUNT; i++) {
+		Slot *block = slot_blocks[i].get();
+		if (block) {
+			memdelete_arr(block);
+			slot_blocks[i].set(nullptr);
+		}
+	}
+	slot_count.set(0);
+	object_count.set(0);
+	free_list.set(0);
 }
@@ -35,6 +35,7 @@
 #include "core/list.h"
 #include "core/map.h"
 #include "core/object_id.h"
+#include "core/os/mutex.h"
 #include "core/os/rw_lock.h"
 #include "core/safe_refcount.h"
 #include "core/set.h"
@@ -758,30 +759,65 @@ public:
 	virtual ~Object();
 };
 
+#ifdef DEBUG_ENABLED
+
+// Keeps the object from being freed while a call into it is in progress,
+// for callers that dispatch resolved methods without going through call().
+struct _ObjectDebugLock {
+	Object *obj;
+
+	_ObjectDebugLock(Object *p_obj) {
+		obj = p_obj;
+		obj->_lock_index.ref();
+	}
+	~_ObjectDebugLock() {
+		obj->_lock_index.unref();
+	}
+};
+
+#endif
+
 bool predelete_handler(Object *p_object);
 void postinitialize_handler(Object *p_object);
 
 class ObjectDB {
-	struct ObjectPtrHash {
-		static _FORCE_INLINE_ uint32_t hash(const Object *p_obj) {
-			union {
-				const Object *p;
-				unsigned long i;
-			} u;
-			u.p = p_obj;
-			return HashMapHasherDefault::hash((uint64_t)u.i);
-		}
+	// Instances are kept in blocks of slots that are never moved or freed until cleanup,
+	// so lookups read them without locking. An ObjectID stores the slot index in its low
+	// bits and the slot generation above them, which is bumped every time the slot is
+	// freed, so stale IDs stop resolving even after the slot is reused.
+	enum {
+		SLOT_BITS = 24,
+		SLOT_MAX = 1 << SLOT_BITS,
+		SLOT_MASK = SLOT_MAX - 1,
+		SLOT_BLOCK_BITS = 14,
+		SLOT_BLOCK_SIZE = 1 << SLOT_BLOCK_BITS,
+		SLOT_BLOCK_MASK = SLOT_BLOCK_SIZE - 1,
+		SLOT_BLOCK_COUNT = SLOT_MAX / SLOT_BLOCK_SIZE,
+		// Keeps IDs below 2^53, so they survive a round trip through a float Variant.
+		GENERATION_BITS = 29,
+		GENERATION_MASK = (1 << GENERATION_BITS) - 1,
 	};
 
-	static HashMap<ObjectID, Object *> instances;
-	static HashMap<Object *, ObjectID, ObjectPtrHash> instance_checks;
+	struct Slot {
+		SafeNumeric<ObjectID> id; // 0 while the slot is free.
+		SafeNumeric<Object *> object;
+		SafeNumeric<uint32_t> next_free;
+		uint32_t generation = 0; // Only touched by the thread owning the slot.
+	};
+
+	static SafeNumeric<Slot *> slot_blocks[SLOT_BLOCK_COUNT];
+	static SafeNumeric<uint32_t> slot_count;
+	static SafeNumeric<uint32_t> object_count;
+	// Free slot index + 1 in the low 32 bits and a tag bumped on every pop in the high
+	// ones, so a pop racing with a pop and push of the same slot is detected.
+	static SafeNumeric<uint64_t> free_list;
+	static BinaryMutex block_mutex;
 
-	static ObjectID instance_counter;
 	friend class Object;
 	friend void unregister_core_types();
 
-	static RWLock rw_lock;
 	static void cleanup();
+	static Slot *_get_slot(uint32_t p_index);
 	static ObjectID add_instance(Object *p_object);
 	static void remove_instance(Object *p_object);
 	friend void register_core_types();
@@ -789,20 +825,30 @@ class ObjectDB {
 public:
 	typedef void (*DebugFunc)(Object *p_obj);
 
-	static Object *get_instance(ObjectID p_instance_id);
+	_FORCE_INLINE_ static Object *get_instance(ObjectID p_instance_id) {
+		uint32_t index = p_instance_id & SLOT_MASK;
+		Slot *block = slot_blocks[index >> SLOT_BLOCK_BITS].get();
+		if (unlikely(!block)) {
+			return nullptr;
+		}
+		Slot &slot = block[index & SLOT_BLOCK_MASK];
+		if (slot.id.get() != p_instance_id) {
+			return nullptr;
+		}
+		Object *object = slot.object.get();
+		// The slot may have been freed and reused while reading it.
+		if (slot.id.get() != p_instance_id) {
+			return nullptr;
+		}
+		return object;
+	}
+
 	static void debug_objects(DebugFunc p_func);
 	static int get_object_count();
 
-	// This one may give false positives because a new object may be allocated at the same memory of a previously freed one
-	_FORCE_INLINE_ static bool instance_validate(Object *p_ptr) {
-		rw_lock.read_lock();
-
-		bool exists = instance_checks.has(p_ptr);
-
-		rw_lock.read_unlock();
-
-		return exists;
-	}
+	// This one may give false positives because a new object may be allocated at the same memory of a previously freed one.
+	// It also walks every slot, so prefer get_instance() with an ObjectID.
+	static bool instance_validate(Object *p_ptr);
 };
 
 //needed by macros
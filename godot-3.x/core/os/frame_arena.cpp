@@ -0,0 +1,189 @@
+/*************************************************************************/
+/*  frame_arena.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "frame_arena.h"
+
+#include "core/os/thread.h"
+#include "core/variant.h"
+
+FrameArena::Chunk FrameArena::chunks[MAX_CHUNKS];
+int FrameArena::chunk_count = 0;
+uint32_t FrameArena::live_blocks = 0;
+bool FrameArena::escaped_blocks_reported = false;
+
+uint64_t FrameArena::arena_bytes = 0;
+SafeNumeric<uint64_t> FrameArena::fallback_bytes;
+uint64_t FrameArena::last_frame_arena_bytes = 0;
+uint64_t FrameArena::last_frame_fallback_bytes = 0;
+
+FrameArena::Chunk *FrameArena::_find_chunk(const void *p_ptr) {
+	for (int i = chunk_count - 1; i >= 0; i--) {
+		if (p_ptr >= chunks[i].memory && p_ptr < chunks[i].memory + chunks[i].size) {
+			return &chunks[i];
+		}
+	}
+	return nullptr;
+}
+
+FrameArena::Chunk *FrameArena::_add_chunk(size_t p_min_size) {
+	if (chunk_count == MAX_CHUNKS) {
+		return nullptr;
+	}
+
+	size_t size = chunk_count ? chunks[chunk_count - 1].size * 2 : MIN_CHUNK_SIZE;
+	size = MAX(size, p_min_size);
+	uint8_t *memory = (uint8_t *)memalloc(size);
+	if (!memory) {
+		return nullptr;
+	}
+
+	Chunk &chunk = chunks[chunk_count++];
+	chunk.memory = memory;
+	chunk.size = size;
+	chunk.used = 0;
+	return &chunk;
+}
+
+void *FrameArena::alloc(size_t p_bytes) {
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		fallback_bytes.add(p_bytes);
+		return memalloc(p_bytes);
+	}
+
+	size_t block_size = _get_block_size(p_bytes);
+	Chunk *chunk = chunk_count ? &chunks[chunk_count - 1] : nullptr;
+	if (!chunk || chunk->size - chunk->used < block_size) {
+		chunk = _add_chunk(block_size);
+		if (!chunk) {
+			fallback_bytes.add(p_bytes);
+			return memalloc(p_bytes);
+		}
+	}
+
+	uint8_t *block = chunk->memory + chunk->used;
+	chunk->used += block_size;
+	*(uint64_t *)block = p_bytes;
+	live_blocks++;
+	arena_bytes += p_bytes;
+
+	return block + BLOCK_HEADER_SIZE;
+}
+
+void *FrameArena::realloc(void *p_ptr, size_t p_bytes) {
+	if (!p_ptr) {
+		return alloc(p_bytes);
+	}
+
+	Chunk *chunk = Thread::get_caller_id() == Thread::get_main_id() ? _find_chunk(p_ptr) : nullptr;
+	if (!chunk) {
+		fallback_bytes.add(p_bytes);
+		return memrealloc(p_ptr, p_bytes);
+	}
+	if (p_bytes == 0) {
+		free(p_ptr);
+		return nullptr;
+	}
+
+	uint8_t *block = (uint8_t *)p_ptr - BLOCK_HEADER_SIZE;
+	size_t old_bytes = *(uint64_t *)block;
+	size_t offset = block - chunk->memory;
+
+	// The last block of the chunk can grow or shrink in place.
+	if (offset + _get_block_size(old_bytes) == chunk->used && offset + _get_block_size(p_bytes) <= chunk->size) {
+		chunk->used = offset + _get_block_size(p_bytes);
+		*(uint64_t *)block = p_bytes;
+		if (p_bytes > old_bytes) {
+			arena_bytes += p_bytes - old_bytes;
+		}
+		return p_ptr;
+	}
+
+	void *mem = alloc(p_bytes);
+	if (mem) {
+		memcpy(mem, p_ptr, MIN(old_bytes, p_bytes));
+		free(p_ptr);
+	}
+	return mem;
+}
+
+void FrameArena::free(void *p_ptr) {
+	Chunk *chunk = Thread::get_caller_id() == Thread::get_main_id() ? _find_chunk(p_ptr) : nullptr;
+	if (!chunk) {
+		memfree(p_ptr);
+		return;
+	}
+
+	live_blocks--;
+	if (live_blocks == 0) {
+		// Nothing uses the arena anymore, start over from the first chunk.
+		for (int i = 0; i < chunk_count; i++) {
+			chunks[i].used = 0;
+		}
+		return;
+	}
+
+	uint8_t *block = (uint8_t *)p_ptr - BLOCK_HEADER_SIZE;
+	size_t offset = block - chunk->memory;
+	if (offset + _get_block_size(*(uint64_t *)block) == chunk->used) {
+		chunk->used = offset; // Freed in reverse order, like most temporaries are.
+	}
+}
+
+void FrameArena::end_frame() {
+	last_frame_arena_bytes = arena_bytes;
+	arena_bytes = 0;
+	last_frame_fallback_bytes = fallback_bytes.get();
+	fallback_bytes.set(0);
+
+	if (live_blocks) {
+		if (!escaped_blocks_reported) {
+			escaped_blocks_reported = true;
+			WARN_PRINT(vformat("%d frame arena blocks are still in use at the end of the frame. Containers using the frame arena must not outlive the frame.", live_blocks));
+		}
+		return;
+	}
+
+	if (chunk_count > 1) {
+		size_t total_size = 0;
+		for (int i = 0; i < chunk_count; i++) {
+			total_size += chunks[i].size;
+		}
+		cleanup();
+		_add_chunk(total_size);
+	}
+}
+
+void FrameArena::cleanup() {
+	for (int i = 0; i < chunk_count; i++) {
+		memfree(chunks[i].memory);
+		chunks[i] = Chunk();
+	}
+	chunk_count = 0;
+}
@@ -0,0 +1,98 @@
+/*************************************************************************/
+/*  frame_arena.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include "core/local_vector.h"
+#include "core/safe_refcount.h"
+
+// Linear allocator for temporary storage that doesn't outlive the current frame.
+// Blocks are carved out of chunks one after the other, and the chunks are reused as
+// soon as every block is freed again. At the end of each frame, chunks that were added
+// because the arena ran out of space are merged, so the next frame fits in one.
+// Only the main thread allocates from the arena; other threads transparently get heap
+// memory, so arena backed containers must stay on the thread that created them.
+class FrameArena {
+	enum {
+		MIN_CHUNK_SIZE = 256 * 1024,
+		MAX_CHUNKS = 16,
+		BLOCK_HEADER_SIZE = 16, // Holds the block size and keeps blocks 16 bytes aligned.
+	};
+
+	struct Chunk {
+		uint8_t *memory = nullptr;
+		size_t size = 0;
+		size_t used = 0;
+	};
+
+	static Chunk chunks[MAX_CHUNKS];
+	static int chunk_count;
+	static uint32_t live_blocks;
+	static bool escaped_blocks_reported;
+
+	static uint64_t arena_bytes;
+	static SafeNumeric<uint64_t> fallback_bytes;
+	static uint64_t last_frame_arena_bytes;
+	static uint64_t last_frame_fallback_bytes;
+
+	_FORCE_INLINE_ static size_t _get_block_size(size_t p_bytes) {
+		return BLOCK_HEADER_SIZE + ((p_bytes + 15) & ~size_t(15));
+	}
+
+	static Chunk *_find_chunk(const void *p_ptr);
+	static Chunk *_add_chunk(size_t p_min_size);
+
+public:
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_ptr, size_t p_bytes);
+	static void free(void *p_ptr);
+
+	static void end_frame();
+	static void cleanup();
+
+	// Bytes served by the arena in the last frame, and bytes requested through it that
+	// fell back to the heap instead: on threads other than the main one, or when the
+	// arena was full.
+	static uint64_t get_last_frame_arena_bytes() { return last_frame_arena_bytes; }
+	static uint64_t get_last_frame_fallback_bytes() { return last_frame_fallback_bytes; }
+};
+
+class FrameArenaAllocator {
+public:
+	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return FrameArena::alloc(p_memory); }
+	_FORCE_INLINE_ static void *realloc(void *p_ptr, size_t p_memory) { return FrameArena::realloc(p_ptr, p_memory); }
+	_FORCE_INLINE_ static void free(void *p_ptr) { FrameArena::free(p_ptr); }
+};
+
+template <class T, class U = uint32_t, bool force_trivial = false>
+using FrameLocalVector = LocalVector<T, U, force_trivial, FrameArenaAllocator>;
+
+#endif // FRAME_ARENA_H
@@ -31,10 +31,12 @@
 #include "memory.h"
 
 #include "core/error_macros.h"
+#include "core/os/size_class_allocator.h"
 #include "core/safe_refcount.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 void *operator new(size_t p_size, const char *p_description) {
 	return Memory::alloc_static(p_size, false);
@@ -65,14 +67,53 @@ SafeNumeric<uint64_t> Memory::max_usage;
 
 SafeNumeric<uint64_t> Memory::alloc_count;
 
+#ifdef ENGINE_ALLOCATOR_ENABLED
+// Small blocks come from SizeClassAllocator. The size header is always written in this
+// mode, as it's what tells the size class of a block when it's freed or reallocated.
+
+static _FORCE_INLINE_ void *_alloc_block(size_t p_bytes) {
+	int size_class = SizeClassAllocator::get_size_class(p_bytes);
+	return size_class >= 0 ? SizeClassAllocator::alloc(size_class) : malloc(p_bytes);
+}
+
+static _FORCE_INLINE_ void _free_block(void *p_mem, size_t p_bytes) {
+	int size_class = SizeClassAllocator::get_size_class(p_bytes);
+	if (size_class >= 0) {
+		SizeClassAllocator::free(p_mem, size_class);
+	} else {
+		free(p_mem);
+	}
+}
+
+static void *_realloc_block(void *p_mem, size_t p_old_bytes, size_t p_bytes) {
+	int old_class = SizeClassAllocator::get_size_class(p_old_bytes);
+	int new_class = SizeClassAllocator::get_size_class(p_bytes);
+	if (old_class == new_class) {
+		return old_class >= 0 ? p_mem : realloc(p_mem, p_bytes);
+	}
+
+	void *mem = _alloc_block(p_bytes);
+	if (mem) {
+		// Copies the whole header too, CowData keeps its own data after the size.
+		memcpy(mem, p_mem, MIN(p_old_bytes, p_bytes));
+		_free_block(p_mem, p_old_bytes);
+	}
+	return mem;
+}
+#endif
+
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(ENGINE_ALLOCATOR_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
 #endif
 
+#ifdef ENGINE_ALLOCATOR_ENABLED
+	void *mem = _alloc_block(p_bytes + PAD_ALIGN);
+#else
 	void *mem = malloc(p_bytes + (prepad ? PAD_ALIGN : 0));
+#endif
 
 	ERR_FAIL_COND_V(!mem, nullptr);
 
@@ -101,7 +142,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_memory;
 
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(ENGINE_ALLOCATOR_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -121,12 +162,20 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 #endif
 
 		if (p_bytes == 0) {
+#ifdef ENGINE_ALLOCATOR_ENABLED
+			_free_block(mem, *s + PAD_ALIGN);
+#else
 			free(mem);
+#endif
 			return nullptr;
 		} else {
+#ifdef ENGINE_ALLOCATOR_ENABLED
+			mem = (uint8_t *)_realloc_block(mem, *s + PAD_ALIGN, p_bytes + PAD_ALIGN);
+#else
 			*s = p_bytes;
 
 			mem = (uint8_t *)realloc(mem, p_bytes + PAD_ALIGN);
+#endif
 			ERR_FAIL_COND_V(!mem, nullptr);
 
 			s = (uint64_t *)mem;
@@ -149,7 +198,7 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_ptr;
 
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(ENGINE_ALLOCATOR_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -165,7 +214,11 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 		mem_usage.sub(*s);
 #endif
 
+#ifdef ENGINE_ALLOCATOR_ENABLED
+		_free_block(mem, *(uint64_t *)mem + PAD_ALIGN);
+#else
 		free(mem);
+#endif
 	} else {
 		free(mem);
 	}
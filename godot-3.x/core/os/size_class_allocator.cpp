@@ -0,0 +1,155 @@
+/*************************************************************************/
+/*  size_class_allocator.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "size_class_allocator.h"
+
+#include "core/error_macros.h"
+#include "core/os/mutex.h"
+
+#include <stdlib.h>
+
+// Everything here is zero or constant initialized, as Memory may use it before
+// static constructors have run.
+struct SizeClassAllocator::SizeClass {
+	BinaryMutex mutex;
+	FreeBlock *free_blocks;
+	uint64_t free_count;
+	uint64_t reserved_count;
+	uint8_t *slab_pos;
+	uint8_t *slab_end;
+};
+
+SizeClassAllocator::SizeClass SizeClassAllocator::size_classes[SIZE_CLASS_COUNT];
+thread_local SizeClassAllocator::ThreadCache SizeClassAllocator::thread_cache;
+
+uint32_t SizeClassAllocator::get_class_block_size(int p_class) {
+	if (p_class < 8) {
+		return (p_class + 1) * 16;
+	} else if (p_class < 12) {
+		return 128 + (p_class - 7) * 32;
+	}
+	return 256 + (p_class - 11) * 64;
+}
+
+void *SizeClassAllocator::_refill(int p_class) {
+	SizeClass &sc = size_classes[p_class];
+	ThreadCache &cache = thread_cache;
+	uint32_t block_size = get_class_block_size(p_class);
+
+	MutexLock lock(sc.mutex);
+
+	for (int i = 0; i < TRANSFER_BATCH; i++) {
+		FreeBlock *block = sc.free_blocks;
+		if (block) {
+			sc.free_blocks = block->next;
+			sc.free_count--;
+		} else {
+			if ((size_t)(sc.slab_end - sc.slab_pos) < block_size) {
+				if (i > 0) {
+					break; // Got some already, don't open a new slab just to fill the batch.
+				}
+				uint8_t *slab = (uint8_t *)::malloc(SLAB_SIZE);
+				if (!slab) {
+					return nullptr;
+				}
+				sc.slab_pos = slab;
+				sc.slab_end = slab + SLAB_SIZE;
+			}
+			block = (FreeBlock *)sc.slab_pos;
+			sc.slab_pos += block_size;
+			sc.reserved_count++;
+		}
+		block->next = cache.blocks[p_class];
+		cache.blocks[p_class] = block;
+		cache.counts[p_class]++;
+	}
+
+	FreeBlock *block = cache.blocks[p_class];
+	cache.blocks[p_class] = block->next;
+	cache.counts[p_class]--;
+	return block;
+}
+
+void SizeClassAllocator::_flush(int p_class, uint32_t p_count) {
+	SizeClass &sc = size_classes[p_class];
+	ThreadCache &cache = thread_cache;
+
+	// Unlink the blocks before locking, the cache belongs to this thread only.
+	FreeBlock *first = cache.blocks[p_class];
+	FreeBlock *last = first;
+	for (uint32_t i = 1; i < p_count; i++) {
+		last = last->next;
+	}
+	cache.blocks[p_class] = last->next;
+	cache.counts[p_class] -= p_count;
+
+	MutexLock lock(sc.mutex);
+	last->next = sc.free_blocks;
+	sc.free_blocks = first;
+	sc.free_count += p_count;
+}
+
+void SizeClassAllocator::thread_exit() {
+	for (int i = 0; i < SIZE_CLASS_COUNT; i++) {
+		if (thread_cache.counts[i]) {
+			_flush(i, thread_cache.counts[i]);
+		}
+	}
+}
+
+void SizeClassAllocator::get_stats(int p_class, Stats &r_stats) {
+	ERR_FAIL_INDEX(p_class, SIZE_CLASS_COUNT);
+	SizeClass &sc = size_classes[p_class];
+
+	MutexLock lock(sc.mutex);
+	r_stats.block_size = get_class_block_size(p_class);
+	r_stats.used_blocks = sc.reserved_count - sc.free_count;
+	r_stats.reserved_blocks = sc.reserved_count;
+}
+
+uint64_t SizeClassAllocator::get_used_bytes() {
+	uint64_t bytes = 0;
+	for (int i = 0; i < SIZE_CLASS_COUNT; i++) {
+		Stats stats;
+		get_stats(i, stats);
+		bytes += stats.used_blocks * stats.block_size;
+	}
+	return bytes;
+}
+
+uint64_t SizeClassAllocator::get_reserved_bytes() {
+	uint64_t bytes = 0;
+	for (int i = 0; i < SIZE_CLASS_COUNT; i++) {
+		Stats stats;
+		get_stats(i, stats);
+		bytes += stats.reserved_blocks * stats.block_size;
+	}
+	return bytes;
+}
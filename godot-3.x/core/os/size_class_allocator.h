@@ -0,0 +1,120 @@
+/*************************************************************************/
+/*  size_class_allocator.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SIZE_CLASS_ALLOCATOR_H
+#define SIZE_CLASS_ALLOCATOR_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+// Allocator for small blocks, used by Memory when built with `engine_allocator=yes`.
+// Blocks are carved out of slabs, one free list per size class, and each thread keeps
+// a small cache per class so most allocations and frees don't take any lock.
+// Slabs are never given back to the system.
+class SizeClassAllocator {
+public:
+	enum {
+		SIZE_CLASS_COUNT = 16,
+		MAX_BLOCK_SIZE = 512,
+		SLAB_SIZE = 64 * 1024,
+		THREAD_CACHE_MAX = 128, // Blocks per class kept by each thread.
+		TRANSFER_BATCH = 32, // Blocks moved at once between a thread cache and the shared list.
+	};
+
+	struct Stats {
+		uint32_t block_size = 0;
+		uint64_t used_blocks = 0; // Includes blocks sitting in thread caches.
+		uint64_t reserved_blocks = 0;
+	};
+
+private:
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	struct ThreadCache {
+		FreeBlock *blocks[SIZE_CLASS_COUNT];
+		uint32_t counts[SIZE_CLASS_COUNT];
+	};
+
+	struct SizeClass;
+
+	static SizeClass size_classes[SIZE_CLASS_COUNT];
+	static thread_local ThreadCache thread_cache;
+
+	static void *_refill(int p_class);
+	static void _flush(int p_class, uint32_t p_count);
+
+public:
+	// Returns -1 if the block is too big for any size class.
+	_FORCE_INLINE_ static int get_size_class(size_t p_bytes) {
+		if (p_bytes <= 128) {
+			return p_bytes ? (p_bytes - 1) >> 4 : 0; // 16 to 128, in steps of 16.
+		} else if (p_bytes <= 256) {
+			return 8 + ((p_bytes - 129) >> 5); // 160 to 256, in steps of 32.
+		} else if (p_bytes <= MAX_BLOCK_SIZE) {
+			return 12 + ((p_bytes - 257) >> 6); // 320 to 512, in steps of 64.
+		}
+		return -1;
+	}
+
+	static uint32_t get_class_block_size(int p_class);
+
+	_FORCE_INLINE_ static void *alloc(int p_class) {
+		ThreadCache &cache = thread_cache;
+		FreeBlock *block = cache.blocks[p_class];
+		if (unlikely(!block)) {
+			return _refill(p_class);
+		}
+		cache.blocks[p_class] = block->next;
+		cache.counts[p_class]--;
+		return block;
+	}
+
+	_FORCE_INLINE_ static void free(void *p_ptr, int p_class) {
+		ThreadCache &cache = thread_cache;
+		FreeBlock *block = (FreeBlock *)p_ptr;
+		block->next = cache.blocks[p_class];
+		cache.blocks[p_class] = block;
+		if (unlikely(++cache.counts[p_class] > THREAD_CACHE_MAX)) {
+			_flush(p_class, THREAD_CACHE_MAX / 2);
+		}
+	}
+
+	// Gives the blocks cached by the calling thread back to the shared lists.
+	static void thread_exit();
+
+	static void get_stats(int p_class, Stats &r_stats);
+	static uint64_t get_used_bytes();
+	static uint64_t get_reserved_bytes();
+};
+
+#endif // SIZE_CLASS_ALLOCATOR_H
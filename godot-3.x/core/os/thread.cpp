@@ -32,6 +32,8 @@
 
 #include "thread.h"
 
+#include "core/message_queue.h"
+#include "core/os/size_class_allocator.h"
 #include "core/script_language.h"
 
 #if !defined(NO_THREADS)
@@ -76,9 +78,13 @@ void Thread::callback(Thread *p_self, const Settings &p_settings, Callback p_cal
 	ScriptServer::thread_enter(); //scripts may need to attach a stack
 	p_callback(p_userdata);
 	ScriptServer::thread_exit();
+	MessageQueue::thread_exit();
 	if (term_func) {
 		term_func();
 	}
+#ifdef ENGINE_ALLOCATOR_ENABLED
+	SizeClassAllocator::thread_exit();
+#endif
 }
 
 void Thread::start(Thread::Callback p_callback, void *p_user, const Settings &p_settings) {
@@ -35,6 +35,7 @@
 #include "core/os/os.h"
 #include "core/os/thread.h"
 #include "core/os/thread_safe.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/safe_refcount.h"
 
 template <class C, class U>
@@ -64,10 +65,10 @@ void process_array_thread(void *ud) {
 	}
 }
 
-// p_num_threads is the number of logical CPU cores to use (0 = use all logical CPU cores available).
-// Negative values subtract from the total number of logical CPU cores available.
+// Spawns and joins its own threads on every call.
+// Only used when the WorkerThreadPool is not available, and kept for comparison in benchmarks.
 template <class C, class M, class U>
-void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_userdata, int p_num_threads = 0) {
+void thread_process_array_unpooled(uint32_t p_elements, C *p_instance, M p_method, U p_userdata, int p_num_threads = 0) {
 	ThreadArrayProcessData<C, U> data;
 	data.method = p_method;
 	data.instance = p_instance;
@@ -95,6 +96,28 @@ void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_us
 	memdelete_arr(threads);
 }
 
+// p_num_threads is the number of logical CPU cores to use (0 = use all logical CPU cores available).
+// Negative values subtract from the total number of logical CPU cores available.
+// The work is dispatched to the persistent WorkerThreadPool, the calling thread helps until it is done.
+template <class C, class M, class U>
+void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_userdata, int p_num_threads = 0) {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (!pool) {
+		thread_process_array_unpooled(p_elements, p_instance, p_method, p_userdata, p_num_threads);
+		return;
+	}
+
+	int thread_count;
+	if (p_num_threads <= 0) {
+		thread_count = MAX(1, OS::get_singleton()->get_processor_count() + p_num_threads);
+	} else {
+		thread_count = p_num_threads;
+	}
+
+	WorkerThreadPool::TaskID task = pool->add_template_group_task(p_instance, p_method, p_userdata, p_elements, 1, thread_count);
+	pool->wait_for_task_completion(task);
+}
+
 #else
 
 // p_num_threads is intentionally unused when threads are disabled.
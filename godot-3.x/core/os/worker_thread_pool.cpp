@@ -0,0 +1,494 @@
+/*************************************************************************/
+/*  worker_thread_pool.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "worker_thread_pool.h"
+
+#include "core/method_bind_ext.gen.inc"
+#include "core/os/os.h"
+
+WorkerThreadPool *WorkerThreadPool::singleton = nullptr;
+
+// Index of the queue owned by the calling thread, or -1 for threads that are not part of the pool.
+static thread_local int current_queue_index = -1;
+
+void WorkerThreadPool::TaskQueue::push_back(Task *p_task, uint32_t p_count) {
+	lock.lock();
+	if (head > 0 && head * 2 >= entries.size()) {
+		// Reclaim the already consumed front before growing.
+		uint32_t remaining = entries.size() - head;
+		memmove(entries.ptr(), entries.ptr() + head, remaining * sizeof(Task *));
+		entries.resize(remaining);
+		head = 0;
+	}
+	for (uint32_t i = 0; i < p_count; i++) {
+		entries.push_back(p_task);
+	}
+	lock.unlock();
+}
+
+bool WorkerThreadPool::TaskQueue::pop_back(Task *&r_task) {
+	lock.lock();
+	if (head == entries.size()) {
+		lock.unlock();
+		return false;
+	}
+	r_task = entries[entries.size() - 1];
+	entries.resize(entries.size() - 1);
+	if (head == entries.size()) {
+		entries.clear();
+		head = 0;
+	}
+	lock.unlock();
+	return true;
+}
+
+bool WorkerThreadPool::TaskQueue::pop_front(Task *&r_task) {
+	lock.lock();
+	if (head == entries.size()) {
+		lock.unlock();
+		return false;
+	}
+	r_task = entries[head++];
+	if (head == entries.size()) {
+		entries.clear();
+		head = 0;
+	}
+	lock.unlock();
+	return true;
+}
+
+void WorkerThreadPool::_thread_function(void *p_user) {
+#if !defined(NO_THREADS)
+	ThreadData *thread_data = (ThreadData *)p_user;
+	WorkerThreadPool *pool = thread_data->pool;
+	current_queue_index = thread_data->index;
+
+	while (true) {
+		Task *task;
+		if (pool->_pop_entry(task)) {
+			pool->_process_entry(task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(pool->sleep_mutex);
+		while (!pool->exit_threads && pool->queued_entries.get() == 0) {
+			pool->work_available.wait(lock);
+		}
+		if (pool->exit_threads) {
+			break;
+		}
+	}
+
+	current_queue_index = -1;
+#endif
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::_alloc_task() {
+	MutexLock lock(task_mutex);
+	return task_allocator.alloc();
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::_add_task(Task *p_task, const Vector<TaskID> &p_dependencies) {
+	task_mutex.lock();
+	TaskID id = ++last_task_id;
+	p_task->self = id;
+	tasks.set(id, p_task);
+
+	for (int i = 0; i < p_dependencies.size(); i++) {
+		Task **dependency = tasks.getptr(p_dependencies[i]);
+		// Unknown IDs belong to tasks that were already waited for, so they are complete.
+		if (dependency && !(*dependency)->completed) {
+			(*dependency)->dependents.push_back(p_task);
+			p_task->pending_dependencies++;
+		}
+	}
+	bool ready = p_task->pending_dependencies == 0;
+	task_mutex.unlock();
+
+	if (ready) {
+		_enqueue(p_task);
+	}
+	return id;
+}
+
+void WorkerThreadPool::_enqueue(Task *p_task) {
+	uint32_t count = 1;
+	if (p_task->is_group) {
+		// There is no point in having more entries than chunks of work or threads able to run them.
+		uint32_t chunks = p_task->elements / p_task->grain_size + (p_task->elements % p_task->grain_size ? 1 : 0);
+		count = MIN(chunks, thread_count + 1);
+		if (p_task->max_concurrency > 0) {
+			count = MIN(count, p_task->max_concurrency);
+		}
+		if (count == 0) {
+			_task_finished(p_task);
+			return;
+		}
+	}
+	p_task->entries_left.set(count);
+
+	TaskQueue &queue = current_queue_index >= 0 ? queues[current_queue_index] : injection_queue;
+	queue.push_back(p_task, count);
+
+#if !defined(NO_THREADS)
+	bool notify_waiters;
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		queued_entries.add(count);
+		notify_waiters = waiting_threads > 0;
+	}
+	if (count == 1) {
+		work_available.notify_one();
+	} else {
+		work_available.notify_all();
+	}
+	if (notify_waiters) {
+		task_done.notify_all();
+	}
+#else
+	queued_entries.add(count);
+#endif
+}
+
+bool WorkerThreadPool::_pop_entry(Task *&r_task) {
+	if (queued_entries.get() == 0) {
+		return false;
+	}
+
+	bool found = false;
+	if (current_queue_index >= 0) {
+		found = queues[current_queue_index].pop_back(r_task);
+	}
+	if (!found) {
+		found = injection_queue.pop_front(r_task);
+	}
+	if (!found && thread_count > 0) {
+		// Steal the oldest work from the other workers, starting with the next one to spread contention.
+		uint32_t start = current_queue_index >= 0 ? current_queue_index + 1 : 0;
+		for (uint32_t i = 0; i < thread_count && !found; i++) {
+			uint32_t index = (start + i) % thread_count;
+			if ((int)index != current_queue_index) {
+				found = queues[index].pop_front(r_task);
+			}
+		}
+	}
+
+	if (found) {
+		queued_entries.decrement();
+	}
+	return found;
+}
+
+void WorkerThreadPool::_call_script_method(Task *p_task, const Variant **p_args, int p_argcount) {
+	Object *instance = ObjectDB::get_instance(p_task->instance_id);
+	ERR_FAIL_COND_MSG(!instance, vformat("Could not call method '%s' on a previously freed instance from a WorkerThreadPool task.", p_task->method));
+
+	Variant::CallError ce;
+	instance->call(p_task->method, p_args, p_argcount, ce);
+	if (ce.error != Variant::CallError::CALL_OK) {
+		ERR_PRINT("Error calling method from WorkerThreadPool task: " + Variant::get_call_error_text(instance, p_task->method, p_args, p_argcount, ce) + ".");
+	}
+}
+
+void WorkerThreadPool::_process_entry(Task *p_task) {
+	if (p_task->is_group) {
+		while (true) {
+			uint32_t from = p_task->next_index.postadd(p_task->grain_size);
+			if (from >= p_task->elements) {
+				break;
+			}
+			uint32_t to = MIN(from + p_task->grain_size, p_task->elements);
+			for (uint32_t i = from; i < to; i++) {
+				if (p_task->template_userdata) {
+					p_task->template_userdata->callback(i);
+				} else if (p_task->native_group_func) {
+					p_task->native_group_func(p_task->native_func_userdata, i);
+				} else {
+					Variant index = i;
+					const Variant *args[2] = { &index, &p_task->userdata };
+					_call_script_method(p_task, args, 2);
+				}
+			}
+		}
+		// The last entry to run out of work completes the group.
+		if (p_task->entries_left.decrement() > 0) {
+			return;
+		}
+	} else if (p_task->native_func) {
+		p_task->native_func(p_task->native_func_userdata);
+	} else {
+		const Variant *args[1] = { &p_task->userdata };
+		_call_script_method(p_task, args, 1);
+	}
+
+	_task_finished(p_task);
+}
+
+void WorkerThreadPool::_task_finished(Task *p_task) {
+	LocalVector<Task *> ready;
+
+	task_mutex.lock();
+	for (uint32_t i = 0; i < p_task->dependents.size(); i++) {
+		Task *dependent = p_task->dependents[i];
+		dependent->pending_dependencies--;
+		if (dependent->pending_dependencies == 0) {
+			ready.push_back(dependent);
+		}
+	}
+	p_task->dependents.clear();
+
+	// Once completed is set and the lock released, the waiter may free the task at any time.
+#if !defined(NO_THREADS)
+	bool notify_waiters;
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		p_task->completed = true;
+		notify_waiters = waiting_threads > 0;
+	}
+#else
+	p_task->completed = true;
+#endif
+	task_mutex.unlock();
+
+#if !defined(NO_THREADS)
+	if (notify_waiters) {
+		task_done.notify_all();
+	}
+#endif
+
+	for (uint32_t i = 0; i < ready.size(); i++) {
+		_enqueue(ready[i]);
+	}
+}
+
+bool WorkerThreadPool::_is_task_completed(Task *p_task) {
+	MutexLock lock(task_mutex);
+	return p_task->completed;
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *), void *p_userdata, const Vector<TaskID> &p_dependencies) {
+	ERR_FAIL_NULL_V(p_func, INVALID_TASK_ID);
+	Task *task = _alloc_task();
+	task->native_func = p_func;
+	task->native_func_userdata = p_userdata;
+	return _add_task(task, p_dependencies);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, uint32_t p_elements, uint32_t p_grain_size, uint32_t p_max_concurrency, const Vector<TaskID> &p_dependencies) {
+	ERR_FAIL_NULL_V(p_func, INVALID_TASK_ID);
+	Task *task = _alloc_task();
+	task->native_group_func = p_func;
+	task->native_func_userdata = p_userdata;
+	task->is_group = true;
+	task->elements = p_elements;
+	task->grain_size = MAX(1u, p_grain_size);
+	task->max_concurrency = p_max_concurrency;
+	return _add_task(task, p_dependencies);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_task(Object *p_instance, const StringName &p_method, const Variant &p_userdata, const Vector<TaskID> &p_dependencies) {
+	ERR_FAIL_NULL_V(p_instance, INVALID_TASK_ID);
+	Task *task = _alloc_task();
+	task->instance_id = p_instance->get_instance_id();
+	task->method = p_method;
+	task->userdata = p_userdata;
+	return _add_task(task, p_dependencies);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_group_task(Object *p_instance, const StringName &p_method, uint32_t p_elements, const Variant &p_userdata, uint32_t p_grain_size, const Vector<TaskID> &p_dependencies) {
+	ERR_FAIL_NULL_V(p_instance, INVALID_TASK_ID);
+	Task *task = _alloc_task();
+	task->instance_id = p_instance->get_instance_id();
+	task->method = p_method;
+	task->userdata = p_userdata;
+	task->is_group = true;
+	task->elements = p_elements;
+	task->grain_size = MAX(1u, p_grain_size);
+	return _add_task(task, p_dependencies);
+}
+
+bool WorkerThreadPool::is_task_completed(TaskID p_task_id) {
+	MutexLock lock(task_mutex);
+	Task **task = tasks.getptr(p_task_id);
+	ERR_FAIL_COND_V_MSG(!task, false, "Invalid task ID: " + itos(p_task_id) + ".");
+	return (*task)->completed;
+}
+
+void WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
+	task_mutex.lock();
+	Task **taskp = tasks.getptr(p_task_id);
+	if (!taskp) {
+		task_mutex.unlock();
+		ERR_FAIL_MSG("Invalid task ID: " + itos(p_task_id) + ".");
+	}
+	Task *task = *taskp;
+	if (task->waiting) {
+		task_mutex.unlock();
+		ERR_FAIL_MSG("Another thread is already waiting for task " + itos(p_task_id) + ".");
+	}
+	task->waiting = true;
+	task_mutex.unlock();
+
+	// Help with pending work instead of sleeping, it may well be the task being waited for.
+	while (!_is_task_completed(task)) {
+		Task *entry;
+		if (_pop_entry(entry)) {
+			_process_entry(entry);
+			continue;
+		}
+
+#if !defined(NO_THREADS)
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		waiting_threads++;
+		while (!task->completed && queued_entries.get() == 0) {
+			task_done.wait(lock);
+		}
+		waiting_threads--;
+#endif
+	}
+
+	task_mutex.lock();
+	tasks.erase(p_task_id);
+	if (task->template_userdata) {
+		memdelete(task->template_userdata);
+	}
+	task_allocator.free(task);
+	task_mutex.unlock();
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::_add_task_bind(Object *p_instance, const StringName &p_method, const Variant &p_userdata, const PoolIntArray &p_dependencies) {
+	Vector<TaskID> dependencies;
+	dependencies.resize(p_dependencies.size());
+	PoolIntArray::Read r = p_dependencies.read();
+	for (int i = 0; i < p_dependencies.size(); i++) {
+		dependencies.write[i] = r[i];
+	}
+	return add_task(p_instance, p_method, p_userdata, dependencies);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::_add_group_task_bind(Object *p_instance, const StringName &p_method, int p_elements, const Variant &p_userdata, int p_grain_size, const PoolIntArray &p_dependencies) {
+	ERR_FAIL_COND_V(p_elements < 0, INVALID_TASK_ID);
+	ERR_FAIL_COND_V(p_grain_size < 1, INVALID_TASK_ID);
+
+	Vector<TaskID> dependencies;
+	dependencies.resize(p_dependencies.size());
+	PoolIntArray::Read r = p_dependencies.read();
+	for (int i = 0; i < p_dependencies.size(); i++) {
+		dependencies.write[i] = r[i];
+	}
+	return add_group_task(p_instance, p_method, p_elements, p_userdata, p_grain_size, dependencies);
+}
+
+void WorkerThreadPool::init(int p_thread_count) {
+	ERR_FAIL_COND(threads != nullptr);
+
+#if !defined(NO_THREADS)
+	if (p_thread_count < 0) {
+		p_thread_count = OS::get_singleton()->get_processor_count();
+	}
+	if (p_thread_count == 0) {
+		return;
+	}
+
+	thread_count = p_thread_count;
+	queues = memnew_arr(TaskQueue, thread_count);
+	threads = memnew_arr(ThreadData, thread_count);
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads[i].pool = this;
+		threads[i].index = i;
+		threads[i].thread.start(&WorkerThreadPool::_thread_function, &threads[i]);
+	}
+#endif
+}
+
+void WorkerThreadPool::finish() {
+	if (!threads) {
+		return;
+	}
+
+#if !defined(NO_THREADS)
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		exit_threads = true;
+	}
+	work_available.notify_all();
+#endif
+
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads[i].thread.wait_to_finish();
+	}
+
+	// Work that was never picked up can still be run by whoever waits for it.
+	for (uint32_t i = 0; i < thread_count; i++) {
+		Task *task;
+		while (queues[i].pop_front(task)) {
+			injection_queue.push_back(task, 1);
+		}
+	}
+
+	memdelete_arr(threads);
+	memdelete_arr(queues);
+	threads = nullptr;
+	queues = nullptr;
+	thread_count = 0;
+	exit_threads = false;
+}
+
+void WorkerThreadPool::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("add_task", "instance", "method", "userdata", "dependencies"), &WorkerThreadPool::_add_task_bind, DEFVAL(Variant()), DEFVAL(PoolIntArray()));
+	ClassDB::bind_method(D_METHOD("add_group_task", "instance", "method", "elements", "userdata", "grain_size", "dependencies"), &WorkerThreadPool::_add_group_task_bind, DEFVAL(Variant()), DEFVAL(1), DEFVAL(PoolIntArray()));
+	ClassDB::bind_method(D_METHOD("is_task_completed", "task_id"), &WorkerThreadPool::is_task_completed);
+	ClassDB::bind_method(D_METHOD("wait_for_task_completion", "task_id"), &WorkerThreadPool::wait_for_task_completion);
+	ClassDB::bind_method(D_METHOD("get_thread_count"), &WorkerThreadPool::get_thread_count);
+}
+
+WorkerThreadPool::WorkerThreadPool() {
+	ERR_FAIL_COND_MSG(singleton, "Singleton for WorkerThreadPool already exists.");
+	singleton = this;
+}
+
+WorkerThreadPool::~WorkerThreadPool() {
+	finish();
+
+	if (tasks.size()) {
+		WARN_PRINT(itos(tasks.size()) + " WorkerThreadPool task(s) were never waited for.");
+		const TaskID *k = nullptr;
+		while ((k = tasks.next(k))) {
+			Task *task = tasks[*k];
+			if (task->template_userdata) {
+				memdelete(task->template_userdata);
+			}
+			task_allocator.free(task);
+		}
+		tasks.clear();
+	}
+
+	singleton = nullptr;
+}
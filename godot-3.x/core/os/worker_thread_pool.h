@@ -0,0 +1,202 @@
+/*************************************************************************/
+/*  worker_thread_pool.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef WORKER_THREAD_POOL_H
+#define WORKER_THREAD_POOL_H
+
+#include "core/hash_map.h"
+#include "core/local_vector.h"
+#include "core/object.h"
+#include "core/os/mutex.h"
+#include "core/os/spin_lock.h"
+#include "core/os/thread.h"
+#include "core/paged_allocator.h"
+#include "core/safe_refcount.h"
+
+#if !defined(NO_THREADS)
+#include <condition_variable>
+#include <mutex>
+#endif
+
+// Persistent pool of worker threads, created once at startup and shared by the whole engine.
+// Each worker owns a deque of pending work: the owner pushes and pops at the back (LIFO, cache friendly),
+// while idle workers steal from the front of the others. Threads that are not part of the pool
+// (such as the main thread) submit to a shared injection queue.
+// Waiting for a task never blocks idly while there is pending work: the waiting thread runs queued work
+// until the task it waits for is done, which also makes nested waits from inside tasks safe.
+// Every task must be waited for exactly once, which is when its resources are released.
+class WorkerThreadPool : public Object {
+	GDCLASS(WorkerThreadPool, Object);
+
+public:
+	typedef int64_t TaskID;
+	enum {
+		INVALID_TASK_ID = -1
+	};
+
+private:
+	struct BaseTemplateUserdata {
+		virtual void callback(uint32_t p_index) = 0;
+		virtual ~BaseTemplateUserdata() {}
+	};
+
+	template <class C, class M, class U>
+	struct GroupUserdata : public BaseTemplateUserdata {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void callback(uint32_t p_index) {
+			(instance->*method)(p_index, userdata);
+		}
+	};
+
+	struct Task {
+		TaskID self = INVALID_TASK_ID;
+
+		void (*native_func)(void *) = nullptr;
+		void (*native_group_func)(void *, uint32_t) = nullptr;
+		void *native_func_userdata = nullptr;
+		BaseTemplateUserdata *template_userdata = nullptr;
+
+		ObjectID instance_id = 0;
+		StringName method;
+		Variant userdata;
+
+		bool is_group = false;
+		uint32_t elements = 0;
+		uint32_t grain_size = 1;
+		uint32_t max_concurrency = 0;
+		SafeNumeric<uint32_t> next_index;
+		SafeNumeric<uint32_t> entries_left;
+
+		// Guarded by task_mutex.
+		uint32_t pending_dependencies = 0;
+		LocalVector<Task *> dependents;
+		bool waiting = false;
+		// Written while holding both task_mutex and sleep_mutex, read under either.
+		bool completed = false;
+	};
+
+	struct TaskQueue {
+		SpinLock lock;
+		LocalVector<Task *> entries;
+		uint32_t head = 0;
+
+		void push_back(Task *p_task, uint32_t p_count);
+		bool pop_back(Task *&r_task);
+		bool pop_front(Task *&r_task);
+	};
+
+	struct ThreadData {
+		WorkerThreadPool *pool = nullptr;
+		uint32_t index = 0;
+		Thread thread;
+	};
+
+	static WorkerThreadPool *singleton;
+
+	ThreadData *threads = nullptr;
+	uint32_t thread_count = 0;
+	bool exit_threads = false;
+
+	// One queue per worker, plus a last one shared by threads that are not part of the pool.
+	TaskQueue *queues = nullptr;
+	TaskQueue injection_queue;
+
+	BinaryMutex task_mutex;
+	PagedAllocator<Task> task_allocator;
+	HashMap<TaskID, Task *> tasks;
+	TaskID last_task_id = 0;
+
+	SafeNumeric<uint32_t> queued_entries;
+#if !defined(NO_THREADS)
+	std::mutex sleep_mutex;
+	std::condition_variable work_available;
+	std::condition_variable task_done;
+	uint32_t waiting_threads = 0;
+#endif
+
+	static void _thread_function(void *p_user);
+
+	Task *_alloc_task();
+	TaskID _add_task(Task *p_task, const Vector<TaskID> &p_dependencies);
+	void _enqueue(Task *p_task);
+	bool _pop_entry(Task *&r_task);
+	void _process_entry(Task *p_task);
+	void _call_script_method(Task *p_task, const Variant **p_args, int p_argcount);
+	void _task_finished(Task *p_task);
+	bool _is_task_completed(Task *p_task);
+
+	TaskID _add_task_bind(Object *p_instance, const StringName &p_method, const Variant &p_userdata, const PoolIntArray &p_dependencies);
+	TaskID _add_group_task_bind(Object *p_instance, const StringName &p_method, int p_elements, const Variant &p_userdata, int p_grain_size, const PoolIntArray &p_dependencies);
+
+protected:
+	static void _bind_methods();
+
+public:
+	static WorkerThreadPool *get_singleton() { return singleton; }
+
+	// p_max_concurrency caps how many threads work on a group at the same time (0 = all available threads).
+	TaskID add_native_task(void (*p_func)(void *), void *p_userdata, const Vector<TaskID> &p_dependencies = Vector<TaskID>());
+	TaskID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, uint32_t p_elements, uint32_t p_grain_size = 1, uint32_t p_max_concurrency = 0, const Vector<TaskID> &p_dependencies = Vector<TaskID>());
+
+	template <class C, class M, class U>
+	TaskID add_template_group_task(C *p_instance, M p_method, U p_userdata, uint32_t p_elements, uint32_t p_grain_size = 1, uint32_t p_max_concurrency = 0, const Vector<TaskID> &p_dependencies = Vector<TaskID>()) {
+		GroupUserdata<C, M, U> *ud = memnew((GroupUserdata<C, M, U>));
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+
+		Task *task = _alloc_task();
+		task->template_userdata = ud;
+		task->is_group = true;
+		task->elements = p_elements;
+		task->grain_size = MAX(1u, p_grain_size);
+		task->max_concurrency = p_max_concurrency;
+		return _add_task(task, p_dependencies);
+	}
+
+	TaskID add_task(Object *p_instance, const StringName &p_method, const Variant &p_userdata = Variant(), const Vector<TaskID> &p_dependencies = Vector<TaskID>());
+	TaskID add_group_task(Object *p_instance, const StringName &p_method, uint32_t p_elements, const Variant &p_userdata = Variant(), uint32_t p_grain_size = 1, const Vector<TaskID> &p_dependencies = Vector<TaskID>());
+
+	bool is_task_completed(TaskID p_task_id);
+	void wait_for_task_completion(TaskID p_task_id);
+
+	int get_thread_count() const { return thread_count; }
+
+	// p_thread_count < 0 means one thread per logical CPU core.
+	void init(int p_thread_count = -1);
+	void finish();
+
+	WorkerThreadPool();
+	~WorkerThreadPool();
+};
+
+#endif // WORKER_THREAD_POOL_H
@@ -334,7 +334,7 @@ struct PtrToArg<const RefPtr &> {
 
 #endif // PTRCALL_ENABLED
 
-#ifdef DEBUG_METHODS_ENABLED
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 
 template <class T>
 struct GetTypeInfo<Ref<T>> {
@@ -356,6 +356,6 @@ struct GetTypeInfo<const Ref<T> &> {
 	}
 };
 
-#endif // DEBUG_METHODS_ENABLED
+#endif // METHOD_ARGUMENT_TYPES_ENABLED
 
 #endif // REFERENCE_H
@@ -131,6 +131,12 @@ public:
 		}
 	}
 
+	// Sets p_value if the current value is r_expected, otherwise r_expected receives the current value.
+	// It may fail spuriously, so it is meant to be used in a loop.
+	_ALWAYS_INLINE_ bool compare_exchange(T &r_expected, T p_value) {
+		return value.compare_exchange_weak(r_expected, p_value, std::memory_order_acq_rel, std::memory_order_acquire);
+	}
+
 	_ALWAYS_INLINE_ explicit SafeNumeric<T>(T p_value = static_cast<T>(0)) {
 		set(p_value);
 	}
@@ -257,6 +263,15 @@ public:
 		}
 	}
 
+	_ALWAYS_INLINE_ bool compare_exchange(T &r_expected, T p_value) {
+		if (value != r_expected) {
+			r_expected = value;
+			return false;
+		}
+		value = p_value;
+		return true;
+	}
+
 	_ALWAYS_INLINE_ explicit SafeNumeric<T>(T p_value = static_cast<T>(0)) :
 			value(p_value) {
 	}
@@ -46,7 +46,7 @@ StringName _scs_create(const char *p_chr) {
 }
 
 bool StringName::configured = false;
-Mutex StringName::lock;
+StringName::TableLock StringName::_table_locks[TABLE_LOCK_COUNT];
 
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
@@ -57,10 +57,10 @@ void StringName::setup() {
 }
 
 void StringName::cleanup() {
-	lock.lock();
-
 	int lost_strings = 0;
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
+		const Mutex &lock = _get_table_lock(i);
+		lock.lock();
 		while (_table[i]) {
 			_Data *d = _table[i];
 			lost_strings++;
@@ -75,17 +75,18 @@ void StringName::cleanup() {
 			_table[i] = _table[i]->next;
 			memdelete(d);
 		}
+		lock.unlock();
 	}
 	if (lost_strings) {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
-	lock.unlock();
 }
 
 void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
+		const Mutex &lock = _get_table_lock(_data->idx);
 		lock.lock();
 
 		if (_data->prev) {
@@ -164,12 +165,13 @@ StringName::StringName(const char *p_name) {
 		return; //empty, ignore
 	}
 
-	lock.lock();
-
 	uint32_t hash = String::hash(p_name);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	const Mutex &lock = _get_table_lock(idx);
+	lock.lock();
+
 	_data = _table[idx];
 
 	while (_data) {
@@ -211,12 +213,13 @@ StringName::StringName(const StaticCString &p_static_string) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	lock.lock();
-
 	uint32_t hash = String::hash(p_static_string.ptr);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	const Mutex &lock = _get_table_lock(idx);
+	lock.lock();
+
 	_data = _table[idx];
 
 	while (_data) {
@@ -260,12 +263,13 @@ StringName::StringName(const String &p_name) {
 		return;
 	}
 
-	lock.lock();
-
 	uint32_t hash = p_name.hash();
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	const Mutex &lock = _get_table_lock(idx);
+	lock.lock();
+
 	_data = _table[idx];
 
 	while (_data) {
@@ -307,12 +311,13 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	lock.lock();
-
 	uint32_t hash = String::hash(p_name);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	const Mutex &lock = _get_table_lock(idx);
+	lock.lock();
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
@@ -341,12 +346,13 @@ StringName StringName::search(const CharType *p_name) {
 		return StringName();
 	}
 
-	lock.lock();
-
 	uint32_t hash = String::hash(p_name);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	const Mutex &lock = _get_table_lock(idx);
+	lock.lock();
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
@@ -368,12 +374,13 @@ StringName StringName::search(const CharType *p_name) {
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	lock.lock();
-
 	uint32_t hash = p_name.hash();
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	const Mutex &lock = _get_table_lock(idx);
+	lock.lock();
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
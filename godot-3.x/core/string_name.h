@@ -45,7 +45,13 @@ class StringName {
 
 		STRING_TABLE_BITS = 12,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+
+		// Buckets are spread over several locks, so threads interning different
+		// names rarely wait on each other. References are atomic and don't lock.
+		TABLE_LOCK_BITS = 6,
+		TABLE_LOCK_COUNT = 1 << TABLE_LOCK_BITS,
+		TABLE_LOCK_MASK = TABLE_LOCK_COUNT - 1
 	};
 
 	struct _Data {
@@ -79,7 +85,13 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 
-	static Mutex lock;
+	struct alignas(64) TableLock {
+		Mutex mutex; // Padded to a cache line to avoid false sharing between locks.
+	};
+
+	static TableLock _table_locks[TABLE_LOCK_COUNT];
+	_FORCE_INLINE_ static const Mutex &_get_table_lock(uint32_t p_idx) { return _table_locks[p_idx & TABLE_LOCK_MASK].mutex; }
+
 	static void setup();
 	static void cleanup();
 	static bool configured;
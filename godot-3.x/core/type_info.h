@@ -31,7 +31,7 @@
 #ifndef GET_TYPE_INFO_H
 #define GET_TYPE_INFO_H
 
-#ifdef DEBUG_METHODS_ENABLED
+#ifdef METHOD_ARGUMENT_TYPES_ENABLED
 
 template <bool C, typename T = void>
 struct EnableIf {
@@ -284,6 +284,6 @@ inline StringName __constant_get_enum_name(T param, const String &p_constant) {
 #define MAKE_ENUM_TYPE_INFO(m_enum)
 #define CLASS_INFO(m_type)
 
-#endif // DEBUG_METHODS_ENABLED
+#endif // METHOD_ARGUMENT_TYPES_ENABLED
 
 #endif // GET_TYPE_INFO_H
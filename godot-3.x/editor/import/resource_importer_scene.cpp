@@ -887,6 +887,26 @@ void ResourceImporterScene::_optimize_animations(Node *scene, float p_max_lin_er
 	}
 }
 
+void ResourceImporterScene::_compress_animations(Node *scene, float p_max_lin_error, float p_max_ang_error, float p_max_angle) {
+	if (!scene->has_node(String("AnimationPlayer"))) {
+		return;
+	}
+	Node *n = scene->get_node(String("AnimationPlayer"));
+	ERR_FAIL_COND(!n);
+	AnimationPlayer *anim = Object::cast_to<AnimationPlayer>(n);
+	ERR_FAIL_COND(!anim);
+
+	List<StringName> anim_names;
+	anim->get_animation_list(&anim_names);
+	for (List<StringName>::Element *E = anim_names.front(); E; E = E->next()) {
+		Ref<Animation> a = anim->get_animation(E->get());
+		int usage = a->get_transform_tracks_memory_usage();
+		a->compress(p_max_lin_error, p_max_ang_error, Math::deg2rad(p_max_angle));
+		int compressed_usage = a->get_transform_tracks_memory_usage();
+		print_verbose(vformat("Compressed animation \"%s\": transform keys use %s instead of %s.", E->get(), String::humanize_size(compressed_usage), String::humanize_size(usage)));
+	}
+}
+
 static String _make_extname(const String &p_str) {
 	String ext_name = p_str.replace(".", "_");
 	ext_name = ext_name.replace(":", "_");
@@ -1134,6 +1154,7 @@ void ResourceImporterScene::get_import_options(List<ImportOption> *r_options, in
 	r_options->push_back(ImportOption(PropertyInfo(Variant::REAL, "animation/optimizer/max_angular_error"), 0.01));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::REAL, "animation/optimizer/max_angle"), 22));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "animation/optimizer/remove_unused_tracks"), true));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "animation/compression/enabled"), false));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "animation/clips/amount", PROPERTY_HINT_RANGE, "0,256,1", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED), 0));
 	for (int i = 0; i < 256; i++) {
 		r_options->push_back(ImportOption(PropertyInfo(Variant::STRING, "animation/clip_" + itos(i + 1) + "/name"), ""));
@@ -1366,6 +1387,10 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 		_filter_tracks(scene, animation_filter);
 	}
 
+	if (bool(p_options["animation/compression/enabled"])) {
+		_compress_animations(scene, anim_optimizer_linerr, anim_optimizer_angerr, anim_optimizer_maxang);
+	}
+
 	bool external_animations = int(p_options["animation/storage"]) == 1 || int(p_options["animation/storage"]) == 2;
 	bool external_animations_as_text = int(p_options["animation/storage"]) == 2;
 	bool keep_custom_tracks = p_options["animation/keep_custom_tracks"];
@@ -40,8 +40,10 @@
 #include "core/io/resource_loader.h"
 #include "core/message_queue.h"
 #include "core/os/dir_access.h"
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 #include "core/os/time.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/project_settings.h"
 #include "core/register_core_types.h"
 #include "core/script_debugger_local.h"
@@ -55,6 +57,7 @@
 #include "main/performance.h"
 #include "main/splash.gen.h"
 #include "main/tests/test_main.h"
+#include "modules/modules_enabled.gen.h" // For gdscript.
 #include "modules/register_module_types.h"
 #include "platform/register_platform_apis.h"
 #include "scene/debugger/script_debugger_remote.h"
@@ -72,6 +75,10 @@
 #include "servers/register_server_types.h"
 #include "servers/visual_server_callbacks.h"
 
+#ifdef MODULE_GDSCRIPT_ENABLED
+#include "modules/gdscript/gdscript.h"
+#endif
+
 #ifdef TOOLS_ENABLED
 #include "editor/doc/doc_data.h"
 #include "editor/doc/doc_data_class_path.gen.h"
@@ -97,6 +104,7 @@ static TranslationServer *translation_server = nullptr;
 static Performance *performance = nullptr;
 static PackedData *packed_data = nullptr;
 static Time *time_singleton = nullptr;
+static WorkerThreadPool *worker_thread_pool = nullptr;
 #ifdef MINIZIP_ENABLED
 static ZipArchive *zip_packed_data = nullptr;
 #endif
@@ -150,6 +158,7 @@ static bool force_lowdpi = false;
 // Debug
 
 static bool use_debug_profiler = false;
+static String gdscript_sampling_profile;
 #ifdef DEBUG_ENABLED
 static bool debug_collisions = false;
 static bool debug_navigation = false;
@@ -313,6 +322,8 @@ void Main::print_help(const char *p_binary) {
 	OS::get_singleton()->print("  -d, --debug                      Debug (local stdout debugger).\n");
 	OS::get_singleton()->print("  -b, --breakpoints                Breakpoint list as source::line comma-separated pairs, no spaces (use %%20 instead).\n");
 	OS::get_singleton()->print("  --profiling                      Enable profiling in the script debugger.\n");
+	OS::get_singleton()->print("  --gdscript-sampling-profile <file>\n");
+	OS::get_singleton()->print("                                   Sample GDScript call stacks and save them to <file> as collapsed stacks (for flame graphs) on exit.\n");
 	OS::get_singleton()->print("  --remote-debug <address>         Remote debug (<host/IP>:<port> address).\n");
 #if defined(DEBUG_ENABLED) && !defined(SERVER_ENABLED)
 	OS::get_singleton()->print("  --debug-collisions               Show collision shapes when running the scene.\n");
@@ -400,6 +411,7 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 	globals = memnew(ProjectSettings);
 	input_map = memnew(InputMap);
 	time_singleton = memnew(Time);
+	worker_thread_pool = memnew(WorkerThreadPool);
 
 	register_core_settings(); //here globals is present
 
@@ -849,6 +861,14 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 				OS::get_singleton()->print("Missing remote debug host address, aborting.\n");
 				goto error;
 			}
+		} else if (I->get() == "--gdscript-sampling-profile") {
+			if (I->next()) {
+				gdscript_sampling_profile = I->next()->get();
+				N = I->next()->next();
+			} else {
+				OS::get_singleton()->print("Missing GDScript sampling profile output file, aborting.\n");
+				goto error;
+			}
 		} else if (I->get() == "--allow_focus_steal_pid") { // not exposed to user
 			if (I->next()) {
 				allow_focus_steal_pid = I->next()->get().to_int64();
@@ -1256,6 +1276,10 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 
 	message_queue = memnew(MessageQueue);
 
+	GLOBAL_DEF("threading/worker_pool/max_threads", -1);
+	ProjectSettings::get_singleton()->set_custom_property_info("threading/worker_pool/max_threads", PropertyInfo(Variant::INT, "threading/worker_pool/max_threads", PROPERTY_HINT_RANGE, "-1,256,1"));
+	worker_thread_pool->init(GLOBAL_GET("threading/worker_pool/max_threads"));
+
 	if (p_second_phase) {
 		return setup2();
 	}
@@ -1285,6 +1309,9 @@ error:
 	if (time_singleton) {
 		memdelete(time_singleton);
 	}
+	if (worker_thread_pool) {
+		memdelete(worker_thread_pool);
+	}
 	if (translation_server) {
 		memdelete(translation_server);
 	}
@@ -1520,6 +1547,14 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 	register_platform_apis();
 	register_module_types();
 
+	if (gdscript_sampling_profile != String()) {
+#ifdef MODULE_GDSCRIPT_ENABLED
+		GDScriptLanguage::get_singleton()->start_sampling_profiler(gdscript_sampling_profile);
+#else
+		WARN_PRINT("The GDScript module is disabled, --gdscript-sampling-profile is ignored.");
+#endif
+	}
+
 	// Theme needs modules to be initialized so that sub-resources can be loaded.
 	initialize_theme();
 
@@ -2344,6 +2379,11 @@ bool Main::iteration() {
 		frames = 0;
 	}
 
+	if (iterating == 1) {
+		FrameArena::end_frame();
+		MessageQueue::get_singleton()->end_frame();
+	}
+
 	iterating--;
 
 	// Needed for OSs using input buffering regardless accumulation (like Android)
@@ -2420,6 +2460,9 @@ void Main::cleanup(bool p_force) {
 	ResourceLoader::clear_translation_remaps();
 	ResourceLoader::clear_path_remaps();
 
+	// Worker threads may run script code, stop them before the languages go away.
+	worker_thread_pool->finish();
+
 	ScriptServer::finish_languages();
 
 	// Sync pending commands that may have been queued from a different thread during ScriptServer finalization
@@ -2470,6 +2513,9 @@ void Main::cleanup(bool p_force) {
 	if (time_singleton) {
 		memdelete(time_singleton);
 	}
+	if (worker_thread_pool) {
+		memdelete(worker_thread_pool);
+	}
 	if (translation_server) {
 		memdelete(translation_server);
 	}
@@ -2497,6 +2543,8 @@ void Main::cleanup(bool p_force) {
 		memdelete(visual_server_callbacks);
 	}
 
+	FrameArena::cleanup();
+
 	unregister_core_driver_types();
 	unregister_core_types();
 
@@ -31,7 +31,9 @@
 #include "performance.h"
 
 #include "core/message_queue.h"
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
+#include "core/os/size_class_allocator.h"
 #include "scene/main/node.h"
 #include "scene/main/scene_tree.h"
 #include "servers/audio_server.h"
@@ -43,6 +45,7 @@ Performance *Performance::singleton = nullptr;
 
 void Performance::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_monitor", "monitor"), &Performance::get_monitor);
+	ClassDB::bind_method(D_METHOD("get_allocator_size_classes"), &Performance::get_allocator_size_classes);
 
 	BIND_ENUM_CONSTANT(TIME_FPS);
 	BIND_ENUM_CONSTANT(TIME_PROCESS);
@@ -75,6 +78,15 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(MEMORY_ALLOCATOR_USED);
+	BIND_ENUM_CONSTANT(MEMORY_ALLOCATOR_RESERVED);
+	BIND_ENUM_CONSTANT(MEMORY_FRAME_ARENA);
+	BIND_ENUM_CONSTANT(MEMORY_FRAME_ARENA_FALLBACK);
+	BIND_ENUM_CONSTANT(MESSAGE_QUEUE_MESSAGES_IN_FRAME);
+	BIND_ENUM_CONSTANT(MESSAGE_QUEUE_BYTES_IN_FRAME);
+	BIND_ENUM_CONSTANT(RENDER_OCCLUSION_CULLED_IN_FRAME);
+	BIND_ENUM_CONSTANT(RENDER_SHADOW_CASTER_CACHE_HITS_IN_FRAME);
+	BIND_ENUM_CONSTANT(RENDER_SHADOW_CASTER_CACHE_MISSES_IN_FRAME);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -123,6 +135,15 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/output_latency",
+		"memory/allocator_used",
+		"memory/allocator_reserved",
+		"memory/frame_arena",
+		"memory/frame_arena_fallback",
+		"object/message_queue_messages",
+		"memory/message_queue_bytes",
+		"raster/occlusion_culled",
+		"raster/shadow_caster_cache_hits",
+		"raster/shadow_caster_cache_misses",
 
 	};
 
@@ -193,6 +214,24 @@ float Performance::get_monitor(Monitor p_monitor) const {
 			return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY:
 			return AudioServer::get_singleton()->get_output_latency();
+		case MEMORY_ALLOCATOR_USED:
+			return SizeClassAllocator::get_used_bytes();
+		case MEMORY_ALLOCATOR_RESERVED:
+			return SizeClassAllocator::get_reserved_bytes();
+		case MEMORY_FRAME_ARENA:
+			return FrameArena::get_last_frame_arena_bytes();
+		case MEMORY_FRAME_ARENA_FALLBACK:
+			return FrameArena::get_last_frame_fallback_bytes();
+		case MESSAGE_QUEUE_MESSAGES_IN_FRAME:
+			return MessageQueue::get_singleton()->get_last_frame_message_count();
+		case MESSAGE_QUEUE_BYTES_IN_FRAME:
+			return MessageQueue::get_singleton()->get_last_frame_bytes();
+		case RENDER_OCCLUSION_CULLED_IN_FRAME:
+			return VS::get_singleton()->get_render_info(VS::INFO_OCCLUSION_CULLED_IN_FRAME);
+		case RENDER_SHADOW_CASTER_CACHE_HITS_IN_FRAME:
+			return VS::get_singleton()->get_render_info(VS::INFO_SHADOW_CASTER_CACHE_HITS_IN_FRAME);
+		case RENDER_SHADOW_CASTER_CACHE_MISSES_IN_FRAME:
+			return VS::get_singleton()->get_render_info(VS::INFO_SHADOW_CASTER_CACHE_MISSES_IN_FRAME);
 
 		default: {
 		}
@@ -237,12 +276,36 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
 	return types[p_monitor];
 }
 
+Array Performance::get_allocator_size_classes() const {
+	Array classes;
+	for (int i = 0; i < SizeClassAllocator::SIZE_CLASS_COUNT; i++) {
+		SizeClassAllocator::Stats stats;
+		SizeClassAllocator::get_stats(i, stats);
+
+		Dictionary d;
+		d["block_size"] = stats.block_size;
+		d["used_blocks"] = stats.used_blocks;
+		d["reserved_blocks"] = stats.reserved_blocks;
+		classes.push_back(d);
+	}
+	return classes;
+}
+
 void Performance::set_process_time(float p_pt) {
 	_process_time = p_pt;
 }
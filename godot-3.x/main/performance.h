@@ -82,6 +82,15 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		MEMORY_ALLOCATOR_USED,
+		MEMORY_ALLOCATOR_RESERVED,
+		MEMORY_FRAME_ARENA,
+		MEMORY_FRAME_ARENA_FALLBACK,
+		MESSAGE_QUEUE_MESSAGES_IN_FRAME,
+		MESSAGE_QUEUE_BYTES_IN_FRAME,
+		RENDER_OCCLUSION_CULLED_IN_FRAME,
+		RENDER_SHADOW_CASTER_CACHE_HITS_IN_FRAME,
+		RENDER_SHADOW_CASTER_CACHE_MISSES_IN_FRAME,
 		MONITOR_MAX
 	};
 
@@ -96,6 +105,8 @@ public:
 
 	MonitorType get_monitor_type(Monitor p_monitor) const;
 
+	Array get_allocator_size_classes() const;
+
 	void set_process_time(float p_pt);
 	void set_physics_process_time(float p_pt);
 
@@ -0,0 +1,313 @@
+/*************************************************************************/
+/*  test_animation.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_animation.h"
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "scene/resources/animation.h"
+
+namespace TestAnimation {
+
+// One transform track per bone, with a key every p_key_step seconds.
+Ref<Animation> create_animation(int p_bones, float p_length, float p_key_step, Animation::InterpolationType p_interp = Animation::INTERPOLATION_LINEAR) {
+	Ref<Animation> animation;
+	animation.instance();
+	animation->set_length(p_length);
+	animation->set_loop(true);
+
+	RandomPCG rng(13);
+	for (int i = 0; i < p_bones; i++) {
+		int track = animation->add_track(Animation::TYPE_TRANSFORM);
+		animation->track_set_path(track, NodePath("Skeleton:bone_" + itos(i)));
+		animation->track_set_interpolation_type(track, p_interp);
+		for (float t = 0; t < p_length; t += p_key_step) {
+			Vector3 loc(rng.randf() * 2 - 1, rng.randf() * 2 - 1, rng.randf() * 2 - 1);
+			Quat rot(Vector3(rng.randf() - 0.5, rng.randf() - 0.5, rng.randf() - 0.5).normalized(), rng.randf() * Math_PI);
+			Vector3 scale(1 + rng.randf() * 0.1, 1, 1);
+			animation->transform_track_insert_key(track, t, loc, rot, scale);
+		}
+	}
+	return animation;
+}
+
+static bool _test_key_times(bool p_bake) {
+	Ref<Animation> animation = create_animation(4, 2.0, 0.25);
+	animation->set_loop(false);
+	animation->set_bake_transform_tracks(p_bake);
+	int usage = animation->get_transform_tracks_memory_usage();
+
+	bool ok = true;
+	for (int i = 0; ok && i < animation->get_track_count(); i++) {
+		for (int k = 0; ok && k < animation->track_get_key_count(i); k++) {
+			Vector3 key_loc;
+			Quat key_rot;
+			Vector3 key_scale;
+			animation->transform_track_get_key(i, k, &key_loc, &key_rot, &key_scale);
+
+			Vector3 loc;
+			Quat rot;
+			Vector3 scale;
+			Error err = animation->transform_track_interpolate(i, animation->track_get_key_time(i, k), &loc, &rot, &scale);
+			ok = err == OK && loc == key_loc && rot == key_rot && scale == key_scale;
+		}
+	}
+
+	// Halfway between two keys, linear interpolation.
+	Vector3 loc_a;
+	Vector3 loc_b;
+	animation->transform_track_get_key(0, 2, &loc_a, nullptr, nullptr);
+	animation->transform_track_get_key(0, 3, &loc_b, nullptr, nullptr);
+	Vector3 loc;
+	animation->transform_track_interpolate(0, 0.625, &loc, nullptr, nullptr);
+	ok = ok && loc.is_equal_approx(loc_a.linear_interpolate(loc_b, 0.5));
+
+	// Only baking keeps a second copy of the keys.
+	int sampled_usage = animation->get_transform_tracks_memory_usage();
+	ok = ok && (p_bake ? sampled_usage > usage : sampled_usage == usage);
+
+	// Edits must be picked up by the next sample.
+	animation->transform_track_insert_key(0, 0.5, Vector3(5, 5, 5));
+	animation->transform_track_interpolate(0, 0.5, &loc, nullptr, nullptr);
+	ok = ok && loc == Vector3(5, 5, 5);
+
+	// Turning baking off releases the copy. The key above replaced the one at 0.5.
+	animation->set_bake_transform_tracks(false);
+	ok = ok && animation->get_transform_tracks_memory_usage() == usage;
+
+	return ok;
+}
+
+bool test_key_times() {
+	return _test_key_times(false) && _test_key_times(true);
+}
+
+bool test_key_cursor() {
+	bool ok = true;
+	const Animation::InterpolationType interps[3] = { Animation::INTERPOLATION_NEAREST, Animation::INTERPOLATION_LINEAR, Animation::INTERPOLATION_CUBIC };
+	for (int l = 0; l < 2; l++) {
+		for (int m = 0; ok && m < 3; m++) {
+			Ref<Animation> animation = create_animation(8, 2.0, 0.1, interps[m]);
+			animation->set_loop(l == 1);
+			animation->set_bake_transform_tracks(true);
+
+			// Forward, then a seek backwards, with steps both shorter and longer than the keys.
+			const float steps[4] = { 1.0 / 60.0, 0.1, 0.37, -0.23 };
+			for (int i = 0; ok && i < animation->get_track_count(); i++) {
+				int cursor = -1;
+				float time = 0;
+				for (int s = 0; ok && s < 200; s++) {
+					time = Math::fposmod(time + steps[s % 4], 2.0f);
+
+					Vector3 loc[2];
+					Quat rot[2];
+					Vector3 scale[2];
+					Error err = animation->transform_track_interpolate(i, time, &loc[0], &rot[0], &scale[0], &cursor);
+					Error err_search = animation->transform_track_interpolate(i, time, &loc[1], &rot[1], &scale[1]);
+					ok = err == err_search && loc[0] == loc[1] && rot[0] == rot[1] && scale[0] == scale[1];
+				}
+			}
+		}
+	}
+	return ok;
+}
+
+bool test_quantized() {
+	Ref<Animation> animation = create_animation(16, 2.0, 0.1, Animation::INTERPOLATION_LINEAR);
+
+	const int samples = 100;
+	Vector<Vector3> locs;
+	Vector<Quat> rots;
+	for (int i = 0; i < animation->get_track_count(); i++) {
+		for (int s = 0; s < samples; s++) {
+			Vector3 loc;
+			Quat rot;
+			animation->transform_track_interpolate(i, s * 2.0 / samples, &loc, &rot, nullptr);
+			locs.push_back(loc);
+			rots.push_back(rot);
+		}
+	}
+
+	animation->set_quantize_transform_tracks(true);
+
+	// Locations are in [-1, 1], so 16 bits give an error well below 0.001.
+	bool ok = true;
+	float max_loc_error = 0;
+	float max_rot_error = 0;
+	for (int i = 0; i < animation->get_track_count(); i++) {
+		for (int s = 0; s < samples; s++) {
+			Vector3 loc;
+			Quat rot;
+			animation->transform_track_interpolate(i, s * 2.0 / samples, &loc, &rot, nullptr);
+			int idx = i * samples + s;
+			max_loc_error = MAX(max_loc_error, loc.distance_to(locs[idx]));
+			max_rot_error = MAX(max_rot_error, 1.0f - ABS(rot.dot(rots[idx])));
+			ok = ok && rot.is_normalized();
+		}
+	}
+	OS::get_singleton()->print("\tquantized: max location error %f, max rotation error %g\n", max_loc_error, max_rot_error);
+	return ok && max_loc_error < 0.001 && max_rot_error < 0.0001;
+}
+
+bool test_compressed() {
+	Ref<Animation> animation = create_animation(16, 2.0, 1.0 / 30.0);
+	Ref<Animation> reference = animation->duplicate();
+
+	int usage = animation->get_transform_tracks_memory_usage();
+	animation->compress();
+	int compressed_usage = animation->get_transform_tracks_memory_usage();
+	OS::get_singleton()->print("\tcompressed: %d bytes of keys instead of %d\n", compressed_usage, usage);
+	bool ok = compressed_usage * 2 <= usage;
+
+	// Saving and loading keeps the compressed keys as they are.
+	Ref<Animation> loaded;
+	loaded.instance();
+	loaded->set_length(animation->get_length());
+	loaded->set_loop(animation->has_loop());
+	for (int i = 0; i < animation->get_track_count(); i++) {
+		loaded->add_track(Animation::TYPE_TRANSFORM);
+		String base = "tracks/" + itos(i) + "/keys";
+		Variant keys = animation->get(base);
+		ok = ok && keys.get_type() == Variant::DICTIONARY;
+		loaded->set(base, keys);
+	}
+
+	for (int i = 0; ok && i < animation->get_track_count(); i++) {
+		ok = loaded->track_get_key_count(i) == animation->track_get_key_count(i);
+		for (int s = 0; ok && s < 60; s++) {
+			float time = s / 30.0;
+			Vector3 loc[3];
+			Quat rot[3];
+			Vector3 scale[3];
+			animation->transform_track_interpolate(i, time, &loc[0], &rot[0], &scale[0]);
+			loaded->transform_track_interpolate(i, time, &loc[1], &rot[1], &scale[1]);
+			reference->transform_track_interpolate(i, time, &loc[2], &rot[2], &scale[2]);
+			ok = loc[0] == loc[1] && rot[0] == rot[1] && scale[0] == scale[1];
+			ok = ok && loc[0].distance_to(loc[2]) < 0.001 && 1.0f - ABS(rot[0].dot(rot[2])) < 0.0001;
+		}
+	}
+
+	// Key ranges are found on the compressed times.
+	for (int i = 0; ok && i < animation->get_track_count(); i++) {
+		List<int> indices;
+		animation->track_get_key_indices_in_range(i, 0.99, 0.48, &indices);
+		int expected = 0;
+		for (int k = 0; k < animation->track_get_key_count(i); k++) {
+			float time = animation->track_get_key_time(i, k);
+			expected += time >= 0.51 && time < 0.99;
+		}
+		ok = indices.size() == expected && indices.size() > 0;
+		for (List<int>::Element *E = indices.front(); ok && E; E = E->next()) {
+			float time = animation->track_get_key_time(i, E->get());
+			ok = time >= 0.51 && time < 0.99;
+		}
+	}
+
+	// Editing decompresses the track.
+	animation->transform_track_insert_key(0, 0.5, Vector3(5, 5, 5));
+	Vector3 loc;
+	animation->transform_track_interpolate(0, 0.5, &loc, nullptr, nullptr);
+	ok = ok && loc == Vector3(5, 5, 5) && animation->get_transform_tracks_memory_usage() > compressed_usage;
+
+	return ok;
+}
+
+bool test_sampling_benchmark() {
+	const int bones = 64;
+	const int characters = 100;
+	const int frames = 120;
+	Ref<Animation> animation = create_animation(bones, 4.0, 1.0 / 30.0);
+
+	Vector<int> cursors;
+	cursors.resize(bones * characters);
+
+	bool ok = true;
+	for (int mode = 0; mode < 4; mode++) {
+		animation->set_bake_transform_tracks(mode > 0);
+		animation->set_quantize_transform_tracks(mode == 3);
+		for (int i = 0; i < cursors.size(); i++) {
+			cursors.write[i] = -1;
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int f = 0; f < frames; f++) {
+			for (int c = 0; c < characters; c++) {
+				// Each character plays the animation with its own offset.
+				float time = Math::fmod(f / 60.0f + c * 0.037f, 4.0f);
+				for (int b = 0; b < bones; b++) {
+					Vector3 loc;
+					Quat rot;
+					Vector3 scale;
+					int *cursor = mode < 2 ? nullptr : &cursors.write[c * bones + b];
+					ok = ok && animation->transform_track_interpolate(b, time, &loc, &rot, &scale, cursor) == OK;
+				}
+			}
+		}
+		uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+		static const char *mode_names[4] = { "keys", "baked, key search", "baked, key cursor", "baked, key cursor, quantized" };
+		OS::get_singleton()->print("\t%s: %d samples in %.2f msec: %.1f samples/msec\n", mode_names[mode], bones * characters * frames, elapsed / 1000.0, double(bones) * characters * frames * 1000.0 / elapsed);
+	}
+	return ok;
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+	test_key_times,
+	test_key_cursor,
+	test_quantized,
+	test_compressed,
+	test_sampling_benchmark,
+	nullptr
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+	OS::get_singleton()->print("\n");
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+	return nullptr;
+}
+
+} // namespace TestAnimation
@@ -375,6 +375,47 @@ bool test_solutions() {
 	return true;
 }
 
+bool test_grid_benchmark() {
+	const int size = 512;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	AStar2D a;
+	a.reserve_space(size * size);
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			int id = y * size + x;
+			a.add_point(id, Vector2(x, y));
+			if (x > 0) {
+				a.connect_points(id, id - 1);
+			}
+			if (y > 0) {
+				a.connect_points(id, id - size);
+			}
+		}
+	}
+	uint64_t build = OS::get_singleton()->get_ticks_usec() - begin;
+
+	// On an open 4-connected grid, the shortest path walks every row and column once.
+	begin = OS::get_singleton()->get_ticks_usec();
+	PoolVector<int> path = a.get_id_path(0, size * size - 1);
+	uint64_t open_grid = OS::get_singleton()->get_ticks_usec() - begin;
+	bool ok = path.size() == size * 2 - 1;
+
+	// Walls with a single gap at alternating ends make the path snake through the whole grid.
+	for (int y = 2; y < size; y += 4) {
+		for (int x = 0; x < size - 1; x++) {
+			a.set_point_disabled(y * size + ((y / 4) % 2 == 0 ? x : x + 1));
+		}
+	}
+	begin = OS::get_singleton()->get_ticks_usec();
+	path = a.get_id_path(0, size * size - 1);
+	uint64_t maze = OS::get_singleton()->get_ticks_usec() - begin;
+	ok = ok && path.size() > size * size / 8;
+
+	OS::get_singleton()->print("\t%dx%d grid: build %.2f msec, open path %.2f msec, maze path %.2f msec\n", size, size, build / 1000.0, open_grid / 1000.0, maze / 1000.0);
+	return ok;
+}
+
 typedef bool (*TestFunc)();
 
 TestFunc test_funcs[] = {
@@ -382,6 +423,7 @@ TestFunc test_funcs[] = {
 	test_abcx,
 	test_add_remove,
 	test_solutions,
+	test_grid_benchmark,
 	nullptr
 };
 
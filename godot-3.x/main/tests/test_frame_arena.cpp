@@ -0,0 +1,277 @@
+/*************************************************************************/
+/*  test_frame_arena.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_frame_arena.h"
+
+#include "core/os/frame_arena.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+
+namespace TestFrameArena {
+
+enum {
+	// Larger than the first chunk, so that a second one is needed for two of them.
+	BIG_BLOCK_SIZE = 200 * 1024,
+	// Block header and alignment added to a 16 byte block.
+	SMALL_BLOCK_STRIDE = 32,
+};
+
+static void _fill(void *p_ptr, size_t p_bytes, uint8_t p_value) {
+	memset(p_ptr, p_value, p_bytes);
+}
+
+static bool _check(const void *p_ptr, size_t p_bytes, uint8_t p_value) {
+	const uint8_t *bytes = (const uint8_t *)p_ptr;
+	for (size_t i = 0; i < p_bytes; i++) {
+		if (bytes[i] != p_value) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool test_lifo_free() {
+	OS::get_singleton()->print("\n\nTest 1: Blocks freed in reverse order are reused\n");
+
+	void *a = FrameArena::alloc(16);
+	void *b = FrameArena::alloc(16);
+	bool ok = (uint8_t *)b == (uint8_t *)a + SMALL_BLOCK_STRIDE;
+
+	FrameArena::free(b);
+	void *c = FrameArena::alloc(16);
+	ok = ok && c == b;
+
+	// A block freed out of order stays taken until the arena is empty.
+	void *d = FrameArena::alloc(16);
+	FrameArena::free(c);
+	void *e = FrameArena::alloc(16);
+	ok = ok && (uint8_t *)e == (uint8_t *)d + SMALL_BLOCK_STRIDE;
+
+	FrameArena::free(e);
+	FrameArena::free(d);
+	FrameArena::free(a);
+	return ok;
+}
+
+bool test_realloc() {
+	OS::get_singleton()->print("\n\nTest 2: The last block is resized in place\n");
+
+	void *a = FrameArena::alloc(64);
+	_fill(a, 64, 1);
+	void *b = FrameArena::alloc(64);
+	_fill(b, 64, 2);
+
+	// Growing and shrinking the last block keeps it where it is.
+	void *grown = FrameArena::realloc(b, 4096);
+	bool ok = grown == b && _check(grown, 64, 2);
+	void *shrunk = FrameArena::realloc(grown, 16);
+	ok = ok && shrunk == b && _check(shrunk, 16, 2);
+	void *c = FrameArena::alloc(16);
+	ok = ok && (uint8_t *)c == (uint8_t *)b + SMALL_BLOCK_STRIDE;
+
+	// Any other block moves to the end, with its contents.
+	void *moved = FrameArena::realloc(a, 128);
+	ok = ok && moved != a && (uint8_t *)moved == (uint8_t *)c + SMALL_BLOCK_STRIDE && _check(moved, 64, 1);
+
+	FrameArena::free(moved);
+	FrameArena::free(c);
+	FrameArena::free(shrunk);
+	return ok;
+}
+
+bool test_reset() {
+	OS::get_singleton()->print("\n\nTest 3: The arena starts over once every block is freed\n");
+
+	void *first = FrameArena::alloc(16);
+	FrameArena::free(first);
+
+	void *a = FrameArena::alloc(16);
+	void *b = FrameArena::alloc(16);
+	void *c = FrameArena::alloc(16);
+	bool ok = a == first;
+
+	// Out of order, so only the last free empties the arena.
+	FrameArena::free(a);
+	FrameArena::free(c);
+	FrameArena::free(b);
+	void *d = FrameArena::alloc(16);
+	ok = ok && d == first;
+
+	FrameArena::free(d);
+	return ok;
+}
+
+bool test_chunk_merge() {
+	OS::get_singleton()->print("\n\nTest 4: Chunks added during a frame are merged at the end of it\n");
+
+	// Start from a single chunk of the minimum size.
+	FrameArena::end_frame();
+	FrameArena::cleanup();
+
+	void *blocks[3];
+	for (int i = 0; i < 3; i++) {
+		blocks[i] = FrameArena::alloc(BIG_BLOCK_SIZE);
+	}
+	// The first block fills the first chunk, the others go to a new one.
+	size_t stride = BIG_BLOCK_SIZE + 16;
+	bool ok = (uint8_t *)blocks[1] != (uint8_t *)blocks[0] + stride && (uint8_t *)blocks[2] == (uint8_t *)blocks[1] + stride;
+	for (int i = 2; i >= 0; i--) {
+		FrameArena::free(blocks[i]);
+	}
+
+	FrameArena::end_frame();
+	ok = ok && FrameArena::get_last_frame_arena_bytes() == 3 * BIG_BLOCK_SIZE && FrameArena::get_last_frame_fallback_bytes() == 0;
+
+	// The next frame fits in a single chunk.
+	for (int i = 0; i < 3; i++) {
+		blocks[i] = FrameArena::alloc(BIG_BLOCK_SIZE);
+	}
+	ok = ok && (uint8_t *)blocks[1] == (uint8_t *)blocks[0] + stride && (uint8_t *)blocks[2] == (uint8_t *)blocks[1] + stride;
+	for (int i = 2; i >= 0; i--) {
+		FrameArena::free(blocks[i]);
+	}
+
+	FrameArena::end_frame();
+	return ok;
+}
+
+struct ThreadData {
+	void *arena_block = nullptr;
+	bool contents_kept = false;
+};
+
+static void _alloc_on_thread(void *p_userdata) {
+	ThreadData *data = (ThreadData *)p_userdata;
+
+	void *mem = FrameArena::alloc(1000);
+	_fill(mem, 1000, 3);
+	mem = FrameArena::realloc(mem, 2000);
+	data->contents_kept = _check(mem, 1000, 3);
+	FrameArena::free(mem);
+
+	// Blocks from the arena may be passed to other threads too, they just can't be resized or freed there.
+	_fill(data->arena_block, 16, 4);
+}
+
+bool test_thread_fallback() {
+	OS::get_singleton()->print("\n\nTest 5: Other threads get heap memory\n");
+
+	FrameArena::end_frame();
+
+	ThreadData data;
+	data.arena_block = FrameArena::alloc(16);
+
+	Thread thread;
+	thread.start(_alloc_on_thread, &data);
+	thread.wait_to_finish();
+
+	bool ok = data.contents_kept && _check(data.arena_block, 16, 4);
+
+	// The thread left the arena alone.
+	void *next = FrameArena::alloc(16);
+	ok = ok && (uint8_t *)next == (uint8_t *)data.arena_block + SMALL_BLOCK_STRIDE;
+	FrameArena::free(next);
+	FrameArena::free(data.arena_block);
+
+	FrameArena::end_frame();
+	ok = ok && FrameArena::get_last_frame_fallback_bytes() == 3000 && FrameArena::get_last_frame_arena_bytes() == 32;
+
+	return ok;
+}
+
+bool test_outlive_frame() {
+	OS::get_singleton()->print("\n\nTest 6: Blocks that outlive the frame stay valid\n");
+
+	FrameArena::end_frame();
+	FrameArena::cleanup();
+
+	// The second block doesn't fit in the first chunk, so it adds another one.
+	void *kept = FrameArena::alloc(BIG_BLOCK_SIZE);
+	_fill(kept, BIG_BLOCK_SIZE, 5);
+	void *other = FrameArena::alloc(BIG_BLOCK_SIZE * 8);
+	FrameArena::free(other);
+
+	// Warns about the block still in use, and neither resets nor merges the chunks under it.
+	FrameArena::end_frame();
+	bool ok = _check(kept, BIG_BLOCK_SIZE, 5);
+
+	void *next = FrameArena::alloc(16);
+	_fill(next, 16, 6);
+	ok = ok && next == other && _check(kept, BIG_BLOCK_SIZE, 5);
+
+	FrameArena::free(next);
+	FrameArena::free(kept);
+
+	// Once freed, the chunks are merged as usual.
+	FrameArena::end_frame();
+	void *a = FrameArena::alloc(BIG_BLOCK_SIZE);
+	void *b = FrameArena::alloc(BIG_BLOCK_SIZE * 8);
+	ok = ok && (uint8_t *)b == (uint8_t *)a + BIG_BLOCK_SIZE + 16;
+	FrameArena::free(b);
+	FrameArena::free(a);
+
+	FrameArena::end_frame();
+	return ok;
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+	test_lifo_free,
+	test_realloc,
+	test_reset,
+	test_chunk_merge,
+	test_thread_fallback,
+	test_outlive_frame,
+	nullptr
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+	OS::get_singleton()->print("\n");
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+	return nullptr;
+}
+
+} // namespace TestFrameArena
@@ -460,430 +460,336 @@ static void _parser_show_class(const GDScriptParser::ClassNode *p_class, int p_i
 	print_line("\n");
 }
 
-static String _disassemble_addr(const Ref<GDScript> &p_script, const GDScriptFunction &func, int p_addr) {
-	int addr = p_addr & GDScriptFunction::ADDR_MASK;
-
-	switch (p_addr >> GDScriptFunction::ADDR_BITS) {
-		case GDScriptFunction::ADDR_TYPE_SELF: {
-			return "self";
-		} break;
-		case GDScriptFunction::ADDR_TYPE_CLASS: {
-			return "class";
-		} break;
-		case GDScriptFunction::ADDR_TYPE_MEMBER: {
-			return "member(" + p_script->debug_get_member_by_index(addr) + ")";
-		} break;
-		case GDScriptFunction::ADDR_TYPE_CLASS_CONSTANT: {
-			return "class_const(" + func.get_global_name(addr) + ")";
-		} break;
-		case GDScriptFunction::ADDR_TYPE_LOCAL_CONSTANT: {
-			Variant v = func.get_constant(addr);
-			String txt;
-			if (v.get_type() == Variant::STRING || v.get_type() == Variant::NODE_PATH) {
-				txt = "\"" + String(v) + "\"";
-			} else {
-				txt = v;
-			}
-			return "const(" + txt + ")";
-		} break;
-		case GDScriptFunction::ADDR_TYPE_STACK: {
-			return "stack(" + itos(addr) + ")";
-		} break;
-		case GDScriptFunction::ADDR_TYPE_STACK_VARIABLE: {
-			return "var_stack(" + itos(addr) + ")";
-		} break;
-		case GDScriptFunction::ADDR_TYPE_GLOBAL: {
-			return "global(" + func.get_global_name(addr) + ")";
-		} break;
-		case GDScriptFunction::ADDR_TYPE_NIL: {
-			return "nil";
-		} break;
-	}
-
-	return "<err>";
-}
-
 static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String> &p_code) {
 	const Map<StringName, GDScriptFunction *> &mf = p_class->debug_get_member_functions();
 
 	for (const Map<StringName, GDScriptFunction *>::Element *E = mf.front(); E; E = E->next()) {
-		const GDScriptFunction &func = *E->get();
-		const int *code = func.get_code();
-		int codelen = func.get_code_size();
-		String defargs;
-		if (func.get_default_argument_count()) {
-			defargs = "defarg at: ";
-			for (int i = 0; i < func.get_default_argument_count(); i++) {
-				if (i > 0) {
-					defargs += ",";
-				}
-				defargs += itos(func.get_default_argument_addr(i));
-			}
-			defargs += " ";
-		}
-		print_line("== function " + String(func.get_name()) + "() :: stack size: " + itos(func.get_max_stack_size()) + " " + defargs + "==");
-
-#define DADDR(m_ip) (_disassemble_addr(p_class, func, code[ip + m_ip]))
-
-		for (int ip = 0; ip < codelen;) {
-			int incr = 0;
-			String txt = itos(ip) + " ";
-
-			switch (code[ip]) {
-				case GDScriptFunction::OPCODE_OPERATOR: {
-					int op = code[ip + 1];
-					txt += " op ";
-
-					String opname = Variant::get_operator_name(Variant::Operator(op));
-
-					txt += DADDR(4);
-					txt += " = ";
-					txt += DADDR(2);
-					txt += " " + opname + " ";
-					txt += DADDR(3);
-					incr += 5;
-
-				} break;
-				case GDScriptFunction::OPCODE_SET: {
-					txt += "set ";
-					txt += DADDR(1);
-					txt += "[";
-					txt += DADDR(2);
-					txt += "]=";
-					txt += DADDR(3);
-					incr += 4;
-
-				} break;
-				case GDScriptFunction::OPCODE_GET: {
-					txt += " get ";
-					txt += DADDR(3);
-					txt += "=";
-					txt += DADDR(1);
-					txt += "[";
-					txt += DADDR(2);
-					txt += "]";
-					incr += 4;
-
-				} break;
-				case GDScriptFunction::OPCODE_SET_NAMED: {
-					txt += " set_named ";
-					txt += DADDR(1);
-					txt += "[\"";
-					txt += func.get_global_name(code[ip + 2]);
-					txt += "\"]=";
-					txt += DADDR(3);
-					incr += 4;
-
-				} break;
-				case GDScriptFunction::OPCODE_GET_NAMED: {
-					txt += " get_named ";
-					txt += DADDR(3);
-					txt += "=";
-					txt += DADDR(1);
-					txt += "[\"";
-					txt += func.get_global_name(code[ip + 2]);
-					txt += "\"]";
-					incr += 4;
-
-				} break;
-				case GDScriptFunction::OPCODE_SET_MEMBER: {
-					txt += " set_member ";
-					txt += "[\"";
-					txt += func.get_global_name(code[ip + 1]);
-					txt += "\"]=";
-					txt += DADDR(2);
-					incr += 3;
-
-				} break;
-				case GDScriptFunction::OPCODE_GET_MEMBER: {
-					txt += " get_member ";
-					txt += DADDR(2);
-					txt += "=";
-					txt += "[\"";
-					txt += func.get_global_name(code[ip + 1]);
-					txt += "\"]";
-					incr += 3;
-
-				} break;
-				case GDScriptFunction::OPCODE_ASSIGN: {
-					txt += " assign ";
-					txt += DADDR(1);
-					txt += "=";
-					txt += DADDR(2);
-					incr += 3;
-
-				} break;
-				case GDScriptFunction::OPCODE_ASSIGN_TRUE: {
-					txt += " assign ";
-					txt += DADDR(1);
-					txt += "= true";
-					incr += 2;
-
-				} break;
-				case GDScriptFunction::OPCODE_ASSIGN_FALSE: {
-					txt += " assign ";
-					txt += DADDR(1);
-					txt += "= false";
-					incr += 2;
-
-				} break;
-				case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN: {
-					txt += " assign typed builtin (";
-					txt += Variant::get_type_name((Variant::Type)code[ip + 1]);
-					txt += ") ";
-					txt += DADDR(2);
-					txt += " = ";
-					txt += DADDR(3);
-					incr += 4;
-
-				} break;
-				case GDScriptFunction::OPCODE_ASSIGN_TYPED_NATIVE: {
-					Variant className = func.get_constant(code[ip + 1]);
-					GDScriptNativeClass *nc = Object::cast_to<GDScriptNativeClass>(className.operator Object *());
-
-					txt += " assign typed native (";
-					txt += nc->get_name().operator String();
-					txt += ") ";
-					txt += DADDR(2);
-					txt += " = ";
-					txt += DADDR(3);
-					incr += 4;
-
-				} break;
-				case GDScriptFunction::OPCODE_CAST_TO_SCRIPT: {
-					txt += " cast ";
-					txt += DADDR(3);
-					txt += "=";
-					txt += DADDR(1);
-					txt += " as ";
-					txt += DADDR(2);
-					incr += 4;
-
-				} break;
-				case GDScriptFunction::OPCODE_CONSTRUCT: {
-					Variant::Type t = Variant::Type(code[ip + 1]);
-					int argc = code[ip + 2];
-
-					txt += " construct ";
-					txt += DADDR(3 + argc);
-					txt += " = ";
-
-					txt += Variant::get_type_name(t) + "(";
-					for (int i = 0; i < argc; i++) {
-						if (i > 0) {
-							txt += ", ";
-						}
-						txt += DADDR(i + 3);
-					}
-					txt += ")";
-
-					incr = 4 + argc;
-
-				} break;
-				case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY: {
-					int argc = code[ip + 1];
-					txt += " make_array ";
-					txt += DADDR(2 + argc);
-					txt += " = [ ";
-
-					for (int i = 0; i < argc; i++) {
-						if (i > 0) {
-							txt += ", ";
-						}
-						txt += DADDR(2 + i);
-					}
-
-					txt += "]";
-
-					incr += 3 + argc;
-
-				} break;
-				case GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY: {
-					int argc = code[ip + 1];
-					txt += " make_dict ";
-					txt += DADDR(2 + argc * 2);
-					txt += " = { ";
-
-					for (int i = 0; i < argc; i++) {
-						if (i > 0) {
-							txt += ", ";
-						}
-						txt += DADDR(2 + i * 2 + 0);
-						txt += ":";
-						txt += DADDR(2 + i * 2 + 1);
-					}
-
-					txt += "}";
-
-					incr += 3 + argc * 2;
-
-				} break;
-
-				case GDScriptFunction::OPCODE_CALL:
-				case GDScriptFunction::OPCODE_CALL_RETURN: {
-					bool ret = code[ip] == GDScriptFunction::OPCODE_CALL_RETURN;
-
-					if (ret) {
-						txt += " call-ret ";
-					} else {
-						txt += " call ";
-					}
-
-					int argc = code[ip + 1];
-					if (ret) {
-						txt += DADDR(4 + argc) + "=";
-					}
-
-					txt += DADDR(2) + ".";
-					txt += String(func.get_global_name(code[ip + 3]));
-					txt += "(";
-
-					for (int i = 0; i < argc; i++) {
-						if (i > 0) {
-							txt += ", ";
-						}
-						txt += DADDR(4 + i);
-					}
-					txt += ")";
-
-					incr = 5 + argc;
+		print_line(E->get()->disassemble(p_code));
+	}
+}
 
-				} break;
-				case GDScriptFunction::OPCODE_CALL_BUILT_IN: {
-					txt += " call-built-in ";
+struct BenchmarkCase {
+	const char *name;
+	const char *typed;
+	const char *untyped;
+};
+
+// Each case is run as statically typed and as untyped code, which should
+// give the same result. The typed version can use the specialized opcodes.
+static const BenchmarkCase benchmark_cases[] = {
+	{ "int arithmetic",
+			"static func run(n: int) -> int:\n"
+			"\tvar total: int = 0\n"
+			"\tvar i: int = 0\n"
+			"\twhile i < n:\n"
+			"\t\ttotal = (total + i * 7) % 1000003\n"
+			"\t\ti += 1\n"
+			"\treturn total\n",
+			"static func run(n):\n"
+			"\tvar total = 0\n"
+			"\tvar i = 0\n"
+			"\twhile i < n:\n"
+			"\t\ttotal = (total + i * 7) % 1000003\n"
+			"\t\ti += 1\n"
+			"\treturn total\n" },
+	{ "float arithmetic",
+			"static func run(n: int) -> float:\n"
+			"\tvar x: float = 0.0\n"
+			"\tvar y: float = 1.0\n"
+			"\tfor i in n:\n"
+			"\t\tx = x * 0.999 + y\n"
+			"\t\tif x > 500.0:\n"
+			"\t\t\ty = -y\n"
+			"\treturn x\n",
+			"static func run(n):\n"
+			"\tvar x = 0.0\n"
+			"\tvar y = 1.0\n"
+			"\tfor i in n:\n"
+			"\t\tx = x * 0.999 + y\n"
+			"\t\tif x > 500.0:\n"
+			"\t\t\ty = -y\n"
+			"\treturn x\n" },
+	{ "Vector3 arithmetic",
+			"static func run(n: int) -> Vector3:\n"
+			"\tvar p: Vector3 = Vector3()\n"
+			"\tvar v: Vector3 = Vector3(1, 2, 3)\n"
+			"\tvar damping: float = 0.5\n"
+			"\tfor i in n:\n"
+			"\t\tp = p * damping + v - p / 8.0\n"
+			"\treturn p\n",
+			"static func run(n):\n"
+			"\tvar p = Vector3()\n"
+			"\tvar v = Vector3(1, 2, 3)\n"
+			"\tvar damping = 0.5\n"
+			"\tfor i in n:\n"
+			"\t\tp = p * damping + v - p / 8.0\n"
+			"\treturn p\n" },
+	{ "PoolRealArray indexing",
+			"static func run(n: int) -> float:\n"
+			"\tvar values: PoolRealArray = PoolRealArray()\n"
+			"\tfor i in 64:\n"
+			"\t\tvalues.push_back(i * 0.5)\n"
+			"\tvar sum: float = 0.0\n"
+			"\tvar i: int = 0\n"
+			"\twhile i < n:\n"
+			"\t\tvar value: float = values[i & 63]\n"
+			"\t\tsum = sum + value\n"
+			"\t\ti += 1\n"
+			"\treturn sum\n",
+			"static func run(n):\n"
+			"\tvar values = PoolRealArray()\n"
+			"\tfor i in 64:\n"
+			"\t\tvalues.push_back(i * 0.5)\n"
+			"\tvar sum = 0.0\n"
+			"\tvar i = 0\n"
+			"\twhile i < n:\n"
+			"\t\tvar value = values[i & 63]\n"
+			"\t\tsum = sum + value\n"
+			"\t\ti += 1\n"
+			"\treturn sum\n" },
+	{ "Array indexing",
+			"static func run(n: int) -> int:\n"
+			"\tvar values: Array = []\n"
+			"\tfor i in 64:\n"
+			"\t\tvalues.push_back(i)\n"
+			"\tvar sum: int = 0\n"
+			"\tvar i: int = 0\n"
+			"\twhile i < n:\n"
+			"\t\tsum += values[i & 63]\n"
+			"\t\ti += 1\n"
+			"\treturn sum\n",
+			"static func run(n):\n"
+			"\tvar values = []\n"
+			"\tfor i in 64:\n"
+			"\t\tvalues.push_back(i)\n"
+			"\tvar sum = 0\n"
+			"\tvar i = 0\n"
+			"\twhile i < n:\n"
+			"\t\tsum += values[i & 63]\n"
+			"\t\ti += 1\n"
+			"\treturn sum\n" },
+	{ "Native calls and properties",
+			"static func run(n: int) -> int:\n"
+			"\tvar res: Resource = Resource.new()\n"
+			"\tres.resource_name = \"bench\"\n"
+			"\tvar total: int = 0\n"
+			"\tfor i in n:\n"
+			"\t\tres.resource_local_to_scene = (i & 1) == 0\n"
+			"\t\tif res.is_local_to_scene():\n"
+			"\t\t\ttotal += res.get_name().length()\n"
+			"\treturn total\n",
+			"static func run(n):\n"
+			"\tvar res = Resource.new()\n"
+			"\tres.resource_name = \"bench\"\n"
+			"\tvar total = 0\n"
+			"\tfor i in n:\n"
+			"\t\tres.resource_local_to_scene = (i & 1) == 0\n"
+			"\t\tif res.is_local_to_scene():\n"
+			"\t\t\ttotal += res.get_name().length()\n"
+			"\treturn total\n" },
+	{ "Native calls with typed arguments",
+			"static func run(n: int) -> int:\n"
+			"\tvar astar: AStar = AStar.new()\n"
+			"\tfor i in 16:\n"
+			"\t\tastar.add_point(i, Vector3(i, 0, 0), 1.0)\n"
+			"\tvar total: float = 0.0\n"
+			"\tfor i in n:\n"
+			"\t\tvar id: int = i & 15\n"
+			"\t\tif astar.has_point(id):\n"
+			"\t\t\ttotal += astar.get_point_position(id).x + astar.get_point_weight_scale(id)\n"
+			"\treturn int(total)\n",
+			"static func run(n):\n"
+			"\tvar astar = AStar.new()\n"
+			"\tfor i in 16:\n"
+			"\t\tastar.add_point(i, Vector3(i, 0, 0), 1.0)\n"
+			"\tvar total = 0.0\n"
+			"\tfor i in n:\n"
+			"\t\tvar id = i & 15\n"
+			"\t\tif astar.has_point(id):\n"
+			"\t\t\ttotal += astar.get_point_position(id).x + astar.get_point_weight_scale(id)\n"
+			"\treturn int(total)\n" },
+	{ "Script calls and members",
+			"class Counter:\n"
+			"\tvar value: int = 0\n"
+			"\tfunc add(amount: int) -> void:\n"
+			"\t\tvalue = (value + amount) % 1000\n"
+			"static func run(n: int) -> int:\n"
+			"\tvar counter: Counter = Counter.new()\n"
+			"\tvar total: int = 0\n"
+			"\tfor i in n:\n"
+			"\t\tcounter.add(i & 7)\n"
+			"\t\ttotal += counter.value\n"
+			"\treturn total\n",
+			"class Counter:\n"
+			"\tvar value = 0\n"
+			"\tfunc add(amount):\n"
+			"\t\tvalue = (value + amount) % 1000\n"
+			"static func run(n):\n"
+			"\tvar counter = Counter.new()\n"
+			"\tvar total = 0\n"
+			"\tfor i in n:\n"
+			"\t\tcounter.add(i & 7)\n"
+			"\t\ttotal += counter.value\n"
+			"\treturn total\n" },
+};
+
+static Ref<GDScript> _compile_code(const String &p_code) {
+	GDScriptParser parser;
+	Error err = parser.parse(p_code);
+	if (err) {
+		print_line("Parse Error:\n" + itos(parser.get_error_line()) + ":" + itos(parser.get_error_column()) + ":" + parser.get_error());
+		return Ref<GDScript>();
+	}
 
-					int argc = code[ip + 2];
-					txt += DADDR(3 + argc) + "=";
+	Ref<GDScript> gds;
+	gds.instance();
 
-					txt += GDScriptFunctions::get_func_name(GDScriptFunctions::Function(code[ip + 1]));
-					txt += "(";
+	GDScriptCompiler gdc;
+	err = gdc.compile(&parser, gds.ptr());
+	if (err) {
+		print_line("Compile Error:\n" + itos(gdc.get_error_line()) + ":" + itos(gdc.get_error_column()) + ":" + gdc.get_error());
+		return Ref<GDScript>();
+	}
 
-					for (int i = 0; i < argc; i++) {
-						if (i > 0) {
-							txt += ", ";
-						}
-						txt += DADDR(3 + i);
-					}
-					txt += ")";
+	return gds;
+}
 
-					incr = 4 + argc;
+static bool _run_benchmark(Object *p_script, int p_iterations, Variant &r_result, uint64_t &r_usec) {
+	Variant arg = p_iterations;
+	const Variant *args[1] = { &arg };
+	Variant::CallError ce;
 
-				} break;
-				case GDScriptFunction::OPCODE_CALL_SELF_BASE: {
-					txt += " call-self-base ";
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	r_result = p_script->call("run", args, 1, ce);
+	r_usec = OS::get_singleton()->get_ticks_usec() - begin;
 
-					int argc = code[ip + 2];
-					txt += DADDR(3 + argc) + "=";
+	return ce.error == Variant::CallError::CALL_OK;
+}
 
-					txt += func.get_global_name(code[ip + 1]);
-					txt += "(";
+static MainLoop *_test_benchmark() {
+	const int iterations = 1000000;
+	bool ok = true;
 
-					for (int i = 0; i < argc; i++) {
-						if (i > 0) {
-							txt += ", ";
-						}
-						txt += DADDR(3 + i);
-					}
-					txt += ")";
+	print_line("GDScript typed vs. untyped benchmark, " + itos(iterations) + " iterations per case.");
 
-					incr = 4 + argc;
+	for (uint32_t i = 0; i < sizeof(benchmark_cases) / sizeof(benchmark_cases[0]); i++) {
+		const BenchmarkCase &bc = benchmark_cases[i];
 
-				} break;
-				case GDScriptFunction::OPCODE_YIELD: {
-					txt += " yield ";
-					incr = 1;
+		Ref<GDScript> typed = _compile_code(bc.typed);
+		Ref<GDScript> untyped = _compile_code(bc.untyped);
+		if (typed.is_null() || untyped.is_null()) {
+			ok = false;
+			continue;
+		}
 
-				} break;
-				case GDScriptFunction::OPCODE_YIELD_SIGNAL: {
-					txt += " yield_signal ";
-					txt += DADDR(1);
-					txt += ",";
-					txt += DADDR(2);
-					incr = 3;
-				} break;
-				case GDScriptFunction::OPCODE_YIELD_RESUME: {
-					txt += " yield resume: ";
-					txt += DADDR(1);
-					incr = 2;
-				} break;
-				case GDScriptFunction::OPCODE_JUMP: {
-					txt += " jump ";
-					txt += itos(code[ip + 1]);
+		Variant typed_result, untyped_result;
+		uint64_t typed_usec = 0, untyped_usec = 0;
+		if (!_run_benchmark(untyped.ptr(), iterations, untyped_result, untyped_usec) || !_run_benchmark(typed.ptr(), iterations, typed_result, typed_usec)) {
+			print_line("\t" + String(bc.name) + ": call failed.");
+			ok = false;
+			continue;
+		}
 
-					incr = 2;
+		bool same = typed_result == untyped_result;
+		ok = ok && same;
 
-				} break;
-				case GDScriptFunction::OPCODE_JUMP_IF: {
-					txt += " jump-if ";
-					txt += DADDR(1);
-					txt += " to ";
-					txt += itos(code[ip + 2]);
+		print_line("\t" + String(bc.name) + ": untyped " + rtos(untyped_usec / 1000.0) + " msec, typed " + rtos(typed_usec / 1000.0) + " msec (" + rtos(untyped_usec / (double)MAX(typed_usec, (uint64_t)1)) + "x)" + (same ? "" : ", results differ: " + String(untyped_result) + " vs. " + String(typed_result)));
+	}
 
-					incr = 3;
-				} break;
-				case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
-					txt += " jump-if-not ";
-					txt += DADDR(1);
-					txt += " to ";
-					txt += itos(code[ip + 2]);
+	print_line(ok ? "Benchmark finished." : "Benchmark failed.");
 
-					incr = 3;
-				} break;
-				case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT: {
-					txt += " jump-to-default-argument ";
-					incr = 1;
-				} break;
-				case GDScriptFunction::OPCODE_RETURN: {
-					txt += " return ";
-					txt += DADDR(1);
+	return nullptr;
+}
 
-					incr = 2;
+struct OptimizerCase {
+	const char *name;
+	const char *code;
+	const char *expected; // must show up in the bytecode of f()
+	const char *unexpected; // must not
+};
+
+static const OptimizerCase optimizer_cases[] = {
+	{ "constant false branch",
+			"const DEBUG = false\n"
+			"func f():\n"
+			"\tif DEBUG:\n"
+			"\t\tprint(\"debug\")\n"
+			"\treturn 1\n",
+			"return const(1)", "jump" },
+	{ "constant else branch",
+			"func f():\n"
+			"\tif 1 > 2:\n"
+			"\t\treturn \"a\"\n"
+			"\telse:\n"
+			"\t\treturn \"b\"\n",
+			"return const(\"b\")", "const(\"a\")" },
+	{ "constant false loop",
+			"func f():\n"
+			"\twhile false:\n"
+			"\t\tprint(\"never\")\n"
+			"\treturn 2\n",
+			"return const(2)", "print" },
+	{ "folded constant chain",
+			"const A = 2\n"
+			"const B = A * 3 + 1\n"
+			"func f():\n"
+			"\treturn B * 2\n",
+			"return const(14)", " op " },
+	{ "folded enum value",
+			"enum Mode { NONE, FIRST = 4, SECOND }\n"
+			"func f():\n"
+			"\treturn Mode.SECOND + 1\n",
+			"return const(6)", " op " },
+	{ "folded inner class constant",
+			"class Inner:\n"
+			"\tconst C = 10\n"
+			"const D = Inner.C + 1\n"
+			"func f():\n"
+			"\treturn D\n",
+			"return const(11)", "class_const" },
+	{ "argument shadows constant",
+			"const X = 5\n"
+			"func f(X):\n"
+			"\treturn X\n",
+			"return var_stack(0)", "const(5)" },
+};
+
+static MainLoop *_test_optimizer() {
+	bool ok = true;
+
+	for (uint32_t i = 0; i < sizeof(optimizer_cases) / sizeof(optimizer_cases[0]); i++) {
+		const OptimizerCase &oc = optimizer_cases[i];
+
+		String code = oc.code;
+		Ref<GDScript> gds = _compile_code(code);
+		const Map<StringName, GDScriptFunction *> &mf = gds.is_valid() ? gds->debug_get_member_functions() : Map<StringName, GDScriptFunction *>();
+		if (!mf.has("f")) {
+			print_line("\t" + String(oc.name) + ": FAILED, could not compile.");
+			ok = false;
+			continue;
+		}
 
-				} break;
-				case GDScriptFunction::OPCODE_ITERATE_BEGIN: {
-					txt += " for-init " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(code[ip + 3]);
-					incr += 5;
+		String bytecode = mf["f"]->disassemble(code.split("\n"));
+		bool passed = bytecode.find(oc.expected) != -1 && bytecode.find(oc.unexpected) == -1;
+		ok = ok && passed;
 
-				} break;
-				case GDScriptFunction::OPCODE_ITERATE: {
-					txt += " for-loop " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(code[ip + 3]);
-					incr += 5;
+		print_line("\t" + String(oc.name) + ": " + (passed ? "OK" : "FAILED\n" + bytecode));
+	}
 
-				} break;
-				case GDScriptFunction::OPCODE_LINE: {
-					int line = code[ip + 1] - 1;
-					if (line >= 0 && line < p_code.size()) {
-						txt = "\n" + itos(line + 1) + ": " + p_code[line] + "\n";
-					} else {
-						txt = "";
-					}
-					incr += 2;
-				} break;
-				case GDScriptFunction::OPCODE_END: {
-					txt += " end";
-					incr += 1;
-				} break;
-				case GDScriptFunction::OPCODE_ASSERT: {
-					txt += " assert ";
-					txt += DADDR(1);
-					incr += 2;
+	print_line(ok ? "All optimizer tests passed." : "Some optimizer tests failed.");
 
-				} break;
-			}
+	return nullptr;
+}
 
-			if (incr == 0) {
-				ERR_BREAK_MSG(true, "Unhandled opcode: " + itos(code[ip]));
-			}
+MainLoop *test(TestType p_type) {
+	if (p_type == TEST_BENCHMARK) {
+		return _test_benchmark();
+	}
 
-			ip += incr;
-			if (txt != "") {
-				print_line(txt);
-			}
-		}
+	if (p_type == TEST_OPTIMIZER) {
+		return _test_optimizer();
 	}
-}
 
-MainLoop *test(TestType p_type) {
 	List<String> cmdlargs = OS::get_singleton()->get_cmdline_args();
 
 	if (cmdlargs.empty()) {
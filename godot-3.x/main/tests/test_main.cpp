@@ -34,20 +34,29 @@
 
 #ifdef DEBUG_ENABLED
 
+#include "test_animation.h"
 #include "test_astar.h"
 #include "test_basis.h"
 #include "test_crypto.h"
+#include "test_frame_arena.h"
 #include "test_gdscript.h"
 #include "test_gui.h"
 #include "test_math.h"
+#include "test_message_queue.h"
+#include "test_navigation.h"
 #include "test_oa_hash_map.h"
+#include "test_object_db.h"
+#include "test_occlusion_buffer.h"
 #include "test_ordered_hash_map.h"
 #include "test_physics.h"
 #include "test_physics_2d.h"
 #include "test_render.h"
 #include "test_shader_lang.h"
+#include "test_size_class_allocator.h"
 #include "test_string.h"
+#include "test_string_name.h"
 #include "test_transform.h"
+#include "test_worker_thread_pool.h"
 #include "test_xml_parser.h"
 
 const char **tests_get_names() {
@@ -58,7 +67,12 @@ const char **tests_get_names() {
 		"transform",
 		"physics",
 		"physics_2d",
+		"physics_2d_benchmark",
 		"render",
+		"render_cull_benchmark",
+		"render_multi_viewport_cull_benchmark",
+		"render_canvas_benchmark",
+		"render_concurrent_cull",
 		"oa_hash_map",
 		"gui",
 		"shaderlang",
@@ -66,9 +80,20 @@ const char **tests_get_names() {
 		"gd_parser",
 		"gd_compiler",
 		"gd_bytecode",
+		"gd_benchmark",
+		"gd_optimizer",
 		"ordered_hash_map",
 		"astar",
 		"xml_parser",
+		"worker_thread_pool",
+		"navigation",
+		"animation",
+		"string_name",
+		"object_db",
+		"size_class_allocator",
+		"message_queue",
+		"frame_arena",
+		"occlusion_buffer",
 		nullptr
 	};
 
@@ -100,10 +125,30 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestPhysics2D::test();
 	}
 
+	if (p_test == "physics_2d_benchmark") {
+		return TestPhysics2D::test_benchmark();
+	}
+
 	if (p_test == "render") {
 		return TestRender::test();
 	}
 
+	if (p_test == "render_cull_benchmark") {
+		return TestRender::test_cull_benchmark();
+	}
+
+	if (p_test == "render_multi_viewport_cull_benchmark") {
+		return TestRender::test_multi_viewport_cull_benchmark();
+	}
+
+	if (p_test == "render_canvas_benchmark") {
+		return TestRender::test_canvas_benchmark();
+	}
+
+	if (p_test == "render_concurrent_cull") {
+		return TestRender::test_concurrent_cull();
+	}
+
 	if (p_test == "oa_hash_map") {
 		return TestOAHashMap::test();
 	}
@@ -138,6 +183,14 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestGDScript::test(TestGDScript::TEST_BYTECODE);
 	}
 
+	if (p_test == "gd_benchmark") {
+		return TestGDScript::test(TestGDScript::TEST_BENCHMARK);
+	}
+
+	if (p_test == "gd_optimizer") {
+		return TestGDScript::test(TestGDScript::TEST_OPTIMIZER);
+	}
+
 	if (p_test == "ordered_hash_map") {
 		return TestOrderedHashMap::test();
 	}
@@ -150,6 +203,42 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestXMLParser::test();
 	}
 
+	if (p_test == "worker_thread_pool") {
+		return TestWorkerThreadPool::test();
+	}
+
+	if (p_test == "navigation") {
+		return TestNavigation::test();
+	}
+
+	if (p_test == "animation") {
+		return TestAnimation::test();
+	}
+
+	if (p_test == "string_name") {
+		return TestStringName::test();
+	}
+
+	if (p_test == "object_db") {
+		return TestObjectDB::test();
+	}
+
+	if (p_test == "size_class_allocator") {
+		return TestSizeClassAllocator::test();
+	}
+
+	if (p_test == "message_queue") {
+		return TestMessageQueue::test();
+	}
+
+	if (p_test == "frame_arena") {
+		return TestFrameArena::test();
+	}
+
+	if (p_test == "occlusion_buffer") {
+		return TestOcclusionBuffer::test();
+	}
+
 	print_line("Unknown test: " + p_test);
 	return nullptr;
 }
@@ -0,0 +1,250 @@
+/*************************************************************************/
+/*  test_message_queue.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_message_queue.h"
+
+#include "core/message_queue.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+
+namespace TestMessageQueue {
+
+enum {
+	THREAD_COUNT = 8,
+	// Kept clear of the notifications the engine sends on its own.
+	NOTIFICATION_TEST_BASE = 1000,
+	NOTIFICATION_REQUEUE = NOTIFICATION_TEST_BASE,
+	NOTIFICATION_RUNAWAY = NOTIFICATION_TEST_BASE + 31000, // past the ones test_order() cycles through
+};
+
+class Recorder : public Object {
+	GDCLASS(Recorder, Object);
+
+public:
+	Vector<int> notifications;
+	Vector<int> values[THREAD_COUNT];
+	int requeue_count = 0;
+	int runaway_count = 0;
+	Error runaway_error = OK;
+
+	void _notification(int p_what) {
+		if (p_what < NOTIFICATION_TEST_BASE) {
+			return;
+		}
+		if (p_what == NOTIFICATION_RUNAWAY) {
+			// Keeps deferring itself until the queue refuses.
+			runaway_count++;
+			runaway_error = MessageQueue::get_singleton()->push_notification(this, NOTIFICATION_RUNAWAY);
+			return;
+		}
+		notifications.push_back(p_what);
+		if (p_what == NOTIFICATION_REQUEUE && requeue_count > 0) {
+			requeue_count--;
+			MessageQueue::get_singleton()->push_notification(this, NOTIFICATION_REQUEUE);
+		}
+	}
+
+	bool _set(const StringName &p_name, const Variant &p_value) {
+		int thread = String(p_name).to_int();
+		ERR_FAIL_INDEX_V(thread, THREAD_COUNT, false);
+		values[thread].push_back(p_value);
+		return true;
+	}
+};
+
+bool test_order() {
+	OS::get_singleton()->print("\n\nTest 1: Messages are flushed in order, past the reserved queue size\n");
+
+	const int count = 200000;
+	Recorder *recorder = memnew(Recorder);
+
+	for (int i = 0; i < count; i++) {
+		if (i % 2) {
+			MessageQueue::get_singleton()->push_set(recorder, "0", i);
+		} else {
+			MessageQueue::get_singleton()->push_notification(recorder, NOTIFICATION_TEST_BASE + 1 + i % 30000);
+		}
+	}
+	MessageQueue::get_singleton()->flush();
+
+	bool ok = recorder->notifications.size() == count / 2 && recorder->values[0].size() == count / 2;
+	for (int i = 0; ok && i < count / 2; i++) {
+		ok = recorder->notifications[i] == NOTIFICATION_TEST_BASE + 1 + (i * 2) % 30000 && recorder->values[0][i] == i * 2 + 1;
+	}
+
+	memdelete(recorder);
+	return ok;
+}
+
+struct ProducerData {
+	Recorder *recorder = nullptr;
+	int thread = 0;
+	int count = 0;
+};
+
+static void _push_values(void *p_userdata) {
+	ProducerData *data = (ProducerData *)p_userdata;
+	StringName property = itos(data->thread);
+	for (int i = 0; i < data->count; i++) {
+		MessageQueue::get_singleton()->push_set(data->recorder, property, i);
+	}
+}
+
+bool test_producers() {
+	OS::get_singleton()->print("\n\nTest 2: Messages pushed from several threads\n");
+
+	const int count = 50000;
+	Recorder *recorder = memnew(Recorder);
+
+	ProducerData data[THREAD_COUNT];
+	Thread threads[THREAD_COUNT];
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		data[i].recorder = recorder;
+		data[i].thread = i;
+		data[i].count = count;
+		threads[i].start(_push_values, &data[i]);
+	}
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		threads[i].wait_to_finish();
+	}
+	MessageQueue::get_singleton()->flush();
+
+	bool ok = true;
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		ok = ok && recorder->values[i].size() == count;
+		for (int j = 0; ok && j < count; j++) {
+			ok = recorder->values[i][j] == j;
+		}
+	}
+
+	memdelete(recorder);
+	return ok;
+}
+
+bool test_requeue() {
+	OS::get_singleton()->print("\n\nTest 3: Messages pushed while flushing are flushed too\n");
+
+	Recorder *recorder = memnew(Recorder);
+	recorder->requeue_count = 100;
+	MessageQueue::get_singleton()->push_notification(recorder, NOTIFICATION_REQUEUE);
+	MessageQueue::get_singleton()->flush();
+
+	bool ok = recorder->notifications.size() == 101 && recorder->requeue_count == 0;
+
+	memdelete(recorder);
+	return ok;
+}
+
+bool test_runaway() {
+	OS::get_singleton()->print("\n\nTest 4: A message that keeps deferring itself runs out of memory instead of hanging the flush\n");
+
+	Recorder *recorder = memnew(Recorder);
+	MessageQueue::get_singleton()->push_notification(recorder, NOTIFICATION_RUNAWAY);
+	MessageQueue::get_singleton()->flush();
+
+	OS::get_singleton()->print("\tdeferred %d times before running out of memory\n", recorder->runaway_count);
+	bool ok = recorder->runaway_error == ERR_OUT_OF_MEMORY && recorder->runaway_count > 1;
+
+	// Once the flush is over, the queue takes messages again.
+	ok = ok && MessageQueue::get_singleton()->push_notification(recorder, NOTIFICATION_REQUEUE) == OK;
+	MessageQueue::get_singleton()->flush();
+	ok = ok && recorder->notifications.size() == 1;
+
+	memdelete(recorder);
+	return ok;
+}
+
+bool test_benchmark() {
+	OS::get_singleton()->print("\n\nTest 5: Push and flush benchmark\n");
+
+	const int count = 200000;
+	Recorder *recorder = memnew(Recorder);
+
+	for (int thread_count = 1; thread_count <= THREAD_COUNT; thread_count *= 2) {
+		ProducerData data[THREAD_COUNT];
+		Thread threads[THREAD_COUNT];
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < thread_count; i++) {
+			data[i].recorder = recorder;
+			data[i].thread = i;
+			data[i].count = count;
+			threads[i].start(_push_values, &data[i]);
+		}
+		for (int i = 0; i < thread_count; i++) {
+			threads[i].wait_to_finish();
+		}
+		uint64_t pushed = OS::get_singleton()->get_ticks_usec();
+		MessageQueue::get_singleton()->flush();
+		uint64_t flushed = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < thread_count; i++) {
+			recorder->values[i].clear();
+		}
+
+		OS::get_singleton()->print("\t%d threads: pushed %d messages in %.1f msec, flushed in %.1f msec\n", thread_count, thread_count * count, (pushed - begin) / 1000.0, (flushed - pushed) / 1000.0);
+	}
+
+	memdelete(recorder);
+	return true;
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+	test_order,
+	test_producers,
+	test_requeue,
+	test_runaway,
+	test_benchmark,
+	nullptr
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+	OS::get_singleton()->print("\n");
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+	return nullptr;
+}
+
+} // namespace TestMessageQueue
@@ -0,0 +1,240 @@
+/*************************************************************************/
+/*  test_navigation.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_navigation.h"
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "scene/resources/navigation_mesh.h"
+#include "servers/navigation_server.h"
+
+namespace TestNavigation {
+
+// Square grid of p_size x p_size cells, two triangles per cell. Cells with
+// x == p_gap_column are left out, which splits the grid in two islands.
+Ref<NavigationMesh> create_grid_navmesh(int p_size, int p_gap_column = -1) {
+	PoolVector<Vector3> vertices;
+	vertices.resize((p_size + 1) * (p_size + 1));
+	{
+		PoolVector<Vector3>::Write w = vertices.write();
+		for (int z = 0; z <= p_size; z++) {
+			for (int x = 0; x <= p_size; x++) {
+				w[z * (p_size + 1) + x] = Vector3(x, 0, z);
+			}
+		}
+	}
+
+	Ref<NavigationMesh> navmesh;
+	navmesh.instance();
+	navmesh->set_vertices(vertices);
+
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			if (x == p_gap_column) {
+				continue;
+			}
+			int a = z * (p_size + 1) + x;
+			int b = a + 1;
+			int c = a + p_size + 1;
+			int d = c + 1;
+
+			Vector<int> polygon;
+			polygon.resize(3);
+			polygon.write[0] = a;
+			polygon.write[1] = b;
+			polygon.write[2] = d;
+			navmesh->add_polygon(polygon);
+			polygon.write[0] = a;
+			polygon.write[1] = d;
+			polygon.write[2] = c;
+			navmesh->add_polygon(polygon);
+		}
+	}
+	return navmesh;
+}
+
+struct TestMap {
+	RID map;
+	RID region;
+
+	TestMap(const Ref<NavigationMesh> &p_navmesh) {
+		map = NavigationServer::get_singleton()->map_create();
+		NavigationServer::get_singleton()->map_set_active(map, true);
+		region = NavigationServer::get_singleton()->region_create();
+		NavigationServer::get_singleton()->region_set_map(region, map);
+		NavigationServer::get_singleton()->region_set_navmesh(region, p_navmesh);
+		// Flushes the commands and syncs the map.
+		NavigationServer::get_singleton_mut()->process(0.0);
+	}
+
+	~TestMap() {
+		NavigationServer::get_singleton()->free(region);
+		NavigationServer::get_singleton()->free(map);
+		NavigationServer::get_singleton_mut()->process(0.0);
+	}
+};
+
+bool test_straight_path() {
+	TestMap test_map(create_grid_navmesh(16));
+
+	Vector3 from(0.5, 0, 0.5);
+	Vector3 to(15.5, 0, 15.5);
+	Vector<Vector3> path = NavigationServer::get_singleton()->map_get_path(test_map.map, from, to, true);
+
+	bool ok = path.size() == 2;
+	ok = ok && path[0].is_equal_approx(from) && path[path.size() - 1].is_equal_approx(to);
+	if (!ok) {
+		OS::get_singleton()->print("\tpath with %d points\n", path.size());
+	}
+	return ok;
+}
+
+bool test_unreachable_destination() {
+	TestMap test_map(create_grid_navmesh(16, 8));
+
+	// The destination is on the other island, the path must stop at the gap.
+	Vector<Vector3> path = NavigationServer::get_singleton()->map_get_path(test_map.map, Vector3(0.5, 0, 4.5), Vector3(15.5, 0, 4.5), true);
+
+	bool ok = path.size() >= 2;
+	ok = ok && Math::is_equal_approx(path[path.size() - 1].x, 8.0f);
+	if (!ok) {
+		OS::get_singleton()->print("\tpath with %d points\n", path.size());
+	}
+	return ok;
+}
+
+bool test_path_query_benchmark() {
+	const int grid_size = 150;
+	const int queries = 200;
+
+	TestMap test_map(create_grid_navmesh(grid_size));
+
+	RandomPCG rng(42);
+	uint64_t points = 0;
+	bool ok = true;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < queries; i++) {
+		Vector3 from(rng.randf() * grid_size, 0, rng.randf() * grid_size);
+		Vector3 to(rng.randf() * grid_size, 0, rng.randf() * grid_size);
+		Vector<Vector3> path = NavigationServer::get_singleton()->map_get_path(test_map.map, from, to, i % 2 == 0);
+		ok = ok && path.size() >= 2;
+		points += path.size();
+	}
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+	OS::get_singleton()->print("\t%d triangles, %d queries in %.2f msec: %.1f paths/sec (%.1f points per path)\n", grid_size * grid_size * 2, queries, elapsed / 1000.0, queries * 1000000.0 / MAX(elapsed, (uint64_t)1), double(points) / queries);
+	return ok;
+}
+
+Vector<NavigationServer::PathQuery> create_random_queries(int p_count, int p_grid_size) {
+	RandomPCG rng(7);
+	Vector<NavigationServer::PathQuery> queries;
+	queries.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		queries.write[i].origin = Vector3(rng.randf() * p_grid_size, 0, rng.randf() * p_grid_size);
+		queries.write[i].destination = Vector3(rng.randf() * p_grid_size, 0, rng.randf() * p_grid_size);
+		queries.write[i].optimize = i % 2 == 0;
+	}
+	return queries;
+}
+
+bool test_batch_matches_single_queries() {
+	const int grid_size = 32;
+	TestMap test_map(create_grid_navmesh(grid_size));
+
+	Vector<NavigationServer::PathQuery> queries = create_random_queries(64, grid_size);
+	Vector<Vector<Vector3>> paths = NavigationServer::get_singleton()->map_get_paths(test_map.map, queries);
+
+	bool ok = paths.size() == queries.size();
+	for (int i = 0; ok && i < queries.size(); i++) {
+		Vector<Vector3> path = NavigationServer::get_singleton()->map_get_path(test_map.map, queries[i].origin, queries[i].destination, queries[i].optimize);
+		ok = path.size() == paths[i].size();
+		for (int j = 0; ok && j < path.size(); j++) {
+			ok = path[j] == paths[i][j];
+		}
+	}
+	return ok;
+}
+
+bool test_batch_benchmark() {
+	const int grid_size = 150;
+	const int queries_count = 512;
+
+	TestMap test_map(create_grid_navmesh(grid_size));
+	Vector<NavigationServer::PathQuery> queries = create_random_queries(queries_count, grid_size);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < queries.size(); i++) {
+		NavigationServer::get_singleton()->map_get_path(test_map.map, queries[i].origin, queries[i].destination, queries[i].optimize);
+	}
+	uint64_t single = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	Vector<Vector<Vector3>> paths = NavigationServer::get_singleton()->map_get_paths(test_map.map, queries);
+	uint64_t batched = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+	OS::get_singleton()->print("\t%d queries: one by one %.1f paths/sec, batched %.1f paths/sec\n", queries_count, queries_count * 1000000.0 / single, queries_count * 1000000.0 / batched);
+	return paths.size() == queries_count;
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+	test_straight_path,
+	test_unreachable_destination,
+	test_path_query_benchmark,
+	test_batch_matches_single_queries,
+	test_batch_benchmark,
+	nullptr
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+	OS::get_singleton()->print("\n");
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+	return nullptr;
+}
+
+} // namespace TestNavigation
@@ -0,0 +1,220 @@
+/*************************************************************************/
+/*  test_object_db.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_object_db.h"
+
+#include "core/object.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+
+namespace TestObjectDB {
+
+enum {
+	THREAD_COUNT = 8,
+};
+
+bool test_stale_ids() {
+	OS::get_singleton()->print("\n\nTest 1: IDs of freed objects stop resolving, even when the slot is reused\n");
+
+	Object *first = memnew(Object);
+	ObjectID first_id = first->get_instance_id();
+	bool ok = ObjectDB::get_instance(first_id) == first;
+	memdelete(first);
+	ok = ok && ObjectDB::get_instance(first_id) == nullptr;
+
+	Object *second = memnew(Object);
+	ObjectID second_id = second->get_instance_id();
+	ok = ok && second_id != first_id;
+	ok = ok && ObjectDB::get_instance(second_id) == second;
+	ok = ok && ObjectDB::get_instance(first_id) == nullptr;
+	ok = ok && ObjectDB::instance_validate(second);
+	memdelete(second);
+
+	ok = ok && ObjectDB::get_instance(0) == nullptr;
+	return ok;
+}
+
+struct ChurnData {
+	bool ok = true;
+};
+
+static void _churn_objects(void *p_userdata) {
+	ChurnData *data = (ChurnData *)p_userdata;
+	Object *objects[64];
+	ObjectID ids[64];
+	for (int r = 0; r < 2000; r++) {
+		for (int i = 0; i < 64; i++) {
+			objects[i] = memnew(Object);
+			ids[i] = objects[i]->get_instance_id();
+		}
+		for (int i = 0; i < 64; i++) {
+			if (ObjectDB::get_instance(ids[i]) != objects[i]) {
+				data->ok = false;
+			}
+			memdelete(objects[i]);
+			if (ObjectDB::get_instance(ids[i]) != nullptr) {
+				data->ok = false;
+			}
+		}
+	}
+}
+
+bool test_churn() {
+	OS::get_singleton()->print("\n\nTest 2: Objects created and freed from several threads\n");
+
+	int count_before = ObjectDB::get_object_count();
+
+	ChurnData data[THREAD_COUNT];
+	Thread threads[THREAD_COUNT];
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		threads[i].start(_churn_objects, &data[i]);
+	}
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	bool ok = ObjectDB::get_object_count() == count_before;
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		ok = ok && data[i].ok;
+	}
+	return ok;
+}
+
+bool test_benchmark_create() {
+	OS::get_singleton()->print("\n\nTest 3: Create and free benchmark\n");
+
+	const int count = 1000000;
+	Vector<Object *> objects;
+	objects.resize(count);
+	Object **ptr = objects.ptrw();
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		ptr[i] = memnew(Object);
+	}
+	uint64_t created = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		memdelete(ptr[i]);
+	}
+	uint64_t freed = OS::get_singleton()->get_ticks_usec();
+
+	OS::get_singleton()->print("\tcreated %d objects in %.1f msec, freed in %.1f msec\n", count, (created - begin) / 1000.0, (freed - created) / 1000.0);
+	return true;
+}
+
+struct ResolveData {
+	const ObjectID *ids = nullptr;
+	int count = 0;
+	int rounds = 0;
+	int found = 0;
+};
+
+static void _resolve_ids(void *p_userdata) {
+	ResolveData *data = (ResolveData *)p_userdata;
+	int found = 0;
+	for (int r = 0; r < data->rounds; r++) {
+		for (int i = 0; i < data->count; i++) {
+			found += ObjectDB::get_instance(data->ids[i]) != nullptr;
+		}
+	}
+	data->found = found;
+}
+
+bool test_benchmark_resolve() {
+	OS::get_singleton()->print("\n\nTest 4: ID resolve benchmark\n");
+
+	const int count = 100000;
+	const int rounds = 50;
+	Vector<Object *> objects;
+	Vector<ObjectID> ids;
+	for (int i = 0; i < count; i++) {
+		objects.push_back(memnew(Object));
+		ids.push_back(objects[i]->get_instance_id());
+	}
+
+	bool ok = true;
+	for (int thread_count = 1; thread_count <= THREAD_COUNT; thread_count *= 2) {
+		ResolveData data[THREAD_COUNT];
+		Thread threads[THREAD_COUNT];
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < thread_count; i++) {
+			data[i].ids = ids.ptr();
+			data[i].count = count;
+			data[i].rounds = rounds;
+			threads[i].start(_resolve_ids, &data[i]);
+		}
+		for (int i = 0; i < thread_count; i++) {
+			threads[i].wait_to_finish();
+			ok = ok && data[i].found == count * rounds;
+		}
+		uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+		double total = double(thread_count) * rounds * count;
+		OS::get_singleton()->print("\t%d threads: %.2f million lookups/sec\n", thread_count, total / elapsed);
+	}
+
+	for (int i = 0; i < count; i++) {
+		memdelete(objects[i]);
+	}
+	return ok;
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+	test_stale_ids,
+	test_churn,
+	test_benchmark_create,
+	test_benchmark_resolve,
+	nullptr
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+	OS::get_singleton()->print("\n");
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+	return nullptr;
+}
+
+} // namespace TestObjectDB
@@ -0,0 +1,188 @@
+/*************************************************************************/
+/*  test_occlusion_buffer.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_occlusion_buffer.h"
+
+#include "core/os/os.h"
+#include "servers/visual/occlusion_buffer.h"
+
+namespace TestOcclusionBuffer {
+
+static const Vector3 quad_vertices[4] = {
+	Vector3(-1, -1, 0),
+	Vector3(1, -1, 0),
+	Vector3(1, 1, 0),
+	Vector3(-1, 1, 0),
+};
+
+static const uint32_t quad_indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+// Camera at the origin looking down -Z, with a 4x4 quad at Z = -5 filling the center of the view.
+static void _setup_buffer(OcclusionBuffer &r_buffer) {
+	CameraMatrix projection;
+	projection.set_perspective(70, 16.0 / 9.0, 0.1, 100);
+
+	r_buffer.begin(Transform(), projection, 256);
+	Transform quad_xform(Basis().scaled(Vector3(2, 2, 1)), Vector3(0, 0, -5));
+	r_buffer.add_occluder(quad_xform, quad_vertices, 4, quad_indices, 6);
+	r_buffer.finish();
+}
+
+bool test_occluded() {
+	OS::get_singleton()->print("\n\nTest 1: AABB fully behind an occluder\n");
+
+	OcclusionBuffer buffer;
+	_setup_buffer(buffer);
+
+	bool ok = buffer.is_active();
+	ok = ok && buffer.get_depth(buffer.get_width() / 2, buffer.get_height() / 2) < 1.0f;
+	ok = ok && buffer.get_depth(0, 0) == 1.0f;
+	ok = ok && buffer.is_occluded(AABB(Vector3(-0.5, -0.5, -10), Vector3(1, 1, 1)));
+	ok = ok && buffer.is_occluded(AABB(Vector3(-3, -3, -20), Vector3(6, 6, 2)));
+	return ok;
+}
+
+bool test_visible() {
+	OS::get_singleton()->print("\n\nTest 2: AABBs in front of, beside or around an occluder\n");
+
+	OcclusionBuffer buffer;
+	_setup_buffer(buffer);
+
+	bool ok = true;
+	// In front of the quad.
+	ok = ok && !buffer.is_occluded(AABB(Vector3(-0.5, -0.5, -3), Vector3(1, 1, 1)));
+	// Crossing the quad.
+	ok = ok && !buffer.is_occluded(AABB(Vector3(-0.5, -0.5, -6), Vector3(1, 1, 2)));
+	// Behind, but larger than the quad on screen.
+	ok = ok && !buffer.is_occluded(AABB(Vector3(-10, -1, -20), Vector3(20, 2, 1)));
+	// Off to the side.
+	ok = ok && !buffer.is_occluded(AABB(Vector3(6, -0.5, -10), Vector3(1, 1, 1)));
+	// Reaching behind the camera.
+	ok = ok && !buffer.is_occluded(AABB(Vector3(-0.5, -0.5, -10), Vector3(1, 1, 20)));
+	return ok;
+}
+
+bool test_near_clip() {
+	OS::get_singleton()->print("\n\nTest 3: Occluder crossing the near plane\n");
+
+	CameraMatrix projection;
+	projection.set_perspective(70, 1.0, 0.1, 100);
+
+	// A large floor passing under and behind the camera.
+	OcclusionBuffer buffer;
+	buffer.begin(Transform(), projection, 128);
+	Transform floor_xform(Basis(Vector3(1, 0, 0), -Math_PI / 2).scaled(Vector3(50, 50, 50)), Vector3(0, -1, 0));
+	buffer.add_occluder(floor_xform, quad_vertices, 4, quad_indices, 6);
+	buffer.finish();
+
+	bool ok = buffer.is_active();
+	// Below the floor.
+	ok = ok && buffer.is_occluded(AABB(Vector3(-0.5, -5, -10), Vector3(1, 1, 1)));
+	// Above it.
+	ok = ok && !buffer.is_occluded(AABB(Vector3(-0.5, 0, -10), Vector3(1, 1, 1)));
+	// The top rows look at the sky.
+	ok = ok && buffer.get_depth(buffer.get_width() / 2, 0) == 1.0f;
+	ok = ok && buffer.get_depth(buffer.get_width() / 2, buffer.get_height() - 1) < 1.0f;
+	return ok;
+}
+
+bool test_benchmark() {
+	OS::get_singleton()->print("\n\nTest 4: Rasterization benchmark\n");
+
+	CameraMatrix projection;
+	projection.set_perspective(70, 16.0 / 9.0, 0.1, 500);
+
+	// A grid of walls at various depths.
+	const int grid = 32;
+	Vector<Transform> xforms;
+	for (int i = 0; i < grid; i++) {
+		for (int j = 0; j < grid; j++) {
+			Vector3 origin((i - grid / 2) * 6.0, (j - grid / 2) * 3.0, -20.0 - (i + j) % 7 * 10.0);
+			xforms.push_back(Transform(Basis(Vector3(0, 1, 0), (i * j) % 5 * 0.2).scaled(Vector3(3, 2, 1)), origin));
+		}
+	}
+
+	const int frames = 100;
+	OcclusionBuffer buffer;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int f = 0; f < frames; f++) {
+		buffer.begin(Transform(), projection, 256);
+		for (int i = 0; i < xforms.size(); i++) {
+			buffer.add_occluder(xforms[i], quad_vertices, 4, quad_indices, 6);
+		}
+		buffer.finish();
+	}
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+	int occluded = 0;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < 100000; i++) {
+		Vector3 position((i % 100 - 50) * 2.0, (i / 100 % 100 - 50) * 1.0, -100.0 - i / 10000 * 5.0);
+		occluded += buffer.is_occluded(AABB(position, Vector3(1, 1, 1)));
+	}
+	uint64_t test_elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+	OS::get_singleton()->print("\t%d triangles: %.3f msec per frame\n", xforms.size() * 2, elapsed / 1000.0 / frames);
+	OS::get_singleton()->print("\t100000 AABB tests: %.3f msec, %d occluded\n", test_elapsed / 1000.0, occluded);
+	return true;
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+	test_occluded,
+	test_visible,
+	test_near_clip,
+	test_benchmark,
+	nullptr
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+	OS::get_singleton()->print("\n");
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+	return nullptr;
+}
+
+} // namespace TestOcclusionBuffer
@@ -30,9 +30,11 @@
 
 #include "test_physics_2d.h"
 
+#include "core/hashfuncs.h"
 #include "core/map.h"
 #include "core/os/main_loop.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/print_string.h"
 #include "scene/resources/texture.h"
 #include "servers/physics_2d_server.h"
@@ -402,4 +404,102 @@ namespace TestPhysics2D {
 MainLoop *test() {
 	return memnew(TestPhysics2DMainLoop);
 }
+
+// Steps piles of boxes resting on a static floor. Every pile is a constraint island of its own.
+// Returns a hash of the final body transforms, which must not depend on the thread count.
+static uint32_t _run_piles(int p_piles, int p_pile_height, int p_steps, uint64_t &r_usec) {
+	Physics2DServer *ps = Physics2DServer::get_singleton();
+
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	ps->area_set_param(space, Physics2DServer::AREA_PARAM_GRAVITY_VECTOR, Vector2(0, 1));
+	ps->area_set_param(space, Physics2DServer::AREA_PARAM_GRAVITY, 98);
+
+	RID floor_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(floor_shape, Vector2(p_piles * 32, 16));
+	RID floor = ps->body_create();
+	ps->body_set_mode(floor, Physics2DServer::BODY_MODE_STATIC);
+	ps->body_add_shape(floor, floor_shape);
+	ps->body_set_space(floor, space);
+	ps->body_set_state(floor, Physics2DServer::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(p_piles * 32, 16)));
+
+	RID box_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(box_shape, Vector2(12, 12));
+
+	Vector<RID> boxes;
+	for (int i = 0; i < p_piles; i++) {
+		for (int j = 0; j < p_pile_height; j++) {
+			RID box = ps->body_create();
+			ps->body_add_shape(box, box_shape);
+			ps->body_set_space(box, space);
+			ps->body_set_state(box, Physics2DServer::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(i * 64 + 32, -12 - j * 25)));
+			ps->body_set_state(box, Physics2DServer::BODY_STATE_CAN_SLEEP, false);
+			boxes.push_back(box);
+		}
+	}
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_steps; i++) {
+		ps->step(1.0 / 60.0);
+	}
+	r_usec = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+	uint32_t hash = 5381;
+	for (int i = 0; i < boxes.size(); i++) {
+		Transform2D xform = ps->body_get_state(boxes[i], Physics2DServer::BODY_STATE_TRANSFORM);
+		for (int j = 0; j < 3; j++) {
+			hash = hash_djb2_one_float(xform.elements[j].x, hash);
+			hash = hash_djb2_one_float(xform.elements[j].y, hash);
+		}
+		ps->free(boxes[i]);
+	}
+	ps->free(floor);
+	ps->free(box_shape);
+	ps->free(floor_shape);
+	ps->free(space);
+
+	return hash;
+}
+
+MainLoop *test_benchmark() {
+	const int piles = 256;
+	const int pile_height = 8;
+	const int steps = 120;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	int original_thread_count = pool->get_thread_count();
+
+	Vector<int> thread_counts;
+	thread_counts.push_back(1);
+	thread_counts.push_back(2);
+	thread_counts.push_back(4);
+	if (OS::get_singleton()->get_processor_count() > 4) {
+		thread_counts.push_back(OS::get_singleton()->get_processor_count());
+	}
+
+	Physics2DServer::get_singleton()->set_active(true);
+
+	uint32_t reference_hash = 0;
+	bool deterministic = true;
+	for (int i = 0; i < thread_counts.size(); i++) {
+		pool->finish();
+		pool->init(thread_counts[i]);
+
+		uint64_t usec;
+		uint32_t hash = _run_piles(piles, pile_height, steps, usec);
+		if (i == 0) {
+			reference_hash = hash;
+		} else if (hash != reference_hash) {
+			deterministic = false;
+		}
+
+		OS::get_singleton()->print("\t%d threads: %d bodies, %d steps in %.2f msec: %.1f bodies/msec\n", thread_counts[i], piles * pile_height, steps, usec / 1000.0, piles * pile_height * steps * 1000.0 / usec);
+	}
+
+	pool->finish();
+	pool->init(original_thread_count);
+
+	OS::get_singleton()->print("\t%s\n", deterministic ? "PASS" : "FAILED: results depend on the thread count");
+	return nullptr;
+}
 } // namespace TestPhysics2D
@@ -35,7 +35,9 @@
 #include "core/os/keyboard.h"
 #include "core/os/main_loop.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/print_string.h"
+#include "servers/visual/visual_server_scene.h"
 #include "servers/visual_server.h"
 
 #define OBJECT_COUNT 50
@@ -232,7 +234,304 @@ public:
 	}
 };
 
+// Keeps more instances in view than the old fixed cull buffer could hold, and reports the
+// average frame time. Meant to be run headless with the dummy rasterizer, so culling and
+// scene preparation make up most of the frame.
+class TestCullBenchmarkMainLoop : public MainLoop {
+	enum {
+		GRID_SIZE = 96,
+		GRID_LAYERS = 8,
+		WARMUP_FRAMES = 10,
+		MEASURED_FRAMES = 200,
+	};
+
+	RID scenario;
+	Vector<RID> cameras;
+	Vector<RID> viewports;
+	Vector<RID> instances;
+
+	int viewport_count;
+	int frame;
+	uint64_t begin_usec;
+
+public:
+	virtual void init() {
+		VisualServer *vs = VisualServer::get_singleton();
+		RID test_cube = vs->get_test_cube();
+		scenario = RID_PRIME(vs->scenario_create());
+
+		for (int z = 0; z < GRID_LAYERS; z++) {
+			for (int y = 0; y < GRID_SIZE; y++) {
+				for (int x = 0; x < GRID_SIZE; x++) {
+					RID instance = vs->instance_create2(test_cube, scenario);
+					vs->instance_set_transform(instance, Transform(Basis(), Vector3(x - GRID_SIZE / 2, y - GRID_SIZE / 2, -z) * 3));
+					instances.push_back(instance);
+				}
+			}
+		}
+
+		// Split the screen into vertical strips, each one looking at the grid from a different angle.
+		Size2i screen_size = OS::get_singleton()->get_window_size();
+		int strip_width = screen_size.x / viewport_count;
+
+		for (int i = 0; i < viewport_count; i++) {
+			RID camera = RID_PRIME(vs->camera_create());
+			Transform camera_xform(Basis(Vector3(0, 1, 0), (i - (viewport_count - 1) * 0.5) * 0.3), Vector3());
+			camera_xform.translate(0, 0, 200);
+			vs->camera_set_transform(camera, camera_xform);
+			vs->camera_set_perspective(camera, 90, 0.1, 1000);
+			cameras.push_back(camera);
+
+			RID viewport = RID_PRIME(vs->viewport_create());
+			vs->viewport_set_size(viewport, strip_width, screen_size.y);
+			vs->viewport_attach_to_screen(viewport, Rect2(strip_width * i, 0, strip_width, screen_size.y));
+			vs->viewport_set_active(viewport, true);
+			vs->viewport_attach_camera(viewport, camera);
+			vs->viewport_set_scenario(viewport, scenario);
+			viewports.push_back(viewport);
+		}
+
+		print_line("Culling " + itos(instances.size()) + " instances from " + itos(viewport_count) + " viewports");
+
+		frame = 0;
+		begin_usec = 0;
+	}
+
+	virtual bool iteration(float p_time) {
+		return false;
+	}
+
+	virtual bool idle(float p_time) {
+		frame++;
+		if (frame == WARMUP_FRAMES) {
+			begin_usec = OS::get_singleton()->get_ticks_usec();
+		} else if (frame == WARMUP_FRAMES + MEASURED_FRAMES) {
+			uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin_usec;
+			print_line("Average frame time: " + rtos(elapsed / 1000.0 / MEASURED_FRAMES) + " msec");
+			return true;
+		}
+		return false;
+	}
+
+	virtual void finish() {
+		VisualServer *vs = VisualServer::get_singleton();
+		for (int i = 0; i < instances.size(); i++) {
+			vs->free(instances[i]);
+		}
+		for (int i = 0; i < viewports.size(); i++) {
+			vs->free(viewports[i]);
+			vs->free(cameras[i]);
+		}
+		vs->free(scenario);
+	}
+
+	TestCullBenchmarkMainLoop(int p_viewport_count = 1) {
+		viewport_count = p_viewport_count;
+		frame = 0;
+		begin_usec = 0;
+	}
+};
+
+class TestCanvasBenchmarkMainLoop : public MainLoop {
+	enum {
+		LAYER_COUNT = 4,
+		PANEL_COUNT = 64,
+		PANEL_ITEMS = 80,
+		ITEM_COLUMNS = 8,
+		WARMUP_FRAMES = 10,
+		MEASURED_FRAMES = 200,
+	};
+
+	RID viewport;
+	Vector<RID> canvases;
+	Vector<RID> items;
+
+	int frame;
+	uint64_t begin_usec;
+
+public:
+	virtual void init() {
+		VisualServer *vs = VisualServer::get_singleton();
+
+		viewport = RID_PRIME(vs->viewport_create());
+		Size2i screen_size = OS::get_singleton()->get_window_size();
+		vs->viewport_set_size(viewport, screen_size.x, screen_size.y);
+		vs->viewport_attach_to_screen(viewport, Rect2(Vector2(), screen_size));
+		vs->viewport_set_active(viewport, true);
+
+		// Each layer is a long list of panels full of small controls, only a couple of panels are on screen.
+		int rows = PANEL_ITEMS / ITEM_COLUMNS;
+		for (int i = 0; i < LAYER_COUNT; i++) {
+			RID canvas = RID_PRIME(vs->canvas_create());
+			vs->viewport_attach_canvas(viewport, canvas);
+			vs->viewport_set_canvas_stacking(viewport, canvas, i, 0);
+			canvases.push_back(canvas);
+
+			for (int j = 0; j < PANEL_COUNT; j++) {
+				RID panel = vs->canvas_item_create();
+				vs->canvas_item_set_parent(panel, canvas);
+				vs->canvas_item_set_transform(panel, Transform2D(0, Vector2(i * 20, j * rows * 40)));
+				vs->canvas_item_add_rect(panel, Rect2(0, 0, ITEM_COLUMNS * 100, rows * 40), Color(0.2, 0.2, 0.2, 0.5));
+				items.push_back(panel);
+
+				for (int k = 0; k < PANEL_ITEMS; k++) {
+					RID item = vs->canvas_item_create();
+					vs->canvas_item_set_parent(item, panel);
+					vs->canvas_item_set_transform(item, Transform2D(0, Vector2((k % ITEM_COLUMNS) * 100, (k / ITEM_COLUMNS) * 40)));
+					vs->canvas_item_add_rect(item, Rect2(5, 5, 90, 30), Color(0.8, 0.8, 0.8, 0.5));
+					items.push_back(item);
+				}
+			}
+		}
+
+		print_line("Drawing " + itos(items.size()) + " canvas items in " + itos(LAYER_COUNT) + " layers");
+
+		frame = 0;
+		begin_usec = 0;
+	}
+
+	virtual bool iteration(float p_time) {
+		return false;
+	}
+
+	virtual bool idle(float p_time) {
+		// Scroll the layers, which moves the view without touching the items.
+		VisualServer *vs = VisualServer::get_singleton();
+		for (int i = 0; i < canvases.size(); i++) {
+			vs->viewport_set_canvas_transform(viewport, canvases[i], Transform2D(0, Vector2(0, -frame * (i + 1) * 10)));
+		}
+
+		frame++;
+		if (frame == WARMUP_FRAMES) {
+			begin_usec = OS::get_singleton()->get_ticks_usec();
+		} else if (frame == WARMUP_FRAMES + MEASURED_FRAMES) {
+			uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin_usec;
+			print_line("Average frame time: " + rtos(elapsed / 1000.0 / MEASURED_FRAMES) + " msec");
+			return true;
+		}
+		return false;
+	}
+
+	virtual void finish() {
+		VisualServer *vs = VisualServer::get_singleton();
+		for (int i = 0; i < items.size(); i++) {
+			vs->free(items[i]);
+		}
+		for (int i = 0; i < canvases.size(); i++) {
+			vs->free(canvases[i]);
+		}
+		vs->free(viewport);
+	}
+};
+
 MainLoop *test() {
 	return memnew(TestMainLoop);
 }
+
+MainLoop *test_cull_benchmark() {
+	return memnew(TestCullBenchmarkMainLoop);
+}
+
+MainLoop *test_multi_viewport_cull_benchmark() {
+	return memnew(TestCullBenchmarkMainLoop(4));
+}
+
+MainLoop *test_canvas_benchmark() {
+	return memnew(TestCanvasBenchmarkMainLoop);
+}
+
+struct ConcurrentCullData {
+	VisualServerScene::SpatialPartitioningScene *partitioning;
+	Vector<Plane> planes;
+	Vector<Vector<VisualServerScene::Instance *>> results;
+};
+
+static void _concurrent_cull(void *p_userdata, uint32_t p_index) {
+	ConcurrentCullData *data = (ConcurrentCullData *)p_userdata;
+	Vector<VisualServerScene::Instance *> &result = data->results.write[p_index];
+
+	int count = data->partitioning->cull_convex_concurrent(data->planes, result.ptrw(), result.size());
+	result.resize(MAX(count, 0));
+	result.sort();
+}
+
+static bool _same_instances(const Vector<VisualServerScene::Instance *> &p_a, const Vector<VisualServerScene::Instance *> &p_b) {
+	if (p_a.size() != p_b.size()) {
+		return false;
+	}
+	for (int i = 0; i < p_a.size(); i++) {
+		if (p_a[i] != p_b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+MainLoop *test_concurrent_cull() {
+	OS::get_singleton()->print("\n\nTest: Concurrent camera cull matches the serial cull\n");
+
+	const int grid_size = 12;
+	const int result_max = grid_size * grid_size * grid_size;
+	const int cull_count = 8;
+
+	VisualServerScene::SpatialPartitioningScene_BVH partitioning;
+	Vector<VisualServerScene::Instance *> instances;
+
+	for (int x = 0; x < grid_size; x++) {
+		for (int y = 0; y < grid_size; y++) {
+			for (int z = 0; z < grid_size; z++) {
+				VisualServerScene::Instance *instance = memnew(VisualServerScene::Instance);
+				Vector3 pos = Vector3(x - grid_size / 2, y - grid_size / 2, z - grid_size / 2) * 3.0;
+				instance->spatial_partition_id = partitioning.create(instance, AABB(pos, Vector3(1, 1, 1)), 0, false, 1 << VS::INSTANCE_MESH, 0);
+				instances.push_back(instance);
+			}
+		}
+	}
+	partitioning.update();
+
+	CameraMatrix projection;
+	projection.set_perspective(60, 1.0, 0.1, 20.0);
+	Transform camera_xform;
+	camera_xform.rotate(Vector3(0, 1, 0), 0.4);
+
+	ConcurrentCullData data;
+	data.partitioning = &partitioning;
+	data.planes = projection.get_projection_planes(camera_xform);
+
+	Vector<VisualServerScene::Instance *> serial;
+	serial.resize(result_max);
+	serial.resize(partitioning.cull_convex(data.planes, serial.ptrw(), result_max));
+	serial.sort();
+
+	data.results.resize(cull_count);
+	for (int i = 0; i < cull_count; i++) {
+		data.results.write[i].resize(result_max);
+	}
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool) {
+		pool->wait_for_task_completion(pool->add_native_group_task(&_concurrent_cull, &data, cull_count));
+	} else {
+		for (int i = 0; i < cull_count; i++) {
+			_concurrent_cull(&data, i);
+		}
+	}
+
+	bool pass = serial.size() > 0 && serial.size() < instances.size();
+	for (int i = 0; i < cull_count; i++) {
+		if (!_same_instances(data.results[i], serial)) {
+			OS::get_singleton()->print("\tCull %d returned %d instances, serial cull returned %d\n", i, data.results[i].size(), serial.size());
+			pass = false;
+		}
+	}
+
+	for (int i = 0; i < instances.size(); i++) {
+		partitioning.erase(instances[i]->spatial_partition_id);
+		memdelete(instances[i]);
+	}
+
+	OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+	return nullptr;
+}
+
 } // namespace TestRender
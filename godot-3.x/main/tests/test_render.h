@@ -36,6 +36,10 @@
 namespace TestRender {
 
 MainLoop *test();
+MainLoop *test_cull_benchmark();
+MainLoop *test_multi_viewport_cull_benchmark();
+MainLoop *test_canvas_benchmark();
+MainLoop *test_concurrent_cull();
 }
 
 #endif
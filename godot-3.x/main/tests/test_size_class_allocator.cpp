@@ -0,0 +1,289 @@
+/*************************************************************************/
+/*  test_size_class_allocator.cpp                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_size_class_allocator.h"
+
+#include "core/os/os.h"
+#include "core/os/size_class_allocator.h"
+#include "core/os/thread.h"
+#include "scene/main/node.h"
+#include "scene/resources/packed_scene.h"
+
+#include <stdlib.h>
+
+namespace TestSizeClassAllocator {
+
+enum {
+	THREAD_COUNT = 4,
+	BLOCK_COUNT = 4096,
+};
+
+static uint64_t _get_used_blocks() {
+	SizeClassAllocator::thread_exit(); // Blocks cached by this thread count as used.
+	uint64_t used = 0;
+	for (int i = 0; i < SizeClassAllocator::SIZE_CLASS_COUNT; i++) {
+		SizeClassAllocator::Stats stats;
+		SizeClassAllocator::get_stats(i, stats);
+		used += stats.used_blocks;
+	}
+	return used;
+}
+
+bool test_size_classes() {
+	OS::get_singleton()->print("\n\nTest 1: Size classes fit the requested sizes\n");
+
+	for (int i = 1; i <= SizeClassAllocator::MAX_BLOCK_SIZE; i++) {
+		int size_class = SizeClassAllocator::get_size_class(i);
+		if (size_class < 0 || size_class >= SizeClassAllocator::SIZE_CLASS_COUNT) {
+			OS::get_singleton()->print("\tNo size class for %d bytes\n", i);
+			return false;
+		}
+		bool fits = SizeClassAllocator::get_class_block_size(size_class) >= uint32_t(i);
+		bool smallest = size_class == 0 || SizeClassAllocator::get_class_block_size(size_class - 1) < uint32_t(i);
+		if (!fits || !smallest) {
+			OS::get_singleton()->print("\tWrong size class %d for %d bytes\n", size_class, i);
+			return false;
+		}
+	}
+	return SizeClassAllocator::get_size_class(SizeClassAllocator::MAX_BLOCK_SIZE + 1) == -1;
+}
+
+bool test_alloc_free() {
+	OS::get_singleton()->print("\n\nTest 2: Blocks are aligned, don't overlap and go back to the free lists\n");
+
+	uint64_t used_before = _get_used_blocks();
+
+	uint8_t *blocks[BLOCK_COUNT];
+	int classes[BLOCK_COUNT];
+	for (int i = 0; i < BLOCK_COUNT; i++) {
+		classes[i] = i % SizeClassAllocator::SIZE_CLASS_COUNT;
+		blocks[i] = (uint8_t *)SizeClassAllocator::alloc(classes[i]);
+		memset(blocks[i], i & 0xFF, SizeClassAllocator::get_class_block_size(classes[i]));
+	}
+
+	bool ok = true;
+	for (int i = 0; i < BLOCK_COUNT; i++) {
+		ok = ok && ((uintptr_t)blocks[i] & 15) == 0;
+		uint32_t size = SizeClassAllocator::get_class_block_size(classes[i]);
+		for (uint32_t j = 0; j < size; j++) {
+			ok = ok && blocks[i][j] == (i & 0xFF);
+		}
+	}
+	ok = ok && _get_used_blocks() == used_before + BLOCK_COUNT;
+
+	for (int i = 0; i < BLOCK_COUNT; i++) {
+		SizeClassAllocator::free(blocks[i], classes[i]);
+	}
+	ok = ok && _get_used_blocks() == used_before;
+
+	// Vectors grow through several size classes before leaving them.
+	Vector<int> values;
+	for (int i = 0; i < 1000; i++) {
+		values.push_back(i);
+	}
+	for (int i = 0; i < values.size(); i++) {
+		ok = ok && values[i] == i;
+	}
+	return ok;
+}
+
+struct CrossThreadData {
+	void *blocks[BLOCK_COUNT];
+};
+
+static void _alloc_blocks(void *p_userdata) {
+	CrossThreadData *data = (CrossThreadData *)p_userdata;
+	for (int i = 0; i < BLOCK_COUNT; i++) {
+		data->blocks[i] = SizeClassAllocator::alloc(i % SizeClassAllocator::SIZE_CLASS_COUNT);
+	}
+	// Only engine_allocator builds flush the thread caches on exit by themselves.
+	SizeClassAllocator::thread_exit();
+}
+
+static void _free_blocks(void *p_userdata) {
+	CrossThreadData *data = (CrossThreadData *)p_userdata;
+	for (int i = 0; i < BLOCK_COUNT; i++) {
+		SizeClassAllocator::free(data->blocks[i], i % SizeClassAllocator::SIZE_CLASS_COUNT);
+	}
+	SizeClassAllocator::thread_exit();
+}
+
+bool test_cross_thread() {
+	OS::get_singleton()->print("\n\nTest 3: Blocks freed by another thread than the one allocating them\n");
+
+	uint64_t used_before = _get_used_blocks();
+
+	CrossThreadData data[THREAD_COUNT];
+	Thread threads[THREAD_COUNT];
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		threads[i].start(_alloc_blocks, &data[i]);
+	}
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		threads[i].wait_to_finish();
+	}
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		// Each thread frees the blocks of the next one.
+		threads[i].start(_free_blocks, &data[(i + 1) % THREAD_COUNT]);
+	}
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	return _get_used_blocks() == used_before;
+}
+
+struct BenchmarkData {
+	bool use_malloc = false;
+};
+
+static int _benchmark_size(int p_index) {
+	// Mostly tiny blocks, like list elements and map nodes.
+	return 16 + (p_index * 37) % (p_index % 8 == 0 ? SizeClassAllocator::MAX_BLOCK_SIZE - 16 : 96);
+}
+
+static void _benchmark_churn(void *p_userdata) {
+	BenchmarkData *data = (BenchmarkData *)p_userdata;
+	void *blocks[256];
+	for (int r = 0; r < 4000; r++) {
+		for (int i = 0; i < 256; i++) {
+			int size = _benchmark_size(i);
+			blocks[i] = data->use_malloc ? malloc(size) : SizeClassAllocator::alloc(SizeClassAllocator::get_size_class(size));
+		}
+		for (int i = 0; i < 256; i++) {
+			int size = _benchmark_size(i);
+			if (data->use_malloc) {
+				free(blocks[i]);
+			} else {
+				SizeClassAllocator::free(blocks[i], SizeClassAllocator::get_size_class(size));
+			}
+		}
+	}
+}
+
+bool test_benchmark() {
+	OS::get_singleton()->print("\n\nTest 4: Allocation benchmark against malloc\n");
+
+	for (int m = 0; m < 2; m++) {
+		for (int thread_count = 1; thread_count <= THREAD_COUNT; thread_count *= 2) {
+			BenchmarkData data;
+			data.use_malloc = m == 1;
+			Thread threads[THREAD_COUNT];
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < thread_count; i++) {
+				threads[i].start(_benchmark_churn, &data);
+			}
+			for (int i = 0; i < thread_count; i++) {
+				threads[i].wait_to_finish();
+			}
+			uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+			double total = double(thread_count) * 4000 * 256;
+			OS::get_singleton()->print("\t%s, %d threads: %.2f million alloc/free pairs/sec\n", data.use_malloc ? "malloc" : "size classes", thread_count, total / elapsed);
+		}
+	}
+	return true;
+}
+
+bool test_benchmark_instancing() {
+	OS::get_singleton()->print("\n\nTest 5: Scene instancing benchmark\n");
+
+	Node *root = memnew(Node);
+	root->set_name("Root");
+	for (int i = 0; i < 100; i++) {
+		Node *child = memnew(Node);
+		child->set_name("Child" + itos(i));
+		root->add_child(child);
+		child->set_owner(root);
+		for (int j = 0; j < 10; j++) {
+			Node *leaf = memnew(Node);
+			leaf->set_name("Leaf" + itos(j));
+			child->add_child(leaf);
+			leaf->set_owner(root);
+		}
+	}
+
+	Ref<PackedScene> scene;
+	scene.instance();
+	Error err = scene->pack(root);
+	memdelete(root);
+	if (err != OK) {
+		return false;
+	}
+
+	const int count = 200;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		Node *instance = scene->instance();
+		memdelete(instance);
+	}
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+#ifdef ENGINE_ALLOCATOR_ENABLED
+	const char *allocator = "size classes";
+#else
+	const char *allocator = "malloc";
+#endif
+	OS::get_singleton()->print("\t%s: instanced and freed a %d node scene %d times in %.1f msec\n", allocator, 1101, count, elapsed / 1000.0);
+	return true;
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+	test_size_classes,
+	test_alloc_free,
+	test_cross_thread,
+	test_benchmark,
+	test_benchmark_instancing,
+	nullptr
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+	OS::get_singleton()->print("\n");
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+	return nullptr;
+}
+
+} // namespace TestSizeClassAllocator
@@ -0,0 +1,221 @@
+/*************************************************************************/
+/*  test_string_name.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_string_name.h"
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string_name.h"
+
+namespace TestStringName {
+
+enum {
+	THREAD_COUNT = 8,
+	NAME_COUNT = 2048,
+};
+
+struct InternData {
+	const void *pointers[NAME_COUNT];
+	int rounds = 0;
+};
+
+static void _intern_names(void *p_userdata) {
+	InternData *data = (InternData *)p_userdata;
+	for (int r = 0; r < data->rounds; r++) {
+		for (int i = 0; i < NAME_COUNT; i++) {
+			// Built from a fresh String every time, so the table has to be searched.
+			StringName name = String("name_") + itos(i);
+			if (r == 0) {
+				data->pointers[i] = name.data_unique_pointer();
+			} else if (data->pointers[i] != name.data_unique_pointer()) {
+				data->pointers[i] = nullptr;
+			}
+		}
+	}
+}
+
+bool test_pointer_equality() {
+	OS::get_singleton()->print("\n\nTest 1: Same names interned from several threads are the same pointer\n");
+
+	// Kept alive here, so every thread must find exactly these entries.
+	Vector<StringName> names;
+	for (int i = 0; i < NAME_COUNT; i++) {
+		names.push_back(String("name_") + itos(i));
+	}
+
+	InternData data[THREAD_COUNT];
+	Thread threads[THREAD_COUNT];
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		data[i].rounds = 20;
+		threads[i].start(_intern_names, &data[i]);
+	}
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	for (int t = 0; t < THREAD_COUNT; t++) {
+		for (int i = 0; i < NAME_COUNT; i++) {
+			if (data[t].pointers[i] != names[i].data_unique_pointer()) {
+				OS::get_singleton()->print("\tMismatch for \"%s\" on thread %d\n", String(names[i]).utf8().get_data(), t);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+struct ChurnData {
+	int thread_index = 0;
+	bool ok = true;
+};
+
+static void _churn_names(void *p_userdata) {
+	ChurnData *data = (ChurnData *)p_userdata;
+	for (int r = 0; r < 200; r++) {
+		for (int i = 0; i < 64; i++) {
+			// Names shared by all threads are created and released at the same time
+			// by several of them, which races the last unref against new lookups.
+			StringName shared = String("churn_shared_") + itos(i);
+			StringName copy = String("churn_shared_") + itos(i);
+			StringName own = String("churn_") + itos(data->thread_index) + "_" + itos(i);
+			if (shared != copy || String(shared) != "churn_shared_" + itos(i) || String(own) != "churn_" + itos(data->thread_index) + "_" + itos(i)) {
+				data->ok = false;
+			}
+		}
+	}
+}
+
+bool test_churn() {
+	OS::get_singleton()->print("\n\nTest 2: Names created and released concurrently\n");
+
+	ChurnData data[THREAD_COUNT];
+	Thread threads[THREAD_COUNT];
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		data[i].thread_index = i;
+		threads[i].start(_churn_names, &data[i]);
+	}
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	bool ok = true;
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		ok = ok && data[i].ok;
+	}
+	// Nothing holds them anymore, so they must be gone from the table.
+	for (int i = 0; i < 64; i++) {
+		ok = ok && StringName::search(String("churn_shared_") + itos(i)) == StringName();
+		ok = ok && StringName::search(String("churn_0_") + itos(i)) == StringName();
+	}
+	return ok;
+}
+
+struct BenchmarkData {
+	const String *strings = nullptr;
+	int count = 0;
+	int rounds = 0;
+};
+
+static void _benchmark_intern(void *p_userdata) {
+	BenchmarkData *data = (BenchmarkData *)p_userdata;
+	for (int r = 0; r < data->rounds; r++) {
+		for (int i = 0; i < data->count; i++) {
+			StringName name = data->strings[i];
+		}
+	}
+}
+
+bool test_benchmark() {
+	OS::get_singleton()->print("\n\nTest 3: Interning benchmark\n");
+
+	Vector<String> strings;
+	Vector<StringName> names;
+	for (int i = 0; i < NAME_COUNT; i++) {
+		strings.push_back("bench_" + itos(i));
+		// Half of them already exist, the other half is added and removed every time.
+		if (i % 2 == 0) {
+			names.push_back(strings[i]);
+		}
+	}
+
+	const int rounds = 200;
+	for (int thread_count = 1; thread_count <= THREAD_COUNT; thread_count *= 2) {
+		BenchmarkData data;
+		data.strings = strings.ptr();
+		data.count = strings.size();
+		data.rounds = rounds;
+
+		Thread threads[THREAD_COUNT];
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < thread_count; i++) {
+			threads[i].start(_benchmark_intern, &data);
+		}
+		for (int i = 0; i < thread_count; i++) {
+			threads[i].wait_to_finish();
+		}
+		uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+		double total = double(thread_count) * rounds * strings.size();
+		OS::get_singleton()->print("\t%d threads: %.2f million names/sec\n", thread_count, total / elapsed);
+	}
+	return true;
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+	test_pointer_equality,
+	test_churn,
+	test_benchmark,
+	nullptr
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+	OS::get_singleton()->print("\n");
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+	return nullptr;
+}
+
+} // namespace TestStringName
@@ -0,0 +1,198 @@
+/*************************************************************************/
+/*  test_worker_thread_pool.cpp                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_worker_thread_pool.h"
+
+#include "core/os/os.h"
+#include "core/os/threaded_array_processor.h"
+#include "core/os/worker_thread_pool.h"
+
+namespace TestWorkerThreadPool {
+
+struct Counter {
+	LocalVector<uint32_t> values;
+	SafeNumeric<uint32_t> calls;
+
+	void process(uint32_t p_index, uint32_t p_multiplier) {
+		values[p_index] = p_index * p_multiplier;
+		calls.increment();
+	}
+};
+
+bool test_group_task() {
+	Counter counter;
+	counter.values.resize(10000);
+
+	WorkerThreadPool::TaskID task = WorkerThreadPool::get_singleton()->add_template_group_task(&counter, &Counter::process, 3u, counter.values.size(), 64);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+
+	bool ok = counter.calls.get() == counter.values.size();
+	for (uint32_t i = 0; i < counter.values.size(); i++) {
+		ok = ok && counter.values[i] == i * 3;
+	}
+	return ok;
+}
+
+bool test_thread_process_array() {
+	Counter counter;
+	counter.values.resize(1000);
+	thread_process_array(counter.values.size(), &counter, &Counter::process, 2u);
+
+	bool ok = counter.calls.get() == counter.values.size();
+	for (uint32_t i = 0; i < counter.values.size(); i++) {
+		ok = ok && counter.values[i] == i * 2;
+	}
+	return ok;
+}
+
+struct Chain {
+	SafeNumeric<uint32_t> step;
+	bool in_order = true;
+};
+
+static void _chain_step(void *p_userdata) {
+	Chain *chain = (Chain *)p_userdata;
+	chain->step.increment();
+}
+
+static void _chain_check(void *p_userdata) {
+	Chain *chain = (Chain *)p_userdata;
+	if (chain->step.get() != 2) {
+		chain->in_order = false;
+	}
+	chain->step.increment();
+}
+
+bool test_dependencies() {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	Chain chain;
+
+	Vector<WorkerThreadPool::TaskID> first;
+	first.push_back(pool->add_native_task(_chain_step, &chain));
+	first.push_back(pool->add_native_task(_chain_step, &chain));
+	WorkerThreadPool::TaskID last = pool->add_native_task(_chain_check, &chain, first);
+
+	pool->wait_for_task_completion(last);
+	for (int i = 0; i < first.size(); i++) {
+		pool->wait_for_task_completion(first[i]);
+	}
+	return chain.in_order && chain.step.get() == 3;
+}
+
+static void _nested_inner(void *p_userdata, uint32_t p_index) {
+	((SafeNumeric<uint32_t> *)p_userdata)->increment();
+}
+
+static void _nested_outer(void *p_userdata, uint32_t p_index) {
+	// Waiting from inside a task must not deadlock, even when all workers do it at once.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	WorkerThreadPool::TaskID task = pool->add_native_group_task(_nested_inner, p_userdata, 100);
+	pool->wait_for_task_completion(task);
+}
+
+bool test_nested_wait() {
+	SafeNumeric<uint32_t> count;
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	WorkerThreadPool::TaskID task = pool->add_native_group_task(_nested_outer, &count, 64);
+	pool->wait_for_task_completion(task);
+	return count.get() == 64 * 100;
+}
+
+struct Dummy {
+	uint32_t *values = nullptr;
+
+	void process(uint32_t p_index, uint32_t p_unused) {
+		values[p_index] += p_index;
+	}
+};
+
+bool test_dispatch_benchmark() {
+	const uint32_t element_counts[] = { 1, 64, 4096 };
+	const int iterations = 200;
+
+	OS::get_singleton()->print("\tworker threads: %d, logical cores: %d\n", WorkerThreadPool::get_singleton()->get_thread_count(), OS::get_singleton()->get_processor_count());
+
+	for (uint32_t c = 0; c < sizeof(element_counts) / sizeof(element_counts[0]); c++) {
+		uint32_t elements = element_counts[c];
+		LocalVector<uint32_t> values;
+		values.resize(elements);
+		Dummy dummy;
+		dummy.values = values.ptr();
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			thread_process_array_unpooled(elements, &dummy, &Dummy::process, 0u);
+		}
+		uint64_t unpooled = OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			thread_process_array(elements, &dummy, &Dummy::process, 0u);
+		}
+		uint64_t pooled = OS::get_singleton()->get_ticks_usec() - begin;
+
+		OS::get_singleton()->print("\t%5d elements: spawning threads %8.2f usec/call, worker pool %8.2f usec/call\n", elements, double(unpooled) / iterations, double(pooled) / iterations);
+	}
+	return true;
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+	test_group_task,
+	test_thread_process_array,
+	test_dependencies,
+	test_nested_wait,
+	test_dispatch_benchmark,
+	nullptr
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+	OS::get_singleton()->print("\n");
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+	return nullptr;
+}
+
+} // namespace TestWorkerThreadPool
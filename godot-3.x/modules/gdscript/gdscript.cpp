@@ -35,9 +35,9 @@
 #include "core/global_constants.h"
 #include "core/io/file_access_encrypted.h"
 #include "core/os/file_access.h"
-#include "core/os/os.h"
 #include "core/project_settings.h"
 #include "gdscript_compiler.h"
+#include "gdscript_sampling_profiler.h"
 
 ///////////////////////////
 
@@ -960,6 +960,8 @@ GDScript::~GDScript() {
 	for (Map<StringName, GDScriptFunction *>::Element *E = member_functions.front(); E; E = E->next()) {
 		memdelete(E->get());
 	}
+	// Call sites may have cached functions or members of this script, keyed by its address.
+	GDScriptLanguage::get_singleton()->invalidate_inline_caches();
 
 	_save_orphaned_subclasses();
 
@@ -1449,6 +1451,17 @@ Error GDScriptLanguage::execute_file(const String &p_path) {
 	return OK;
 }
 void GDScriptLanguage::finish() {
+	if (sampling_profile_path != String()) {
+		GDScriptSamplingProfiler::stop();
+		GDScriptSamplingProfiler::save(sampling_profile_path);
+	}
+	GDScriptSamplingProfiler::finish();
+}
+
+void GDScriptLanguage::start_sampling_profiler(const String &p_output_path) {
+	ERR_FAIL_COND(p_output_path == String());
+	sampling_profile_path = p_output_path;
+	GDScriptSamplingProfiler::start(GLOBAL_GET("debug/gdscript/profiler/sampling_interval_usec"));
 }
 
 void GDScriptLanguage::profiling_start() {
@@ -2107,6 +2120,7 @@ GDScriptLanguage::GDScriptLanguage() {
 
 	profiling = false;
 	script_frame_time = 0;
+	inline_cache_generation.set(1);
 
 	_debug_call_stack_pos = 0;
 	int dmcs = GLOBAL_DEF("debug/settings/gdscript/max_call_stack", 1024);
@@ -2128,12 +2142,16 @@ GDScriptLanguage::GDScriptLanguage() {
 	GLOBAL_DEF("debug/gdscript/warnings/treat_warnings_as_errors", false);
 	GLOBAL_DEF("debug/gdscript/warnings/exclude_addons", true);
 	GLOBAL_DEF("debug/gdscript/completion/autocomplete_setters_and_getters", false);
+	GLOBAL_DEF("debug/gdscript/compiler/dump_bytecode", false);
 	for (int i = 0; i < (int)GDScriptWarning::WARNING_MAX; i++) {
 		String warning = GDScriptWarning::get_name_from_code((GDScriptWarning::Code)i).to_lower();
 		bool default_enabled = !warning.begins_with("unsafe_") && i != GDScriptWarning::UNUSED_CLASS_VARIABLE;
 		GLOBAL_DEF("debug/gdscript/warnings/" + warning, default_enabled);
 	}
 #endif // DEBUG_ENABLED
+
+	GLOBAL_DEF("debug/gdscript/profiler/sampling_interval_usec", 1000);
+	ProjectSettings::get_singleton()->set_custom_property_info("debug/gdscript/profiler/sampling_interval_usec", PropertyInfo(Variant::INT, "debug/gdscript/profiler/sampling_interval_usec", PROPERTY_HINT_RANGE, "50,100000,1,or_greater"));
 }
 
 GDScriptLanguage::~GDScriptLanguage() {
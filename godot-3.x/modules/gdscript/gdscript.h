@@ -360,12 +360,20 @@ class GDScriptLanguage : public ScriptLanguage {
 	SelfList<GDScriptFunction>::List function_list;
 	bool profiling;
 	uint64_t script_frame_time;
+	String sampling_profile_path;
+
+	SafeNumeric<uint32_t> inline_cache_generation;
 
 	Map<String, ObjectID> orphan_subclasses;
 
 public:
 	int calls;
 
+	// Bumped whenever compiled functions or member layouts are discarded, which
+	// makes every call site drop what it cached in GDScriptFunction::InlineCache.
+	_FORCE_INLINE_ uint32_t get_inline_cache_generation() const { return inline_cache_generation.get(); }
+	_FORCE_INLINE_ void invalidate_inline_caches() { inline_cache_generation.increment(); }
+
 	bool debug_break(const String &p_error, bool p_allow_continue = true);
 	bool debug_break_parse(const String &p_file, int p_line, const String &p_error);
 
@@ -504,6 +512,9 @@ public:
 	virtual void profiling_start();
 	virtual void profiling_stop();
 
+	// Runs the sampling profiler until finish(), which saves the samples to p_output_path.
+	void start_sampling_profiler(const String &p_output_path);
+
 	virtual int profiling_get_accumulated_data(ProfilingInfo *p_info_arr, int p_info_max);
 	virtual int profiling_get_frame_data(ProfilingInfo *p_info_arr, int p_info_max);
 
@@ -30,6 +30,7 @@
 
 #include "gdscript_compiler.h"
 
+#include "core/project_settings.h"
 #include "gdscript.h"
 
 bool GDScriptCompiler::_is_class_member_property(CodeGen &codegen, const StringName &p_name) {
@@ -74,6 +75,60 @@ void GDScriptCompiler::_set_error(const String &p_error, const GDScriptParser::N
 	}
 }
 
+Variant::Type GDScriptCompiler::_get_builtin_type(const GDScriptParser::Node *p_node) const {
+	GDScriptParser::DataType datatype = p_node->get_datatype();
+	if (datatype.has_type && datatype.kind == GDScriptParser::DataType::BUILTIN) {
+		return datatype.builtin_type;
+	}
+	return Variant::NIL;
+}
+
+GDScriptFunction::Opcode GDScriptCompiler::_get_operator_opcode(Variant::Operator p_op, Variant::Type p_type_a, Variant::Type p_type_b) const {
+	// Specialized opcodes skip Variant::evaluate() when the operand types
+	// are known. They still check the types at runtime and fall back to the
+	// generic path, so a wrong guess is only slower, never incorrect.
+	switch (p_op) {
+		case Variant::OP_EQUAL:
+		case Variant::OP_NOT_EQUAL:
+		case Variant::OP_ADD:
+		case Variant::OP_SUBTRACT:
+		case Variant::OP_MULTIPLY:
+		case Variant::OP_DIVIDE:
+		case Variant::OP_NEGATE: {
+			if (p_type_a == Variant::VECTOR3 && p_type_b == Variant::VECTOR3) {
+				return GDScriptFunction::OPCODE_OPERATOR_VECTOR3;
+			}
+			if (p_type_a == Variant::VECTOR3 && p_type_b == Variant::REAL && (p_op == Variant::OP_MULTIPLY || p_op == Variant::OP_DIVIDE)) {
+				return GDScriptFunction::OPCODE_OPERATOR_VECTOR3;
+			}
+			FALLTHROUGH;
+		}
+		case Variant::OP_LESS:
+		case Variant::OP_LESS_EQUAL:
+		case Variant::OP_GREATER:
+		case Variant::OP_GREATER_EQUAL: {
+			if (p_type_a == Variant::INT && p_type_b == Variant::INT) {
+				return GDScriptFunction::OPCODE_OPERATOR_INT;
+			}
+			if (p_type_a == Variant::REAL && p_type_b == Variant::REAL) {
+				return GDScriptFunction::OPCODE_OPERATOR_REAL;
+			}
+		} break;
+		case Variant::OP_MODULE:
+		case Variant::OP_BIT_AND:
+		case Variant::OP_BIT_OR:
+		case Variant::OP_BIT_XOR: {
+			if (p_type_a == Variant::INT && p_type_b == Variant::INT) {
+				return GDScriptFunction::OPCODE_OPERATOR_INT;
+			}
+		} break;
+		default: {
+		} break;
+	}
+
+	return GDScriptFunction::OPCODE_OPERATOR;
+}
+
 bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level) {
 	ERR_FAIL_COND_V(on->arguments.size() != 1, false);
 
@@ -82,7 +137,8 @@ bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptPa
 		return false;
 	}
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+	Variant::Type type = _get_builtin_type(on->arguments[0]);
+	codegen.opcodes.push_back(_get_operator_opcode(op, type, type)); // perform operator
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_a); // argument 2 (repeated)
@@ -106,13 +162,163 @@ bool GDScriptCompiler::_create_binary_operator(CodeGen &codegen, const GDScriptP
 		return false;
 	}
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+	codegen.opcodes.push_back(_get_operator_opcode(op, _get_builtin_type(on->arguments[0]), _get_builtin_type(on->arguments[1]))); // perform operator
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_b); // argument 2 (unary only takes one parameter)
 	return true;
 }
 
+int GDScriptCompiler::_create_jump_if_not(CodeGen &codegen, const GDScriptParser::Node *p_condition, int p_stack_level) {
+	// Comparisons of two ints or two floats jump directly, without storing
+	// the boolean result first. Returns the position of the jump address.
+	if (p_condition->type == GDScriptParser::Node::TYPE_OPERATOR) {
+		const GDScriptParser::OperatorNode *on = static_cast<const GDScriptParser::OperatorNode *>(p_condition);
+		Variant::Operator op = Variant::OP_MAX;
+
+		switch (on->op) {
+			case GDScriptParser::OperatorNode::OP_EQUAL:
+				op = Variant::OP_EQUAL;
+				break;
+			case GDScriptParser::OperatorNode::OP_NOT_EQUAL:
+				op = Variant::OP_NOT_EQUAL;
+				break;
+			case GDScriptParser::OperatorNode::OP_LESS:
+				op = Variant::OP_LESS;
+				break;
+			case GDScriptParser::OperatorNode::OP_LESS_EQUAL:
+				op = Variant::OP_LESS_EQUAL;
+				break;
+			case GDScriptParser::OperatorNode::OP_GREATER:
+				op = Variant::OP_GREATER;
+				break;
+			case GDScriptParser::OperatorNode::OP_GREATER_EQUAL:
+				op = Variant::OP_GREATER_EQUAL;
+				break;
+			default:
+				break;
+		}
+
+		if (op != Variant::OP_MAX && on->arguments.size() == 2) {
+			Variant::Type type_a = _get_builtin_type(on->arguments[0]);
+			Variant::Type type_b = _get_builtin_type(on->arguments[1]);
+			GDScriptFunction::Opcode opcode = GDScriptFunction::OPCODE_END;
+			if (type_a == Variant::INT && type_b == Variant::INT) {
+				opcode = GDScriptFunction::OPCODE_JUMP_IF_NOT_COMPARE_INT;
+			} else if (type_a == Variant::REAL && type_b == Variant::REAL) {
+				opcode = GDScriptFunction::OPCODE_JUMP_IF_NOT_COMPARE_REAL;
+			}
+
+			if (opcode != GDScriptFunction::OPCODE_END) {
+				int slevel = p_stack_level;
+				int src_address_a = _parse_expression(codegen, on->arguments[0], slevel);
+				if (src_address_a < 0) {
+					return -1;
+				}
+				if (src_address_a & GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) {
+					slevel++; //uses stack for return, increase stack
+				}
+
+				int src_address_b = _parse_expression(codegen, on->arguments[1], slevel);
+				if (src_address_b < 0) {
+					return -1;
+				}
+
+				codegen.opcodes.push_back(opcode);
+				codegen.opcodes.push_back(op);
+				codegen.opcodes.push_back(src_address_a);
+				codegen.opcodes.push_back(src_address_b);
+				codegen.opcodes.push_back(0); //temporary
+				return codegen.opcodes.size() - 1;
+			}
+		}
+	}
+
+	int ret = _parse_expression(codegen, p_condition, p_stack_level, false);
+	if (ret < 0) {
+		return -1;
+	}
+
+	codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT);
+	codegen.opcodes.push_back(ret);
+	codegen.opcodes.push_back(0); //temporary
+	return codegen.opcodes.size() - 1;
+}
+
+StringName GDScriptCompiler::_get_native_class(const GDScriptParser::DataType &p_datatype) const {
+	if (!p_datatype.has_type || p_datatype.is_meta_type) {
+		return StringName();
+	}
+
+	switch (p_datatype.kind) {
+		case GDScriptParser::DataType::NATIVE: {
+			return p_datatype.native_type;
+		} break;
+		case GDScriptParser::DataType::SCRIPT:
+		case GDScriptParser::DataType::GDSCRIPT: {
+			if (p_datatype.script_type.is_valid()) {
+				return p_datatype.script_type->get_instance_base_type();
+			}
+		} break;
+		case GDScriptParser::DataType::CLASS: {
+			if (p_datatype.class_type) {
+				return _get_native_class(p_datatype.class_type->base_type);
+			}
+		} break;
+		default: {
+		}
+	}
+	return StringName();
+}
+
+MethodBind *GDScriptCompiler::_get_ptrcall_method(CodeGen &codegen, const GDScriptParser::OperatorNode *p_call) const {
+#ifdef PTRCALL_ENABLED
+	// The receiver's native class must be known, and the method must be a
+	// regular bind the arguments can be passed to as they are. The VM still
+	// checks the receiver and argument types, and uses the regular call when
+	// they don't match.
+	const GDScriptParser::Node *base = p_call->arguments[0];
+	StringName native_class;
+	if (base->type == GDScriptParser::Node::TYPE_SELF) {
+		if (!codegen.function_node || codegen.function_node->_static) {
+			return nullptr;
+		}
+		native_class = _get_native_class(codegen.class_node->base_type);
+	} else {
+		native_class = _get_native_class(base->get_datatype());
+	}
+	if (native_class == StringName()) {
+		return nullptr;
+	}
+
+	const StringName &method_name = static_cast<const GDScriptParser::IdentifierNode *>(p_call->arguments[1])->name;
+	MethodBind *method = ClassDB::get_method(native_class, method_name);
+	int argc = p_call->arguments.size() - 2;
+	if (!method || method->is_vararg() || method->get_argument_count() != argc) {
+		return nullptr;
+	}
+
+	// Objects are excluded, the ptrcall layout of Object * and Ref<T> differs.
+	if (method->has_return() && method->get_argument_type(-1) == Variant::OBJECT) {
+		return nullptr;
+	}
+	for (int i = 0; i < argc; i++) {
+		Variant::Type type = method->get_argument_type(i);
+		if (type == Variant::OBJECT) {
+			return nullptr;
+		}
+
+		GDScriptParser::DataType arg_type = p_call->arguments[i + 2]->get_datatype();
+		if (type != Variant::NIL && arg_type.has_type && (arg_type.kind != GDScriptParser::DataType::BUILTIN || arg_type.builtin_type != type)) {
+			return nullptr; // Would always need a conversion.
+		}
+	}
+	return method;
+#else
+	return nullptr;
+#endif
+}
+
 GDScriptDataType GDScriptCompiler::_gdtype_from_datatype(const GDScriptParser::DataType &p_datatype, GDScript *p_owner) const {
 	if (!p_datatype.has_type) {
 		return GDScriptDataType();
@@ -668,11 +874,22 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							arguments.push_back(ret);
 						}
 
-						codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
+						MethodBind *ptrcall_method = _get_ptrcall_method(codegen, on);
+						if (ptrcall_method) {
+							codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL_METHOD_BIND : GDScriptFunction::OPCODE_CALL_METHOD_BIND_RETURN);
+						} else {
+							codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
+						}
 						codegen.opcodes.push_back(on->arguments.size() - 2);
 						codegen.alloc_call(on->arguments.size() - 2);
 						for (int i = 0; i < arguments.size(); i++) {
 							codegen.opcodes.push_back(arguments[i]);
+							if (i == 1) {
+								codegen.opcodes.push_back(codegen.alloc_inline_cache()); // after the method name
+								if (ptrcall_method) {
+									codegen.opcodes.push_back(codegen.get_method_bind_pos(ptrcall_method));
+								}
+							}
 						}
 					}
 				} break;
@@ -761,9 +978,18 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						}
 					}
 
-					codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET); // perform operator
+					if (named) {
+						codegen.opcodes.push_back(GDScriptFunction::OPCODE_GET_NAMED); // perform operator
+					} else {
+						Variant::Type from_type = _get_builtin_type(on->arguments[0]);
+						bool array_index = (from_type == Variant::ARRAY || from_type == Variant::POOL_REAL_ARRAY || from_type == Variant::POOL_INT_ARRAY) && _get_builtin_type(on->arguments[1]) == Variant::INT;
+						codegen.opcodes.push_back(array_index ? GDScriptFunction::OPCODE_GET_ARRAY_INDEX : GDScriptFunction::OPCODE_GET); // perform operator
+					}
 					codegen.opcodes.push_back(from); // argument 1
 					codegen.opcodes.push_back(index); // argument 2 (unary only takes one parameter)
+					if (named) {
+						codegen.opcodes.push_back(codegen.alloc_inline_cache());
+					}
 
 				} break;
 				case GDScriptParser::OperatorNode::OP_AND: {
@@ -1106,6 +1332,9 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET);
 							codegen.opcodes.push_back(prev_pos);
 							codegen.opcodes.push_back(key_idx);
+							if (named) {
+								codegen.opcodes.push_back(codegen.alloc_inline_cache());
+							}
 							slevel++;
 							codegen.alloc_stack(slevel);
 							int dst_pos = (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) | slevel;
@@ -1114,6 +1343,9 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 
 							//add in reverse order, since it will be reverted
 
+							if (named) {
+								setchain.push_back(codegen.alloc_inline_cache());
+							}
 							setchain.push_back(dst_pos);
 							setchain.push_back(key_idx);
 							setchain.push_back(prev_pos);
@@ -1153,6 +1385,9 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						codegen.opcodes.push_back(prev_pos);
 						codegen.opcodes.push_back(set_index);
 						codegen.opcodes.push_back(set_value);
+						if (named) {
+							codegen.opcodes.push_back(codegen.alloc_inline_cache());
+						}
 
 						for (int i = 0; i < setchain.size(); i++) {
 							codegen.opcodes.push_back(setchain[i]);
@@ -1410,15 +1645,29 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 					} break;
 
 					case GDScriptParser::ControlFlowNode::CF_IF: {
-						int ret2 = _parse_expression(codegen, cf->arguments[0], p_stack_level, false);
-						if (ret2 < 0) {
-							return ERR_PARSE_ERROR;
+						if (cf->arguments[0]->type == GDScriptParser::Node::TYPE_CONSTANT) {
+							// Condition was folded by the parser, only the branch that can run is compiled.
+							bool taken = static_cast<const GDScriptParser::ConstantNode *>(cf->arguments[0])->value.booleanize();
+							const GDScriptParser::BlockNode *block = taken ? cf->body : cf->body_else;
+							if (block) {
+								if (!taken) {
+									codegen.opcodes.push_back(GDScriptFunction::OPCODE_LINE);
+									codegen.opcodes.push_back(block->line);
+									codegen.current_line = block->line;
+								}
+
+								Error err = _parse_block(codegen, block, p_stack_level, p_break_addr, p_continue_addr);
+								if (err) {
+									return err;
+								}
+							}
+							break;
 						}
 
-						codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-						codegen.opcodes.push_back(ret2);
-						int else_addr = codegen.opcodes.size();
-						codegen.opcodes.push_back(0); //temporary
+						int else_addr = _create_jump_if_not(codegen, cf->arguments[0], p_stack_level);
+						if (else_addr < 0) {
+							return ERR_PARSE_ERROR;
+						}
 
 						Error err = _parse_block(codegen, cf->body, p_stack_level, p_break_addr, p_continue_addr);
 						if (err) {
@@ -1501,6 +1750,12 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 
 					} break;
 					case GDScriptParser::ControlFlowNode::CF_WHILE: {
+						bool constant_condition = cf->arguments[0]->type == GDScriptParser::Node::TYPE_CONSTANT;
+						if (constant_condition && !static_cast<const GDScriptParser::ConstantNode *>(cf->arguments[0])->value.booleanize()) {
+							// Never entered, no code needed.
+							break;
+						}
+
 						codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP);
 						codegen.opcodes.push_back(codegen.opcodes.size() + 3);
 						int break_addr = codegen.opcodes.size();
@@ -1508,13 +1763,13 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 						codegen.opcodes.push_back(0);
 						int continue_addr = codegen.opcodes.size();
 
-						int ret2 = _parse_expression(codegen, cf->arguments[0], p_stack_level, false);
-						if (ret2 < 0) {
-							return ERR_PARSE_ERROR;
+						if (!constant_condition) {
+							int exit_addr = _create_jump_if_not(codegen, cf->arguments[0], p_stack_level);
+							if (exit_addr < 0) {
+								return ERR_PARSE_ERROR;
+							}
+							codegen.opcodes.write[exit_addr] = break_addr;
 						}
-						codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-						codegen.opcodes.push_back(ret2);
-						codegen.opcodes.push_back(break_addr);
 						Error err = _parse_block(codegen, cf->body, p_stack_level, break_addr, continue_addr);
 						if (err) {
 							return err;
@@ -1631,6 +1886,7 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	codegen.stack_max = 0;
 	codegen.current_line = 0;
 	codegen.call_max = 0;
+	codegen.inline_cache_count = 0;
 	codegen.debug_stack = ScriptDebugger::get_singleton() != nullptr;
 	Vector<StringName> argnames;
 
@@ -1806,6 +2062,14 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 		gdfunc->_default_arg_ptr = nullptr;
 	}
 
+	gdfunc->inline_caches.resize(codegen.inline_cache_count);
+	gdfunc->_inline_caches_ptr = gdfunc->inline_caches.ptr();
+	gdfunc->_inline_cache_count = codegen.inline_cache_count;
+
+	gdfunc->method_binds = codegen.method_binds;
+	gdfunc->_method_binds_ptr = gdfunc->method_binds.ptr();
+	gdfunc->_method_bind_count = gdfunc->method_binds.size();
+
 	gdfunc->_argument_count = p_func ? p_func->arguments.size() : 0;
 	gdfunc->_stack_size = codegen.stack_max;
 	gdfunc->_call_size = codegen.call_max;
@@ -1894,6 +2158,7 @@ Error GDScriptCompiler::_parse_class_level(GDScript *p_script, const GDScriptPar
 	}
 	p_script->member_functions.clear();
 	p_script->member_indices.clear();
+	GDScriptLanguage::get_singleton()->invalidate_inline_caches();
 	p_script->member_info.clear();
 	p_script->_signals.clear();
 	p_script->initializer = nullptr;
@@ -2219,9 +2484,29 @@ Error GDScriptCompiler::compile(const GDScriptParser *p_parser, GDScript *p_scri
 		return err;
 	}
 
+#ifdef DEBUG_ENABLED
+	if (GLOBAL_GET("debug/gdscript/compiler/dump_bytecode").booleanize()) {
+		_dump_bytecode(p_script, p_script->get_source_code().split("\n"));
+	}
+#endif
+
 	return OK;
 }
 
+#ifdef DEBUG_ENABLED
+void GDScriptCompiler::_dump_bytecode(const GDScript *p_script, const Vector<String> &p_code_lines) {
+	print_line("** CLASS " + p_script->fully_qualified_name + " **");
+
+	for (const Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
+		print_line(E->get()->disassemble(p_code_lines));
+	}
+
+	for (const Map<StringName, Ref<GDScript>>::Element *E = p_script->subclasses.front(); E; E = E->next()) {
+		_dump_bytecode(E->get().ptr(), p_code_lines);
+	}
+}
+#endif
+
 String GDScriptCompiler::get_error() const {
 	return error;
 }
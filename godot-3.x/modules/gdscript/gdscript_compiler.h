@@ -129,10 +129,24 @@ class GDScriptCompiler {
 				call_max = p_params;
 			}
 		}
+		int alloc_inline_cache() {
+			return inline_cache_count++;
+		}
+
+		Vector<MethodBind *> method_binds;
+		int get_method_bind_pos(MethodBind *p_method) {
+			int pos = method_binds.find(p_method);
+			if (pos == -1) {
+				pos = method_binds.size();
+				method_binds.push_back(p_method);
+			}
+			return pos;
+		}
 
 		int current_line;
 		int stack_max;
 		int call_max;
+		int inline_cache_count;
 	};
 
 	bool _is_class_member_property(CodeGen &codegen, const StringName &p_name);
@@ -140,8 +154,15 @@ class GDScriptCompiler {
 
 	void _set_error(const String &p_error, const GDScriptParser::Node *p_node);
 
+	Variant::Type _get_builtin_type(const GDScriptParser::Node *p_node) const;
+	GDScriptFunction::Opcode _get_operator_opcode(Variant::Operator p_op, Variant::Type p_type_a, Variant::Type p_type_b) const;
+
 	bool _create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level);
 	bool _create_binary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level, bool p_initializer = false, int p_index_addr = 0);
+	int _create_jump_if_not(CodeGen &codegen, const GDScriptParser::Node *p_condition, int p_stack_level);
+
+	StringName _get_native_class(const GDScriptParser::DataType &p_datatype) const;
+	MethodBind *_get_ptrcall_method(CodeGen &codegen, const GDScriptParser::OperatorNode *p_call) const;
 
 	GDScriptDataType _gdtype_from_datatype(const GDScriptParser::DataType &p_datatype, GDScript *p_owner = nullptr) const;
 
@@ -152,6 +173,9 @@ class GDScriptCompiler {
 	Error _parse_class_level(GDScript *p_script, const GDScriptParser::ClassNode *p_class, bool p_keep_state);
 	Error _parse_class_blocks(GDScript *p_script, const GDScriptParser::ClassNode *p_class, bool p_keep_state);
 	void _make_scripts(GDScript *p_script, const GDScriptParser::ClassNode *p_class, bool p_keep_state);
+#ifdef DEBUG_ENABLED
+	void _dump_bytecode(const GDScript *p_script, const Vector<String> &p_code_lines);
+#endif
 	int err_line;
 	int err_column;
 	StringName source;
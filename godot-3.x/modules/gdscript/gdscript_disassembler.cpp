@@ -0,0 +1,561 @@
+/*************************************************************************/
+/*  gdscript_disassembler.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_function.h"
+
+#ifdef DEBUG_ENABLED
+
+#include "gdscript.h"
+#include "gdscript_functions.h"
+
+String GDScriptFunction::_disassemble_addr(int p_addr) const {
+	int addr = p_addr & ADDR_MASK;
+
+	switch (p_addr >> ADDR_BITS) {
+		case ADDR_TYPE_SELF: {
+			return "self";
+		} break;
+		case ADDR_TYPE_CLASS: {
+			return "class";
+		} break;
+		case ADDR_TYPE_MEMBER: {
+			return "member(" + _script->debug_get_member_by_index(addr) + ")";
+		} break;
+		case ADDR_TYPE_CLASS_CONSTANT: {
+			return "class_const(" + get_global_name(addr) + ")";
+		} break;
+		case ADDR_TYPE_LOCAL_CONSTANT: {
+			Variant v = get_constant(addr);
+			String txt;
+			if (v.get_type() == Variant::STRING || v.get_type() == Variant::NODE_PATH) {
+				txt = "\"" + String(v) + "\"";
+			} else if (v.get_type() == Variant::OBJECT && Object::cast_to<GDScriptNativeClass>(v.operator Object *())) {
+				txt = Object::cast_to<GDScriptNativeClass>(v.operator Object *())->get_name();
+			} else if (v.get_type() == Variant::OBJECT && Object::cast_to<Script>(v.operator Object *())) {
+				Script *script = Object::cast_to<Script>(v.operator Object *());
+				txt = script->get_path() != "" ? script->get_path() : "<script>";
+			} else {
+				txt = v;
+			}
+			return "const(" + txt + ")";
+		} break;
+		case ADDR_TYPE_STACK: {
+			return "stack(" + itos(addr) + ")";
+		} break;
+		case ADDR_TYPE_STACK_VARIABLE: {
+			return "var_stack(" + itos(addr) + ")";
+		} break;
+		case ADDR_TYPE_GLOBAL: {
+			const Map<StringName, int> &globals = GDScriptLanguage::get_singleton()->get_global_map();
+			for (const Map<StringName, int>::Element *E = globals.front(); E; E = E->next()) {
+				if (E->get() == addr) {
+					return "global(" + String(E->key()) + ")";
+				}
+			}
+			return "global(" + itos(addr) + ")";
+		} break;
+#ifdef TOOLS_ENABLED
+		case ADDR_TYPE_NAMED_GLOBAL: {
+			ERR_FAIL_INDEX_V(addr, _named_globals_count, "<err>");
+			return "named_global(" + String(_named_globals_ptr[addr]) + ")";
+		} break;
+#endif
+		case ADDR_TYPE_NIL: {
+			return "nil";
+		} break;
+	}
+
+	return "<err>";
+}
+
+String GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
+	String defargs;
+	if (get_default_argument_count()) {
+		defargs = "defarg at: ";
+		for (int i = 0; i < get_default_argument_count(); i++) {
+			if (i > 0) {
+				defargs += ",";
+			}
+			defargs += itos(get_default_argument_addr(i));
+		}
+		defargs += " ";
+	}
+	String out = "== function " + String(get_name()) + "() :: stack size: " + itos(get_max_stack_size()) + " " + defargs + "==\n";
+
+#define DADDR(m_ip) (_disassemble_addr(_code_ptr[ip + m_ip]))
+
+	for (int ip = 0; ip < _code_size;) {
+		int incr = 0;
+		String txt = itos(ip) + " ";
+
+		switch (_code_ptr[ip]) {
+			case OPCODE_OPERATOR:
+			case OPCODE_OPERATOR_INT:
+			case OPCODE_OPERATOR_REAL:
+			case OPCODE_OPERATOR_VECTOR3: {
+				int op = _code_ptr[ip + 1];
+				switch (_code_ptr[ip]) {
+					case OPCODE_OPERATOR_INT:
+						txt += " op (int) ";
+						break;
+					case OPCODE_OPERATOR_REAL:
+						txt += " op (float) ";
+						break;
+					case OPCODE_OPERATOR_VECTOR3:
+						txt += " op (Vector3) ";
+						break;
+					default:
+						txt += " op ";
+						break;
+				}
+
+				String opname = Variant::get_operator_name(Variant::Operator(op));
+
+				txt += DADDR(4);
+				txt += " = ";
+				txt += DADDR(2);
+				txt += " " + opname + " ";
+				txt += DADDR(3);
+				incr += 5;
+
+			} break;
+			case OPCODE_EXTENDS_TEST: {
+				txt += " is ";
+				txt += DADDR(3);
+				txt += " = ";
+				txt += DADDR(1);
+				txt += " is ";
+				txt += DADDR(2);
+				incr += 4;
+
+			} break;
+			case OPCODE_IS_BUILTIN: {
+				txt += " is builtin ";
+				txt += DADDR(3);
+				txt += " = ";
+				txt += DADDR(1);
+				txt += " is ";
+				txt += Variant::get_type_name(Variant::Type(_code_ptr[ip + 2]));
+				incr += 4;
+
+			} break;
+			case OPCODE_SET: {
+				txt += "set ";
+				txt += DADDR(1);
+				txt += "[";
+				txt += DADDR(2);
+				txt += "]=";
+				txt += DADDR(3);
+				incr += 4;
+
+			} break;
+			case OPCODE_GET:
+			case OPCODE_GET_ARRAY_INDEX: {
+				txt += _code_ptr[ip] == OPCODE_GET_ARRAY_INDEX ? " get (array) " : " get ";
+				txt += DADDR(3);
+				txt += "=";
+				txt += DADDR(1);
+				txt += "[";
+				txt += DADDR(2);
+				txt += "]";
+				incr += 4;
+
+			} break;
+			case OPCODE_SET_NAMED: {
+				txt += " set_named ";
+				txt += DADDR(1);
+				txt += "[\"";
+				txt += get_global_name(_code_ptr[ip + 2]);
+				txt += "\"]=";
+				txt += DADDR(3);
+				incr += 5;
+
+			} break;
+			case OPCODE_GET_NAMED: {
+				txt += " get_named ";
+				txt += DADDR(4);
+				txt += "=";
+				txt += DADDR(1);
+				txt += "[\"";
+				txt += get_global_name(_code_ptr[ip + 2]);
+				txt += "\"]";
+				incr += 5;
+
+			} break;
+			case OPCODE_SET_MEMBER: {
+				txt += " set_member ";
+				txt += "[\"";
+				txt += get_global_name(_code_ptr[ip + 1]);
+				txt += "\"]=";
+				txt += DADDR(2);
+				incr += 3;
+
+			} break;
+			case OPCODE_GET_MEMBER: {
+				txt += " get_member ";
+				txt += DADDR(2);
+				txt += "=";
+				txt += "[\"";
+				txt += get_global_name(_code_ptr[ip + 1]);
+				txt += "\"]";
+				incr += 3;
+
+			} break;
+			case OPCODE_ASSIGN: {
+				txt += " assign ";
+				txt += DADDR(1);
+				txt += "=";
+				txt += DADDR(2);
+				incr += 3;
+
+			} break;
+			case OPCODE_ASSIGN_TRUE: {
+				txt += " assign ";
+				txt += DADDR(1);
+				txt += "= true";
+				incr += 2;
+
+			} break;
+			case OPCODE_ASSIGN_FALSE: {
+				txt += " assign ";
+				txt += DADDR(1);
+				txt += "= false";
+				incr += 2;
+
+			} break;
+			case OPCODE_ASSIGN_TYPED_BUILTIN: {
+				txt += " assign typed builtin (";
+				txt += Variant::get_type_name((Variant::Type)_code_ptr[ip + 1]);
+				txt += ") ";
+				txt += DADDR(2);
+				txt += " = ";
+				txt += DADDR(3);
+				incr += 4;
+
+			} break;
+			case OPCODE_ASSIGN_TYPED_NATIVE:
+			case OPCODE_ASSIGN_TYPED_SCRIPT: {
+				txt += _code_ptr[ip] == OPCODE_ASSIGN_TYPED_NATIVE ? " assign typed native (" : " assign typed script (";
+				txt += DADDR(1);
+				txt += ") ";
+				txt += DADDR(2);
+				txt += " = ";
+				txt += DADDR(3);
+				incr += 4;
+
+			} break;
+			case OPCODE_CAST_TO_BUILTIN: {
+				txt += " cast ";
+				txt += DADDR(3);
+				txt += "=";
+				txt += DADDR(2);
+				txt += " as ";
+				txt += Variant::get_type_name(Variant::Type(_code_ptr[ip + 1]));
+				incr += 4;
+
+			} break;
+			case OPCODE_CAST_TO_NATIVE:
+			case OPCODE_CAST_TO_SCRIPT: {
+				txt += " cast ";
+				txt += DADDR(3);
+				txt += "=";
+				txt += DADDR(2);
+				txt += " as ";
+				txt += DADDR(1);
+				incr += 4;
+
+			} break;
+			case OPCODE_CONSTRUCT: {
+				Variant::Type t = Variant::Type(_code_ptr[ip + 1]);
+				int argc = _code_ptr[ip + 2];
+
+				txt += " construct ";
+				txt += DADDR(3 + argc);
+				txt += " = ";
+
+				txt += Variant::get_type_name(t) + "(";
+				for (int i = 0; i < argc; i++) {
+					if (i > 0) {
+						txt += ", ";
+					}
+					txt += DADDR(i + 3);
+				}
+				txt += ")";
+
+				incr = 4 + argc;
+
+			} break;
+			case OPCODE_CONSTRUCT_ARRAY: {
+				int argc = _code_ptr[ip + 1];
+				txt += " make_array ";
+				txt += DADDR(2 + argc);
+				txt += " = [ ";
+
+				for (int i = 0; i < argc; i++) {
+					if (i > 0) {
+						txt += ", ";
+					}
+					txt += DADDR(2 + i);
+				}
+
+				txt += "]";
+
+				incr += 3 + argc;
+
+			} break;
+			case OPCODE_CONSTRUCT_DICTIONARY: {
+				int argc = _code_ptr[ip + 1];
+				txt += " make_dict ";
+				txt += DADDR(2 + argc * 2);
+				txt += " = { ";
+
+				for (int i = 0; i < argc; i++) {
+					if (i > 0) {
+						txt += ", ";
+					}
+					txt += DADDR(2 + i * 2 + 0);
+					txt += ":";
+					txt += DADDR(2 + i * 2 + 1);
+				}
+
+				txt += "}";
+
+				incr += 3 + argc * 2;
+
+			} break;
+
+			case OPCODE_CALL:
+			case OPCODE_CALL_RETURN:
+			case OPCODE_CALL_METHOD_BIND:
+			case OPCODE_CALL_METHOD_BIND_RETURN: {
+				bool ret = _code_ptr[ip] == OPCODE_CALL_RETURN || _code_ptr[ip] == OPCODE_CALL_METHOD_BIND_RETURN;
+				bool method_bind = _code_ptr[ip] == OPCODE_CALL_METHOD_BIND || _code_ptr[ip] == OPCODE_CALL_METHOD_BIND_RETURN;
+				int args_ofs = method_bind ? 6 : 5;
+
+				if (ret) {
+					txt += " call-ret ";
+				} else {
+					txt += " call ";
+				}
+				if (method_bind) {
+					txt += "(ptrcall) ";
+				}
+
+				int argc = _code_ptr[ip + 1];
+				if (ret) {
+					txt += DADDR(args_ofs + argc) + "=";
+				}
+
+				txt += DADDR(2) + ".";
+				txt += String(get_global_name(_code_ptr[ip + 3]));
+				txt += "(";
+
+				for (int i = 0; i < argc; i++) {
+					if (i > 0) {
+						txt += ", ";
+					}
+					txt += DADDR(args_ofs + i);
+				}
+				txt += ")";
+
+				incr = args_ofs + 1 + argc;
+
+			} break;
+			case OPCODE_CALL_BUILT_IN: {
+				txt += " call-built-in ";
+
+				int argc = _code_ptr[ip + 2];
+				txt += DADDR(3 + argc) + "=";
+
+				txt += GDScriptFunctions::get_func_name(GDScriptFunctions::Function(_code_ptr[ip + 1]));
+				txt += "(";
+
+				for (int i = 0; i < argc; i++) {
+					if (i > 0) {
+						txt += ", ";
+					}
+					txt += DADDR(3 + i);
+				}
+				txt += ")";
+
+				incr = 4 + argc;
+
+			} break;
+			case OPCODE_CALL_SELF: {
+				txt += " call-self ";
+
+				int argc = _code_ptr[ip + 2];
+				txt += DADDR(3 + argc) + "=";
+
+				txt += "self(" + itos(_code_ptr[ip + 1]) + ")(";
+
+				for (int i = 0; i < argc; i++) {
+					if (i > 0) {
+						txt += ", ";
+					}
+					txt += DADDR(3 + i);
+				}
+				txt += ")";
+
+				incr = 4 + argc;
+
+			} break;
+			case OPCODE_CALL_SELF_BASE: {
+				txt += " call-self-base ";
+
+				int argc = _code_ptr[ip + 2];
+				txt += DADDR(3 + argc) + "=";
+
+				txt += get_global_name(_code_ptr[ip + 1]);
+				txt += "(";
+
+				for (int i = 0; i < argc; i++) {
+					if (i > 0) {
+						txt += ", ";
+					}
+					txt += DADDR(3 + i);
+				}
+				txt += ")";
+
+				incr = 4 + argc;
+
+			} break;
+			case OPCODE_YIELD: {
+				txt += " yield ";
+				incr = 1;
+
+			} break;
+			case OPCODE_YIELD_SIGNAL: {
+				txt += " yield_signal ";
+				txt += DADDR(1);
+				txt += ",";
+				txt += DADDR(2);
+				incr = 3;
+			} break;
+			case OPCODE_YIELD_RESUME: {
+				txt += " yield resume: ";
+				txt += DADDR(1);
+				incr = 2;
+			} break;
+			case OPCODE_JUMP: {
+				txt += " jump ";
+				txt += itos(_code_ptr[ip + 1]);
+
+				incr = 2;
+
+			} break;
+			case OPCODE_JUMP_IF: {
+				txt += " jump-if ";
+				txt += DADDR(1);
+				txt += " to ";
+				txt += itos(_code_ptr[ip + 2]);
+
+				incr = 3;
+			} break;
+			case OPCODE_JUMP_IF_NOT: {
+				txt += " jump-if-not ";
+				txt += DADDR(1);
+				txt += " to ";
+				txt += itos(_code_ptr[ip + 2]);
+
+				incr = 3;
+			} break;
+			case OPCODE_JUMP_IF_NOT_COMPARE_INT:
+			case OPCODE_JUMP_IF_NOT_COMPARE_REAL: {
+				txt += _code_ptr[ip] == OPCODE_JUMP_IF_NOT_COMPARE_INT ? " jump-if-not (int) " : " jump-if-not (float) ";
+				txt += DADDR(2);
+				txt += " " + Variant::get_operator_name(Variant::Operator(_code_ptr[ip + 1])) + " ";
+				txt += DADDR(3);
+				txt += " to ";
+				txt += itos(_code_ptr[ip + 4]);
+
+				incr = 5;
+			} break;
+			case OPCODE_JUMP_TO_DEF_ARGUMENT: {
+				txt += " jump-to-default-argument ";
+				incr = 1;
+			} break;
+			case OPCODE_RETURN: {
+				txt += " return ";
+				txt += DADDR(1);
+
+				incr = 2;
+
+			} break;
+			case OPCODE_ITERATE_BEGIN: {
+				txt += " for-init " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(_code_ptr[ip + 3]);
+				incr += 5;
+
+			} break;
+			case OPCODE_ITERATE: {
+				txt += " for-loop " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(_code_ptr[ip + 3]);
+				incr += 5;
+
+			} break;
+			case OPCODE_BREAKPOINT: {
+				txt += " breakpoint";
+				incr += 1;
+			} break;
+			case OPCODE_LINE: {
+				int line = _code_ptr[ip + 1] - 1;
+				if (line >= 0 && line < p_code_lines.size()) {
+					txt = "\n" + itos(line + 1) + ": " + p_code_lines[line] + "\n";
+				} else {
+					txt = "";
+				}
+				incr += 2;
+			} break;
+			case OPCODE_END: {
+				txt += " end";
+				incr += 1;
+			} break;
+			case OPCODE_ASSERT: {
+				txt += " assert ";
+				txt += DADDR(1);
+				incr += 2;
+
+			} break;
+		}
+		if (incr == 0) {
+			ERR_BREAK_MSG(true, "Unhandled opcode: " + itos(_code_ptr[ip]));
+		}
+
+		ip += incr;
+		if (txt != "") {
+			out += txt + "\n";
+		}
+	}
+
+#undef DADDR
+
+	return out;
+}
+
+#endif // DEBUG_ENABLED
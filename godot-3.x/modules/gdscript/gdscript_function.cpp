@@ -30,9 +30,13 @@
 
 #include "gdscript_function.h"
 
+#include "core/class_db.h"
+#include "core/core_string_names.h"
 #include "core/os/os.h"
+#include "core/variant_internal.h"
 #include "gdscript.h"
 #include "gdscript_functions.h"
+#include "gdscript_sampling_profiler.h"
 
 Variant *GDScriptFunction::_get_variant(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant &static_ref, Variant *p_stack, String &r_error) const {
 	int address = p_address & ADDR_MASK;
@@ -183,14 +187,333 @@ String GDScriptFunction::_get_call_error(const Variant::CallError &p_err, const
 	return err_text;
 }
 
+// Returns false if p_base can't be cached: not an object, freed, or carrying
+// a script instance that isn't GDScript (those dispatch on their own).
+static _FORCE_INLINE_ bool _get_inline_cache_receiver(const Variant *p_base, Object *&r_object, GDScriptInstance *&r_instance) {
+	if (p_base->get_type() != Variant::OBJECT) {
+		return false;
+	}
+
+	r_object = p_base->operator Object *();
+	if (unlikely(!r_object)) {
+		return false;
+	}
+
+	ScriptInstance *si = r_object->get_script_instance();
+	if (!si) {
+		r_instance = nullptr;
+		return true;
+	}
+	if (si->get_language() != GDScriptLanguage::get_singleton() || si->is_placeholder()) {
+		return false;
+	}
+
+	r_instance = static_cast<GDScriptInstance *>(si);
+	return true;
+}
+
+void GDScriptFunction::_resolve_call(InlineCache::Entry *r_entry, Object *p_object, GDScript *p_script, const StringName &p_method) {
+	for (GDScript *sptr = p_script; sptr; sptr = sptr->_base) {
+		const Map<StringName, GDScriptFunction *>::Element *E = sptr->member_functions.find(p_method);
+		if (E) {
+			r_entry->kind = InlineCache::KIND_SCRIPT_FUNCTION;
+			r_entry->function = E->get();
+			return;
+		}
+	}
+
+	// free() is special cased by Object::call(), and scripts override call() to dispatch their static functions.
+	if (p_method == CoreStringNames::get_singleton()->_free || Object::cast_to<Script>(p_object)) {
+		return;
+	}
+
+	MethodBind *method = ClassDB::get_method(p_object->get_class_name(), p_method);
+	if (method) {
+		r_entry->kind = InlineCache::KIND_METHOD_BIND;
+		r_entry->method = method;
+	}
+}
+
+void GDScriptFunction::_resolve_get_named(InlineCache::Entry *r_entry, Object *p_object, GDScript *p_script, const StringName &p_name) {
+	if (p_script) {
+		const Map<StringName, GDScript::MemberInfo>::Element *E = p_script->member_indices.find(p_name);
+		if (E) {
+			if (!E->get().getter) {
+				r_entry->kind = InlineCache::KIND_MEMBER;
+				r_entry->index = E->get().index;
+			}
+			return;
+		}
+
+		// Script constants and _get() come before native properties.
+		for (const GDScript *sptr = p_script; sptr; sptr = sptr->_base) {
+			if (sptr->constants.has(p_name) || sptr->member_functions.has(GDScriptLanguage::get_singleton()->strings._get)) {
+				return;
+			}
+		}
+	}
+
+	const ClassDB::PropertySetGet *psg = ClassDB::get_property_setget(p_object->get_class_name(), p_name);
+	if (!psg || !psg->getter) {
+		return;
+	}
+
+	bool is_constant = false;
+	ClassDB::get_integer_constant(p_object->get_class_name(), p_name, &is_constant);
+	if (is_constant) {
+		return;
+	}
+
+	MethodBind *getter = psg->_getptr;
+	if (psg->index >= 0) {
+		// Indexed getters go through Object::call(), where a script could intercept them.
+		if (p_script) {
+			return;
+		}
+		getter = ClassDB::get_method(p_object->get_class_name(), psg->getter);
+	}
+
+	if (getter) {
+		r_entry->kind = InlineCache::KIND_PROPERTY;
+		r_entry->index = psg->index;
+		r_entry->method = getter;
+	}
+}
+
+void GDScriptFunction::_resolve_set_named(InlineCache::Entry *r_entry, Object *p_object, GDScript *p_script, const StringName &p_name) {
+	if (p_script) {
+		const Map<StringName, GDScript::MemberInfo>::Element *E = p_script->member_indices.find(p_name);
+		if (E) {
+			if (!E->get().setter) {
+				r_entry->kind = InlineCache::KIND_MEMBER;
+				r_entry->index = E->get().index;
+				r_entry->member_type = &E->get().data_type;
+			}
+			return;
+		}
+
+		for (const GDScript *sptr = p_script; sptr; sptr = sptr->_base) {
+			if (sptr->member_functions.has(GDScriptLanguage::get_singleton()->strings._set)) {
+				return;
+			}
+		}
+	}
+
+	const ClassDB::PropertySetGet *psg = ClassDB::get_property_setget(p_object->get_class_name(), p_name);
+	if (psg && psg->setter && psg->_setptr) {
+		r_entry->kind = InlineCache::KIND_PROPERTY;
+		r_entry->index = psg->index;
+		r_entry->method = psg->_setptr;
+	}
+}
+
+bool GDScriptFunction::_call_cached(InlineCache &p_cache, const Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, Variant::CallError &r_err, MethodBind *p_ptrcall_method) {
+	Object *obj;
+	GDScriptInstance *instance;
+	if (!_get_inline_cache_receiver(p_base, obj, instance)) {
+		return false;
+	}
+
+	const StringName *native_class = &obj->get_class_name();
+	GDScript *script = instance ? instance->script.ptr() : nullptr;
+	const InlineCache::Entry *e = p_cache.find(native_class, script, GDScriptLanguage::get_singleton()->get_inline_cache_generation());
+	if (unlikely(!e)) {
+		InlineCache::Entry *added = p_cache.add(native_class, script);
+		_resolve_call(added, obj, script, p_method);
+		e = added;
+	}
+
+	// The callee may run this same site again and replace the entry, so don't touch it past this point.
+	Variant ret;
+	r_err.error = Variant::CallError::CALL_OK;
+	switch (e->kind) {
+		case InlineCache::KIND_SCRIPT_FUNCTION: {
+			GDScriptFunction *function = e->function;
+#ifdef DEBUG_ENABLED
+			_ObjectDebugLock debug_lock(obj);
+#endif
+			ret = function->call(instance, p_args, p_argcount, r_err);
+		} break;
+		case InlineCache::KIND_METHOD_BIND: {
+			MethodBind *method = e->method;
+#ifdef DEBUG_ENABLED
+			_ObjectDebugLock debug_lock(obj);
+#endif
+#ifdef PTRCALL_ENABLED
+			// Only the bind the compiler checked the signature of is called directly.
+			// The result goes straight into r_ret, unless overwriting it could
+			// release an object (possibly the receiver) while it's still locked.
+			if (method == p_ptrcall_method) {
+				bool in_place = !r_ret || r_ret->get_type() != Variant::OBJECT;
+				if (_ptrcall(method, obj, p_args, p_argcount, in_place ? r_ret : &ret)) {
+					if (in_place) {
+						return true;
+					}
+					break;
+				}
+			}
+#endif
+			ret = method->call(obj, p_args, p_argcount, r_err);
+		} break;
+		default: {
+			return false;
+		}
+	}
+
+	if (r_err.error == Variant::CallError::CALL_OK && r_ret) {
+		*r_ret = ret;
+	}
+	return true;
+}
+
+#ifdef PTRCALL_ENABLED
+bool GDScriptFunction::_ptrcall(MethodBind *p_method, Object *p_object, const Variant **p_args, int p_argcount, Variant *r_ret) {
+	// Arguments are passed in place, so they must already hold the exact type
+	// the bind expects. Anything else is left to MethodBind::call(), which converts.
+	const void **argptrs = (const void **)alloca(sizeof(void *) * p_argcount);
+	for (int i = 0; i < p_argcount; i++) {
+		Variant::Type type = p_method->get_argument_type(i);
+		if (type == Variant::NIL) {
+			argptrs[i] = p_args[i];
+		} else if (p_args[i]->get_type() == type) {
+			argptrs[i] = VariantInternal::get_opaque_pointer(p_args[i]);
+		} else {
+			return false;
+		}
+	}
+
+	if (!p_method->has_return()) {
+		p_method->ptrcall(p_object, argptrs, nullptr);
+		if (r_ret) {
+			*r_ret = Variant();
+		}
+		return true;
+	}
+
+	// The return value is only written once the method is done with its
+	// arguments, so it can go straight into r_ret when the type already matches.
+	// Ints go through a zeroed temporary, as enums are only written as 32-bit ints.
+	Variant::Type ret_type = p_method->get_argument_type(-1);
+	if (r_ret && ret_type == Variant::NIL) {
+		p_method->ptrcall(p_object, argptrs, r_ret);
+	} else if (r_ret && ret_type != Variant::INT && r_ret->get_type() == ret_type) {
+		p_method->ptrcall(p_object, argptrs, VariantInternal::get_opaque_pointer(r_ret));
+	} else {
+		Variant ret;
+		if (ret_type != Variant::NIL) {
+			VariantInternal::initialize(&ret, ret_type);
+		}
+		p_method->ptrcall(p_object, argptrs, ret_type == Variant::NIL ? &ret : VariantInternal::get_opaque_pointer(&ret));
+		if (r_ret) {
+			*r_ret = ret;
+		}
+	}
+	return true;
+}
+#endif
+
+bool GDScriptFunction::_get_named_cached(InlineCache &p_cache, const Variant *p_base, const StringName &p_name, Variant *r_ret) {
+	Object *obj;
+	GDScriptInstance *instance;
+	if (!_get_inline_cache_receiver(p_base, obj, instance)) {
+		return false;
+	}
+
+	const StringName *native_class = &obj->get_class_name();
+	GDScript *script = instance ? instance->script.ptr() : nullptr;
+	const InlineCache::Entry *e = p_cache.find(native_class, script, GDScriptLanguage::get_singleton()->get_inline_cache_generation());
+	if (unlikely(!e)) {
+		InlineCache::Entry *added = p_cache.add(native_class, script);
+		_resolve_get_named(added, obj, script, p_name);
+		e = added;
+	}
+
+	// Read into a temporary, r_ret may be the variant holding the receiver.
+	Variant ret;
+	switch (e->kind) {
+		case InlineCache::KIND_MEMBER: {
+			ret = instance->members[e->index];
+		} break;
+		case InlineCache::KIND_PROPERTY: {
+			Variant::CallError ce;
+			if (e->index >= 0) {
+				Variant index = e->index;
+				const Variant *arg[1] = { &index };
+				ret = e->method->call(obj, arg, 1, ce);
+			} else {
+				ret = e->method->call(obj, nullptr, 0, ce);
+			}
+		} break;
+		default: {
+			return false;
+		}
+	}
+
+	*r_ret = ret;
+	return true;
+}
+
+bool GDScriptFunction::_set_named_cached(InlineCache &p_cache, const Variant *p_base, const StringName &p_name, const Variant *p_value, bool &r_valid) {
+#ifdef TOOLS_ENABLED
+	// Object::set() also flags the object as edited, leave that to the regular path.
+	return false;
+#else
+	Object *obj;
+	GDScriptInstance *instance;
+	if (!_get_inline_cache_receiver(p_base, obj, instance)) {
+		return false;
+	}
+
+	const StringName *native_class = &obj->get_class_name();
+	GDScript *script = instance ? instance->script.ptr() : nullptr;
+	const InlineCache::Entry *e = p_cache.find(native_class, script, GDScriptLanguage::get_singleton()->get_inline_cache_generation());
+	if (unlikely(!e)) {
+		InlineCache::Entry *added = p_cache.add(native_class, script);
+		_resolve_set_named(added, obj, script, p_name);
+		e = added;
+	}
+
+	switch (e->kind) {
+		case InlineCache::KIND_MEMBER: {
+			if (!e->member_type->is_type(*p_value)) {
+				return false; // Conversion and errors are handled by GDScriptInstance::set().
+			}
+			instance->members.write[e->index] = *p_value;
+			r_valid = true;
+		} break;
+		case InlineCache::KIND_PROPERTY: {
+			Variant::CallError ce;
+			if (e->index >= 0) {
+				Variant index = e->index;
+				const Variant *arg[2] = { &index, p_value };
+				e->method->call(obj, arg, 2, ce);
+			} else {
+				const Variant *arg[1] = { p_value };
+				e->method->call(obj, arg, 1, ce);
+			}
+			r_valid = ce.error == Variant::CallError::CALL_OK;
+		} break;
+		default: {
+			return false;
+		}
+	}
+
+	return true;
+#endif
+}
+
 #if defined(__GNUC__)
 #define OPCODES_TABLE                         \
 	static const void *switch_table_ops[] = { \
 		&&OPCODE_OPERATOR,                    \
+		&&OPCODE_OPERATOR_INT,                \
+		&&OPCODE_OPERATOR_REAL,               \
+		&&OPCODE_OPERATOR_VECTOR3,            \
 		&&OPCODE_EXTENDS_TEST,                \
 		&&OPCODE_IS_BUILTIN,                  \
 		&&OPCODE_SET,                         \
 		&&OPCODE_GET,                         \
+		&&OPCODE_GET_ARRAY_INDEX,             \
 		&&OPCODE_SET_NAMED,                   \
 		&&OPCODE_GET_NAMED,                   \
 		&&OPCODE_SET_MEMBER,                  \
@@ -209,6 +532,8 @@ String GDScriptFunction::_get_call_error(const Variant::CallError &p_err, const
 		&&OPCODE_CONSTRUCT_DICTIONARY,        \
 		&&OPCODE_CALL,                        \
 		&&OPCODE_CALL_RETURN,                 \
+		&&OPCODE_CALL_METHOD_BIND,            \
+		&&OPCODE_CALL_METHOD_BIND_RETURN,     \
 		&&OPCODE_CALL_BUILT_IN,               \
 		&&OPCODE_CALL_SELF,                   \
 		&&OPCODE_CALL_SELF_BASE,              \
@@ -218,6 +543,8 @@ String GDScriptFunction::_get_call_error(const Variant::CallError &p_err, const
 		&&OPCODE_JUMP,                        \
 		&&OPCODE_JUMP_IF,                     \
 		&&OPCODE_JUMP_IF_NOT,                 \
+		&&OPCODE_JUMP_IF_NOT_COMPARE_INT,     \
+		&&OPCODE_JUMP_IF_NOT_COMPARE_REAL,    \
 		&&OPCODE_JUMP_TO_DEF_ARGUMENT,        \
 		&&OPCODE_RETURN,                      \
 		&&OPCODE_ITERATE_BEGIN,               \
@@ -277,6 +604,8 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	GDScript *script;
 	int ip = 0;
 	int line = _initial_line;
+	// Inline caches aren't synchronized, other threads resolve every time.
+	InlineCache *inline_caches = Thread::get_caller_id() == Thread::get_main_id() ? _inline_caches_ptr : nullptr;
 
 	if (p_state) {
 		//use existing (supplied) state (yielded)
@@ -371,6 +700,8 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	String err_text;
 
+	GDScriptSamplingProfiler::ThreadState *sampling_state = GDScriptSamplingProfiler::enter(this, &line);
+
 #ifdef DEBUG_ENABLED
 
 	if (ScriptDebugger::get_singleton()) {
@@ -394,6 +725,46 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	if (unlikely(!m_v))                                                                                    \
 		OPCODE_BREAK;
 
+// Generic operator evaluation, shared by the typed operator opcodes
+// when their operands turn out not to have the expected types.
+#define OPERATOR_EVALUATE(m_op, m_a, m_b, m_dst)                                                                                                                                                               \
+	{                                                                                                                                                                                                          \
+		bool valid;                                                                                                                                                                                            \
+		Variant ret;                                                                                                                                                                                           \
+		Variant::evaluate(m_op, *m_a, *m_b, ret, valid);                                                                                                                                                       \
+		if (!valid) {                                                                                                                                                                                          \
+			if (ret.get_type() == Variant::STRING) {                                                                                                                                                           \
+				/* return a string when invalid with the error */                                                                                                                                              \
+				err_text = ret;                                                                                                                                                                                \
+				err_text += " in operator '" + Variant::get_operator_name(m_op) + "'.";                                                                                                                        \
+			} else {                                                                                                                                                                                           \
+				err_text = "Invalid operands '" + Variant::get_type_name(m_a->get_type()) + "' and '" + Variant::get_type_name(m_b->get_type()) + "' in operator '" + Variant::get_operator_name(m_op) + "'."; \
+			}                                                                                                                                                                                                  \
+			OPCODE_BREAK;                                                                                                                                                                                      \
+		}                                                                                                                                                                                                      \
+		*m_dst = ret;                                                                                                                                                                                          \
+	}
+
+// Generic indexing, shared by OPCODE_GET and OPCODE_GET_ARRAY_INDEX.
+// Gets into a temporary first to allow better error messages in cases
+// where src and dst are the same stack position.
+#define INDEX_GET(m_src, m_index, m_dst)                                                         \
+	{                                                                                            \
+		bool valid;                                                                              \
+		Variant ret = m_src->get(*m_index, &valid);                                              \
+		if (!valid) {                                                                            \
+			String v = m_index->operator String();                                               \
+			if (v != "") {                                                                       \
+				v = "'" + v + "'";                                                               \
+			} else {                                                                             \
+				v = "of type '" + _get_var_type(m_index) + "'";                                  \
+			}                                                                                    \
+			err_text = "Invalid get index " + v + " (on base: '" + _get_var_type(m_src) + "')."; \
+			OPCODE_BREAK;                                                                        \
+		}                                                                                        \
+		*m_dst = ret;                                                                            \
+	}
+
 #else
 #define GD_ERR_BREAK(m_cond)
 #define CHECK_SPACE(m_space)
@@ -401,6 +772,18 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	Variant *m_v;                        \
 	m_v = _get_variant(_code_ptr[ip + m_code_ofs], p_instance, script, self, static_ref, stack, err_text);
 
+#define OPERATOR_EVALUATE(m_op, m_a, m_b, m_dst)            \
+	{                                                       \
+		bool valid;                                         \
+		Variant::evaluate(m_op, *m_a, *m_b, *m_dst, valid); \
+	}
+
+#define INDEX_GET(m_src, m_index, m_dst)       \
+	{                                          \
+		bool valid;                            \
+		*m_dst = m_src->get(*m_index, &valid); \
+	}
+
 #endif
 
 #ifdef DEBUG_ENABLED
@@ -429,7 +812,6 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_OPERATOR) {
 				CHECK_SPACE(5);
 
-				bool valid;
 				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
 				GD_ERR_BREAK(op >= Variant::OP_MAX);
 
@@ -437,26 +819,223 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GET_VARIANT_PTR(b, 3);
 				GET_VARIANT_PTR(dst, 4);
 
-#ifdef DEBUG_ENABLED
+				OPERATOR_EVALUATE(op, a, b, dst);
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_OPERATOR_INT) {
+				CHECK_SPACE(5);
+
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
+				GD_ERR_BREAK(op >= Variant::OP_MAX);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+				GET_VARIANT_PTR(dst, 4);
+
+				// The compiler only emits this when both operands are typed as int,
+				// but that is a hint: anything unexpected takes the generic path.
+				if (likely(a->get_type() == Variant::INT && b->get_type() == Variant::INT)) {
+					const int64_t va = *VariantInternal::get_int(a);
+					const int64_t vb = *VariantInternal::get_int(b);
+					bool handled = true;
+
+					switch (op) {
+						case Variant::OP_EQUAL:
+							VariantInternal::set_bool(dst, va == vb);
+							break;
+						case Variant::OP_NOT_EQUAL:
+							VariantInternal::set_bool(dst, va != vb);
+							break;
+						case Variant::OP_LESS:
+							VariantInternal::set_bool(dst, va < vb);
+							break;
+						case Variant::OP_LESS_EQUAL:
+							VariantInternal::set_bool(dst, va <= vb);
+							break;
+						case Variant::OP_GREATER:
+							VariantInternal::set_bool(dst, va > vb);
+							break;
+						case Variant::OP_GREATER_EQUAL:
+							VariantInternal::set_bool(dst, va >= vb);
+							break;
+						case Variant::OP_ADD:
+							VariantInternal::set_int(dst, va + vb);
+							break;
+						case Variant::OP_SUBTRACT:
+							VariantInternal::set_int(dst, va - vb);
+							break;
+						case Variant::OP_MULTIPLY:
+							VariantInternal::set_int(dst, va * vb);
+							break;
+						case Variant::OP_NEGATE:
+							VariantInternal::set_int(dst, -va);
+							break;
+						case Variant::OP_BIT_AND:
+							VariantInternal::set_int(dst, va & vb);
+							break;
+						case Variant::OP_BIT_OR:
+							VariantInternal::set_int(dst, va | vb);
+							break;
+						case Variant::OP_BIT_XOR:
+							VariantInternal::set_int(dst, va ^ vb);
+							break;
+						case Variant::OP_DIVIDE: {
+							handled = vb != 0; // Let the generic path report division by zero.
+							if (handled) {
+								VariantInternal::set_int(dst, va / vb);
+							}
+						} break;
+						case Variant::OP_MODULE: {
+							handled = vb != 0;
+							if (handled) {
+								VariantInternal::set_int(dst, va % vb);
+							}
+						} break;
+						default: {
+							handled = false;
+						} break;
+					}
+
+					if (likely(handled)) {
+						ip += 5;
+						DISPATCH_OPCODE;
+					}
+				}
 
-				Variant ret;
-				Variant::evaluate(op, *a, *b, ret, valid);
+				OPERATOR_EVALUATE(op, a, b, dst);
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_OPERATOR_REAL) {
+				CHECK_SPACE(5);
+
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
+				GD_ERR_BREAK(op >= Variant::OP_MAX);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+				GET_VARIANT_PTR(dst, 4);
+
+				if (likely(a->get_type() == Variant::REAL && b->get_type() == Variant::REAL)) {
+					const double va = *VariantInternal::get_real(a);
+					const double vb = *VariantInternal::get_real(b);
+					bool handled = true;
+
+					switch (op) {
+						case Variant::OP_EQUAL:
+							VariantInternal::set_bool(dst, va == vb);
+							break;
+						case Variant::OP_NOT_EQUAL:
+							VariantInternal::set_bool(dst, va != vb);
+							break;
+						case Variant::OP_LESS:
+							VariantInternal::set_bool(dst, va < vb);
+							break;
+						case Variant::OP_LESS_EQUAL:
+							VariantInternal::set_bool(dst, va <= vb);
+							break;
+						case Variant::OP_GREATER:
+							VariantInternal::set_bool(dst, va > vb);
+							break;
+						case Variant::OP_GREATER_EQUAL:
+							VariantInternal::set_bool(dst, va >= vb);
+							break;
+						case Variant::OP_ADD:
+							VariantInternal::set_real(dst, va + vb);
+							break;
+						case Variant::OP_SUBTRACT:
+							VariantInternal::set_real(dst, va - vb);
+							break;
+						case Variant::OP_MULTIPLY:
+							VariantInternal::set_real(dst, va * vb);
+							break;
+						case Variant::OP_NEGATE:
+							VariantInternal::set_real(dst, -va);
+							break;
+						case Variant::OP_DIVIDE: {
+#ifdef DEBUG_ENABLED
+							handled = vb != 0; // Let the generic path report division by zero.
+							if (handled) {
+								VariantInternal::set_real(dst, va / vb);
+							}
 #else
-				Variant::evaluate(op, *a, *b, *dst, valid);
+							VariantInternal::set_real(dst, va / vb);
 #endif
-#ifdef DEBUG_ENABLED
-				if (!valid) {
-					if (ret.get_type() == Variant::STRING) {
-						//return a string when invalid with the error
-						err_text = ret;
-						err_text += " in operator '" + Variant::get_operator_name(op) + "'.";
-					} else {
-						err_text = "Invalid operands '" + Variant::get_type_name(a->get_type()) + "' and '" + Variant::get_type_name(b->get_type()) + "' in operator '" + Variant::get_operator_name(op) + "'.";
+						} break;
+						default: {
+							handled = false;
+						} break;
+					}
+
+					if (likely(handled)) {
+						ip += 5;
+						DISPATCH_OPCODE;
 					}
-					OPCODE_BREAK;
 				}
-				*dst = ret;
-#endif
+
+				OPERATOR_EVALUATE(op, a, b, dst);
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_OPERATOR_VECTOR3) {
+				CHECK_SPACE(5);
+
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
+				GD_ERR_BREAK(op >= Variant::OP_MAX);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+				GET_VARIANT_PTR(dst, 4);
+
+				if (likely(a->get_type() == Variant::VECTOR3 && b->get_type() == Variant::VECTOR3)) {
+					const Vector3 va = *VariantInternal::get_vector3(a);
+					const Vector3 vb = *VariantInternal::get_vector3(b);
+					bool handled = true;
+
+					switch (op) {
+						case Variant::OP_EQUAL:
+							VariantInternal::set_bool(dst, va == vb);
+							break;
+						case Variant::OP_NOT_EQUAL:
+							VariantInternal::set_bool(dst, va != vb);
+							break;
+						case Variant::OP_ADD:
+							VariantInternal::set_vector3(dst, va + vb);
+							break;
+						case Variant::OP_SUBTRACT:
+							VariantInternal::set_vector3(dst, va - vb);
+							break;
+						case Variant::OP_MULTIPLY:
+							VariantInternal::set_vector3(dst, va * vb);
+							break;
+						case Variant::OP_DIVIDE:
+							VariantInternal::set_vector3(dst, va / vb);
+							break;
+						case Variant::OP_NEGATE:
+							VariantInternal::set_vector3(dst, -va);
+							break;
+						default: {
+							handled = false;
+						} break;
+					}
+
+					if (likely(handled)) {
+						ip += 5;
+						DISPATCH_OPCODE;
+					}
+				} else if (likely(a->get_type() == Variant::VECTOR3 && b->get_type() == Variant::REAL && (op == Variant::OP_MULTIPLY || op == Variant::OP_DIVIDE))) {
+					const Vector3 va = *VariantInternal::get_vector3(a);
+					const real_t vb = *VariantInternal::get_real(b);
+					VariantInternal::set_vector3(dst, op == Variant::OP_MULTIPLY ? va * vb : va / vb);
+					ip += 5;
+					DISPATCH_OPCODE;
+				}
+
+				OPERATOR_EVALUATE(op, a, b, dst);
 				ip += 5;
 			}
 			DISPATCH_OPCODE;
@@ -573,44 +1152,77 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GET_VARIANT_PTR(index, 2);
 				GET_VARIANT_PTR(dst, 3);
 
-				bool valid;
-#ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get(*index, &valid);
-#else
-				*dst = src->get(*index, &valid);
+				INDEX_GET(src, index, dst);
+				ip += 4;
+			}
+			DISPATCH_OPCODE;
 
-#endif
-#ifdef DEBUG_ENABLED
-				if (!valid) {
-					String v = index->operator String();
-					if (v != "") {
-						v = "'" + v + "'";
-					} else {
-						v = "of type '" + _get_var_type(index) + "'";
+			OPCODE(OPCODE_GET_ARRAY_INDEX) {
+				CHECK_SPACE(3);
+
+				GET_VARIANT_PTR(src, 1);
+				GET_VARIANT_PTR(index, 2);
+				GET_VARIANT_PTR(dst, 3);
+
+				// Typed array indexing, negative or out of range indices and
+				// unexpected types go through the generic path.
+				if (likely(index->get_type() == Variant::INT)) {
+					const int64_t idx = *VariantInternal::get_int(index);
+
+					switch (src->get_type()) {
+						case Variant::ARRAY: {
+							const Array *array = VariantInternal::get_array(src);
+							if (likely(idx >= 0 && idx < array->size())) {
+								// Copy first, src and dst may be the same stack position.
+								Variant ret = array->get(idx);
+								*dst = ret;
+								ip += 4;
+								DISPATCH_OPCODE;
+							}
+						} break;
+						case Variant::POOL_REAL_ARRAY: {
+							const PoolVector<real_t> *array = VariantInternal::get_real_array(src);
+							if (likely(idx >= 0 && idx < array->size())) {
+								VariantInternal::set_real(dst, array->get(idx));
+								ip += 4;
+								DISPATCH_OPCODE;
+							}
+						} break;
+						case Variant::POOL_INT_ARRAY: {
+							const PoolVector<int> *array = VariantInternal::get_int_array(src);
+							if (likely(idx >= 0 && idx < array->size())) {
+								VariantInternal::set_int(dst, array->get(idx));
+								ip += 4;
+								DISPATCH_OPCODE;
+							}
+						} break;
+						default: {
+						} break;
 					}
-					err_text = "Invalid get index " + v + " (on base: '" + _get_var_type(src) + "').";
-					OPCODE_BREAK;
 				}
-				*dst = ret;
-#endif
+
+				INDEX_GET(src, index, dst);
 				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_NAMED) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(4);
 
 				GET_VARIANT_PTR(dst, 1);
 				GET_VARIANT_PTR(value, 3);
 
 				int indexname = _code_ptr[ip + 2];
+				int cache_index = _code_ptr[ip + 4];
 
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _inline_cache_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
 				bool valid;
-				dst->set_named(*index, *value, &valid);
+				if (!inline_caches || !_set_named_cached(inline_caches[cache_index], dst, *index, value, valid)) {
+					dst->set_named(*index, *value, &valid);
+				}
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -619,21 +1231,28 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(src, 1);
-				GET_VARIANT_PTR(dst, 3);
+				GET_VARIANT_PTR(dst, 4);
 
 				int indexname = _code_ptr[ip + 2];
+				int cache_index = _code_ptr[ip + 3];
 
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _inline_cache_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				if (inline_caches && _get_named_cached(inline_caches[cache_index], src, *index, dst)) {
+					ip += 5;
+					DISPATCH_OPCODE;
+				}
+
 				bool valid;
 #ifdef DEBUG_ENABLED
 				//allow better error message in cases where src and dst are the same stack position
@@ -653,7 +1272,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 				*dst = ret;
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1012,20 +1631,35 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_CALL_METHOD_BIND_RETURN)
+			OPCODE(OPCODE_CALL_METHOD_BIND)
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
-				CHECK_SPACE(4);
-				bool call_ret = _code_ptr[ip] == OPCODE_CALL_RETURN;
+				CHECK_SPACE(5);
+				int call_op = _code_ptr[ip];
+				bool call_ret = call_op == OPCODE_CALL_RETURN || call_op == OPCODE_CALL_METHOD_BIND_RETURN;
 
 				int argc = _code_ptr[ip + 1];
 				GET_VARIANT_PTR(base, 2);
 				int nameg = _code_ptr[ip + 3];
+				int cache_index = _code_ptr[ip + 4];
 
 				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _inline_cache_count);
 				const StringName *methodname = &_global_names_ptr[nameg];
 
 				GD_ERR_BREAK(argc < 0);
-				ip += 4;
+				MethodBind *ptrcall_method = nullptr;
+				if (call_op == OPCODE_CALL_METHOD_BIND || call_op == OPCODE_CALL_METHOD_BIND_RETURN) {
+					// The compiler resolved a native method with matching argument types.
+					CHECK_SPACE(6);
+					int method_index = _code_ptr[ip + 5];
+					GD_ERR_BREAK(method_index < 0 || method_index >= _method_bind_count);
+					ptrcall_method = _method_binds_ptr[method_index];
+					ip += 6;
+				} else {
+					ip += 5;
+				}
 				CHECK_SPACE(argc + 1);
 				Variant **argptrs = call_args;
 
@@ -1043,11 +1677,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 #endif
 				Variant::CallError err;
+				Variant *ret = nullptr;
 				if (call_ret) {
-					GET_VARIANT_PTR(ret, argc);
+					GET_VARIANT_PTR(dst, argc);
+					ret = dst;
+				}
+				if (!inline_caches || !_call_cached(inline_caches[cache_index], base, *methodname, (const Variant **)argptrs, argc, ret, err, ptrcall_method)) {
 					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
-				} else {
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, nullptr, err);
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -1356,6 +1992,108 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_JUMP_IF_NOT_COMPARE_INT) {
+				CHECK_SPACE(5);
+
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
+				GD_ERR_BREAK(op >= Variant::OP_MAX);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				bool result;
+				if (likely(a->get_type() == Variant::INT && b->get_type() == Variant::INT)) {
+					const int64_t va = *VariantInternal::get_int(a);
+					const int64_t vb = *VariantInternal::get_int(b);
+
+					switch (op) {
+						case Variant::OP_EQUAL:
+							result = va == vb;
+							break;
+						case Variant::OP_NOT_EQUAL:
+							result = va != vb;
+							break;
+						case Variant::OP_LESS:
+							result = va < vb;
+							break;
+						case Variant::OP_LESS_EQUAL:
+							result = va <= vb;
+							break;
+						case Variant::OP_GREATER:
+							result = va > vb;
+							break;
+						default: // Variant::OP_GREATER_EQUAL, only comparisons are emitted.
+							result = va >= vb;
+							break;
+					}
+				} else {
+					Variant ret;
+					Variant *dst = &ret;
+					OPERATOR_EVALUATE(op, a, b, dst);
+					result = ret.booleanize();
+				}
+
+				if (!result) {
+					int to = _code_ptr[ip + 4];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 5;
+				}
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_JUMP_IF_NOT_COMPARE_REAL) {
+				CHECK_SPACE(5);
+
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
+				GD_ERR_BREAK(op >= Variant::OP_MAX);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				bool result;
+				if (likely(a->get_type() == Variant::REAL && b->get_type() == Variant::REAL)) {
+					const double va = *VariantInternal::get_real(a);
+					const double vb = *VariantInternal::get_real(b);
+
+					switch (op) {
+						case Variant::OP_EQUAL:
+							result = va == vb;
+							break;
+						case Variant::OP_NOT_EQUAL:
+							result = va != vb;
+							break;
+						case Variant::OP_LESS:
+							result = va < vb;
+							break;
+						case Variant::OP_LESS_EQUAL:
+							result = va <= vb;
+							break;
+						case Variant::OP_GREATER:
+							result = va > vb;
+							break;
+						default: // Variant::OP_GREATER_EQUAL, only comparisons are emitted.
+							result = va >= vb;
+							break;
+					}
+				} else {
+					Variant ret;
+					Variant *dst = &ret;
+					OPERATOR_EVALUATE(op, a, b, dst);
+					result = ret.booleanize();
+				}
+
+				if (!result) {
+					int to = _code_ptr[ip + 4];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 5;
+				}
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_JUMP_TO_DEF_ARGUMENT) {
 				CHECK_SPACE(2);
 				ip = _default_arg_ptr[defarg];
@@ -1478,6 +2216,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				line = _code_ptr[ip + 1];
 				ip += 2;
 
+				if (sampling_state) {
+					GDScriptSamplingProfiler::poll(sampling_state);
+				}
+
 				if (ScriptDebugger::get_singleton()) {
 					// line
 					bool do_break = false;
@@ -1555,6 +2297,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	}
 
 	OPCODES_OUT
+
+	if (sampling_state) {
+		GDScriptSamplingProfiler::exit(sampling_state);
+	}
+
 #ifdef DEBUG_ENABLED
 	if (GDScriptLanguage::get_singleton()->profiling) {
 		uint64_t time_taken = OS::get_singleton()->get_ticks_usec() - function_start_time;
@@ -1698,6 +2445,10 @@ GDScriptFunction::GDScriptFunction() :
 		function_list(this) {
 	_stack_size = 0;
 	_call_size = 0;
+	_inline_caches_ptr = nullptr;
+	_inline_cache_count = 0;
+	_method_binds_ptr = nullptr;
+	_method_bind_count = 0;
 	rpc_mode = MultiplayerAPI::RPC_MODE_DISABLED;
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
@@ -31,6 +31,7 @@
 #ifndef GDSCRIPT_FUNCTION_H
 #define GDSCRIPT_FUNCTION_H
 
+#include "core/local_vector.h"
 #include "core/os/thread.h"
 #include "core/pair.h"
 #include "core/reference.h"
@@ -41,6 +42,7 @@
 
 class GDScriptInstance;
 class GDScript;
+class MethodBind;
 
 struct GDScriptDataType {
 	bool has_type;
@@ -160,10 +162,14 @@ class GDScriptFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
+		OPCODE_OPERATOR_INT,
+		OPCODE_OPERATOR_REAL,
+		OPCODE_OPERATOR_VECTOR3,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_IS_BUILTIN,
 		OPCODE_SET,
 		OPCODE_GET,
+		OPCODE_GET_ARRAY_INDEX,
 		OPCODE_SET_NAMED,
 		OPCODE_GET_NAMED,
 		OPCODE_SET_MEMBER,
@@ -182,6 +188,8 @@ public:
 		OPCODE_CONSTRUCT_DICTIONARY,
 		OPCODE_CALL,
 		OPCODE_CALL_RETURN,
+		OPCODE_CALL_METHOD_BIND,
+		OPCODE_CALL_METHOD_BIND_RETURN,
 		OPCODE_CALL_BUILT_IN,
 		OPCODE_CALL_SELF,
 		OPCODE_CALL_SELF_BASE,
@@ -191,6 +199,8 @@ public:
 		OPCODE_JUMP,
 		OPCODE_JUMP_IF,
 		OPCODE_JUMP_IF_NOT,
+		OPCODE_JUMP_IF_NOT_COMPARE_INT,
+		OPCODE_JUMP_IF_NOT_COMPARE_REAL,
 		OPCODE_JUMP_TO_DEF_ARGUMENT,
 		OPCODE_RETURN,
 		OPCODE_ITERATE_BEGIN,
@@ -224,6 +234,78 @@ public:
 		StringName identifier;
 	};
 
+	// What a call or named get/set site resolved for the receivers it has seen,
+	// keyed by their native class and GDScript. A few entries are kept so
+	// polymorphic sites don't keep resolving. Caches are only touched from the
+	// main thread, and are dropped when the language's generation changes.
+	struct InlineCache {
+		enum Kind {
+			KIND_GENERIC, // Receiver needs the regular lookup.
+			KIND_METHOD_BIND,
+			KIND_SCRIPT_FUNCTION,
+			KIND_MEMBER,
+			KIND_PROPERTY,
+		};
+
+		enum {
+			MAX_ENTRIES = 4
+		};
+
+		struct Entry {
+			const StringName *native_class;
+			const GDScript *script;
+			Kind kind;
+			int index; // Member index, or property index (-1 if none).
+			union {
+				MethodBind *method;
+				GDScriptFunction *function;
+				const GDScriptDataType *member_type;
+			};
+		};
+
+		Entry entries[MAX_ENTRIES];
+		uint32_t entry_count;
+		uint32_t next_entry;
+		uint32_t generation;
+
+		_FORCE_INLINE_ const Entry *find(const StringName *p_native_class, const GDScript *p_script, uint32_t p_generation) {
+			if (unlikely(generation != p_generation)) {
+				generation = p_generation;
+				entry_count = 0;
+				next_entry = 0;
+				return nullptr;
+			}
+			for (uint32_t i = 0; i < entry_count; i++) {
+				if (entries[i].native_class == p_native_class && entries[i].script == p_script) {
+					return &entries[i];
+				}
+			}
+			return nullptr;
+		}
+
+		Entry *add(const StringName *p_native_class, const GDScript *p_script) {
+			Entry *e;
+			if (entry_count < MAX_ENTRIES) {
+				e = &entries[entry_count++];
+			} else {
+				e = &entries[next_entry];
+				next_entry = (next_entry + 1) % MAX_ENTRIES;
+			}
+			e->native_class = p_native_class;
+			e->script = p_script;
+			e->kind = KIND_GENERIC;
+			e->index = -1;
+			e->method = nullptr;
+			return e;
+		}
+
+		InlineCache() {
+			entry_count = 0;
+			next_entry = 0;
+			generation = 0;
+		}
+	};
+
 private:
 	friend class GDScriptCompiler;
 
@@ -242,6 +324,10 @@ private:
 	int _default_arg_count;
 	const int *_code_ptr;
 	int _code_size;
+	InlineCache *_inline_caches_ptr;
+	int _inline_cache_count;
+	MethodBind *const *_method_binds_ptr;
+	int _method_bind_count;
 	int _argument_count;
 	int _stack_size;
 	int _call_size;
@@ -259,6 +345,8 @@ private:
 #endif
 	Vector<int> default_arguments;
 	Vector<int> code;
+	LocalVector<InlineCache> inline_caches;
+	Vector<MethodBind *> method_binds;
 	Vector<GDScriptDataType> argument_types;
 	GDScriptDataType return_type;
 
@@ -271,10 +359,22 @@ private:
 	_FORCE_INLINE_ Variant *_get_variant(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant &static_ref, Variant *p_stack, String &r_error) const;
 	_FORCE_INLINE_ String _get_call_error(const Variant::CallError &p_err, const String &p_where, const Variant **argptrs) const;
 
+	static void _resolve_call(InlineCache::Entry *r_entry, Object *p_object, GDScript *p_script, const StringName &p_method);
+	static void _resolve_get_named(InlineCache::Entry *r_entry, Object *p_object, GDScript *p_script, const StringName &p_name);
+	static void _resolve_set_named(InlineCache::Entry *r_entry, Object *p_object, GDScript *p_script, const StringName &p_name);
+	static bool _call_cached(InlineCache &p_cache, const Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, Variant::CallError &r_err, MethodBind *p_ptrcall_method = nullptr);
+#ifdef PTRCALL_ENABLED
+	static bool _ptrcall(MethodBind *p_method, Object *p_object, const Variant **p_args, int p_argcount, Variant *r_ret);
+#endif
+	static bool _get_named_cached(InlineCache &p_cache, const Variant *p_base, const StringName &p_name, Variant *r_ret);
+	static bool _set_named_cached(InlineCache &p_cache, const Variant *p_base, const StringName &p_name, const Variant *p_value, bool &r_valid);
+
 	friend class GDScriptLanguage;
 
 	SelfList<GDScriptFunction> function_list;
 #ifdef DEBUG_ENABLED
+	String _disassemble_addr(int p_addr) const;
+
 	CharString func_cname;
 	const char *_func_cname;
 
@@ -327,6 +427,9 @@ public:
 	StringName get_source() const { return source; }
 
 	void debug_get_stack_member_state(int p_line, List<Pair<StringName, int>> *r_stackvars) const;
+#ifdef DEBUG_ENABLED
+	String disassemble(const Vector<String> &p_code_lines) const;
+#endif
 
 	_FORCE_INLINE_ bool is_empty() const { return _code_size == 0; }
 
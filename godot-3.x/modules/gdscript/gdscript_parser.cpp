@@ -56,6 +56,268 @@ T *GDScriptParser::alloc_node() {
 	return t;
 }
 
+bool GDScriptParser::_get_class_constant(ClassNode *p_class, const StringName &p_identifier, Variant &r_value) const {
+	// Same lookup order as the compiler: members of the class itself shadow constants,
+	// then constants are searched through the inheritance chain of each outer class.
+	for (ClassNode *c = p_class; c; c = c->owner) {
+		bool innermost = c == p_class;
+
+		DataType base_type;
+		ClassNode *base = c;
+		while (base) {
+			if (innermost) {
+				for (int i = 0; i < base->variables.size(); i++) {
+					if (base->variables[i].identifier == p_identifier) {
+						return false;
+					}
+				}
+			}
+			if (base->constant_expressions.has(p_identifier)) {
+				Node *expr = base->constant_expressions[p_identifier].expression;
+				if (!expr || expr->type != Node::TYPE_CONSTANT) {
+					return false;
+				}
+				r_value = static_cast<ConstantNode *>(expr)->value;
+				// Scripts and resources keep going through the class constant table.
+				return r_value.get_type() != Variant::OBJECT;
+			}
+			for (int i = 0; i < base->subclasses.size(); i++) {
+				if (base->subclasses[i]->name == p_identifier) {
+					return false;
+				}
+			}
+
+			base_type = base->base_type;
+			base = base_type.has_type && base_type.kind == DataType::CLASS ? base_type.class_type : nullptr;
+		}
+
+		if (!base_type.has_type) {
+			continue;
+		}
+
+		StringName native;
+		if (base_type.kind == DataType::GDSCRIPT || base_type.kind == DataType::SCRIPT) {
+			Ref<Script> scr = base_type.script_type;
+			while (scr.is_valid()) {
+				if (innermost) {
+					Set<StringName> members;
+					scr->get_members(&members);
+					if (members.has(p_identifier)) {
+						return false;
+					}
+				}
+
+				Map<StringName, Variant> constants;
+				scr->get_constants(&constants);
+				if (constants.has(p_identifier)) {
+					r_value = constants[p_identifier];
+					return r_value.get_type() != Variant::OBJECT;
+				}
+
+				native = scr->get_instance_base_type();
+				scr = scr->get_base_script();
+			}
+		} else if (base_type.kind == DataType::NATIVE) {
+			native = base_type.native_type;
+		}
+
+		if (native != StringName()) {
+			if (innermost && ClassDB::has_property(native, p_identifier)) {
+				return false;
+			}
+
+			bool success = false;
+			int constant = ClassDB::get_integer_constant(native, p_identifier, &success);
+			if (success) {
+				r_value = constant;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+GDScriptParser::Node *GDScriptParser::_fold_constant_identifiers(Node *p_node, ClassNode *p_class, FunctionNode *p_function) {
+	switch (p_node->type) {
+		case Node::TYPE_IDENTIFIER: {
+			IdentifierNode *id = static_cast<IdentifierNode *>(p_node);
+			if (id->declared_block || (p_function && p_function->arguments.find(id->name) != -1)) {
+				return p_node;
+			}
+
+			Variant value;
+			if (!_get_class_constant(p_class, id->name, value)) {
+				return p_node;
+			}
+
+			ConstantNode *cn = alloc_node<ConstantNode>();
+			cn->value = value;
+			cn->datatype = _type_from_variant(value);
+			cn->line = id->line;
+			return cn;
+		} break;
+		case Node::TYPE_ARRAY: {
+			ArrayNode *an = static_cast<ArrayNode *>(p_node);
+			for (int i = 0; i < an->elements.size(); i++) {
+				an->elements.write[i] = _fold_constant_identifiers(an->elements[i], p_class, p_function);
+			}
+		} break;
+		case Node::TYPE_DICTIONARY: {
+			DictionaryNode *dn = static_cast<DictionaryNode *>(p_node);
+			for (int i = 0; i < dn->elements.size(); i++) {
+				dn->elements.write[i].key = _fold_constant_identifiers(dn->elements[i].key, p_class, p_function);
+				dn->elements.write[i].value = _fold_constant_identifiers(dn->elements[i].value, p_class, p_function);
+			}
+		} break;
+		case Node::TYPE_OPERATOR: {
+			OperatorNode *op = static_cast<OperatorNode *>(p_node);
+
+			int first = 0;
+			switch (op->op) {
+				case OperatorNode::OP_PARENT_CALL: {
+					first = 1; // Function name.
+				} break;
+				case OperatorNode::OP_INIT_ASSIGN:
+				case OperatorNode::OP_ASSIGN:
+				case OperatorNode::OP_ASSIGN_ADD:
+				case OperatorNode::OP_ASSIGN_SUB:
+				case OperatorNode::OP_ASSIGN_MUL:
+				case OperatorNode::OP_ASSIGN_DIV:
+				case OperatorNode::OP_ASSIGN_MOD:
+				case OperatorNode::OP_ASSIGN_SHIFT_LEFT:
+				case OperatorNode::OP_ASSIGN_SHIFT_RIGHT:
+				case OperatorNode::OP_ASSIGN_BIT_AND:
+				case OperatorNode::OP_ASSIGN_BIT_OR:
+				case OperatorNode::OP_ASSIGN_BIT_XOR: {
+					first = 1; // Assignment target is left untouched.
+				} break;
+				case OperatorNode::OP_INDEX_NAMED: {
+					// Constants of inner classes, e.g. "Inner.VALUE".
+					if (op->arguments[0]->type == Node::TYPE_IDENTIFIER && op->arguments[1]->type == Node::TYPE_IDENTIFIER) {
+						IdentifierNode *base = static_cast<IdentifierNode *>(op->arguments[0]);
+						StringName name = static_cast<IdentifierNode *>(op->arguments[1])->name;
+						if (!base->declared_block && !(p_function && p_function->arguments.find(base->name) != -1)) {
+							for (ClassNode *c = p_class; c; c = c->owner) {
+								for (int i = 0; i < c->subclasses.size(); i++) {
+									ClassNode *inner = c->subclasses[i];
+									if (inner->name != base->name || !inner->constant_expressions.has(name)) {
+										continue;
+									}
+									Node *expr = inner->constant_expressions[name].expression;
+									if (expr && expr->type == Node::TYPE_CONSTANT && static_cast<ConstantNode *>(expr)->value.get_type() != Variant::OBJECT) {
+										ConstantNode *cn = alloc_node<ConstantNode>();
+										cn->value = static_cast<ConstantNode *>(expr)->value;
+										cn->datatype = _type_from_variant(cn->value);
+										cn->line = op->line;
+										return cn;
+									}
+								}
+							}
+						}
+					}
+				} break;
+				default: {
+				}
+			}
+
+			bool named_call = op->op == OperatorNode::OP_CALL && op->arguments[0]->type != Node::TYPE_TYPE && op->arguments[0]->type != Node::TYPE_BUILT_IN_FUNCTION;
+			if (named_call || op->op == OperatorNode::OP_INDEX_NAMED) {
+				// The second argument is the method or property name.
+				op->arguments.write[0] = _fold_constant_identifiers(op->arguments[0], p_class, p_function);
+				first = 2;
+			}
+			for (int i = first; i < op->arguments.size(); i++) {
+				op->arguments.write[i] = _fold_constant_identifiers(op->arguments[i], p_class, p_function);
+			}
+		} break;
+		default: {
+		}
+	}
+
+	return p_node;
+}
+
+GDScriptParser::Node *GDScriptParser::_fold_expression(Node *p_node, ClassNode *p_class, FunctionNode *p_function) {
+	Node *folded = _fold_constant_identifiers(p_node, p_class, p_function);
+	Node *reduced = _reduce_expression(folded);
+	if (error_set) {
+		// The code already passed the type checks, an invalid constant operation
+		// (e.g. a division by zero) is left to fail at runtime as it did before.
+		error_set = false;
+		error = String();
+		return folded;
+	}
+	return reduced;
+}
+
+void GDScriptParser::_fold_block_constants(BlockNode *p_block, ClassNode *p_class, FunctionNode *p_function) {
+	for (int i = 0; i < p_block->statements.size(); i++) {
+		Node *statement = p_block->statements[i];
+		switch (statement->type) {
+			case Node::TYPE_OPERATOR: {
+				p_block->statements.write[i] = _fold_expression(statement, p_class, p_function);
+			} break;
+			case Node::TYPE_ASSERT: {
+				AssertNode *an = static_cast<AssertNode *>(statement);
+				an->condition = _fold_expression(an->condition, p_class, p_function);
+				if (an->message) {
+					an->message = _fold_expression(an->message, p_class, p_function);
+				}
+			} break;
+			case Node::TYPE_CONTROL_FLOW: {
+				ControlFlowNode *cf = static_cast<ControlFlowNode *>(statement);
+				switch (cf->cf_type) {
+					case ControlFlowNode::CF_IF:
+					case ControlFlowNode::CF_WHILE:
+					case ControlFlowNode::CF_RETURN: {
+						for (int j = 0; j < cf->arguments.size(); j++) {
+							cf->arguments.write[j] = _fold_expression(cf->arguments[j], p_class, p_function);
+						}
+					} break;
+					case ControlFlowNode::CF_FOR: {
+						// First argument is the iterator variable.
+						cf->arguments.write[1] = _fold_expression(cf->arguments[1], p_class, p_function);
+					} break;
+					case ControlFlowNode::CF_MATCH: {
+						for (int j = 0; j < cf->match->compiled_pattern_branches.size(); j++) {
+							_fold_block_constants(cf->match->compiled_pattern_branches[j].body, p_class, p_function);
+						}
+					} break;
+					default: {
+					}
+				}
+
+				if (cf->body) {
+					_fold_block_constants(cf->body, p_class, p_function);
+				}
+				if (cf->body_else) {
+					_fold_block_constants(cf->body_else, p_class, p_function);
+				}
+			} break;
+			default: {
+			}
+		}
+	}
+}
+
+void GDScriptParser::_fold_class_constants(ClassNode *p_class) {
+	for (int i = 0; i < p_class->static_functions.size() + p_class->functions.size(); i++) {
+		FunctionNode *function = i < p_class->static_functions.size() ? p_class->static_functions[i] : p_class->functions[i - p_class->static_functions.size()];
+		for (int j = 0; j < function->default_values.size(); j++) {
+			function->default_values.write[j] = _fold_expression(function->default_values[j], p_class, function);
+		}
+		_fold_block_constants(function->body, p_class, function);
+	}
+
+	_fold_block_constants(p_class->initializer, p_class, nullptr);
+	_fold_block_constants(p_class->ready, p_class, nullptr);
+
+	for (int i = 0; i < p_class->subclasses.size(); i++) {
+		_fold_class_constants(p_class->subclasses[i]);
+	}
+}
+
 #ifdef DEBUG_ENABLED
 static String _find_function_name(const GDScriptParser::OperatorNode *p_call);
 #endif // DEBUG_ENABLED
@@ -5168,6 +5430,14 @@ void GDScriptParser::_parse_class(ClassNode *p_class) {
 					return;
 				}
 
+				if (subexpr->type != Node::TYPE_CONSTANT) {
+					// May still refer to constants of outer or inner classes.
+					subexpr = _reduce_expression(_fold_constant_identifiers(subexpr, p_class, nullptr), true);
+					if (error_set) {
+						return;
+					}
+				}
+
 				if (subexpr->type != Node::TYPE_CONSTANT) {
 					_set_error("Expected a constant expression.", line);
 					return;
@@ -8750,6 +9020,12 @@ Error GDScriptParser::_parse(const String &p_base_path) {
 		return ERR_PARSE_ERROR;
 	}
 
+	// Inline class constants used in functions and fold what becomes constant,
+	// so the compiler can drop branches that can't be taken.
+	if (!for_completion && !validating) {
+		_fold_class_constants(main_class);
+	}
+
 #ifdef DEBUG_ENABLED
 
 	// Resolve warning ignores
@@ -636,6 +636,12 @@ private:
 	void _check_class_blocks_types(ClassNode *p_class);
 	void _check_function_types(FunctionNode *p_function);
 	void _check_block_types(BlockNode *p_block);
+
+	bool _get_class_constant(ClassNode *p_class, const StringName &p_identifier, Variant &r_value) const;
+	Node *_fold_constant_identifiers(Node *p_node, ClassNode *p_class, FunctionNode *p_function);
+	Node *_fold_expression(Node *p_node, ClassNode *p_class, FunctionNode *p_function);
+	void _fold_block_constants(BlockNode *p_block, ClassNode *p_class, FunctionNode *p_function);
+	void _fold_class_constants(ClassNode *p_class);
 	_FORCE_INLINE_ void _mark_line_as_safe(int p_line) const {
 #ifdef DEBUG_ENABLED
 		if (safe_lines) {
@@ -0,0 +1,181 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.cpp                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_sampling_profiler.h"
+
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "core/sort_array.h"
+#include "gdscript_function.h"
+
+SafeFlag GDScriptSamplingProfiler::active;
+SafeFlag GDScriptSamplingProfiler::exit_thread;
+Thread GDScriptSamplingProfiler::thread;
+uint64_t GDScriptSamplingProfiler::interval_usec = 1000;
+Mutex GDScriptSamplingProfiler::states_mutex;
+Vector<GDScriptSamplingProfiler::ThreadState *> GDScriptSamplingProfiler::states;
+
+static thread_local GDScriptSamplingProfiler::ThreadState *thread_state = nullptr;
+
+GDScriptSamplingProfiler::ThreadState *GDScriptSamplingProfiler::_enter(const GDScriptFunction *p_function, const int *p_line) {
+	ThreadState *state = thread_state;
+	if (unlikely(!state)) {
+		state = memnew(ThreadState);
+		state->depth.set(0);
+		state->pending.set(0);
+		state->name = Thread::get_caller_id() == Thread::get_main_id() ? String("main") : "thread " + String::num_uint64(Thread::get_caller_id());
+
+		states_mutex.lock();
+		states.push_back(state);
+		states_mutex.unlock();
+		thread_state = state;
+	}
+
+	uint32_t depth = state->depth.get();
+	if (depth < ThreadState::MAX_FRAMES) {
+		state->frames[depth].function = p_function;
+		state->frames[depth].line = p_line;
+	}
+	state->depth.set(depth + 1);
+	return state;
+}
+
+void GDScriptSamplingProfiler::_record_sample(ThreadState *p_state) {
+	// Samples requested while the thread was busy in native code are all
+	// attributed to the stack it returns to.
+	uint32_t count = p_state->pending.get();
+	p_state->pending.sub(count);
+
+	uint32_t depth = MIN(p_state->depth.get(), (uint32_t)ThreadState::MAX_FRAMES);
+	uint64_t hash = hash_djb2_one_64(depth);
+	for (uint32_t i = 0; i < depth; i++) {
+		hash = hash_djb2_one_64((uint64_t)p_state->frames[i].function, hash);
+		hash = hash_djb2_one_64(*p_state->frames[i].line, hash);
+	}
+
+	MutexLock lock(p_state->mutex);
+	ThreadState::Sample *sample = p_state->samples.getptr(hash);
+	if (!sample) {
+		sample = &p_state->samples[hash];
+		sample->stack = p_state->name;
+		for (uint32_t i = 0; i < depth; i++) {
+			const ThreadState::Frame &frame = p_state->frames[i];
+			sample->stack += ";" + String(frame.function->get_name()) + " (" + String(frame.function->get_source()) + ":" + itos(*frame.line) + ")";
+		}
+	}
+	sample->count += count;
+}
+
+void GDScriptSamplingProfiler::_thread_func(void *p_user) {
+	Thread::set_name("GDScript sampling profiler");
+
+	while (!exit_thread.is_set()) {
+		OS::get_singleton()->delay_usec(interval_usec);
+
+		MutexLock lock(states_mutex);
+		for (int i = 0; i < states.size(); i++) {
+			// Threads that aren't running script code aren't sampled.
+			if (states[i]->depth.get() > 0) {
+				states[i]->pending.increment();
+			}
+		}
+	}
+}
+
+void GDScriptSamplingProfiler::start(uint64_t p_interval_usec) {
+	ERR_FAIL_COND_MSG(active.is_set(), "The GDScript sampling profiler is already running.");
+#ifdef NO_THREADS
+	ERR_FAIL_MSG("The GDScript sampling profiler requires thread support.");
+#else
+	interval_usec = MAX(p_interval_usec, (uint64_t)50);
+	exit_thread.clear();
+	active.set();
+	thread.start(_thread_func, nullptr);
+#endif
+}
+
+void GDScriptSamplingProfiler::stop() {
+	if (!active.is_set()) {
+		return;
+	}
+	active.clear();
+	exit_thread.set();
+	thread.wait_to_finish();
+}
+
+void GDScriptSamplingProfiler::clear() {
+	MutexLock lock(states_mutex);
+	for (int i = 0; i < states.size(); i++) {
+		MutexLock state_lock(states[i]->mutex);
+		states[i]->samples.clear();
+	}
+}
+
+Error GDScriptSamplingProfiler::save(const String &p_path) {
+	Error err;
+	FileAccessRef f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(!f, err, "Can't open GDScript profile file for writing: " + p_path + ".");
+
+	Vector<String> lines;
+	uint64_t total = 0;
+	{
+		MutexLock lock(states_mutex);
+		for (int i = 0; i < states.size(); i++) {
+			MutexLock state_lock(states[i]->mutex);
+			const uint64_t *key = nullptr;
+			while ((key = states[i]->samples.next(key))) {
+				const ThreadState::Sample &sample = states[i]->samples[*key];
+				lines.push_back(sample.stack + " " + itos(sample.count));
+				total += sample.count;
+			}
+		}
+	}
+
+	// One line per unique stack, as used by flamegraph.pl, speedscope and similar tools.
+	lines.sort();
+	for (int i = 0; i < lines.size(); i++) {
+		f->store_line(lines[i]);
+	}
+	f->close();
+
+	print_line(vformat("GDScript sampling profiler: saved %d samples (%d unique stacks) to \"%s\".", total, lines.size(), p_path));
+	return OK;
+}
+
+void GDScriptSamplingProfiler::finish() {
+	stop();
+
+	MutexLock lock(states_mutex);
+	for (int i = 0; i < states.size(); i++) {
+		memdelete(states[i]);
+	}
+	states.clear();
+	thread_state = nullptr;
+}
@@ -0,0 +1,114 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLING_PROFILER_H
+#define GDSCRIPT_SAMPLING_PROFILER_H
+
+#include "core/hash_map.h"
+#include "core/hashfuncs.h"
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+#include "core/ustring.h"
+#include "core/vector.h"
+
+class GDScriptFunction;
+
+// Statistical profiler for GDScript. Every thread running scripts keeps a
+// small stack of the functions it is executing; a background thread
+// periodically asks them for a sample, which the script thread takes itself
+// the next time it reaches a line boundary. Nothing but a flag check is added
+// to calls when the profiler isn't running.
+class GDScriptSamplingProfiler {
+public:
+	struct ThreadState {
+		enum {
+			MAX_FRAMES = 256
+		};
+
+		struct Frame {
+			const GDScriptFunction *function;
+			const int *line;
+		};
+
+		Frame frames[MAX_FRAMES];
+		SafeNumeric<uint32_t> depth;
+		SafeNumeric<uint32_t> pending;
+
+		struct Sample {
+			String stack; // Collapsed stack, built once per unique stack.
+			uint64_t count = 0;
+		};
+
+		String name;
+		Mutex mutex;
+		HashMap<uint64_t, Sample> samples; // Keyed by a hash of the frames.
+	};
+
+private:
+	static SafeFlag active;
+	static SafeFlag exit_thread;
+	static Thread thread;
+	static uint64_t interval_usec;
+
+	static Mutex states_mutex;
+	static Vector<ThreadState *> states;
+
+	static ThreadState *_enter(const GDScriptFunction *p_function, const int *p_line);
+	static void _record_sample(ThreadState *p_state);
+	static void _thread_func(void *p_user);
+
+public:
+	_FORCE_INLINE_ static ThreadState *enter(const GDScriptFunction *p_function, const int *p_line) {
+		if (likely(!active.is_set())) {
+			return nullptr;
+		}
+		return _enter(p_function, p_line);
+	}
+
+	_FORCE_INLINE_ static void exit(ThreadState *p_state) {
+		p_state->depth.set(p_state->depth.get() - 1);
+	}
+
+	_FORCE_INLINE_ static void poll(ThreadState *p_state) {
+		if (unlikely(p_state->pending.get())) {
+			_record_sample(p_state);
+		}
+	}
+
+	static bool is_active() { return active.is_set(); }
+	static void start(uint64_t p_interval_usec);
+	static void stop();
+	static void clear();
+	static Error save(const String &p_path);
+	static void finish();
+};
+
+#endif // GDSCRIPT_SAMPLING_PROFILER_H
@@ -31,6 +31,7 @@
 #include "godot_navigation_server.h"
 
 #include "core/os/mutex.h"
+#include "core/os/worker_thread_pool.h"
 
 #ifndef _3D_DISABLED
 #include "navigation_mesh_generator.h"
@@ -113,6 +114,29 @@
 	}                                                                              \
 	void GodotNavigationServer::MERGE(_cmd_, F_NAME)(T_0 D_0, T_1 D_1, T_2 D_2, T_3 D_3)
 
+struct PathQueryBatch {
+	NavMapSnapshot *snapshot;
+	Vector<NavigationServer::PathQuery> queries;
+	Vector<Vector<Vector3>> paths;
+	Vector<Vector3> *paths_ptrw;
+	WorkerThreadPool::TaskID task;
+
+	ObjectID receiver;
+	StringName method;
+	Variant udata;
+
+	PathQueryBatch() :
+			snapshot(nullptr),
+			paths_ptrw(nullptr),
+			task(WorkerThreadPool::INVALID_TASK_ID),
+			receiver(0) {}
+
+	void solve(uint32_t p_index, const NavMapSnapshot *p_snapshot) {
+		const NavigationServer::PathQuery &query = queries[p_index];
+		paths_ptrw[p_index] = p_snapshot->get_path(query.origin, query.destination, query.optimize);
+	}
+};
+
 GodotNavigationServer::GodotNavigationServer() :
 		NavigationServer(),
 		active(true) {
@@ -120,6 +144,11 @@ GodotNavigationServer::GodotNavigationServer() :
 
 GodotNavigationServer::~GodotNavigationServer() {
 	flush_queries();
+
+	for (uint32_t i = 0; i < deferred_path_batches.size(); i++) {
+		finish_path_batch(deferred_path_batches[i]);
+		memdelete(deferred_path_batches[i]);
+	}
 }
 
 void GodotNavigationServer::add_command(SetCommand *command) const {
@@ -222,6 +251,90 @@ Vector<Vector3> GodotNavigationServer::map_get_path(RID p_map, Vector3 p_origin,
 	return map->get_path(p_origin, p_destination, p_optimize);
 }
 
+PathQueryBatch *GodotNavigationServer::start_path_batch(RID p_map, const Vector<PathQuery> &p_queries) const {
+	NavMap *map = map_owner.getornull(p_map);
+	ERR_FAIL_COND_V(map == nullptr, nullptr);
+
+	PathQueryBatch *batch = memnew(PathQueryBatch);
+	// The snapshot stays valid even if the map is synced or freed meanwhile.
+	batch->snapshot = map->get_snapshot();
+	batch->queries = p_queries;
+	batch->paths.resize(p_queries.size());
+	batch->paths_ptrw = batch->paths.ptrw();
+
+	if (WorkerThreadPool::get_singleton() && p_queries.size() > 1) {
+		batch->task = WorkerThreadPool::get_singleton()->add_template_group_task(batch, &PathQueryBatch::solve, (const NavMapSnapshot *)batch->snapshot, p_queries.size());
+	} else {
+		for (int i = 0; i < p_queries.size(); i++) {
+			batch->solve(i, batch->snapshot);
+		}
+	}
+	return batch;
+}
+
+void GodotNavigationServer::finish_path_batch(PathQueryBatch *p_batch) const {
+	if (p_batch->task != WorkerThreadPool::INVALID_TASK_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(p_batch->task);
+		p_batch->task = WorkerThreadPool::INVALID_TASK_ID;
+	}
+	if (p_batch->snapshot) {
+		p_batch->snapshot->unreference();
+		p_batch->snapshot = nullptr;
+	}
+}
+
+Vector<Vector<Vector3>> GodotNavigationServer::map_get_paths(RID p_map, const Vector<PathQuery> &p_queries) const {
+	PathQueryBatch *batch = start_path_batch(p_map, p_queries);
+	ERR_FAIL_COND_V(batch == nullptr, Vector<Vector<Vector3>>());
+
+	finish_path_batch(batch);
+	Vector<Vector<Vector3>> paths = batch->paths;
+	memdelete(batch);
+	return paths;
+}
+
+void GodotNavigationServer::map_get_paths_deferred(RID p_map, const Vector<PathQuery> &p_queries, Object *p_receiver, StringName p_method, Variant p_udata) const {
+	ERR_FAIL_COND(p_receiver == nullptr);
+
+	PathQueryBatch *batch = start_path_batch(p_map, p_queries);
+	ERR_FAIL_COND(batch == nullptr);
+	batch->receiver = p_receiver->get_instance_id();
+	batch->method = p_method;
+	batch->udata = p_udata;
+
+	auto mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(mut_this->path_batches_mutex);
+	mut_this->deferred_path_batches.push_back(batch);
+}
+
+void GodotNavigationServer::dispatch_path_batches() {
+	LocalVector<PathQueryBatch *> batches;
+	{
+		MutexLock lock(path_batches_mutex);
+		SWAP(batches, deferred_path_batches);
+	}
+
+	for (uint32_t i = 0; i < batches.size(); i++) {
+		PathQueryBatch *batch = batches[i];
+		finish_path_batch(batch);
+
+		Object *obj = ObjectDB::get_instance(batch->receiver);
+		if (obj) {
+			Array paths;
+			paths.resize(batch->paths.size());
+			for (int j = 0; j < batch->paths.size(); j++) {
+				paths[j] = batch->paths[j];
+			}
+
+			const Variant paths_variant = paths;
+			const Variant *vp[2] = { &paths_variant, &batch->udata };
+			Variant::CallError call_error;
+			obj->call(batch->method, vp, 2, call_error);
+		}
+		memdelete(batch);
+	}
+}
+
 Vector3 GodotNavigationServer::map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
 	const NavMap *map = map_owner.getornull(p_map);
 	ERR_FAIL_COND_V(map == nullptr, Vector3());
@@ -498,6 +611,9 @@ void GodotNavigationServer::flush_queries() {
 void GodotNavigationServer::process(real_t p_delta_time) {
 	flush_queries();
 
+	// Delivers the batches started since the last process, before the maps get synced again.
+	dispatch_path_batches();
+
 	if (!active) {
 		return;
 	}
@@ -65,6 +65,8 @@ struct SetCommand {
 	virtual void exec(GodotNavigationServer *server) = 0;
 };
 
+struct PathQueryBatch;
+
 class GodotNavigationServer : public NavigationServer {
 	Mutex commands_mutex;
 	/// Mutex used to make any operation threadsafe.
@@ -79,6 +81,14 @@ class GodotNavigationServer : public NavigationServer {
 	bool active;
 	Vector<NavMap *> active_maps;
 
+	/// The batches started by `map_get_paths_deferred`, dispatched during the next `process`.
+	Mutex path_batches_mutex;
+	LocalVector<PathQueryBatch *> deferred_path_batches;
+
+	PathQueryBatch *start_path_batch(RID p_map, const Vector<PathQuery> &p_queries) const;
+	void finish_path_batch(PathQueryBatch *p_batch) const;
+	void dispatch_path_batches();
+
 public:
 	GodotNavigationServer();
 	virtual ~GodotNavigationServer();
@@ -102,6 +112,8 @@ public:
 	virtual real_t map_get_edge_connection_margin(RID p_map) const;
 
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize) const;
+	virtual Vector<Vector<Vector3>> map_get_paths(RID p_map, const Vector<PathQuery> &p_queries) const;
+	virtual void map_get_paths_deferred(RID p_map, const Vector<PathQuery> &p_queries, Object *p_receiver, StringName p_method, Variant p_udata = Variant()) const;
 
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const;
@@ -50,7 +50,13 @@ NavMap::NavMap() :
 		regenerate_links(true),
 		agents_dirty(false),
 		deltatime(0.0),
-		map_update_id(0) {}
+		map_update_id(0) {
+	snapshot = memnew(NavMapSnapshot);
+}
+
+NavMap::~NavMap() {
+	snapshot->unreference();
+}
 
 void NavMap::set_up(Vector3 p_up) {
 	up = p_up;
@@ -85,7 +91,70 @@ gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 	return p;
 }
 
-Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize) const {
+NavMapSnapshot::NavMapSnapshot() :
+		map_update_id(0),
+		up(0, 1, 0) {
+	refcount.init();
+}
+
+NavMapSnapshot::~NavMapSnapshot() {
+	for (uint32_t i = 0; i < free_path_query_scratches.size(); i++) {
+		memdelete(free_path_query_scratches[i]);
+	}
+}
+
+NavMapSnapshot::PathQueryScratch *NavMapSnapshot::alloc_path_query_scratch() const {
+	PathQueryScratch *scratch = NULL;
+	path_query_scratch_mutex.lock();
+	if (free_path_query_scratches.size()) {
+		scratch = free_path_query_scratches[free_path_query_scratches.size() - 1];
+		free_path_query_scratches.resize(free_path_query_scratches.size() - 1);
+	}
+	path_query_scratch_mutex.unlock();
+
+	if (!scratch) {
+		scratch = memnew(PathQueryScratch);
+		scratch->navigation_polys.resize(polygons.size());
+		for (size_t i = 0; i < polygons.size(); i++) {
+			scratch->navigation_polys[i] = gd::NavigationPoly(&polygons[i]);
+			scratch->navigation_polys[i].self_id = i;
+		}
+	}
+
+	if (scratch->query_id > UINT32_MAX - 2) {
+		// Each query uses up to two ids, reset before they wrap around.
+		for (size_t i = 0; i < scratch->navigation_polys.size(); i++) {
+			scratch->navigation_polys[i].query_id = 0;
+		}
+		scratch->query_id = 0;
+	}
+	return scratch;
+}
+
+void NavMapSnapshot::free_path_query_scratch(PathQueryScratch *p_scratch) const {
+	p_scratch->open_list.clear();
+	MutexLock lock(path_query_scratch_mutex);
+	free_path_query_scratches.push_back(p_scratch);
+}
+
+void NavMapSnapshot::reference() {
+	refcount.ref();
+}
+
+void NavMapSnapshot::unreference() {
+	if (refcount.unref()) {
+		memdelete(this);
+	}
+}
+
+Vector<Vector3> NavMapSnapshot::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize) const {
+	PathQueryScratch *scratch = alloc_path_query_scratch();
+	Vector<Vector3> path = compute_path(scratch, p_origin, p_destination, p_optimize);
+	free_path_query_scratch(scratch);
+	return path;
+}
+
+Vector<Vector3> NavMapSnapshot::compute_path(PathQueryScratch *p_scratch, Vector3 p_origin, Vector3 p_destination, bool p_optimize) const {
 	const gd::Polygon *begin_poly = NULL;
 	const gd::Polygon *end_poly = NULL;
 	Vector3 begin_point;
@@ -132,24 +201,23 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
-	std::vector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.reserve(polygons.size() * 0.75);
+	std::vector<gd::NavigationPoly> &navigation_polys = p_scratch->navigation_polys;
+	IndexedHeap<gd::NavigationPoly *, gd::NavigationPolyCostLess, gd::NavigationPolyOpenListIndexer> &open_list = p_scratch->open_list;
+	uint32_t query_id = ++p_scratch->query_id;
 
-	// The elements indices in the `navigation_polys`.
-	int least_cost_id(-1);
-	List<uint32_t> open_list;
+	// The elements indices in the `navigation_polys`, which are the polygon ids.
+	int least_cost_id = begin_poly->id;
 	bool found_route = false;
 
-	navigation_polys.push_back(gd::NavigationPoly(begin_poly));
 	{
-		least_cost_id = 0;
 		gd::NavigationPoly *least_cost_poly = &navigation_polys[least_cost_id];
-		least_cost_poly->self_id = least_cost_id;
+		least_cost_poly->query_id = query_id;
+		least_cost_poly->prev_navigation_poly_id = -1;
+		least_cost_poly->back_navigation_edge = 0;
+		least_cost_poly->traveled_distance = 0.0;
 		least_cost_poly->entry = begin_point;
 	}
 
-	open_list.push_back(0);
-
 	const gd::Polygon *reachable_end = NULL;
 	float reachable_d = 1e30;
 	bool is_reachable = true;
@@ -157,9 +225,8 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	while (found_route == false) {
 		{
 			// Takes the current least_cost_poly neighbors and compute the traveled_distance of each
-			for (size_t i = 0; i < navigation_polys[least_cost_id].poly->edges.size(); i++) {
-				gd::NavigationPoly *least_cost_poly = &navigation_polys[least_cost_id];
-
+			gd::NavigationPoly *least_cost_poly = &navigation_polys[least_cost_id];
+			for (size_t i = 0; i < least_cost_poly->poly->edges.size(); i++) {
 				const gd::Edge &edge = least_cost_poly->poly->edges[i];
 				if (!edge.other_polygon)
 					continue;
@@ -176,43 +243,42 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 				const float new_distance = least_cost_poly->poly->center.distance_to(edge.other_polygon->center) + least_cost_poly->traveled_distance;
 #endif
 
-				auto it = std::find(
-						navigation_polys.begin(),
-						navigation_polys.end(),
-						gd::NavigationPoly(edge.other_polygon));
+				gd::NavigationPoly *np = &navigation_polys[edge.other_polygon->id];
 
-				if (it != navigation_polys.end()) {
+				if (np->query_id == query_id) {
 					// Oh this was visited already, can we win the cost?
-					if (it->traveled_distance > new_distance) {
-						it->prev_navigation_poly_id = least_cost_id;
-						it->back_navigation_edge = edge.other_edge;
-						it->traveled_distance = new_distance;
+					if (np->traveled_distance > new_distance) {
+						np->prev_navigation_poly_id = least_cost_id;
+						np->back_navigation_edge = edge.other_edge;
+						np->traveled_distance = new_distance;
 #ifdef USE_ENTRY_POINT
-						it->entry = new_entry;
+						np->entry = new_entry;
+						np->total_cost = new_distance + new_entry.distance_to(end_point);
+#else
+						np->total_cost = new_distance + np->poly->center.distance_to(end_point);
 #endif
+						if (np->open_list_index != INDEXED_HEAP_INVALID_INDEX) {
+							open_list.shift(np->open_list_index);
+						}
 					}
 				} else {
 					// Add to open neighbours
-
-					navigation_polys.push_back(gd::NavigationPoly(edge.other_polygon));
-					gd::NavigationPoly *np = &navigation_polys[navigation_polys.size() - 1];
-
-					np->self_id = navigation_polys.size() - 1;
+					np->query_id = query_id;
 					np->prev_navigation_poly_id = least_cost_id;
 					np->back_navigation_edge = edge.other_edge;
 					np->traveled_distance = new_distance;
 #ifdef USE_ENTRY_POINT
 					np->entry = new_entry;
+					np->total_cost = new_distance + new_entry.distance_to(end_point);
+#else
+					np->total_cost = new_distance + np->poly->center.distance_to(end_point);
 #endif
-					open_list.push_back(navigation_polys.size() - 1);
+					open_list.push(np);
 				}
 			}
 		}
 
-		// Removes the least cost polygon from the open list so we can advance.
-		open_list.erase(least_cost_id);
-
-		if (open_list.size() == 0) {
+		if (open_list.is_empty()) {
 			// When the open list is empty at this point the End Polygon is not reachable
 			// so use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
@@ -235,12 +301,10 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 				}
 			}
 
-			// Reset open and navigation_polys
-			gd::NavigationPoly np = navigation_polys[0];
-			navigation_polys.clear();
-			navigation_polys.push_back(np);
-			open_list.clear();
-			open_list.push_back(0);
+			// Restart the search from the begin poly, everything visited so far becomes stale.
+			query_id = ++p_scratch->query_id;
+			least_cost_id = begin_poly->id;
+			navigation_polys[least_cost_id].query_id = query_id;
 
 			reachable_end = NULL;
 
@@ -248,22 +312,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		}
 
 		// Now take the new least_cost_poly from the open list.
-		least_cost_id = -1;
-		float least_cost = 1e30;
-
-		for (auto element = open_list.front(); element != NULL; element = element->next()) {
-			gd::NavigationPoly *np = &navigation_polys[element->get()];
-			float cost = np->traveled_distance;
-#ifdef USE_ENTRY_POINT
-			cost += np->entry.distance_to(end_point);
-#else
-			cost += np->poly->center.distance_to(end_point);
-#endif
-			if (cost < least_cost) {
-				least_cost_id = np->self_id;
-				least_cost = cost;
-			}
-		}
+		least_cost_id = open_list.pop()->self_id;
 
 		// Stores the further reachable end polygon, in case our goal is not reachable.
 		if (is_reachable) {
@@ -274,8 +323,6 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			}
 		}
 
-		ERR_BREAK(least_cost_id == -1);
-
 		// Check if we reached the end
 		if (navigation_polys[least_cost_id].poly == end_poly) {
 			// Yep, done!!
@@ -397,11 +444,26 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	return Vector<Vector3>();
 }
 
+NavMapSnapshot *NavMap::get_snapshot() const {
+	MutexLock lock(snapshot_mutex);
+	snapshot->reference();
+	return snapshot;
+}
+
+Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize) const {
+	NavMapSnapshot *current = get_snapshot();
+	Vector<Vector3> path = current->get_path(p_origin, p_destination, p_optimize);
+	current->unreference();
+	return path;
+}
+
 Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
 	bool use_collision = p_use_collision;
 	Vector3 closest_point;
 	real_t closest_point_d = 1e20;
 
+	NavMapSnapshot *current = get_snapshot();
+	const std::vector<gd::Polygon> &polygons = current->get_polygons();
 	for (size_t i(0); i < polygons.size(); i++) {
 		const gd::Polygon &p = polygons[i];
 
@@ -442,6 +504,7 @@ Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector
 			}
 		}
 	}
+	current->unreference();
 
 	return closest_point;
 }
@@ -465,6 +528,8 @@ gd::ClosestPointQueryResult NavMap::get_closest_point_info(const Vector3 &p_poin
 	gd::ClosestPointQueryResult result;
 	real_t closest_point_ds = 1e20;
 
+	NavMapSnapshot *current = get_snapshot();
+	const std::vector<gd::Polygon> &polygons = current->get_polygons();
 	for (size_t i(0); i < polygons.size(); i++) {
 		const gd::Polygon &p = polygons[i];
 
@@ -481,6 +546,7 @@ gd::ClosestPointQueryResult NavMap::get_closest_point_info(const Vector3 &p_poin
 			}
 		}
 	}
+	current->unreference();
 
 	return result;
 }
@@ -548,6 +614,11 @@ void NavMap::sync() {
 	}
 
 	if (regenerate_links) {
+		// The polygons are built in a new snapshot, queries still running on the old one are not affected.
+		NavMapSnapshot *new_snapshot = memnew(NavMapSnapshot);
+		new_snapshot->up = up;
+		std::vector<gd::Polygon> &polygons = new_snapshot->polygons;
+
 		// Copy all region polygons in the map.
 		int count = 0;
 		for (size_t r(0); r < regions.size(); r++) {
@@ -566,6 +637,10 @@ void NavMap::sync() {
 			count += regions[r]->get_polygons().size();
 		}
 
+		for (size_t poly_id(0); poly_id < polygons.size(); poly_id++) {
+			polygons[poly_id].id = poly_id;
+		}
+
 		// Connects the `Edges` of all the `Polygons` of all `Regions` each other.
 		Map<gd::EdgeKey, gd::Connection> connections;
 
@@ -677,10 +752,15 @@ void NavMap::sync() {
 				}
 			}
 		}
-	}
 
-	if (regenerate_links) {
 		map_update_id = map_update_id + 1 % 9999999;
+		new_snapshot->map_update_id = map_update_id;
+
+		snapshot_mutex.lock();
+		NavMapSnapshot *old_snapshot = snapshot;
+		snapshot = new_snapshot;
+		snapshot_mutex.unlock();
+		old_snapshot->unreference();
 	}
 
 	if (agents_dirty) {
@@ -718,7 +798,7 @@ void NavMap::dispatch_callbacks() {
 	}
 }
 
-void NavMap::clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const {
+void NavMapSnapshot::clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const {
 	Vector3 from = path[path.size() - 1];
 
 	if (from.distance_to(p_to_point) < CMP_EPSILON)
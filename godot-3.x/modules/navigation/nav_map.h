@@ -33,7 +33,10 @@
 
 #include "nav_rid.h"
 
+#include "core/local_vector.h"
 #include "core/math/math_defs.h"
+#include "core/os/mutex.h"
+#include "core/safe_refcount.h"
 #include "nav_utils.h"
 #include <KdTree.h>
 
@@ -45,6 +48,60 @@ class NavRegion;
 class RvoAgent;
 class NavRegion;
 
+/// Immutable copy of the map polygons, built by `NavMap::sync()`.
+/// Path queries only read a snapshot, so they can run on any thread while
+/// the map keeps changing; a snapshot lives until its last query is done.
+class NavMapSnapshot {
+	friend class NavMap;
+
+	/// Memory used by a single path query, kept around and reused
+	/// by the next queries so that they do not allocate.
+	struct PathQueryScratch {
+		/// One `NavigationPoly` per map polygon, indexed by the polygon id.
+		std::vector<gd::NavigationPoly> navigation_polys;
+		IndexedHeap<gd::NavigationPoly *, gd::NavigationPolyCostLess, gd::NavigationPolyOpenListIndexer> open_list;
+		uint32_t query_id = 0;
+	};
+
+	SafeRefCount refcount;
+
+	/// The map update id this snapshot was taken at.
+	uint32_t map_update_id;
+
+	/// Map Up
+	Vector3 up;
+
+	/// Map polygons
+	std::vector<gd::Polygon> polygons;
+
+	/// Path query scratch memory not in use, queries can run from multiple threads.
+	mutable LocalVector<PathQueryScratch *> free_path_query_scratches;
+	mutable BinaryMutex path_query_scratch_mutex;
+
+public:
+	NavMapSnapshot();
+	~NavMapSnapshot();
+
+	uint32_t get_map_update_id() const {
+		return map_update_id;
+	}
+
+	const std::vector<gd::Polygon> &get_polygons() const {
+		return polygons;
+	}
+
+	Vector<Vector3> get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize) const;
+
+	void reference();
+	void unreference();
+
+private:
+	PathQueryScratch *alloc_path_query_scratch() const;
+	void free_path_query_scratch(PathQueryScratch *p_scratch) const;
+	Vector<Vector3> compute_path(PathQueryScratch *p_scratch, Vector3 p_origin, Vector3 p_destination, bool p_optimize) const;
+	void clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const;
+};
+
 class NavMap : public NavRid {
 	/// Map Up
 	Vector3 up;
@@ -62,8 +119,9 @@ class NavMap : public NavRid {
 
 	std::vector<NavRegion *> regions;
 
-	/// Map polygons
-	std::vector<gd::Polygon> polygons;
+	/// Map polygons, swapped with a new snapshot each time the links are regenerated.
+	NavMapSnapshot *snapshot;
+	mutable BinaryMutex snapshot_mutex;
 
 	/// Rvo world
 	RVO::KdTree rvo;
@@ -85,6 +143,7 @@ class NavMap : public NavRid {
 
 public:
 	NavMap();
+	~NavMap();
 
 	void set_up(Vector3 p_up);
 	Vector3 get_up() const {
@@ -135,13 +194,15 @@ public:
 		return map_update_id;
 	}
 
+	/// Returns the latest polygons snapshot, referenced; `unreference()` it once done.
+	NavMapSnapshot *get_snapshot() const;
+
 	void sync();
 	void step(real_t p_deltatime);
 	void dispatch_callbacks();
 
 private:
 	void compute_single_step(uint32_t index, RvoAgent **agent);
-	void clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const;
 };
 
 #endif // RVO_SPACE_H
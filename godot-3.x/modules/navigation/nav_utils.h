@@ -31,6 +31,7 @@
 #ifndef NAV_UTILS_H
 #define NAV_UTILS_H
 
+#include "core/indexed_heap.h"
 #include "core/math/vector3.h"
 #include <vector>
 
@@ -94,6 +95,9 @@ struct Edge {
 };
 
 struct Polygon {
+	/// The index of this `Polygon` in the map polygons.
+	uint32_t id;
+
 	NavRegion *owner;
 
 	/// The points of this `Polygon`
@@ -135,13 +139,22 @@ struct NavigationPoly {
 	Vector3 entry;
 	/// The distance to the destination.
 	float traveled_distance;
-
-	NavigationPoly(const Polygon *p_poly) :
+	/// The traveled distance plus the estimated distance left to the destination.
+	float total_cost;
+	/// The position in the open list, `INDEXED_HEAP_INVALID_INDEX` when not in it.
+	uint32_t open_list_index;
+	/// The path query that last visited this poly; data from other queries is stale.
+	uint32_t query_id;
+
+	NavigationPoly(const Polygon *p_poly = NULL) :
 			self_id(0),
 			poly(p_poly),
 			prev_navigation_poly_id(-1),
 			back_navigation_edge(0),
-			traveled_distance(0.0) {
+			traveled_distance(0.0),
+			total_cost(0.0),
+			open_list_index(INDEXED_HEAP_INVALID_INDEX),
+			query_id(0) {
 	}
 
 	bool operator==(const NavigationPoly &other) const {
@@ -153,6 +166,18 @@ struct NavigationPoly {
 	}
 };
 
+struct NavigationPolyCostLess {
+	_FORCE_INLINE_ bool operator()(const NavigationPoly *p_a, const NavigationPoly *p_b) const {
+		return p_a->total_cost < p_b->total_cost;
+	}
+};
+
+struct NavigationPolyOpenListIndexer {
+	_FORCE_INLINE_ void operator()(NavigationPoly *p_poly, uint32_t p_index) const {
+		p_poly->open_list_index = p_index;
+	}
+};
+
 struct FreeEdge {
 	bool is_free;
 	Polygon *poly;
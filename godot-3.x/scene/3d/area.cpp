@@ -128,7 +128,7 @@ void Area::_body_exit_tree(ObjectID p_id) {
 	}
 }
 
-void Area::_body_inout(int p_status, const RID &p_body, int p_instance, int p_body_shape, int p_area_shape) {
+void Area::_body_inout(int p_status, const RID &p_body, ObjectID p_instance, int p_body_shape, int p_area_shape) {
 	bool body_in = p_status == PhysicsServer::AREA_BODY_ADDED;
 	ObjectID objid = p_instance;
 
@@ -306,7 +306,7 @@ void Area::_area_exit_tree(ObjectID p_id) {
 	}
 }
 
-void Area::_area_inout(int p_status, const RID &p_area, int p_instance, int p_area_shape, int p_self_shape) {
+void Area::_area_inout(int p_status, const RID &p_area, ObjectID p_instance, int p_area_shape, int p_self_shape) {
 	bool area_in = p_status == PhysicsServer::AREA_BODY_ADDED;
 	ObjectID objid = p_instance;
 
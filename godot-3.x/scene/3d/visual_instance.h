@@ -88,6 +88,7 @@ public:
 	enum Flags {
 		FLAG_USE_BAKED_LIGHT = VS::INSTANCE_FLAG_USE_BAKED_LIGHT,
 		FLAG_DRAW_NEXT_FRAME_IF_VISIBLE = VS::INSTANCE_FLAG_DRAW_NEXT_FRAME_IF_VISIBLE,
+		FLAG_OCCLUDER = VS::INSTANCE_FLAG_OCCLUDER,
 		FLAG_MAX = VS::INSTANCE_FLAG_MAX,
 	};
 
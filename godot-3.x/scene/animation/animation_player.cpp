@@ -32,6 +32,7 @@
 
 #include "core/engine.h"
 #include "core/message_queue.h"
+#include "core/os/worker_thread_pool.h"
 #include "scene/scene_string_names.h"
 #include "servers/audio/audio_stream.h"
 
@@ -183,6 +184,8 @@ void AnimationPlayer::_get_property_list(List<PropertyInfo> *p_list) const {
 	p_list->push_back(PropertyInfo(Variant::ARRAY, "blend_times", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
 }
 
+LocalVector<AnimationPlayer *> AnimationPlayer::parallel_batch[AnimationPlayer::ANIMATION_PROCESS_MANUAL];
+
 void AnimationPlayer::advance(float p_time) {
 	_animation_process(p_time);
 }
@@ -211,7 +214,7 @@ void AnimationPlayer::_notification(int p_what) {
 			}
 
 			if (processing) {
-				_animation_process(get_process_delta_time());
+				_animation_process(get_process_delta_time(), parallel_process);
 			}
 		} break;
 		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
@@ -220,10 +223,14 @@ void AnimationPlayer::_notification(int p_what) {
 			}
 
 			if (processing) {
-				_animation_process(get_physics_process_delta_time());
+				_animation_process(get_physics_process_delta_time(), parallel_process);
 			}
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
+			if (parallel_pending) {
+				parallel_batch[animation_process_mode].erase(this);
+				parallel_pending = false;
+			}
 			clear_caches();
 		} break;
 	}
@@ -242,14 +249,16 @@ void AnimationPlayer::_ensure_node_caches(AnimationData *p_anim, Node *p_root_ov
 	Animation *a = p_anim->animation.operator->();
 
 	p_anim->node_cache.resize(a->get_track_count());
+	p_anim->key_cursors.resize(a->get_track_count());
 
 	for (int i = 0; i < a->get_track_count(); i++) {
 		p_anim->node_cache.write[i] = NULL;
+		p_anim->key_cursors[i] = -1;
 		RES resource;
 		Vector<StringName> leftover_path;
 		Node *child = parent->get_node_and_resource(a->track_get_path(i), resource, leftover_path);
 		ERR_CONTINUE_MSG(!child, "On Animation: '" + p_anim->name + "', couldn't resolve track:  '" + String(a->track_get_path(i)) + "'."); // couldn't find the child node
-		uint32_t id = resource.is_valid() ? resource->get_instance_id() : child->get_instance_id();
+		ObjectID id = resource.is_valid() ? resource->get_instance_id() : child->get_instance_id();
 		int bone_idx = -1;
 
 		if (a->track_get_path(i).get_subname_count() == 1 && Object::cast_to<Skeleton>(child)) {
@@ -371,29 +380,17 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 					continue;
 				}
 
-				Vector3 loc;
-				Quat rot;
-				Vector3 scale;
-
-				Error err = a->transform_track_interpolate(i, p_time, &loc, &rot, &scale);
-				//ERR_CONTINUE(err!=OK); //used for testing, should be removed
-
-				if (err != OK) {
-					continue;
-				}
-
-				if (nc->accum_pass != accum_pass) {
-					ERR_CONTINUE(cache_update_size >= NODE_CACHE_UPDATE_MAX);
-					cache_update[cache_update_size++] = nc;
-					nc->accum_pass = accum_pass;
-					nc->loc_accum = loc;
-					nc->rot_accum = rot;
-					nc->scale_accum = scale;
-
+				if (parallel_recording) {
+					// Sampling is pure data work, defer it to flush_parallel_process().
+					TransformSample sample;
+					sample.anim = p_anim;
+					sample.nc = nc;
+					sample.track = i;
+					sample.time = p_time;
+					sample.interp = p_interp;
+					transform_samples.push_back(sample);
 				} else {
-					nc->loc_accum = nc->loc_accum.linear_interpolate(loc, p_interp);
-					nc->rot_accum = nc->rot_accum.slerp(rot, p_interp);
-					nc->scale_accum = nc->scale_accum.linear_interpolate(scale, p_interp);
+					_accumulate_transform(p_anim, nc, i, p_time, p_interp);
 				}
 
 			} break;
@@ -772,6 +769,42 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 	}
 }
 
+void AnimationPlayer::_accumulate_transform(AnimationData *p_anim, TrackNodeCache *p_nc, int p_track, float p_time, float p_interp) {
+	Vector3 loc;
+	Quat rot;
+	Vector3 scale;
+
+	Error err = p_anim->animation->transform_track_interpolate(p_track, p_time, &loc, &rot, &scale, &p_anim->key_cursors[p_track]);
+	//ERR_FAIL_COND(err!=OK); //used for testing, should be removed
+
+	if (err != OK) {
+		return;
+	}
+
+	if (p_nc->accum_pass != accum_pass) {
+		ERR_FAIL_COND(cache_update_size >= NODE_CACHE_UPDATE_MAX);
+		cache_update[cache_update_size++] = p_nc;
+		p_nc->accum_pass = accum_pass;
+		p_nc->loc_accum = loc;
+		p_nc->rot_accum = rot;
+		p_nc->scale_accum = scale;
+
+	} else {
+		p_nc->loc_accum = p_nc->loc_accum.linear_interpolate(loc, p_interp);
+		p_nc->rot_accum = p_nc->rot_accum.slerp(rot, p_interp);
+		p_nc->scale_accum = p_nc->scale_accum.linear_interpolate(scale, p_interp);
+	}
+}
+
+void AnimationPlayer::_sample_transforms() {
+	// Samples are replayed in recording order, so blending matches the serial path.
+	for (uint32_t i = 0; i < transform_samples.size(); i++) {
+		const TransformSample &sample = transform_samples[i];
+		_accumulate_transform(sample.anim, sample.nc, sample.track, sample.time, sample.interp);
+	}
+	transform_samples.clear();
+}
+
 void AnimationPlayer::_animation_process_data(PlaybackData &cd, float p_delta, float p_blend, bool p_seeked, bool p_started) {
 	float delta = p_delta * speed_scale * cd.speed_scale;
 	float next_pos = cd.pos + delta;
@@ -921,35 +954,33 @@ void AnimationPlayer::_animation_update_transforms() {
 	cache_update_bezier_size = 0;
 }
 
-void AnimationPlayer::_animation_process(float p_delta) {
+void AnimationPlayer::_animation_process(float p_delta, bool p_parallel) {
+	// Processed again before the batch was flushed, finish the previous pass first.
+	_finish_parallel_pending();
+
 	if (playback.current.from) {
 		end_reached = false;
 		end_notify = false;
-		_animation_process2(p_delta, playback.started);
+
+		if (p_parallel) {
+			// Only record transform samples now; they are evaluated together with
+			// all other batched players, then applied in _animation_process_finish().
+			parallel_recording = true;
+			_animation_process2(p_delta, playback.started);
+			parallel_recording = false;
+
+			parallel_pending = true;
+			parallel_batch[animation_process_mode].push_back(this);
+		} else {
+			_animation_process2(p_delta, playback.started);
+		}
 
 		if (playback.started) {
 			playback.started = false;
 		}
 
-		_animation_update_transforms();
-		if (end_reached) {
-			if (queued.size()) {
-				String old = playback.assigned;
-				play(queued.front()->get());
-				String new_name = playback.assigned;
-				queued.pop_front();
-				if (end_notify) {
-					emit_signal(SceneStringNames::get_singleton()->animation_changed, old, new_name);
-				}
-			} else {
-				//stop();
-				playing = false;
-				_set_process(false);
-				if (end_notify) {
-					emit_signal(SceneStringNames::get_singleton()->animation_finished, playback.assigned);
-				}
-			}
-			end_reached = false;
+		if (!parallel_pending) {
+			_animation_process_finish();
 		}
 
 	} else {
@@ -957,6 +988,40 @@ void AnimationPlayer::_animation_process(float p_delta) {
 	}
 }
 
+void AnimationPlayer::_finish_parallel_pending() {
+	if (!parallel_pending) {
+		return;
+	}
+
+	parallel_batch[animation_process_mode].erase(this);
+	parallel_pending = false;
+	_sample_transforms();
+	_animation_process_finish();
+}
+
+void AnimationPlayer::_animation_process_finish() {
+	_animation_update_transforms();
+	if (end_reached) {
+		if (queued.size()) {
+			String old = playback.assigned;
+			play(queued.front()->get());
+			String new_name = playback.assigned;
+			queued.pop_front();
+			if (end_notify) {
+				emit_signal(SceneStringNames::get_singleton()->animation_changed, old, new_name);
+			}
+		} else {
+			//stop();
+			playing = false;
+			_set_process(false);
+			if (end_notify) {
+				emit_signal(SceneStringNames::get_singleton()->animation_finished, playback.assigned);
+			}
+		}
+		end_reached = false;
+	}
+}
+
 Error AnimationPlayer::add_animation(const StringName &p_name, const Ref<Animation> &p_animation) {
 #ifdef DEBUG_ENABLED
 	ERR_FAIL_COND_V_MSG(String(p_name).find("/") != -1 || String(p_name).find(":") != -1 || String(p_name).find(",") != -1 || String(p_name).find("[") != -1, ERR_INVALID_PARAMETER, "Invalid animation name: " + String(p_name) + ".");
@@ -965,6 +1030,8 @@ Error AnimationPlayer::add_animation(const StringName &p_name, const Ref<Animati
 	ERR_FAIL_COND_V(p_animation.is_null(), ERR_INVALID_PARAMETER);
 
 	if (animation_set.has(p_name)) {
+		// Pending transform samples still use the old animation.
+		_finish_parallel_pending();
 		_unref_anim(animation_set[p_name].animation);
 		animation_set[p_name].animation = p_animation;
 		clear_caches();
@@ -984,6 +1051,9 @@ void AnimationPlayer::remove_animation(const StringName &p_name) {
 	ERR_FAIL_COND(!animation_set.has(p_name));
 
 	stop();
+	_finish_parallel_pending();
+	clear_caches();
+
 	_unref_anim(animation_set[p_name].animation);
 	animation_set.erase(p_name);
 
@@ -1005,6 +1075,9 @@ void AnimationPlayer::rename_animation(const StringName &p_name, const StringNam
 	ERR_FAIL_COND(animation_set.has(p_new_name));
 
 	stop();
+	_finish_parallel_pending();
+	clear_caches();
+
 	AnimationData ad = animation_set[p_name];
 	ad.name = p_new_name;
 	animation_set.erase(p_name);
@@ -1374,6 +1447,7 @@ void AnimationPlayer::clear_caches() {
 	cache_update_size = 0;
 	cache_update_prop_size = 0;
 	cache_update_bezier_size = 0;
+	transform_samples.clear();
 }
 
 void AnimationPlayer::set_active(bool p_active) {
@@ -1423,6 +1497,8 @@ void AnimationPlayer::set_animation_process_mode(AnimationProcessMode p_mode) {
 		return;
 	}
 
+	_finish_parallel_pending();
+
 	bool pr = processing;
 	if (pr) {
 		_set_process(false);
@@ -1445,6 +1521,56 @@ AnimationPlayer::AnimationMethodCallMode AnimationPlayer::get_method_call_mode()
 	return method_call_mode;
 }
 
+void AnimationPlayer::set_parallel_process_enabled(bool p_enabled) {
+	parallel_process = p_enabled;
+}
+
+bool AnimationPlayer::is_parallel_process_enabled() const {
+	return parallel_process;
+}
+
+void AnimationPlayer::_parallel_sample_task(void *p_batch, uint32_t p_index) {
+	static_cast<AnimationPlayer **>(p_batch)[p_index]->_sample_transforms();
+}
+
+void AnimationPlayer::flush_parallel_process(AnimationProcessMode p_mode) {
+	ERR_FAIL_INDEX(p_mode, ANIMATION_PROCESS_MANUAL);
+
+	LocalVector<AnimationPlayer *> &batch = parallel_batch[p_mode];
+	if (batch.empty()) {
+		return;
+	}
+
+	// Interpolating and blending transform tracks only touches the player's own
+	// caches, so every player in the batch can be sampled on a different thread.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 1 && batch.size() > 1) {
+		WorkerThreadPool::TaskID task = pool->add_native_group_task(&AnimationPlayer::_parallel_sample_task, batch.ptr(), batch.size());
+		pool->wait_for_task_completion(task);
+	} else {
+		for (uint32_t i = 0; i < batch.size(); i++) {
+			batch[i]->_sample_transforms();
+		}
+	}
+
+	// Writing poses and emitting signals may run arbitrary code (even freeing
+	// other players in the batch), so finish through object IDs.
+	LocalVector<ObjectID> ids;
+	ids.resize(batch.size());
+	for (uint32_t i = 0; i < batch.size(); i++) {
+		ids[i] = batch[i]->get_instance_id();
+	}
+	batch.clear();
+
+	for (uint32_t i = 0; i < ids.size(); i++) {
+		AnimationPlayer *player = Object::cast_to<AnimationPlayer>(ObjectDB::get_instance(ids[i]));
+		if (player && player->parallel_pending) {
+			player->parallel_pending = false;
+			player->_animation_process_finish();
+		}
+	}
+}
+
 void AnimationPlayer::_set_process(bool p_process, bool p_force) {
 	if (processing == p_process && !p_force) {
 		return;
@@ -1660,6 +1786,9 @@ void AnimationPlayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_method_call_mode", "mode"), &AnimationPlayer::set_method_call_mode);
 	ClassDB::bind_method(D_METHOD("get_method_call_mode"), &AnimationPlayer::get_method_call_mode);
 
+	ClassDB::bind_method(D_METHOD("set_parallel_process_enabled", "enabled"), &AnimationPlayer::set_parallel_process_enabled);
+	ClassDB::bind_method(D_METHOD("is_parallel_process_enabled"), &AnimationPlayer::is_parallel_process_enabled);
+
 	ClassDB::bind_method(D_METHOD("get_current_animation_position"), &AnimationPlayer::get_current_animation_position);
 	ClassDB::bind_method(D_METHOD("get_current_animation_length"), &AnimationPlayer::get_current_animation_length);
 
@@ -1676,6 +1805,7 @@ void AnimationPlayer::_bind_methods() {
 
 	ADD_GROUP("Playback Options", "playback_");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "playback_process_mode", PROPERTY_HINT_ENUM, "Physics,Idle,Manual"), "set_animation_process_mode", "get_animation_process_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "playback_parallel_process"), "set_parallel_process_enabled", "is_parallel_process_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "playback_default_blend_time", PROPERTY_HINT_RANGE, "0,4096,0.01"), "set_default_blend_time", "get_default_blend_time");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "playback_active", PROPERTY_HINT_NONE, "", 0), "set_active", "is_active");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "playback_speed", PROPERTY_HINT_RANGE, "-64,64,0.01"), "set_speed_scale", "get_speed_scale");
@@ -1706,6 +1836,9 @@ AnimationPlayer::AnimationPlayer() {
 	animation_process_mode = ANIMATION_PROCESS_IDLE;
 	method_call_mode = ANIMATION_METHOD_CALL_DEFERRED;
 	processing = false;
+	parallel_process = false;
+	parallel_pending = false;
+	parallel_recording = false;
 	default_blend_time = 0;
 	root = SceneStringNames::get_singleton()->path_pp;
 	playing = false;
@@ -91,7 +91,7 @@ private:
 
 	struct TrackNodeCache {
 		NodePath path;
-		uint32_t id;
+		ObjectID id;
 		RES resource;
 		Node *node;
 		Spatial *spatial;
@@ -160,7 +160,7 @@ private:
 	};
 
 	struct TrackNodeCacheKey {
-		uint32_t id;
+		ObjectID id;
 		int bone_idx;
 
 		inline bool operator<(const TrackNodeCacheKey &p_right) const {
@@ -192,10 +192,31 @@ private:
 		String name;
 		StringName next;
 		Vector<TrackNodeCache *> node_cache;
+		// Key hints for Animation::transform_track_interpolate(), one per track.
+		LocalVector<int> key_cursors;
 		Ref<Animation> animation;
 	};
 
 	Map<StringName, AnimationData> animation_set;
+
+	// Transform track samples recorded while processing in parallel mode;
+	// they are interpolated and blended later from a worker thread.
+	struct TransformSample {
+		AnimationData *anim;
+		TrackNodeCache *nc;
+		int track;
+		float time;
+		float interp;
+	};
+
+	LocalVector<TransformSample> transform_samples;
+	bool parallel_process;
+	bool parallel_pending;
+	bool parallel_recording;
+
+	static LocalVector<AnimationPlayer *> parallel_batch[ANIMATION_PROCESS_MANUAL];
+	static void _parallel_sample_task(void *p_batch, uint32_t p_index);
+
 	struct BlendKey {
 		StringName from;
 		StringName to;
@@ -251,12 +272,16 @@ private:
 	NodePath root;
 
 	void _animation_process_animation(AnimationData *p_anim, float p_time, float p_delta, float p_interp, bool p_is_current = true, bool p_seeked = false, bool p_started = false);
+	void _accumulate_transform(AnimationData *p_anim, TrackNodeCache *p_nc, int p_track, float p_time, float p_interp);
+	void _sample_transforms();
 
 	void _ensure_node_caches(AnimationData *p_anim, Node *p_root_override = NULL);
 	void _animation_process_data(PlaybackData &cd, float p_delta, float p_blend, bool p_seeked, bool p_started);
 	void _animation_process2(float p_delta, bool p_started);
 	void _animation_update_transforms();
-	void _animation_process(float p_delta);
+	void _animation_process(float p_delta, bool p_parallel = false);
+	void _animation_process_finish();
+	void _finish_parallel_pending();
 
 	void _node_removed(Node *p_node);
 	void _stop_playing_caches();
@@ -340,6 +365,11 @@ public:
 	void set_method_call_mode(AnimationMethodCallMode p_mode);
 	AnimationMethodCallMode get_method_call_mode() const;
 
+	void set_parallel_process_enabled(bool p_enabled);
+	bool is_parallel_process_enabled() const;
+
+	static void flush_parallel_process(AnimationProcessMode p_mode);
+
 	void seek(float p_time, bool p_update = false);
 	void seek_delta(float p_time, float p_delta);
 	float get_current_animation_position() const;
@@ -31,6 +31,7 @@
 #include "animation.h"
 #include "scene/scene_string_names.h"
 
+#include "core/io/marshalls.h"
 #include "core/math/geometry.h"
 
 bool Animation::_set(const StringName &p_name, const Variant &p_value) {
@@ -77,6 +78,57 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 		} else if (what == "keys" || what == "key_values") {
 			if (track_get_type(track) == TYPE_TRANSFORM) {
 				TransformTrack *tt = static_cast<TransformTrack *>(tracks[track]);
+				if (p_value.get_type() == Variant::DICTIONARY) {
+					// Compressed keys, see _get().
+					Dictionary d = p_value;
+					ERR_FAIL_COND_V(!d.has("times") || !d.has("locations") || !d.has("rotations") || !d.has("scales"), false);
+					PoolVector<float> times = d["times"];
+					PoolVector<float> transitions = d.get("transitions", PoolVector<float>());
+					PoolVector<uint8_t> locs = d["locations"];
+					PoolVector<uint8_t> rots = d["rotations"];
+					PoolVector<uint8_t> scales = d["scales"];
+					int count = times.size();
+					ERR_FAIL_COND_V((transitions.size() && transitions.size() != count) || locs.size() != count * 6 || rots.size() != count * 8 || scales.size() != count * 6, false);
+
+					BakedTransformTrack &baked = tt->baked;
+					baked.quantized = true;
+					baked.loc_bounds = d.get("location_bounds", AABB());
+					baked.scale_bounds = d.get("scale_bounds", AABB());
+					baked.times.resize(count);
+					baked.transitions.resize(transitions.size());
+					baked.quantized_locs.resize(count * 3);
+					baked.quantized_rots.resize(count * 4);
+					baked.quantized_scales.resize(count * 3);
+
+					PoolVector<float>::Read rt = times.read();
+					PoolVector<float>::Read rtr = transitions.read();
+					PoolVector<uint8_t>::Read rl = locs.read();
+					PoolVector<uint8_t>::Read rr = rots.read();
+					PoolVector<uint8_t>::Read rs = scales.read();
+					for (int i = 0; i < count; i++) {
+						baked.times[i] = rt[i];
+					}
+					for (int i = 0; i < transitions.size(); i++) {
+						baked.transitions[i] = rtr[i];
+					}
+					for (int i = 0; i < count * 3; i++) {
+						baked.quantized_locs[i] = decode_uint16(&rl[i * 2]);
+						baked.quantized_scales[i] = decode_uint16(&rs[i * 2]);
+					}
+					for (int i = 0; i < count * 4; i++) {
+						baked.quantized_rots[i] = (int16_t)decode_uint16(&rr[i * 2]);
+					}
+					baked.locs.reset();
+					baked.rots.reset();
+					baked.scales.reset();
+
+					tt->transforms.clear();
+					tt->compressed = true;
+					// The key count within the length is computed on first use.
+					tt->baked_valid.clear();
+					return true;
+				}
+
 				PoolVector<float> values = p_value;
 				int vcount = values.size();
 				ERR_FAIL_COND_V(vcount % 12, false); // should be multiple of 11
@@ -104,6 +156,8 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 					tk.value.scale.y = ofs[10];
 					tk.value.scale.z = ofs[11];
 				}
+				tt->compressed = false;
+				tt->baked_valid.clear();
 
 			} else if (track_get_type(track) == TYPE_VALUE) {
 				ValueTrack *vt = static_cast<ValueTrack *>(tracks[track]);
@@ -352,6 +406,57 @@ bool Animation::_get(const StringName &p_name, Variant &r_ret) const {
 			r_ret = track_is_enabled(track);
 		} else if (what == "keys") {
 			if (track_get_type(track) == TYPE_TRANSFORM) {
+				const TransformTrack *tt = static_cast<const TransformTrack *>(tracks[track]);
+				if (tt->compressed) {
+					// Stored as quantized, 2 bytes per component.
+					const BakedTransformTrack &baked = tt->baked;
+					int count = baked.times.size();
+
+					PoolVector<float> times;
+					PoolVector<float> transitions;
+					PoolVector<uint8_t> locs;
+					PoolVector<uint8_t> rots;
+					PoolVector<uint8_t> scales;
+					times.resize(count);
+					transitions.resize(baked.transitions.size());
+					locs.resize(count * 6);
+					rots.resize(count * 8);
+					scales.resize(count * 6);
+					{
+						PoolVector<float>::Write wt = times.write();
+						PoolVector<float>::Write wtr = transitions.write();
+						PoolVector<uint8_t>::Write wl = locs.write();
+						PoolVector<uint8_t>::Write wr = rots.write();
+						PoolVector<uint8_t>::Write ws = scales.write();
+						for (int i = 0; i < count; i++) {
+							wt[i] = baked.times[i];
+						}
+						for (uint32_t i = 0; i < baked.transitions.size(); i++) {
+							wtr[i] = baked.transitions[i];
+						}
+						for (int i = 0; i < count * 3; i++) {
+							encode_uint16(baked.quantized_locs[i], &wl[i * 2]);
+							encode_uint16(baked.quantized_scales[i], &ws[i * 2]);
+						}
+						for (int i = 0; i < count * 4; i++) {
+							encode_uint16((uint16_t)baked.quantized_rots[i], &wr[i * 2]);
+						}
+					}
+
+					Dictionary d;
+					d["times"] = times;
+					if (transitions.size()) {
+						d["transitions"] = transitions;
+					}
+					d["location_bounds"] = baked.loc_bounds;
+					d["scale_bounds"] = baked.scale_bounds;
+					d["locations"] = locs;
+					d["rotations"] = rots;
+					d["scales"] = scales;
+					r_ret = d;
+					return true;
+				}
+
 				PoolVector<real_t> keys;
 				int kk = track_get_key_count(track);
 				keys.resize(kk * 12);
@@ -792,6 +897,22 @@ Error Animation::transform_track_get_key(int p_track, int p_key, Vector3 *r_loc,
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, ERR_INVALID_PARAMETER);
+
+	if (tt->compressed) {
+		ERR_FAIL_INDEX_V(p_key, (int)tt->baked.times.size(), ERR_INVALID_PARAMETER);
+		TransformKey tk = _get_baked_key(tt->baked, p_key);
+		if (r_loc) {
+			*r_loc = tk.loc;
+		}
+		if (r_rot) {
+			*r_rot = tk.rot;
+		}
+		if (r_scale) {
+			*r_scale = tk.scale;
+		}
+		return OK;
+	}
+
 	ERR_FAIL_INDEX_V(p_key, tt->transforms.size(), ERR_INVALID_PARAMETER);
 
 	if (r_loc) {
@@ -813,6 +934,9 @@ int Animation::transform_track_insert_key(int p_track, float p_time, const Vecto
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, -1);
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
+	if (tt->compressed) {
+		_decompress_transform_track(tt);
+	}
 
 	TKey<TransformKey> tkey;
 	tkey.time = p_time;
@@ -821,6 +945,7 @@ int Animation::transform_track_insert_key(int p_track, float p_time, const Vecto
 	tkey.value.scale = p_scale;
 
 	int ret = _insert(p_time, tt->transforms, tkey);
+	tt->baked_valid.clear();
 	emit_changed();
 	return ret;
 }
@@ -838,8 +963,12 @@ void Animation::track_remove_key(int p_track, int p_idx) {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				_decompress_transform_track(tt);
+			}
 			ERR_FAIL_INDEX(p_idx, tt->transforms.size());
 			tt->transforms.remove(p_idx);
+			tt->baked_valid.clear();
 
 		} break;
 		case TYPE_VALUE: {
@@ -884,6 +1013,16 @@ int Animation::track_find_key(int p_track, float p_time, bool p_exact) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				int k = _find_baked(tt->baked, p_time, -2);
+				if (k < 0 || k >= (int)tt->baked.times.size()) {
+					return -1;
+				}
+				if (tt->baked.times[k] != p_time && p_exact) {
+					return -1;
+				}
+				return k;
+			}
 			int k = _find(tt->transforms, p_time);
 			if (k < 0 || k >= tt->transforms.size()) {
 				return -1;
@@ -1068,7 +1207,7 @@ int Animation::track_get_key_count(int p_track) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			return tt->transforms.size();
+			return tt->compressed ? tt->baked.times.size() : tt->transforms.size();
 		} break;
 		case TYPE_VALUE: {
 			ValueTrack *vt = static_cast<ValueTrack *>(t);
@@ -1102,13 +1241,17 @@ Variant Animation::track_get_key_value(int p_track, int p_key_idx) const {
 
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
-			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), Variant());
+			Vector3 loc;
+			Quat rot;
+			Vector3 scale;
+			if (transform_track_get_key(p_track, p_key_idx, &loc, &rot, &scale) != OK) {
+				return Variant();
+			}
 
 			Dictionary d;
-			d["location"] = tt->transforms[p_key_idx].value.loc;
-			d["rotation"] = tt->transforms[p_key_idx].value.rot;
-			d["scale"] = tt->transforms[p_key_idx].value.scale;
+			d["location"] = loc;
+			d["rotation"] = rot;
+			d["scale"] = scale;
 
 			return d;
 		} break;
@@ -1171,6 +1314,10 @@ float Animation::track_get_key_time(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, (int)tt->baked.times.size(), -1);
+				return tt->baked.times[p_key_idx];
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].time;
 		} break;
@@ -1216,11 +1363,15 @@ void Animation::track_set_key_time(int p_track, int p_key_idx, float p_time) {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				_decompress_transform_track(tt);
+			}
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			TKey<TransformKey> key = tt->transforms[p_key_idx];
 			key.time = p_time;
 			tt->transforms.remove(p_key_idx);
 			_insert(p_time, tt->transforms, key);
+			tt->baked_valid.clear();
 			return;
 		}
 		case TYPE_VALUE: {
@@ -1280,6 +1431,10 @@ float Animation::track_get_key_transition(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, (int)tt->baked.times.size(), -1);
+				return tt->baked.get_transition(p_key_idx);
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].transition;
 		} break;
@@ -1316,6 +1471,9 @@ void Animation::track_set_key_value(int p_track, int p_key_idx, const Variant &p
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				_decompress_transform_track(tt);
+			}
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 
 			Dictionary d = p_value;
@@ -1329,6 +1487,7 @@ void Animation::track_set_key_value(int p_track, int p_key_idx, const Variant &p
 			if (d.has("scale")) {
 				tt->transforms.write[p_key_idx].value.scale = d["scale"];
 			}
+			tt->baked_valid.clear();
 
 		} break;
 		case TYPE_VALUE: {
@@ -1399,8 +1558,12 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, float p_tra
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				_decompress_transform_track(tt);
+			}
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			tt->transforms.write[p_key_idx].transition = p_transition;
+			tt->baked_valid.clear();
 		} break;
 		case TYPE_VALUE: {
 			ValueTrack *vt = static_cast<ValueTrack *>(t);
@@ -1743,19 +1906,359 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, Interpola
 	// do a barrel roll
 }
 
-Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const {
+static _FORCE_INLINE_ uint16_t _quantize_in_range(real_t p_value, real_t p_begin, real_t p_size) {
+	if (p_size <= 0) {
+		return 0;
+	}
+	return (uint16_t)CLAMP(Math::round((p_value - p_begin) / p_size * 65535), 0, 65535);
+}
+
+static _FORCE_INLINE_ real_t _dequantize_in_range(uint16_t p_value, real_t p_begin, real_t p_size) {
+	return p_begin + p_size * (p_value * (real_t(1.0) / 65535));
+}
+
+void Animation::_build_baked_transform_track(TransformTrack *p_track, bool p_quantize) const {
+	BakedTransformTrack &baked = p_track->baked;
+	const TKey<TransformKey> *keys = p_track->transforms.ptr();
+	const int count = p_track->transforms.size();
+
+	baked.times.resize(count);
+	baked.transitions.reset();
+	for (int i = 0; i < count; i++) {
+		baked.times[i] = keys[i].time;
+		if (keys[i].transition != 1.0f && baked.transitions.empty()) {
+			baked.transitions.resize(count);
+			for (int j = 0; j < i; j++) {
+				baked.transitions[j] = keys[j].transition;
+			}
+		}
+		if (!baked.transitions.empty()) {
+			baked.transitions[i] = keys[i].transition;
+		}
+	}
+	baked.key_count = _find(p_track->transforms, length) + 1;
+	baked.quantized = p_quantize;
+
+	if (!baked.quantized) {
+		baked.locs.resize(count);
+		baked.rots.resize(count);
+		baked.scales.resize(count);
+		for (int i = 0; i < count; i++) {
+			baked.locs[i] = keys[i].value.loc;
+			baked.rots[i] = keys[i].value.rot;
+			baked.scales[i] = keys[i].value.scale;
+		}
+		baked.quantized_locs.reset();
+		baked.quantized_rots.reset();
+		baked.quantized_scales.reset();
+	} else {
+		baked.loc_bounds = AABB();
+		baked.scale_bounds = AABB();
+		for (int i = 0; i < count; i++) {
+			if (i == 0) {
+				baked.loc_bounds.position = keys[i].value.loc;
+				baked.scale_bounds.position = keys[i].value.scale;
+			} else {
+				baked.loc_bounds.expand_to(keys[i].value.loc);
+				baked.scale_bounds.expand_to(keys[i].value.scale);
+			}
+		}
+
+		baked.quantized_locs.resize(count * 3);
+		baked.quantized_rots.resize(count * 4);
+		baked.quantized_scales.resize(count * 3);
+		for (int i = 0; i < count; i++) {
+			const TransformKey &tk = keys[i].value;
+			for (int j = 0; j < 3; j++) {
+				baked.quantized_locs[i * 3 + j] = _quantize_in_range(tk.loc[j], baked.loc_bounds.position[j], baked.loc_bounds.size[j]);
+				baked.quantized_scales[i * 3 + j] = _quantize_in_range(tk.scale[j], baked.scale_bounds.position[j], baked.scale_bounds.size[j]);
+			}
+			baked.quantized_rots[i * 4 + 0] = (int16_t)Math::round(CLAMP(tk.rot.x, -1, 1) * 32767);
+			baked.quantized_rots[i * 4 + 1] = (int16_t)Math::round(CLAMP(tk.rot.y, -1, 1) * 32767);
+			baked.quantized_rots[i * 4 + 2] = (int16_t)Math::round(CLAMP(tk.rot.z, -1, 1) * 32767);
+			baked.quantized_rots[i * 4 + 3] = (int16_t)Math::round(CLAMP(tk.rot.w, -1, 1) * 32767);
+		}
+		baked.locs.reset();
+		baked.rots.reset();
+		baked.scales.reset();
+	}
+}
+
+void Animation::_bake_transform_track(TransformTrack *p_track) const {
+	MutexLock lock(bake_mutex);
+	if (p_track->baked_valid.is_set()) {
+		return; // Baked by another thread while waiting for the lock.
+	}
+
+	if (p_track->compressed) {
+		// The baked keys are all there is, only the length may have changed.
+		p_track->baked.key_count = _find_baked(p_track->baked, length, -2) + 1;
+	} else {
+		_build_baked_transform_track(p_track, quantize_transform_tracks);
+	}
+
+	p_track->baked_valid.set();
+}
+
+Vector<Animation::TKey<Animation::TransformKey>> Animation::_get_transform_keys(const TransformTrack *p_track) const {
+	if (!p_track->compressed) {
+		return p_track->transforms;
+	}
+
+	const BakedTransformTrack &baked = p_track->baked;
+	Vector<TKey<TransformKey>> keys;
+	keys.resize(baked.times.size());
+	for (int i = 0; i < keys.size(); i++) {
+		TKey<TransformKey> &key = keys.write[i];
+		key.time = baked.times[i];
+		key.transition = baked.get_transition(i);
+		key.value = _get_baked_key(baked, i);
+	}
+	return keys;
+}
+
+void Animation::_decompress_transform_track(TransformTrack *p_track) {
+	p_track->transforms = _get_transform_keys(p_track);
+	p_track->compressed = false;
+	p_track->baked_valid.clear();
+	if (!_uses_baked_keys(p_track)) {
+		p_track->baked = BakedTransformTrack();
+	}
+}
+
+void Animation::_invalidate_baked_transform_tracks() {
+	for (int i = 0; i < tracks.size(); i++) {
+		if (tracks[i]->type == TYPE_TRANSFORM) {
+			TransformTrack *tt = static_cast<TransformTrack *>(tracks[i]);
+			tt->baked_valid.clear();
+			if (!_uses_baked_keys(tt)) {
+				tt->baked = BakedTransformTrack(); // Don't keep a second copy of the keys around.
+			}
+		}
+	}
+}
+
+int Animation::_find_baked(const BakedTransformTrack &p_baked, float p_time, int p_cursor) const {
+	const float *times = p_baked.times.ptr();
+	const int count = p_baked.times.size();
+
+	// Sequential playback lands on the key of the previous call or the one
+	// after it. The cursor is only trusted when p_time is not close to either
+	// key, where the binary search below could not return anything else.
+	if (p_cursor >= -1 && p_cursor < count) {
+		for (int i = p_cursor; i <= p_cursor + 1 && i < count; i++) {
+			bool after_key = i < 0 || (times[i] < p_time && !Math::is_equal_approx(p_time, times[i]));
+			bool before_next = i + 1 >= count || (p_time < times[i + 1] && !Math::is_equal_approx(p_time, times[i + 1]));
+			if (after_key && before_next) {
+				return i;
+			}
+		}
+	}
+
+	if (count == 0) {
+		return -2;
+	}
+
+	int low = 0;
+	int high = count - 1;
+	int middle = 0;
+
+	while (low <= high) {
+		middle = (low + high) / 2;
+
+		if (Math::is_equal_approx(p_time, times[middle])) { //match
+			return middle;
+		} else if (p_time < times[middle]) {
+			high = middle - 1; //search low end of array
+		} else {
+			low = middle + 1; //search high end of array
+		}
+	}
+
+	if (times[middle] > p_time) {
+		middle--;
+	}
+
+	return middle;
+}
+
+Animation::TransformKey Animation::_get_baked_key(const BakedTransformTrack &p_baked, int p_key) const {
+	if (!p_baked.quantized) {
+		TransformKey tk;
+		tk.loc = p_baked.locs[p_key];
+		tk.rot = p_baked.rots[p_key];
+		tk.scale = p_baked.scales[p_key];
+		return tk;
+	}
+
+	const uint16_t *loc = &p_baked.quantized_locs[p_key * 3];
+	const int16_t *rot = &p_baked.quantized_rots[p_key * 4];
+	const uint16_t *scale = &p_baked.quantized_scales[p_key * 3];
+	const AABB &lb = p_baked.loc_bounds;
+	const AABB &sb = p_baked.scale_bounds;
+
+	TransformKey tk;
+	tk.loc = Vector3(_dequantize_in_range(loc[0], lb.position.x, lb.size.x), _dequantize_in_range(loc[1], lb.position.y, lb.size.y), _dequantize_in_range(loc[2], lb.position.z, lb.size.z));
+	// Within 1/32767 of unit length, close enough for slerp and Basis without normalizing.
+	tk.rot = Quat(rot[0], rot[1], rot[2], rot[3]) * (real_t(1.0) / 32767);
+	tk.scale = Vector3(_dequantize_in_range(scale[0], sb.position.x, sb.size.x), _dequantize_in_range(scale[1], sb.position.y, sb.size.y), _dequantize_in_range(scale[2], sb.position.z, sb.size.z));
+	return tk;
+}
+
+// Same as _interpolate() on the keys of the track, reading the baked arrays instead.
+bool Animation::_interpolate_baked(const BakedTransformTrack &p_baked, float p_time, InterpolationType p_interp, bool p_loop_wrap, int *r_cursor, TransformKey *r_key) const {
+	int len = p_baked.key_count;
+
+	if (len <= 0) {
+		return false;
+	} else if (len == 1) {
+		*r_key = _get_baked_key(p_baked, 0);
+		return true;
+	}
+
+	int idx = _find_baked(p_baked, p_time, r_cursor ? *r_cursor : -2);
+
+	ERR_FAIL_COND_V(idx == -2, false);
+
+	if (r_cursor) {
+		*r_cursor = idx;
+	}
+
+	const float *times = p_baked.times.ptr();
+	int next = 0;
+	float c = 0;
+
+	if (loop && p_loop_wrap) {
+		// loop
+		if (idx >= 0) {
+			if ((idx + 1) < len) {
+				next = idx + 1;
+				float delta = times[next] - times[idx];
+				float from = p_time - times[idx];
+
+				if (Math::is_zero_approx(delta)) {
+					c = 0;
+				} else {
+					c = from / delta;
+				}
+
+			} else {
+				next = 0;
+				float delta = (length - times[idx]) + times[next];
+				float from = p_time - times[idx];
+
+				if (Math::is_zero_approx(delta)) {
+					c = 0;
+				} else {
+					c = from / delta;
+				}
+			}
+
+		} else {
+			// on loop, behind first key
+			idx = len - 1;
+			next = 0;
+			float endtime = (length - times[idx]);
+			if (endtime < 0) { // may be keys past the end
+				endtime = 0;
+			}
+			float delta = endtime + times[next];
+			float from = endtime + p_time;
+
+			if (Math::is_zero_approx(delta)) {
+				c = 0;
+			} else {
+				c = from / delta;
+			}
+		}
+
+	} else { // no loop
+
+		if (idx >= 0) {
+			if ((idx + 1) < len) {
+				next = idx + 1;
+				float delta = times[next] - times[idx];
+				float from = p_time - times[idx];
+
+				if (Math::is_zero_approx(delta)) {
+					c = 0;
+				} else {
+					c = from / delta;
+				}
+
+			} else {
+				next = idx;
+			}
+
+		} else {
+			// only allow extending first key to anim start if looping
+			if (loop) {
+				idx = next = 0;
+			} else {
+				return false;
+			}
+		}
+	}
+
+	float tr = p_baked.get_transition(idx);
+
+	if (tr == 0 || idx == next || p_interp == INTERPOLATION_NEAREST) {
+		// don't interpolate if not needed
+		*r_key = _get_baked_key(p_baked, idx);
+		return true;
+	}
+
+	if (tr != 1.0) {
+		c = Math::ease(c, tr);
+	}
+
+	if (p_interp == INTERPOLATION_CUBIC) {
+		int pre = idx - 1;
+		if (pre < 0) {
+			if (loop && p_loop_wrap) {
+				pre = len - 1;
+			} else {
+				pre = 0;
+			}
+		}
+		int post = next + 1;
+		if (post >= len) {
+			if (loop && p_loop_wrap) {
+				post = 0;
+			} else {
+				post = next;
+			}
+		}
+
+		*r_key = _cubic_interpolate(_get_baked_key(p_baked, pre), _get_baked_key(p_baked, idx), _get_baked_key(p_baked, next), _get_baked_key(p_baked, post), c);
+	} else {
+		*r_key = _interpolate(_get_baked_key(p_baked, idx), _get_baked_key(p_baked, next), c);
+	}
+	return true;
+}
+
+Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, int *r_key_cursor) const {
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), ERR_INVALID_PARAMETER);
 	Track *t = tracks[p_track];
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, ERR_INVALID_PARAMETER);
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
 
-	bool ok = false;
-
-	TransformKey tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	TransformKey tk;
+	if (_uses_baked_keys(tt)) {
+		if (!tt->baked_valid.is_set()) {
+			_bake_transform_track(tt);
+		}
 
-	if (!ok) {
-		return ERR_UNAVAILABLE;
+		if (!_interpolate_baked(tt->baked, p_time, tt->interpolation, tt->loop_wrap, r_key_cursor, &tk)) {
+			return ERR_UNAVAILABLE;
+		}
+	} else {
+		bool ok = false;
+		tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+		if (!ok) {
+			return ERR_UNAVAILABLE;
+		}
 	}
 
 	if (r_loc) {
@@ -1924,6 +2427,44 @@ void Animation::_track_get_key_indices_in_range(const Vector<T> &p_array, float
 	}
 }
 
+void Animation::_transform_track_get_key_indices_in_range(const TransformTrack *tt, float from_time, float to_time, List<int> *p_indices) const {
+	if (!tt->compressed) {
+		_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+		return;
+	}
+
+	// Same as _track_get_key_indices_in_range(), but only looks at the key times,
+	// so no compressed key has to be decoded.
+	const BakedTransformTrack &baked = tt->baked;
+
+	if (from_time != length && to_time == length) {
+		to_time = length * 1.01; //include a little more if at the end
+	}
+
+	int to = _find_baked(baked, to_time, -2);
+
+	if (to >= 0 && baked.times[to] >= to_time) {
+		to--;
+	}
+
+	if (to < 0) {
+		return; // not bother
+	}
+
+	int from = _find_baked(baked, from_time, -2);
+
+	if (from < 0 || baked.times[from] < from_time) {
+		from++;
+	}
+
+	int max = baked.times.size();
+
+	for (int i = from; i <= to; i++) {
+		ERR_CONTINUE(i < 0 || i >= max); // shouldn't happen
+		p_indices->push_back(i);
+	}
+}
+
 void Animation::track_get_key_indices_in_range(int p_track, float p_time, float p_delta, List<int> *p_indices) const {
 	ERR_FAIL_INDEX(p_track, tracks.size());
 	const Track *t = tracks[p_track];
@@ -1950,8 +2491,8 @@ void Animation::track_get_key_indices_in_range(int p_track, float p_time, float
 			switch (t->type) {
 				case TYPE_TRANSFORM: {
 					const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-					_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
-					_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					_transform_track_get_key_indices_in_range(tt, from_time, length, p_indices);
+					_transform_track_get_key_indices_in_range(tt, 0, to_time, p_indices);
 
 				} break;
 				case TYPE_VALUE: {
@@ -2006,7 +2547,7 @@ void Animation::track_get_key_indices_in_range(int p_track, float p_time, float
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-			_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			_transform_track_get_key_indices_in_range(tt, from_time, to_time, p_indices);
 
 		} break;
 		case TYPE_VALUE: {
@@ -2483,6 +3024,7 @@ void Animation::set_length(float p_length) {
 		p_length = ANIM_MIN_LENGTH;
 	}
 	length = p_length;
+	_invalidate_baked_transform_tracks();
 	emit_changed();
 }
 float Animation::get_length() const {
@@ -2573,6 +3115,32 @@ float Animation::get_step() const {
 	return step;
 }
 
+void Animation::set_bake_transform_tracks(bool p_enable) {
+	if (bake_transform_tracks == p_enable) {
+		return;
+	}
+	bake_transform_tracks = p_enable;
+	_invalidate_baked_transform_tracks();
+	emit_changed();
+}
+
+bool Animation::is_baking_transform_tracks() const {
+	return bake_transform_tracks;
+}
+
+void Animation::set_quantize_transform_tracks(bool p_enable) {
+	if (quantize_transform_tracks == p_enable) {
+		return;
+	}
+	quantize_transform_tracks = p_enable;
+	_invalidate_baked_transform_tracks();
+	emit_changed();
+}
+
+bool Animation::is_quantizing_transform_tracks() const {
+	return quantize_transform_tracks;
+}
+
 void Animation::copy_track(int p_track, Ref<Animation> p_to_animation) {
 	ERR_FAIL_COND(p_to_animation.is_null());
 	ERR_FAIL_INDEX(p_track, get_track_count());
@@ -2677,12 +3245,23 @@ void Animation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_step", "size_sec"), &Animation::set_step);
 	ClassDB::bind_method(D_METHOD("get_step"), &Animation::get_step);
 
+	ClassDB::bind_method(D_METHOD("set_bake_transform_tracks", "enable"), &Animation::set_bake_transform_tracks);
+	ClassDB::bind_method(D_METHOD("is_baking_transform_tracks"), &Animation::is_baking_transform_tracks);
+
+	ClassDB::bind_method(D_METHOD("set_quantize_transform_tracks", "enable"), &Animation::set_quantize_transform_tracks);
+	ClassDB::bind_method(D_METHOD("is_quantizing_transform_tracks"), &Animation::is_quantizing_transform_tracks);
+
 	ClassDB::bind_method(D_METHOD("clear"), &Animation::clear);
 	ClassDB::bind_method(D_METHOD("copy_track", "track_idx", "to_animation"), &Animation::copy_track);
 
+	ClassDB::bind_method(D_METHOD("compress", "allowed_linear_error", "allowed_angular_error", "max_optimizable_angle"), &Animation::compress, DEFVAL(0.05), DEFVAL(0.01), DEFVAL(Math_PI * 0.125));
+	ClassDB::bind_method(D_METHOD("get_transform_tracks_memory_usage"), &Animation::get_transform_tracks_memory_usage);
+
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "length", PROPERTY_HINT_RANGE, "0.001,99999,0.001"), "set_length", "get_length");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "loop"), "set_loop", "has_loop");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "step", PROPERTY_HINT_RANGE, "0,4096,0.001"), "set_step", "get_step");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "bake_transform_tracks"), "set_bake_transform_tracks", "is_baking_transform_tracks");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "quantize_transform_tracks"), "set_quantize_transform_tracks", "is_quantizing_transform_tracks");
 
 	ADD_SIGNAL(MethodInfo("tracks_changed"));
 
@@ -2885,6 +3464,9 @@ void Animation::_transform_track_optimize(int p_idx, float p_allowed_linear_err,
 	ERR_FAIL_INDEX(p_idx, tracks.size());
 	ERR_FAIL_COND(tracks[p_idx]->type != TYPE_TRANSFORM);
 	TransformTrack *tt = static_cast<TransformTrack *>(tracks[p_idx]);
+	if (tt->compressed) {
+		_decompress_transform_track(tt);
+	}
 	bool prev_erased = false;
 	TKey<TransformKey> first_erased;
 
@@ -2919,6 +3501,43 @@ void Animation::_transform_track_optimize(int p_idx, float p_allowed_linear_err,
 			norm = Vector3();
 		}
 	}
+	tt->baked_valid.clear();
+}
+
+void Animation::compress(float p_allowed_linear_err, float p_allowed_angular_err, float p_max_optimizable_angle) {
+	for (int i = 0; i < tracks.size(); i++) {
+		if (tracks[i]->type != TYPE_TRANSFORM) {
+			continue;
+		}
+		TransformTrack *tt = static_cast<TransformTrack *>(tracks[i]);
+		if (tt->compressed) {
+			continue;
+		}
+
+		_transform_track_optimize(i, p_allowed_linear_err, p_allowed_angular_err, p_max_optimizable_angle);
+
+		_build_baked_transform_track(tt, true);
+		tt->transforms.clear();
+		tt->compressed = true;
+		tt->baked_valid.set();
+	}
+	emit_changed();
+}
+
+int Animation::get_transform_tracks_memory_usage() const {
+	int usage = 0;
+	for (int i = 0; i < tracks.size(); i++) {
+		if (tracks[i]->type != TYPE_TRANSFORM) {
+			continue;
+		}
+		const TransformTrack *tt = static_cast<const TransformTrack *>(tracks[i]);
+		const BakedTransformTrack &baked = tt->baked;
+		usage += tt->transforms.size() * sizeof(TKey<TransformKey>);
+		usage += (baked.times.size() + baked.transitions.size()) * sizeof(float);
+		usage += baked.locs.size() * sizeof(Vector3) + baked.rots.size() * sizeof(Quat) + baked.scales.size() * sizeof(Vector3);
+		usage += (baked.quantized_locs.size() + baked.quantized_rots.size() + baked.quantized_scales.size()) * sizeof(uint16_t);
+	}
+	return usage;
 }
 
 void Animation::optimize(float p_allowed_linear_err, float p_allowed_angular_err, float p_max_optimizable_angle) {
@@ -2933,6 +3552,8 @@ Animation::Animation() {
 	step = 0.1;
 	loop = false;
 	length = 1;
+	bake_transform_tracks = false;
+	quantize_transform_tracks = false;
 }
 
 Animation::~Animation() {
@@ -31,7 +31,10 @@
 #ifndef ANIMATION_H
 #define ANIMATION_H
 
+#include "core/local_vector.h"
+#include "core/os/mutex.h"
 #include "core/resource.h"
+#include "core/safe_refcount.h"
 
 #define ANIM_MIN_LENGTH 0.001
 
@@ -100,10 +103,49 @@ private:
 
 	/* TRANSFORM TRACK */
 
+	// Struct-of-arrays copy of the keys of a transform track, which is what
+	// transform_track_interpolate() samples when bake_transform_tracks or
+	// quantize_transform_tracks is set. It is built on first use after the
+	// keys (or the animation length) change.
+	struct BakedTransformTrack {
+		LocalVector<float> times;
+		LocalVector<float> transitions; // Empty when all the keys use the default transition of 1.
+		int key_count; // Keys up to the animation length, as _interpolate() considers them.
+
+		LocalVector<Vector3> locs;
+		LocalVector<Quat> rots;
+		LocalVector<Vector3> scales;
+
+		// When quantized, locations and scales are stored as 16 bits per axis
+		// relative to the bounds of the track, and rotations as 16 bits per
+		// component.
+		bool quantized;
+		AABB loc_bounds;
+		AABB scale_bounds;
+		LocalVector<uint16_t> quantized_locs;
+		LocalVector<int16_t> quantized_rots;
+		LocalVector<uint16_t> quantized_scales;
+
+		_FORCE_INLINE_ float get_transition(int p_key) const { return transitions.size() ? transitions[p_key] : 1.0f; }
+
+		BakedTransformTrack() {
+			key_count = 0;
+			quantized = false;
+		}
+	};
+
 	struct TransformTrack : public Track {
 		Vector<TKey<TransformKey>> transforms;
 
-		TransformTrack() { type = TYPE_TRANSFORM; }
+		BakedTransformTrack baked;
+		SafeFlag baked_valid;
+		// Only the quantized baked keys are kept, see compress().
+		bool compressed;
+
+		TransformTrack() {
+			type = TYPE_TRANSFORM;
+			compressed = false;
+		}
 	};
 
 	/* PROPERTY VALUE TRACK */
@@ -192,6 +234,21 @@ private:
 	template <class K>
 	inline int _find(const Vector<K> &p_keys, float p_time) const;
 
+	Mutex bake_mutex;
+	bool bake_transform_tracks;
+	bool quantize_transform_tracks;
+
+	_FORCE_INLINE_ bool _uses_baked_keys(const TransformTrack *p_track) const { return p_track->compressed || bake_transform_tracks || quantize_transform_tracks; }
+
+	void _build_baked_transform_track(TransformTrack *p_track, bool p_quantize) const;
+	void _bake_transform_track(TransformTrack *p_track) const;
+	Vector<TKey<TransformKey>> _get_transform_keys(const TransformTrack *p_track) const;
+	void _decompress_transform_track(TransformTrack *p_track);
+	void _invalidate_baked_transform_tracks();
+	_FORCE_INLINE_ int _find_baked(const BakedTransformTrack &p_baked, float p_time, int p_cursor) const;
+	_FORCE_INLINE_ TransformKey _get_baked_key(const BakedTransformTrack &p_baked, int p_key) const;
+	bool _interpolate_baked(const BakedTransformTrack &p_baked, float p_time, InterpolationType p_interp, bool p_loop_wrap, int *r_cursor, TransformKey *r_key) const;
+
 	_FORCE_INLINE_ Animation::TransformKey _interpolate(const Animation::TransformKey &p_a, const Animation::TransformKey &p_b, float p_c) const;
 
 	_FORCE_INLINE_ Vector3 _interpolate(const Vector3 &p_a, const Vector3 &p_b, float p_c) const;
@@ -211,6 +268,7 @@ private:
 	template <class T>
 	_FORCE_INLINE_ void _track_get_key_indices_in_range(const Vector<T> &p_array, float from_time, float to_time, List<int> *p_indices) const;
 
+	void _transform_track_get_key_indices_in_range(const TransformTrack *tt, float from_time, float to_time, List<int> *p_indices) const;
 	_FORCE_INLINE_ void _value_track_get_key_indices_in_range(const ValueTrack *vt, float from_time, float to_time, List<int> *p_indices) const;
 	_FORCE_INLINE_ void _method_track_get_key_indices_in_range(const MethodTrack *mt, float from_time, float to_time, List<int> *p_indices) const;
 
@@ -328,7 +386,9 @@ public:
 	void track_set_interpolation_loop_wrap(int p_track, bool p_enable);
 	bool track_get_interpolation_loop_wrap(int p_track) const;
 
-	Error transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const;
+	// r_key_cursor is an optional hint kept by the caller between calls, so
+	// sequential playback can skip the key search. Only baked keys use it.
+	Error transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, int *r_key_cursor = nullptr) const;
 
 	Variant value_track_interpolate(int p_track, float p_time) const;
 	void value_track_get_key_indices(int p_track, float p_time, float p_delta, List<int> *p_indices) const;
@@ -352,9 +412,17 @@ public:
 	void set_step(float p_step);
 	float get_step() const;
 
+	void set_bake_transform_tracks(bool p_enable);
+	bool is_baking_transform_tracks() const;
+
+	void set_quantize_transform_tracks(bool p_enable);
+	bool is_quantizing_transform_tracks() const;
+
 	void clear();
 
 	void optimize(float p_allowed_linear_err = 0.05, float p_allowed_angular_err = 0.01, float p_max_optimizable_angle = Math_PI * 0.125);
+	void compress(float p_allowed_linear_err = 0.05, float p_allowed_angular_err = 0.01, float p_max_optimizable_angle = Math_PI * 0.125);
+	int get_transform_tracks_memory_usage() const;
 
 	Animation();
 	~Animation();
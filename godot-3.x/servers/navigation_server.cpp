@@ -34,8 +34,41 @@
 
 #include "navigation_server.h"
 
+#include "core/method_bind_ext.gen.inc"
+
 NavigationServer *NavigationServer::singleton = nullptr;
 
+static Vector<NavigationServer::PathQuery> _make_path_queries(const PoolVector3Array &p_origins, const PoolVector3Array &p_destinations, bool p_optimize) {
+	Vector<NavigationServer::PathQuery> queries;
+	ERR_FAIL_COND_V_MSG(p_origins.size() != p_destinations.size(), queries, "The origins and the destinations must have the same size.");
+
+	queries.resize(p_origins.size());
+	PoolVector3Array::Read origins = p_origins.read();
+	PoolVector3Array::Read destinations = p_destinations.read();
+	NavigationServer::PathQuery *queries_ptrw = queries.ptrw();
+	for (int i = 0; i < queries.size(); i++) {
+		queries_ptrw[i].origin = origins[i];
+		queries_ptrw[i].destination = destinations[i];
+		queries_ptrw[i].optimize = p_optimize;
+	}
+	return queries;
+}
+
+Array NavigationServer::_map_get_paths(RID p_map, const PoolVector3Array &p_origins, const PoolVector3Array &p_destinations, bool p_optimize) const {
+	Vector<Vector<Vector3>> paths = map_get_paths(p_map, _make_path_queries(p_origins, p_destinations, p_optimize));
+
+	Array ret;
+	ret.resize(paths.size());
+	for (int i = 0; i < paths.size(); i++) {
+		ret[i] = paths[i];
+	}
+	return ret;
+}
+
+void NavigationServer::_map_get_paths_deferred(RID p_map, const PoolVector3Array &p_origins, const PoolVector3Array &p_destinations, bool p_optimize, Object *p_receiver, StringName p_method, Variant p_udata) const {
+	map_get_paths_deferred(p_map, _make_path_queries(p_origins, p_destinations, p_optimize), p_receiver, p_method, p_udata);
+}
+
 void NavigationServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_create"), &NavigationServer::map_create);
 	ClassDB::bind_method(D_METHOD("map_set_active", "map", "active"), &NavigationServer::map_set_active);
@@ -49,6 +82,8 @@ void NavigationServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_set_edge_connection_margin", "map", "margin"), &NavigationServer::map_set_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_get_edge_connection_margin", "map"), &NavigationServer::map_get_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_get_path", "map", "origin", "destination", "optimize"), &NavigationServer::map_get_path);
+	ClassDB::bind_method(D_METHOD("map_get_paths", "map", "origins", "destinations", "optimize"), &NavigationServer::_map_get_paths);
+	ClassDB::bind_method(D_METHOD("map_get_paths_deferred", "map", "origins", "destinations", "optimize", "receiver", "method", "userdata"), &NavigationServer::_map_get_paths_deferred, DEFVAL(Variant()));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_to_segment", "map", "start", "end", "use_collision"), &NavigationServer::map_get_closest_point_to_segment, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point", "map", "to_point"), &NavigationServer::map_get_closest_point);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_normal", "map", "to_point"), &NavigationServer::map_get_closest_point_normal);
@@ -53,7 +53,20 @@ class NavigationServer : public Object {
 protected:
 	static void _bind_methods();
 
+	Array _map_get_paths(RID p_map, const PoolVector3Array &p_origins, const PoolVector3Array &p_destinations, bool p_optimize) const;
+	void _map_get_paths_deferred(RID p_map, const PoolVector3Array &p_origins, const PoolVector3Array &p_destinations, bool p_optimize, Object *p_receiver, StringName p_method, Variant p_udata) const;
+
 public:
+	/// A single path request of a batch.
+	struct PathQuery {
+		Vector3 origin;
+		Vector3 destination;
+		bool optimize;
+
+		PathQuery() :
+				optimize(true) {}
+	};
+
 	/// Thread safe, can be used across many threads.
 	static const NavigationServer *get_singleton();
 
@@ -96,6 +109,15 @@ public:
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize) const = 0;
 
+	/// Returns the navigation paths of all the queries, in the same order.
+	/// The queries are solved in parallel against the last synced map.
+	virtual Vector<Vector<Vector3>> map_get_paths(RID p_map, const Vector<PathQuery> &p_queries) const = 0;
+
+	/// Starts solving the queries in parallel against the last synced map and
+	/// returns immediately; the paths are sent to the receiver during the next
+	/// `process`, as an `Array` of `PoolVector3Array` followed by the user data.
+	virtual void map_get_paths_deferred(RID p_map, const Vector<PathQuery> &p_queries, Object *p_receiver, StringName p_method, Variant p_udata = Variant()) const = 0;
+
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const = 0;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const = 0;
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const = 0;
@@ -222,16 +222,31 @@ public:
 		linear_velocity += p_j * _inv_mass;
 	}
 
+	// Impulses never change static and kinematic bodies, so they are not written to.
+	// Those bodies can be shared by constraint islands solved on different threads.
+	_FORCE_INLINE_ bool is_impulse_receiver() const {
+		return mode > PhysicsServer::BODY_MODE_KINEMATIC;
+	}
+
 	_FORCE_INLINE_ void apply_impulse(const Vector3 &p_pos, const Vector3 &p_j) {
+		if (!is_impulse_receiver()) {
+			return;
+		}
 		linear_velocity += p_j * _inv_mass;
 		angular_velocity += _inv_inertia_tensor.xform((p_pos - center_of_mass).cross(p_j));
 	}
 
 	_FORCE_INLINE_ void apply_torque_impulse(const Vector3 &p_j) {
+		if (!is_impulse_receiver()) {
+			return;
+		}
 		angular_velocity += _inv_inertia_tensor.xform(p_j);
 	}
 
 	_FORCE_INLINE_ void apply_bias_impulse(const Vector3 &p_pos, const Vector3 &p_j, real_t p_max_delta_av = -1.0) {
+		if (!is_impulse_receiver()) {
+			return;
+		}
 		biased_linear_velocity += p_j * _inv_mass;
 		if (p_max_delta_av != 0.0) {
 			Vector3 delta_av = _inv_inertia_tensor.xform((p_pos - center_of_mass).cross(p_j));
@@ -243,6 +258,9 @@ public:
 	}
 
 	_FORCE_INLINE_ void apply_bias_torque_impulse(const Vector3 &p_j) {
+		if (!is_impulse_receiver()) {
+			return;
+		}
 		biased_angular_velocity += _inv_inertia_tensor.xform(p_j);
 	}
 
@@ -34,6 +34,7 @@
 #include "broad_phase_bvh.h"
 #include "broad_phase_octree.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/project_settings.h"
 #include "core/script_language.h"
 #include "joints/cone_twist_joint_sw.h"
@@ -601,14 +602,14 @@ uint32_t PhysicsServerSW::body_get_collision_mask(RID p_body) const {
 	return body->get_collision_mask();
 }
 
-void PhysicsServerSW::body_attach_object_instance_id(RID p_body, uint32_t p_id) {
+void PhysicsServerSW::body_attach_object_instance_id(RID p_body, ObjectID p_id) {
 	BodySW *body = body_owner.get(p_body);
 	ERR_FAIL_COND(!body);
 
 	body->set_instance_id(p_id);
 };
 
-uint32_t PhysicsServerSW::body_get_object_instance_id(RID p_body) const {
+ObjectID PhysicsServerSW::body_get_object_instance_id(RID p_body) const {
 	BodySW *body = body_owner.get(p_body);
 	ERR_FAIL_COND_V(!body, 0);
 
@@ -1285,9 +1286,13 @@ void PhysicsServerSW::set_collision_iterations(int p_iterations) {
 
 void PhysicsServerSW::init() {
 	iterations = 8; // 8?
-	stepper = memnew(StepSW);
+	step_delta = 0.0;
 };
 
+void PhysicsServerSW::_step_space_task(uint32_t p_index, void *p_userdata) {
+	steppers[p_index]->step(stepping_spaces[p_index], step_delta, iterations);
+}
+
 void PhysicsServerSW::step(real_t p_step) {
 #ifndef _3D_DISABLED
 
@@ -1300,11 +1305,38 @@ void PhysicsServerSW::step(real_t p_step) {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	for (int i = 0; i < SpaceSW::ELAPSED_TIME_MAX; i++) {
+		elapsed_time[i] = 0;
+	}
+	stepping_spaces.clear();
 	for (Set<const SpaceSW *>::Element *E = active_spaces.front(); E; E = E->next()) {
-		stepper->step((SpaceSW *)E->get(), p_step, iterations);
-		island_count += E->get()->get_island_count();
-		active_objects += E->get()->get_active_objects();
-		collision_pairs += E->get()->get_collision_pairs();
+		stepping_spaces.push_back((SpaceSW *)E->get());
+	}
+	while (steppers.size() < stepping_spaces.size()) {
+		steppers.push_back(memnew(StepSW));
+	}
+	step_delta = p_step;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 1 && stepping_spaces.size() > 1) {
+		// Spaces share no bodies, areas or broadphase, so each one is stepped by its own stepper.
+		// Direct space state queries are safe again once the task has completed.
+		WorkerThreadPool::TaskID task = pool->add_template_group_task(this, &PhysicsServerSW::_step_space_task, (void *)nullptr, stepping_spaces.size());
+		pool->wait_for_task_completion(task);
+	} else {
+		for (uint32_t i = 0; i < stepping_spaces.size(); i++) {
+			_step_space_task(i, nullptr);
+		}
+	}
+
+	for (uint32_t i = 0; i < stepping_spaces.size(); i++) {
+		const SpaceSW *space = stepping_spaces[i];
+		island_count += space->get_island_count();
+		active_objects += space->get_active_objects();
+		collision_pairs += space->get_collision_pairs();
+		for (int j = 0; j < SpaceSW::ELAPSED_TIME_MAX; j++) {
+			elapsed_time[j] += space->get_elapsed_time(SpaceSW::ElapsedTime(j));
+		}
 	}
 #endif
 }
@@ -1362,7 +1394,11 @@ void PhysicsServerSW::flush_queries() {
 };
 
 void PhysicsServerSW::finish() {
-	memdelete(stepper);
+	for (uint32_t i = 0; i < steppers.size(); i++) {
+		memdelete(steppers[i]);
+	}
+	steppers.clear();
+	stepping_spaces.clear();
 };
 
 int PhysicsServerSW::get_process_info(ProcessInfo p_info) {
@@ -1376,6 +1412,21 @@ int PhysicsServerSW::get_process_info(ProcessInfo p_info) {
 		case INFO_ISLAND_COUNT: {
 			return island_count;
 		} break;
+		case INFO_INTEGRATE_FORCES_TIME: {
+			return elapsed_time[SpaceSW::ELAPSED_TIME_INTEGRATE_FORCES];
+		} break;
+		case INFO_GENERATE_ISLANDS_TIME: {
+			return elapsed_time[SpaceSW::ELAPSED_TIME_GENERATE_ISLANDS];
+		} break;
+		case INFO_SETUP_CONSTRAINTS_TIME: {
+			return elapsed_time[SpaceSW::ELAPSED_TIME_SETUP_CONSTRAINTS];
+		} break;
+		case INFO_SOLVE_CONSTRAINTS_TIME: {
+			return elapsed_time[SpaceSW::ELAPSED_TIME_SOLVE_CONSTRAINTS];
+		} break;
+		case INFO_INTEGRATE_VELOCITIES_TIME: {
+			return elapsed_time[SpaceSW::ELAPSED_TIME_INTEGRATE_VELOCITIES];
+		} break;
 	}
 
 	return 0;
@@ -1436,6 +1487,9 @@ PhysicsServerSW::PhysicsServerSW() {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	for (int i = 0; i < SpaceSW::ELAPSED_TIME_MAX; i++) {
+		elapsed_time[i] = 0;
+	}
 
 	active = true;
 	flushing_queries = false;
@@ -47,12 +47,20 @@ class PhysicsServerSW : public PhysicsServer {
 	int island_count;
 	int active_objects;
 	int collision_pairs;
+	// Time spent in each step phase by all the spaces, in microseconds.
+	uint64_t elapsed_time[SpaceSW::ELAPSED_TIME_MAX];
 
 	bool flushing_queries;
 
-	StepSW *stepper;
 	Set<const SpaceSW *> active_spaces;
 
+	// One stepper per space stepped in the current frame, so independent spaces can be stepped concurrently.
+	LocalVector<StepSW *> steppers;
+	LocalVector<SpaceSW *> stepping_spaces;
+	real_t step_delta;
+
+	void _step_space_task(uint32_t p_index, void *p_userdata);
+
 	mutable RID_Owner<ShapeSW> shape_owner;
 	mutable RID_Owner<SpaceSW> space_owner;
 	mutable RID_Owner<AreaSW> area_owner;
@@ -170,8 +178,8 @@ public:
 	virtual void body_remove_shape(RID p_body, int p_shape_idx);
 	virtual void body_clear_shapes(RID p_body);
 
-	virtual void body_attach_object_instance_id(RID p_body, uint32_t p_id);
-	virtual uint32_t body_get_object_instance_id(RID p_body) const;
+	virtual void body_attach_object_instance_id(RID p_body, ObjectID p_id);
+	virtual ObjectID body_get_object_instance_id(RID p_body) const;
 
 	virtual void body_set_enable_continuous_collision_detection(RID p_body, bool p_enable);
 	virtual bool body_is_continuous_collision_detection_enabled(RID p_body) const;
@@ -32,6 +32,9 @@
 #include "joints_sw.h"
 
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
+
+SafeNumeric<uint64_t> StepSW::step_counter;
 
 void StepSW::_populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island) {
 	p_body->set_island_step(_step);
@@ -103,6 +106,10 @@ void StepSW::_solve_island(ConstraintSW *p_island, int p_iterations, real_t p_de
 	}
 }
 
+void StepSW::_solve_island_task(uint32_t p_island_index, void *p_userdata) {
+	_solve_island(constraint_islands[p_island_index], iterations, delta);
+}
+
 void StepSW::_check_suspend(BodySW *p_island, real_t p_delta) {
 	bool can_sleep = true;
 
@@ -140,6 +147,8 @@ void StepSW::_check_suspend(BodySW *p_island, real_t p_delta) {
 }
 
 void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
+	_step = step_counter.increment();
+
 	p_space->lock(); // can't access space during this
 	p_space->set_step(p_delta);
 	p_space->setup(); //update inertias, etc
@@ -242,12 +251,27 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 	/* SOLVE CONSTRAINT ISLANDS */
 
 	{
+		// Islands share no dynamic body, and impulses are not applied to the static and kinematic
+		// ones, so each island gives the same result whichever thread solves it and in any order.
+		constraint_islands.clear();
 		ConstraintSW *ci = constraint_island_list;
 		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
+			constraint_islands.push_back(ci);
 			ci = ci->get_island_list_next();
 		}
+
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (pool && pool->get_thread_count() > 1 && constraint_islands.size() > 1) {
+			iterations = p_iterations;
+			delta = p_delta;
+			WorkerThreadPool::TaskID task = pool->add_template_group_task(this, &StepSW::_solve_island_task, (void *)nullptr, constraint_islands.size());
+			pool->wait_for_task_completion(task);
+		} else {
+			for (uint32_t i = 0; i < constraint_islands.size(); i++) {
+				//iterating each island separatedly improves cache efficiency
+				_solve_island(constraint_islands[i], p_iterations, p_delta);
+			}
+		}
 	}
 
 	{ //profile
@@ -282,9 +306,10 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 	}
 
 	p_space->unlock();
-	_step++;
 }
 
 StepSW::StepSW() {
-	_step = 1;
+	_step = 0;
+	iterations = 0;
+	delta = 0.0;
 }
@@ -33,12 +33,25 @@
 
 #include "space_sw.h"
 
+#include "core/local_vector.h"
+#include "core/safe_refcount.h"
+
 class StepSW {
+	// Shared by all the steppers, so bodies moved between spaces never see a stale island mark.
+	static SafeNumeric<uint64_t> step_counter;
+
 	uint64_t _step;
 
+	// The step parameters, for the islands solved on the worker threads.
+	int iterations;
+	real_t delta;
+
+	LocalVector<ConstraintSW *> constraint_islands;
+
 	void _populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island);
 	void _setup_island(ConstraintSW *p_island, real_t p_delta);
 	void _solve_island(ConstraintSW *p_island, int p_iterations, real_t p_delta);
+	void _solve_island_task(uint32_t p_island_index, void *p_userdata);
 	void _check_suspend(BodySW *p_island, real_t p_delta);
 
 public:
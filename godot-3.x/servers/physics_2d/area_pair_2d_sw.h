@@ -43,6 +43,8 @@ class AreaPair2DSW : public Constraint2DSW {
 	bool colliding;
 
 public:
+	// Areas are shared by the islands of all the bodies overlapping them.
+	virtual bool is_setup_island_local() const { return false; }
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
@@ -60,6 +62,7 @@ class Area2Pair2DSW : public Constraint2DSW {
 	bool area_b_monitorable;
 
 public:
+	virtual bool is_setup_island_local() const { return false; }
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
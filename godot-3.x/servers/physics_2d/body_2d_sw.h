@@ -205,16 +205,31 @@ public:
 		linear_velocity += p_impulse * _inv_mass;
 	}
 
+	// Impulses never change static and kinematic bodies, so they are not written to.
+	// Those bodies can be shared by constraint islands set up and solved on different threads.
+	_FORCE_INLINE_ bool is_impulse_receiver() const {
+		return mode > Physics2DServer::BODY_MODE_KINEMATIC;
+	}
+
 	_FORCE_INLINE_ void apply_impulse(const Vector2 &p_offset, const Vector2 &p_impulse) {
+		if (!is_impulse_receiver()) {
+			return;
+		}
 		linear_velocity += p_impulse * _inv_mass;
 		angular_velocity += _inv_inertia * p_offset.cross(p_impulse);
 	}
 
 	_FORCE_INLINE_ void apply_torque_impulse(real_t p_torque) {
+		if (!is_impulse_receiver()) {
+			return;
+		}
 		angular_velocity += _inv_inertia * p_torque;
 	}
 
 	_FORCE_INLINE_ void apply_bias_impulse(const Vector2 &p_pos, const Vector2 &p_j) {
+		if (!is_impulse_receiver()) {
+			return;
+		}
 		biased_linear_velocity += p_j * _inv_mass;
 		biased_angular_velocity += _inv_inertia * p_pos.cross(p_j);
 	}
@@ -219,6 +219,20 @@ real_t combine_friction(Body2DSW *A, Body2DSW *B) {
 	return ABS(MIN(A->get_friction(), B->get_friction()));
 }
 
+bool BodyPair2DSW::is_setup_island_local() const {
+	if (space->is_debugging_contacts()) {
+		return false;
+	}
+	// Static and kinematic bodies can be part of several islands, so contacts can't be reported to them concurrently.
+	if (!A->is_impulse_receiver() && A->can_report_contacts()) {
+		return false;
+	}
+	if (!B->is_impulse_receiver() && B->can_report_contacts()) {
+		return false;
+	}
+	return true;
+}
+
 bool BodyPair2DSW::setup(real_t p_step) {
 	//cannot collide
 	if (!A->test_collision_mask(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self())) {
@@ -70,6 +70,10 @@ public:
 	_FORCE_INLINE_ void disable_collisions_between_bodies(const bool p_disabled) { disabled_collisions_between_bodies = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled_collisions_between_bodies() const { return disabled_collisions_between_bodies; }
 
+	// Whether setup() only writes to this constraint and to the dynamic bodies of its island,
+	// so that islands can be set up concurrently on worker threads.
+	virtual bool is_setup_island_local() const { return true; }
+
 	virtual bool setup(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
 
@@ -34,6 +34,7 @@
 #include "broad_phase_2d_hash_grid.h"
 #include "collision_solver_2d_sw.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/project_settings.h"
 #include "core/script_language.h"
 
@@ -675,28 +676,28 @@ Physics2DServerSW::CCDMode Physics2DServerSW::body_get_continuous_collision_dete
 	return body->get_continuous_collision_detection_mode();
 }
 
-void Physics2DServerSW::body_attach_object_instance_id(RID p_body, uint32_t p_id) {
+void Physics2DServerSW::body_attach_object_instance_id(RID p_body, ObjectID p_id) {
 	Body2DSW *body = body_owner.get(p_body);
 	ERR_FAIL_COND(!body);
 
 	body->set_instance_id(p_id);
 };
 
-uint32_t Physics2DServerSW::body_get_object_instance_id(RID p_body) const {
+ObjectID Physics2DServerSW::body_get_object_instance_id(RID p_body) const {
 	Body2DSW *body = body_owner.get(p_body);
 	ERR_FAIL_COND_V(!body, 0);
 
 	return body->get_instance_id();
 };
 
-void Physics2DServerSW::body_attach_canvas_instance_id(RID p_body, uint32_t p_id) {
+void Physics2DServerSW::body_attach_canvas_instance_id(RID p_body, ObjectID p_id) {
 	Body2DSW *body = body_owner.get(p_body);
 	ERR_FAIL_COND(!body);
 
 	body->set_canvas_instance_id(p_id);
 };
 
-uint32_t Physics2DServerSW::body_get_canvas_instance_id(RID p_body) const {
+ObjectID Physics2DServerSW::body_get_canvas_instance_id(RID p_body) const {
 	Body2DSW *body = body_owner.get(p_body);
 	ERR_FAIL_COND_V(!body, 0);
 
@@ -1203,9 +1204,13 @@ void Physics2DServerSW::set_collision_iterations(int p_iterations) {
 void Physics2DServerSW::init() {
 	doing_sync = false;
 	iterations = 8; // 8?
-	stepper = memnew(Step2DSW);
+	step_delta = 0.0;
 };
 
+void Physics2DServerSW::_step_space_task(uint32_t p_index, void *p_userdata) {
+	steppers[p_index]->step(stepping_spaces[p_index], step_delta, iterations);
+}
+
 void Physics2DServerSW::step(real_t p_step) {
 	if (!active) {
 		return;
@@ -1216,11 +1221,38 @@ void Physics2DServerSW::step(real_t p_step) {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	for (int i = 0; i < Space2DSW::ELAPSED_TIME_MAX; i++) {
+		elapsed_time[i] = 0;
+	}
+	stepping_spaces.clear();
 	for (Set<const Space2DSW *>::Element *E = active_spaces.front(); E; E = E->next()) {
-		stepper->step((Space2DSW *)E->get(), p_step, iterations);
-		island_count += E->get()->get_island_count();
-		active_objects += E->get()->get_active_objects();
-		collision_pairs += E->get()->get_collision_pairs();
+		stepping_spaces.push_back((Space2DSW *)E->get());
+	}
+	while (steppers.size() < stepping_spaces.size()) {
+		steppers.push_back(memnew(Step2DSW));
+	}
+	step_delta = p_step;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 1 && stepping_spaces.size() > 1) {
+		// Spaces share no bodies, areas or broadphase, so each one is stepped by its own stepper.
+		// Direct space state queries are safe again once the task has completed.
+		WorkerThreadPool::TaskID task = pool->add_template_group_task(this, &Physics2DServerSW::_step_space_task, (void *)nullptr, stepping_spaces.size());
+		pool->wait_for_task_completion(task);
+	} else {
+		for (uint32_t i = 0; i < stepping_spaces.size(); i++) {
+			_step_space_task(i, nullptr);
+		}
+	}
+
+	for (uint32_t i = 0; i < stepping_spaces.size(); i++) {
+		const Space2DSW *space = stepping_spaces[i];
+		island_count += space->get_island_count();
+		active_objects += space->get_active_objects();
+		collision_pairs += space->get_collision_pairs();
+		for (int j = 0; j < Space2DSW::ELAPSED_TIME_MAX; j++) {
+			elapsed_time[j] += space->get_elapsed_time(Space2DSW::ElapsedTime(j));
+		}
 	}
 };
 
@@ -1282,7 +1314,11 @@ void Physics2DServerSW::end_sync() {
 }
 
 void Physics2DServerSW::finish() {
-	memdelete(stepper);
+	for (uint32_t i = 0; i < steppers.size(); i++) {
+		memdelete(steppers[i]);
+	}
+	steppers.clear();
+	stepping_spaces.clear();
 };
 
 void Physics2DServerSW::_update_shapes() {
@@ -1303,6 +1339,21 @@ int Physics2DServerSW::get_process_info(ProcessInfo p_info) {
 		case INFO_ISLAND_COUNT: {
 			return island_count;
 		} break;
+		case INFO_INTEGRATE_FORCES_TIME: {
+			return elapsed_time[Space2DSW::ELAPSED_TIME_INTEGRATE_FORCES];
+		} break;
+		case INFO_GENERATE_ISLANDS_TIME: {
+			return elapsed_time[Space2DSW::ELAPSED_TIME_GENERATE_ISLANDS];
+		} break;
+		case INFO_SETUP_CONSTRAINTS_TIME: {
+			return elapsed_time[Space2DSW::ELAPSED_TIME_SETUP_CONSTRAINTS];
+		} break;
+		case INFO_SOLVE_CONSTRAINTS_TIME: {
+			return elapsed_time[Space2DSW::ELAPSED_TIME_SOLVE_CONSTRAINTS];
+		} break;
+		case INFO_INTEGRATE_VELOCITIES_TIME: {
+			return elapsed_time[Space2DSW::ELAPSED_TIME_INTEGRATE_VELOCITIES];
+		} break;
 	}
 
 	return 0;
@@ -1332,6 +1383,9 @@ Physics2DServerSW::Physics2DServerSW() {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	for (int i = 0; i < Space2DSW::ELAPSED_TIME_MAX; i++) {
+		elapsed_time[i] = 0;
+	}
 #ifdef NO_THREADS
 	using_threads = false;
 #else
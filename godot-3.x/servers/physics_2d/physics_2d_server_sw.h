@@ -49,14 +49,22 @@ class Physics2DServerSW : public Physics2DServer {
 	int island_count;
 	int active_objects;
 	int collision_pairs;
+	// Time spent in each step phase by all the spaces, in microseconds.
+	uint64_t elapsed_time[Space2DSW::ELAPSED_TIME_MAX];
 
 	bool using_threads;
 
 	bool flushing_queries;
 
-	Step2DSW *stepper;
 	Set<const Space2DSW *> active_spaces;
 
+	// One stepper per space stepped in the current frame, so independent spaces can be stepped concurrently.
+	LocalVector<Step2DSW *> steppers;
+	LocalVector<Space2DSW *> stepping_spaces;
+	real_t step_delta;
+
+	void _step_space_task(uint32_t p_index, void *p_userdata);
+
 	mutable RID_Owner<Shape2DSW> shape_owner;
 	mutable RID_Owner<Space2DSW> space_owner;
 	mutable RID_Owner<Area2DSW> area_owner;
@@ -189,11 +197,11 @@ public:
 	virtual void body_set_shape_disabled(RID p_body, int p_shape_idx, bool p_disabled);
 	virtual void body_set_shape_as_one_way_collision(RID p_body, int p_shape_idx, bool p_enable, float p_margin);
 
-	virtual void body_attach_object_instance_id(RID p_body, uint32_t p_id);
-	virtual uint32_t body_get_object_instance_id(RID p_body) const;
+	virtual void body_attach_object_instance_id(RID p_body, ObjectID p_id);
+	virtual ObjectID body_get_object_instance_id(RID p_body) const;
 
-	virtual void body_attach_canvas_instance_id(RID p_body, uint32_t p_id);
-	virtual uint32_t body_get_canvas_instance_id(RID p_body) const;
+	virtual void body_attach_canvas_instance_id(RID p_body, ObjectID p_id);
+	virtual ObjectID body_get_canvas_instance_id(RID p_body) const;
 
 	virtual void body_set_continuous_collision_detection_mode(RID p_body, CCDMode p_mode);
 	virtual CCDMode body_get_continuous_collision_detection_mode(RID p_body) const;
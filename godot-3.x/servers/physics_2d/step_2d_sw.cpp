@@ -30,6 +30,9 @@
 
 #include "step_2d_sw.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
+
+SafeNumeric<uint64_t> Step2DSW::step_counter;
 
 void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island) {
 	p_body->set_island_step(_step);
@@ -82,6 +85,29 @@ bool Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta) {
 	return removed_root;
 }
 
+bool Step2DSW::_is_island_local(Constraint2DSW *p_island) const {
+	Constraint2DSW *ci = p_island;
+	while (ci) {
+		if (!ci->is_setup_island_local()) {
+			return false;
+		}
+		ci = ci->get_island_next();
+	}
+	return true;
+}
+
+void Step2DSW::_setup_island_at(uint32_t p_island_index, real_t p_delta) {
+	Constraint2DSW *island = constraint_islands[p_island_index];
+	if (_setup_island(island, p_delta)) {
+		// The root was removed from the island because it is not to be processed, the next constraint replaces it.
+		constraint_islands[p_island_index] = island->get_island_next();
+	}
+}
+
+void Step2DSW::_setup_island_task(uint32_t p_local_index, void *p_userdata) {
+	_setup_island_at(local_islands[p_local_index], delta);
+}
+
 void Step2DSW::_solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta) {
 	for (int i = 0; i < p_iterations; i++) {
 		Constraint2DSW *ci = p_island;
@@ -92,6 +118,10 @@ void Step2DSW::_solve_island(Constraint2DSW *p_island, int p_iterations, real_t
 	}
 }
 
+void Step2DSW::_solve_island_task(uint32_t p_island_index, void *p_userdata) {
+	_solve_island(constraint_islands[p_island_index], iterations, delta);
+}
+
 void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
 	bool can_sleep = true;
 
@@ -129,6 +159,8 @@ void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
 }
 
 void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
+	_step = step_counter.increment();
+
 	p_space->lock(); // can't access space during this
 	p_space->set_step(p_delta);
 	p_space->setup(); //update inertias, etc
@@ -215,38 +247,51 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 	/* SETUP CONSTRAINT ISLANDS */
 
 	{
+		// Islands share no dynamic body, and impulses are not applied to the static and kinematic
+		// ones, so each island gives the same result whichever thread sets it up or solves it.
+		// Islands whose setup writes to objects shared with other islands (areas, contacts reported
+		// to static or kinematic bodies) are set up first, in order, on this thread.
+		constraint_islands.clear();
+		local_islands.clear();
 		Constraint2DSW *ci = constraint_island_list;
-		Constraint2DSW *prev_ci = nullptr;
 		while (ci) {
-			if (_setup_island(ci, p_delta)) {
-				//removed the root from the island graph because it is not to be processed
-
-				Constraint2DSW *next = ci->get_island_next();
-
-				if (next) {
-					//root from list being deleted no longer exists, replace by next
-					next->set_island_list_next(ci->get_island_list_next());
-					if (prev_ci) {
-						prev_ci->set_island_list_next(next);
-					} else {
-						constraint_island_list = next;
-					}
-					prev_ci = next;
-				} else {
-					//list is empty, just skip
-					if (prev_ci) {
-						prev_ci->set_island_list_next(ci->get_island_list_next());
-
-					} else {
-						constraint_island_list = ci->get_island_list_next();
-					}
-				}
-			} else {
-				prev_ci = ci;
+			if (_is_island_local(ci)) {
+				local_islands.push_back(constraint_islands.size());
 			}
-
+			constraint_islands.push_back(ci);
 			ci = ci->get_island_list_next();
 		}
+
+		uint32_t local_index = 0;
+		for (uint32_t i = 0; i < constraint_islands.size(); i++) {
+			if (local_index < local_islands.size() && local_islands[local_index] == i) {
+				local_index++;
+				continue;
+			}
+			_setup_island_at(i, p_delta);
+		}
+
+		iterations = p_iterations;
+		delta = p_delta;
+
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (pool && pool->get_thread_count() > 1 && local_islands.size() > 1) {
+			WorkerThreadPool::TaskID task = pool->add_template_group_task(this, &Step2DSW::_setup_island_task, (void *)nullptr, local_islands.size());
+			pool->wait_for_task_completion(task);
+		} else {
+			for (uint32_t i = 0; i < local_islands.size(); i++) {
+				_setup_island_task(i, nullptr);
+			}
+		}
+
+		// Drop the islands left with no constraint to process.
+		uint32_t remaining = 0;
+		for (uint32_t i = 0; i < constraint_islands.size(); i++) {
+			if (constraint_islands[i]) {
+				constraint_islands[remaining++] = constraint_islands[i];
+			}
+		}
+		constraint_islands.resize(remaining);
 	}
 
 	{ //profile
@@ -258,11 +303,15 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 	/* SOLVE CONSTRAINT ISLANDS */
 
 	{
-		Constraint2DSW *ci = constraint_island_list;
-		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
-			ci = ci->get_island_list_next();
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (pool && pool->get_thread_count() > 1 && constraint_islands.size() > 1) {
+			WorkerThreadPool::TaskID task = pool->add_template_group_task(this, &Step2DSW::_solve_island_task, (void *)nullptr, constraint_islands.size());
+			pool->wait_for_task_completion(task);
+		} else {
+			for (uint32_t i = 0; i < constraint_islands.size(); i++) {
+				//iterating each island separatedly improves cache efficiency
+				_solve_island(constraint_islands[i], p_iterations, p_delta);
+			}
 		}
 	}
 
@@ -298,9 +347,10 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 	}
 
 	p_space->unlock();
-	_step++;
 }
 
 Step2DSW::Step2DSW() {
-	_step = 1;
+	_step = 0;
+	iterations = 0;
+	delta = 0.0;
 }
@@ -33,12 +33,30 @@
 
 #include "space_2d_sw.h"
 
+#include "core/local_vector.h"
+#include "core/safe_refcount.h"
+
 class Step2DSW {
+	// Shared by all the steppers, so bodies moved between spaces never see a stale island mark.
+	static SafeNumeric<uint64_t> step_counter;
+
 	uint64_t _step;
 
+	// The step parameters, for the islands set up and solved on the worker threads.
+	int iterations;
+	real_t delta;
+
+	LocalVector<Constraint2DSW *> constraint_islands;
+	// Indices of the constraint islands whose setup writes to nothing outside the island.
+	LocalVector<uint32_t> local_islands;
+
 	void _populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island);
+	bool _is_island_local(Constraint2DSW *p_island) const;
 	bool _setup_island(Constraint2DSW *p_island, real_t p_delta);
+	void _setup_island_at(uint32_t p_island_index, real_t p_delta);
+	void _setup_island_task(uint32_t p_local_index, void *p_userdata);
 	void _solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta);
+	void _solve_island_task(uint32_t p_island_index, void *p_userdata);
 	void _check_suspend(Body2DSW *p_island, real_t p_delta);
 
 public:
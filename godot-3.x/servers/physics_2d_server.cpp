@@ -31,6 +31,7 @@
 #include "physics_2d_server.h"
 
 #include "core/method_bind_ext.gen.inc"
+#include "core/os/frame_arena.h"
 #include "core/print_string.h"
 #include "core/project_settings.h"
 
@@ -281,9 +282,11 @@ Dictionary Physics2DDirectSpaceState::_intersect_ray(const Vector2 &p_from, cons
 Array Physics2DDirectSpaceState::_intersect_shape(const Ref<Physics2DShapeQueryParameters> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
 
-	Vector<ShapeResult> sr;
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
+
+	FrameLocalVector<ShapeResult> sr;
 	sr.resize(p_max_results);
-	int rc = intersect_shape(p_shape_query->shape, p_shape_query->transform, p_shape_query->motion, p_shape_query->margin, sr.ptrw(), sr.size(), p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
+	int rc = intersect_shape(p_shape_query->shape, p_shape_query->transform, p_shape_query->motion, p_shape_query->margin, sr.ptr(), sr.size(), p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
 	Array ret;
 	ret.resize(rc);
 	for (int i = 0; i < rc; i++) {
@@ -320,14 +323,16 @@ Array Physics2DDirectSpaceState::_intersect_point_impl(const Vector2 &p_point, i
 		exclude.insert(p_exclude[i]);
 	}
 
-	Vector<ShapeResult> ret;
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
+
+	FrameLocalVector<ShapeResult> ret;
 	ret.resize(p_max_results);
 
 	int rc;
 	if (p_filter_by_canvas) {
-		rc = intersect_point(p_point, ret.ptrw(), ret.size(), exclude, p_layers, p_collide_with_bodies, p_collide_with_areas);
+		rc = intersect_point(p_point, ret.ptr(), ret.size(), exclude, p_layers, p_collide_with_bodies, p_collide_with_areas);
 	} else {
-		rc = intersect_point_on_canvas(p_point, p_canvas_instance_id, ret.ptrw(), ret.size(), exclude, p_layers, p_collide_with_bodies, p_collide_with_areas);
+		rc = intersect_point_on_canvas(p_point, p_canvas_instance_id, ret.ptr(), ret.size(), exclude, p_layers, p_collide_with_bodies, p_collide_with_areas);
 	}
 
 	if (rc == 0) {
@@ -359,10 +364,12 @@ Array Physics2DDirectSpaceState::_intersect_point_on_canvas(const Vector2 &p_poi
 Array Physics2DDirectSpaceState::_collide_shape(const Ref<Physics2DShapeQueryParameters> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
 
-	Vector<Vector2> ret;
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
+
+	FrameLocalVector<Vector2> ret;
 	ret.resize(p_max_results * 2);
 	int rc = 0;
-	bool res = collide_shape(p_shape_query->shape, p_shape_query->transform, p_shape_query->motion, p_shape_query->margin, ret.ptrw(), p_max_results, rc, p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
+	bool res = collide_shape(p_shape_query->shape, p_shape_query->transform, p_shape_query->motion, p_shape_query->margin, ret.ptr(), p_max_results, rc, p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
 	if (!res) {
 		return Array();
 	}
@@ -725,6 +732,11 @@ void Physics2DServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_ACTIVE_OBJECTS);
 	BIND_ENUM_CONSTANT(INFO_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(INFO_ISLAND_COUNT);
+	BIND_ENUM_CONSTANT(INFO_INTEGRATE_FORCES_TIME);
+	BIND_ENUM_CONSTANT(INFO_GENERATE_ISLANDS_TIME);
+	BIND_ENUM_CONSTANT(INFO_SETUP_CONSTRAINTS_TIME);
+	BIND_ENUM_CONSTANT(INFO_SOLVE_CONSTRAINTS_TIME);
+	BIND_ENUM_CONSTANT(INFO_INTEGRATE_VELOCITIES_TIME);
 }
 
 Physics2DServer::Physics2DServer() {
@@ -375,11 +375,11 @@ public:
 	virtual void body_remove_shape(RID p_body, int p_shape_idx) = 0;
 	virtual void body_clear_shapes(RID p_body) = 0;
 
-	virtual void body_attach_object_instance_id(RID p_body, uint32_t p_id) = 0;
-	virtual uint32_t body_get_object_instance_id(RID p_body) const = 0;
+	virtual void body_attach_object_instance_id(RID p_body, ObjectID p_id) = 0;
+	virtual ObjectID body_get_object_instance_id(RID p_body) const = 0;
 
-	virtual void body_attach_canvas_instance_id(RID p_body, uint32_t p_id) = 0;
-	virtual uint32_t body_get_canvas_instance_id(RID p_body) const = 0;
+	virtual void body_attach_canvas_instance_id(RID p_body, ObjectID p_id) = 0;
+	virtual ObjectID body_get_canvas_instance_id(RID p_body) const = 0;
 
 	enum CCDMode {
 		CCD_MODE_DISABLED,
@@ -565,7 +565,12 @@ public:
 
 		INFO_ACTIVE_OBJECTS,
 		INFO_COLLISION_PAIRS,
-		INFO_ISLAND_COUNT
+		INFO_ISLAND_COUNT,
+		INFO_INTEGRATE_FORCES_TIME,
+		INFO_GENERATE_ISLANDS_TIME,
+		INFO_SETUP_CONSTRAINTS_TIME,
+		INFO_SOLVE_CONSTRAINTS_TIME,
+		INFO_INTEGRATE_VELOCITIES_TIME
 	};
 
 	virtual int get_process_info(ProcessInfo p_info) = 0;
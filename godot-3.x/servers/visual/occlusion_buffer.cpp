@@ -0,0 +1,328 @@
+/*************************************************************************/
+/*  occlusion_buffer.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "occlusion_buffer.h"
+
+#include "core/os/worker_thread_pool.h"
+
+void OcclusionBuffer::_project(const Vector3 &p_view, float &r_x, float &r_y, float &r_z, float &r_w) const {
+	const real_t(*m)[4] = projection.matrix;
+	r_x = m[0][0] * p_view.x + m[1][0] * p_view.y + m[2][0] * p_view.z + m[3][0];
+	r_y = m[0][1] * p_view.x + m[1][1] * p_view.y + m[2][1] * p_view.z + m[3][1];
+	r_z = m[0][2] * p_view.x + m[1][2] * p_view.y + m[2][2] * p_view.z + m[3][2];
+	r_w = m[0][3] * p_view.x + m[1][3] * p_view.y + m[2][3] * p_view.z + m[3][3];
+}
+
+void OcclusionBuffer::begin(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, int p_width) {
+	camera_inverse = p_cam_transform.affine_inverse();
+	projection = p_cam_projection;
+	triangles.clear();
+	active = false;
+
+	int width = MAX(p_width, 1);
+	int height = CLAMP(int(width / p_cam_projection.get_aspect()), 1, width * 4);
+
+	level_count = 0;
+	while (level_count < MAX_LEVELS) {
+		Level &level = levels[level_count++];
+		level.width = width;
+		level.height = height;
+		level.depth.resize(width * height);
+
+		if (width == 1 && height == 1) {
+			break;
+		}
+		width = MAX((width + 1) / 2, 1);
+		height = MAX((height + 1) / 2, 1);
+	}
+}
+
+// Takes clip space vertices (x, y, z, w) in front of the near plane.
+void OcclusionBuffer::_add_triangle(const float *p_a, const float *p_b, const float *p_c) {
+	const float *vertices[3] = { p_a, p_b, p_c };
+	const Level &level = levels[0];
+
+	Triangle triangle;
+	float min_y = 1e20;
+	float max_y = -1e20;
+	for (int i = 0; i < 3; i++) {
+		float inv_w = 1.0f / vertices[i][3];
+		triangle.x[i] = (vertices[i][0] * inv_w * 0.5f + 0.5f) * level.width;
+		triangle.y[i] = (0.5f - vertices[i][1] * inv_w * 0.5f) * level.height;
+		triangle.z[i] = vertices[i][2] * inv_w;
+		min_y = MIN(min_y, triangle.y[i]);
+		max_y = MAX(max_y, triangle.y[i]);
+	}
+
+	if (max_y < 0 || min_y > level.height) {
+		return;
+	}
+
+	triangle.min_y = MAX(int(Math::floor(min_y)), 0);
+	triangle.max_y = MIN(int(Math::ceil(max_y)), level.height - 1);
+	triangles.push_back(triangle);
+}
+
+void OcclusionBuffer::add_occluder(const Transform &p_xform, const Vector3 *p_vertices, uint32_t p_vertex_count, const uint32_t *p_indices, uint32_t p_index_count) {
+	Transform to_view = camera_inverse * p_xform;
+
+	for (uint32_t i = 0; i + 2 < p_index_count; i += 3) {
+		float clip[3][4];
+		float distance[3];
+		bool valid = true;
+		int inside = 0;
+
+		for (int j = 0; j < 3; j++) {
+			uint32_t index = p_indices[i + j];
+			if (index >= p_vertex_count) {
+				valid = false;
+				break;
+			}
+			_project(to_view.xform(p_vertices[index]), clip[j][0], clip[j][1], clip[j][2], clip[j][3]);
+			// Distance to the near plane in clip space.
+			distance[j] = clip[j][2] + clip[j][3];
+			inside += distance[j] > 0;
+		}
+
+		if (!valid || inside == 0) {
+			continue;
+		}
+
+		if (inside == 3) {
+			_add_triangle(clip[0], clip[1], clip[2]);
+			continue;
+		}
+
+		// Clip against the near plane, which leaves a triangle or a quad.
+		float polygon[4][4];
+		int count = 0;
+		for (int j = 0; j < 3; j++) {
+			int next = (j + 1) % 3;
+			if (distance[j] > 0) {
+				memcpy(polygon[count++], clip[j], sizeof(float) * 4);
+			}
+			if ((distance[j] > 0) != (distance[next] > 0)) {
+				float t = distance[j] / (distance[j] - distance[next]);
+				for (int k = 0; k < 4; k++) {
+					polygon[count][k] = clip[j][k] + (clip[next][k] - clip[j][k]) * t;
+				}
+				count++;
+			}
+		}
+
+		for (int j = 2; j < count; j++) {
+			_add_triangle(polygon[0], polygon[j - 1], polygon[j]);
+		}
+	}
+}
+
+void OcclusionBuffer::_rasterize_triangle(const Triangle &p_triangle, int p_from_y, int p_to_y) {
+	const float *x = p_triangle.x;
+	const float *y = p_triangle.y;
+	const float *z = p_triangle.z;
+
+	float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (Math::abs(area) < CMP_EPSILON) {
+		return;
+	}
+
+	Level &level = levels[0];
+	int min_x = MAX(int(Math::floor(MIN(x[0], MIN(x[1], x[2])))), 0);
+	int max_x = MIN(int(Math::ceil(MAX(x[0], MAX(x[1], x[2])))), level.width - 1);
+	int min_y = MAX(p_triangle.min_y, p_from_y);
+	int max_y = MIN(p_triangle.max_y, p_to_y - 1);
+
+	// Edge functions, flipped for clockwise triangles so the inside is always positive.
+	float sign = area > 0 ? 1.0f : -1.0f;
+	float edge_x[3];
+	float edge_y[3];
+	float edge_c[3];
+	for (int i = 0; i < 3; i++) {
+		int next = (i + 1) % 3;
+		edge_x[i] = -(y[next] - y[i]) * sign;
+		edge_y[i] = (x[next] - x[i]) * sign;
+		edge_c[i] = -(edge_x[i] * x[i] + edge_y[i] * y[i]);
+	}
+
+	// Depth plane of the triangle.
+	float dz_dx = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+	float dz_dy = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / area;
+	float dz_c = z[0] - dz_dx * x[0] - dz_dy * y[0];
+
+	for (int py = min_y; py <= max_y; py++) {
+		float center_y = py + 0.5f;
+		float row_c0 = edge_y[0] * center_y + edge_c[0];
+		float row_c1 = edge_y[1] * center_y + edge_c[1];
+		float row_c2 = edge_y[2] * center_y + edge_c[2];
+		float row_z = dz_dy * center_y + dz_c;
+		float *row = level.depth.ptr() + py * level.width;
+
+		// Kept free of branches so the compiler can vectorize it.
+		for (int px = min_x; px <= max_x; px++) {
+			float center_x = px + 0.5f;
+			float e0 = edge_x[0] * center_x + row_c0;
+			float e1 = edge_x[1] * center_x + row_c1;
+			float e2 = edge_x[2] * center_x + row_c2;
+			float depth = dz_dx * center_x + row_z;
+			bool write = (e0 >= 0.0f) & (e1 >= 0.0f) & (e2 >= 0.0f) & (depth < row[px]);
+			row[px] = write ? depth : row[px];
+		}
+	}
+}
+
+void OcclusionBuffer::_rasterize_band(uint32_t p_band, void *p_userdata) {
+	Level &level = levels[0];
+	int from_y = p_band * BAND_HEIGHT;
+	int to_y = MIN(from_y + BAND_HEIGHT, level.height);
+
+	float *depth = level.depth.ptr();
+	for (int i = from_y * level.width; i < to_y * level.width; i++) {
+		depth[i] = 1.0f;
+	}
+
+	for (uint32_t i = 0; i < triangles.size(); i++) {
+		const Triangle &triangle = triangles[i];
+		if (triangle.max_y < from_y || triangle.min_y >= to_y) {
+			continue;
+		}
+		_rasterize_triangle(triangle, from_y, to_y);
+	}
+}
+
+void OcclusionBuffer::_build_pyramid() {
+	for (int i = 1; i < level_count; i++) {
+		const Level &src = levels[i - 1];
+		Level &dst = levels[i];
+
+		for (int y = 0; y < dst.height; y++) {
+			int y0 = y * 2;
+			int y1 = MIN(y0 + 1, src.height - 1);
+			const float *row0 = src.depth.ptr() + y0 * src.width;
+			const float *row1 = src.depth.ptr() + y1 * src.width;
+			float *out = dst.depth.ptr() + y * dst.width;
+
+			for (int x = 0; x < dst.width; x++) {
+				int x0 = x * 2;
+				int x1 = MIN(x0 + 1, src.width - 1);
+				out[x] = MAX(MAX(row0[x0], row0[x1]), MAX(row1[x0], row1[x1]));
+			}
+		}
+	}
+}
+
+void OcclusionBuffer::finish() {
+	active = !triangles.empty();
+	if (!active) {
+		return;
+	}
+
+	uint32_t band_count = (levels[0].height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 1 && triangles.size() >= MIN_TRIANGLES_THREADED) {
+		WorkerThreadPool::TaskID task = pool->add_template_group_task(this, &OcclusionBuffer::_rasterize_band, (void *)nullptr, band_count);
+		pool->wait_for_task_completion(task);
+	} else {
+		for (uint32_t i = 0; i < band_count; i++) {
+			_rasterize_band(i, nullptr);
+		}
+	}
+
+	_build_pyramid();
+}
+
+bool OcclusionBuffer::is_occluded(const AABB &p_aabb) const {
+	if (!active) {
+		return false;
+	}
+
+	const Level &base = levels[0];
+	float min_x = 1e20;
+	float min_y = 1e20;
+	float max_x = -1e20;
+	float max_y = -1e20;
+	float min_z = 1e20;
+
+	for (int i = 0; i < 8; i++) {
+		Vector3 corner = p_aabb.position;
+		corner.x += (i & 1) ? p_aabb.size.x : 0;
+		corner.y += (i & 2) ? p_aabb.size.y : 0;
+		corner.z += (i & 4) ? p_aabb.size.z : 0;
+
+		float x, y, z, w;
+		_project(camera_inverse.xform(corner), x, y, z, w);
+		if (z + w <= 0) {
+			// Reaches behind the near plane.
+			return false;
+		}
+
+		float inv_w = 1.0f / w;
+		float screen_x = (x * inv_w * 0.5f + 0.5f) * base.width;
+		float screen_y = (0.5f - y * inv_w * 0.5f) * base.height;
+		min_x = MIN(min_x, screen_x);
+		max_x = MAX(max_x, screen_x);
+		min_y = MIN(min_y, screen_y);
+		max_y = MAX(max_y, screen_y);
+		min_z = MIN(min_z, z * inv_w);
+	}
+
+	if (max_x < 0 || max_y < 0 || min_x >= base.width || min_y >= base.height) {
+		return false;
+	}
+
+	int x0 = MAX(int(Math::floor(min_x)), 0);
+	int y0 = MAX(int(Math::floor(min_y)), 0);
+	int x1 = MIN(int(Math::floor(max_x)), base.width - 1);
+	int y1 = MIN(int(Math::floor(max_y)), base.height - 1);
+
+	// Go up the pyramid until the AABB covers at most 2x2 texels.
+	int l = 0;
+	while (l < level_count - 1 && ((x1 >> l) - (x0 >> l) > 1 || (y1 >> l) - (y0 >> l) > 1)) {
+		l++;
+	}
+
+	const Level &level = levels[l];
+	for (int y = y0 >> l; y <= (y1 >> l); y++) {
+		const float *row = level.depth.ptr() + y * level.width;
+		for (int x = x0 >> l; x <= (x1 >> l); x++) {
+			if (row[x] >= min_z) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+float OcclusionBuffer::get_depth(int p_x, int p_y) const {
+	ERR_FAIL_INDEX_V(p_x, levels[0].width, 1.0f);
+	ERR_FAIL_INDEX_V(p_y, levels[0].height, 1.0f);
+	return levels[0].depth[p_y * levels[0].width + p_x];
+}
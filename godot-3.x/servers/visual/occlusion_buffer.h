@@ -0,0 +1,96 @@
+/*************************************************************************/
+/*  occlusion_buffer.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef OCCLUSION_BUFFER_H
+#define OCCLUSION_BUFFER_H
+
+#include "core/local_vector.h"
+#include "core/math/aabb.h"
+#include "core/math/camera_matrix.h"
+#include "core/math/transform.h"
+
+// Low resolution depth buffer for occlusion culling, rendered on the CPU from occluder meshes.
+// Triangles are rasterized in bands of rows, which run on worker threads, and the result is
+// reduced into a pyramid that keeps the farthest depth of each texel. AABBs are tested against
+// the level where they only cover a few texels, so each test reads a handful of values.
+// Depths are NDC z values, which interpolate linearly in screen space.
+class OcclusionBuffer {
+	enum {
+		BAND_HEIGHT = 16,
+		MAX_LEVELS = 16,
+		// Below this, splitting the work across threads costs more than it saves.
+		MIN_TRIANGLES_THREADED = 256,
+	};
+
+	struct Triangle {
+		float x[3];
+		float y[3];
+		float z[3];
+		int min_y;
+		int max_y;
+	};
+
+	struct Level {
+		int width = 0;
+		int height = 0;
+		LocalVector<float> depth;
+	};
+
+	Level levels[MAX_LEVELS];
+	int level_count = 0;
+
+	Transform camera_inverse;
+	CameraMatrix projection;
+	LocalVector<Triangle> triangles;
+	bool active = false;
+
+	_FORCE_INLINE_ void _project(const Vector3 &p_view, float &r_x, float &r_y, float &r_z, float &r_w) const;
+	void _add_triangle(const float *p_a, const float *p_b, const float *p_c);
+	void _rasterize_triangle(const Triangle &p_triangle, int p_from_y, int p_to_y);
+	void _rasterize_band(uint32_t p_band, void *p_userdata);
+	void _build_pyramid();
+
+public:
+	// Clears the buffer for a new view. The height follows the aspect ratio of the projection.
+	void begin(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, int p_width);
+	void add_occluder(const Transform &p_xform, const Vector3 *p_vertices, uint32_t p_vertex_count, const uint32_t *p_indices, uint32_t p_index_count);
+	void finish();
+	void clear() { active = false; }
+
+	// Only true when the AABB is entirely behind occluders, anything else counts as visible.
+	bool is_occluded(const AABB &p_aabb) const;
+	bool is_active() const { return active; }
+
+	int get_width() const { return levels[0].width; }
+	int get_height() const { return levels[0].height; }
+	float get_depth(int p_x, int p_y) const;
+};
+
+#endif // OCCLUSION_BUFFER_H
@@ -29,6 +29,7 @@
 /*************************************************************************/
 
 #include "visual_server_canvas.h"
+#include "core/os/worker_thread_pool.h"
 #include "visual_server_globals.h"
 #include "visual_server_raster.h"
 #include "visual_server_viewport.h"
@@ -85,6 +86,66 @@ void _mark_ysort_dirty(VisualServerCanvas::Item *ysort_owner, RID_Owner<VisualSe
 	} while (ysort_owner && ysort_owner->sort_y);
 }
 
+// Stops at the first item that is already dirty, its ancestors are dirty as well. Hidden items are the
+// exception, as their parent doesn't look into them, so visibility and parent changes mark the whole chain.
+void _mark_subtree_rect_dirty(VisualServerCanvas::Item *p_item, RID_Owner<VisualServerCanvas::Item> &canvas_item_owner, bool p_whole_chain = false) {
+	while (p_item && (p_whole_chain || !p_item->subtree_rect_dirty)) {
+		p_item->subtree_rect_dirty = true;
+		p_item = canvas_item_owner.owns(p_item->parent) ? canvas_item_owner.getornull(p_item->parent) : nullptr;
+	}
+}
+
+void VisualServerCanvas::_update_subtree_rect(Item *p_item) {
+	if (!p_item->subtree_rect_dirty) {
+		return;
+	}
+
+	Rect2 rect;
+	bool has_rect = false;
+	bool always_visit = p_item->update_when_visible || p_item->vp_render || p_item->copy_back_buffer;
+	bool has_multimesh = false;
+
+	if (!p_item->commands.empty()) {
+		rect = p_item->get_rect();
+		has_rect = true;
+	}
+
+	// The bounds of meshes, multimeshes and particles change in storage without the item hearing about it.
+	for (int i = 0; i < p_item->commands.size(); i++) {
+		Item::Command::Type type = p_item->commands[i]->type;
+		if (type == Item::Command::TYPE_MESH || type == Item::Command::TYPE_PARTICLES) {
+			always_visit = true;
+		} else if (type == Item::Command::TYPE_MULTIMESH) {
+			always_visit = true;
+			has_multimesh = true;
+		}
+	}
+
+	int child_item_count = p_item->child_items.size();
+	Item **child_items = p_item->child_items.ptrw();
+	for (int i = 0; i < child_item_count; i++) {
+		Item *child = child_items[i];
+		if (!child->visible) {
+			continue;
+		}
+
+		_update_subtree_rect(child);
+		always_visit = always_visit || child->subtree_always_visit;
+		has_multimesh = has_multimesh || child->subtree_has_multimesh;
+
+		if (child->subtree_has_rect) {
+			rect = has_rect ? rect.merge(child->subtree_rect) : child->subtree_rect;
+			has_rect = true;
+		}
+	}
+
+	p_item->subtree_rect = has_rect ? p_item->xform.xform(rect) : Rect2();
+	p_item->subtree_has_rect = has_rect;
+	p_item->subtree_always_visit = always_visit;
+	p_item->subtree_has_multimesh = has_multimesh;
+	p_item->subtree_rect_dirty = false;
+}
+
 void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner) {
 	Item *ci = p_canvas_item;
 
@@ -92,6 +153,20 @@ void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transfor
 		return;
 	}
 
+	_update_subtree_rect(ci);
+
+	if (!ci->subtree_always_visit) {
+		if (!ci->subtree_has_rect) {
+			return; // nothing to draw down there
+		}
+
+		Rect2 subtree_rect = p_transform.xform(ci->subtree_rect);
+		subtree_rect.position += p_clip_rect.position;
+		if (!p_clip_rect.intersects(subtree_rect, true)) {
+			return;
+		}
+	}
+
 	if (ci->children_order_dirty) {
 		ci->child_items.sort_custom<ItemIndexSort>();
 		ci->children_order_dirty = false;
@@ -172,7 +247,7 @@ void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transfor
 	}
 
 	if (ci->update_when_visible) {
-		VisualServerRaster::redraw_request(false);
+		redraw_requested.set();
 	}
 
 	if ((!ci->commands.empty() && p_clip_rect.intersects(global_rect, true)) || ci->vp_render || ci->copy_back_buffer) {
@@ -226,48 +301,125 @@ void VisualServerCanvas::_light_mask_canvas_items(int p_z, RasterizerCanvas::Ite
 	}
 }
 
-void VisualServerCanvas::render_canvas(Canvas *p_canvas, const Transform2D &p_transform, RasterizerCanvas::Light *p_lights, RasterizerCanvas::Light *p_masked_lights, const Rect2 &p_clip_rect, int p_canvas_layer_id) {
-	VSG::canvas_render->canvas_begin();
+void VisualServerCanvas::_cull_canvas(Canvas *p_canvas, const Transform2D &p_transform, const Rect2 &p_clip_rect, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list) {
+	memset(z_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
+	memset(z_last_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
+
+	int l = p_canvas->child_items.size();
+	Canvas::ChildItem *ci = p_canvas->child_items.ptrw();
+	for (int i = 0; i < l; i++) {
+		_render_canvas_item(ci[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr);
+	}
+}
+
+void VisualServerCanvas::_precull_canvas(uint32_t p_index, void *p_userdata) {
+	const PrecullCanvas &pc = precull_canvas_list[p_index];
+	RasterizerCanvas::Item **lists = &precull_z_lists[p_index * z_range * 2];
+	_cull_canvas(pc.canvas, pc.transform, pc.clip_rect, lists, lists + z_range);
+}
+
+void VisualServerCanvas::_flush_redraw_request() {
+	if (redraw_requested.is_set()) {
+		redraw_requested.clear();
+		VisualServerRaster::redraw_request(false);
+	}
+}
 
+void VisualServerCanvas::precull_canvas_add(Canvas *p_canvas, const Transform2D &p_transform, const Rect2 &p_clip_rect) {
 	if (p_canvas->children_order_dirty) {
 		p_canvas->child_items.sort();
 		p_canvas->children_order_dirty = false;
 	}
 
+	// Mirrored items are traversed once per copy while drawing.
+	if (p_canvas->has_mirror()) {
+		return;
+	}
+
+	// Bring the item rects up to date here, so the worker threads only read them. Multimeshes are left
+	// to the render thread, as getting their bounds may upload pending multimesh data.
 	int l = p_canvas->child_items.size();
 	Canvas::ChildItem *ci = p_canvas->child_items.ptrw();
-
-	bool has_mirror = false;
 	for (int i = 0; i < l; i++) {
-		if (ci[i].mirror.x || ci[i].mirror.y) {
-			has_mirror = true;
-			break;
+		if (!ci[i].item->visible) {
+			continue;
+		}
+
+		_update_subtree_rect(ci[i].item);
+		if (ci[i].item->subtree_has_multimesh) {
+			return;
 		}
 	}
 
-	if (!has_mirror) {
-		static const int z_range = VS::CANVAS_ITEM_Z_MAX - VS::CANVAS_ITEM_Z_MIN + 1;
-		RasterizerCanvas::Item *z_list[z_range];
-		RasterizerCanvas::Item *z_last_list[z_range];
+	if (precull_canvas_list.size() <= precull_canvas_count) {
+		precull_canvas_list.resize(precull_canvas_count + 1);
+	}
 
-		memset(z_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
-		memset(z_last_list, 0, z_range * sizeof(RasterizerCanvas::Item *));
+	PrecullCanvas &pc = precull_canvas_list[precull_canvas_count++];
+	pc.canvas = p_canvas;
+	pc.transform = p_transform;
+	pc.clip_rect = p_clip_rect;
+}
 
-		for (int i = 0; i < l; i++) {
-			_render_canvas_item(ci[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr);
+void VisualServerCanvas::precull_canvases() {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (precull_canvas_count < 2 || !pool || pool->get_thread_count() < 2) {
+		// Each canvas is traversed when it's drawn.
+		precull_canvas_count = 0;
+		return;
+	}
+
+	if (precull_z_lists.size() < precull_canvas_count * z_range * 2) {
+		precull_z_lists.resize(precull_canvas_count * z_range * 2);
+	}
+
+	WorkerThreadPool::TaskID task = pool->add_template_group_task(this, &VisualServerCanvas::_precull_canvas, (void *)nullptr, precull_canvas_count);
+	pool->wait_for_task_completion(task);
+}
+
+void VisualServerCanvas::precull_clear() {
+	precull_canvas_count = 0;
+	_flush_redraw_request();
+}
+
+void VisualServerCanvas::render_canvas(Canvas *p_canvas, const Transform2D &p_transform, RasterizerCanvas::Light *p_lights, RasterizerCanvas::Light *p_masked_lights, const Rect2 &p_clip_rect, int p_canvas_layer_id) {
+	VSG::canvas_render->canvas_begin();
+
+	if (p_canvas->children_order_dirty) {
+		p_canvas->child_items.sort();
+		p_canvas->children_order_dirty = false;
+	}
+
+	int l = p_canvas->child_items.size();
+
+	if (!p_canvas->has_mirror()) {
+		RasterizerCanvas::Item **canvas_z_list = nullptr;
+
+		// The tree may already have been traversed along with the other layers of the viewport.
+		for (uint32_t i = 0; i < precull_canvas_count; i++) {
+			const PrecullCanvas &pc = precull_canvas_list[i];
+			if (pc.canvas == p_canvas && pc.transform == p_transform && pc.clip_rect == p_clip_rect) {
+				canvas_z_list = &precull_z_lists[i * z_range * 2];
+				break;
+			}
+		}
+
+		if (!canvas_z_list) {
+			canvas_z_list = z_list;
+			_cull_canvas(p_canvas, p_transform, p_clip_rect, z_list, z_last_list);
 		}
 
 		VSG::canvas_render->canvas_render_items_begin(p_canvas->modulate, p_lights, p_transform);
 		for (int i = 0; i < z_range; i++) {
-			if (!z_list[i]) {
+			if (!canvas_z_list[i]) {
 				continue;
 			}
 
 			if (p_masked_lights) {
-				_light_mask_canvas_items(VS::CANVAS_ITEM_Z_MIN + i, z_list[i], p_masked_lights, p_canvas_layer_id);
+				_light_mask_canvas_items(VS::CANVAS_ITEM_Z_MIN + i, canvas_z_list[i], p_masked_lights, p_canvas_layer_id);
 			}
 
-			VSG::canvas_render->canvas_render_items(z_list[i], VS::CANVAS_ITEM_Z_MIN + i, p_canvas->modulate, p_lights, p_transform);
+			VSG::canvas_render->canvas_render_items(canvas_z_list[i], VS::CANVAS_ITEM_Z_MIN + i, p_canvas->modulate, p_lights, p_transform);
 		}
 		VSG::canvas_render->canvas_render_items_end();
 	} else {
@@ -292,6 +444,8 @@ void VisualServerCanvas::render_canvas(Canvas *p_canvas, const Transform2D &p_tr
 	}
 
 	VSG::canvas_render->canvas_end();
+
+	_flush_redraw_request();
 }
 
 RID VisualServerCanvas::canvas_create() {
@@ -352,6 +506,8 @@ void VisualServerCanvas::canvas_item_set_parent(RID p_item, RID p_parent) {
 			if (item_owner->sort_y) {
 				_mark_ysort_dirty(item_owner, canvas_item_owner);
 			}
+
+			_mark_subtree_rect_dirty(item_owner, canvas_item_owner, true);
 		}
 
 		canvas_item->parent = RID();
@@ -379,6 +535,8 @@ void VisualServerCanvas::canvas_item_set_parent(RID p_item, RID p_parent) {
 	}
 
 	canvas_item->parent = p_parent;
+
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner, true);
 }
 void VisualServerCanvas::canvas_item_set_visible(RID p_item, bool p_visible) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
@@ -387,6 +545,7 @@ void VisualServerCanvas::canvas_item_set_visible(RID p_item, bool p_visible) {
 	canvas_item->visible = p_visible;
 
 	_mark_ysort_dirty(canvas_item, canvas_item_owner);
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner, true);
 }
 void VisualServerCanvas::canvas_item_set_light_mask(RID p_item, int p_mask) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
@@ -400,6 +559,7 @@ void VisualServerCanvas::canvas_item_set_transform(RID p_item, const Transform2D
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->xform = p_transform;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 }
 void VisualServerCanvas::canvas_item_set_clip(RID p_item, bool p_clip) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
@@ -419,6 +579,7 @@ void VisualServerCanvas::canvas_item_set_custom_rect(RID p_item, bool p_custom_r
 
 	canvas_item->custom_rect = p_custom_rect;
 	canvas_item->rect = p_rect;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 }
 void VisualServerCanvas::canvas_item_set_modulate(RID p_item, const Color &p_color) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
@@ -445,6 +606,7 @@ void VisualServerCanvas::canvas_item_set_update_when_visible(RID p_item, bool p_
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->update_when_visible = p_update;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 }
 
 void VisualServerCanvas::canvas_item_add_line(RID p_item, const Point2 &p_from, const Point2 &p_to, const Color &p_color, float p_width, bool p_antialiased) {
@@ -502,6 +664,7 @@ void VisualServerCanvas::canvas_item_add_line(RID p_item, const Point2 &p_from,
 	line->width = p_width;
 	line->antialiased = p_antialiased;
 	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	canvas_item->commands.push_back(line);
 }
@@ -585,6 +748,7 @@ void VisualServerCanvas::canvas_item_add_polyline(RID p_item, const Vector<Point
 		}
 	}
 	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 	canvas_item->commands.push_back(pline);
 }
 
@@ -608,6 +772,7 @@ void VisualServerCanvas::canvas_item_add_multiline(RID p_item, const Vector<Poin
 	}
 
 	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 	canvas_item->commands.push_back(pline);
 }
 
@@ -620,6 +785,7 @@ void VisualServerCanvas::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, c
 	rect->modulate = p_color;
 	rect->rect = p_rect;
 	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	canvas_item->commands.push_back(rect);
 }
@@ -634,6 +800,9 @@ void VisualServerCanvas::canvas_item_add_circle(RID p_item, const Point2 &p_pos,
 	circle->pos = p_pos;
 	circle->radius = p_radius;
 
+	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
+
 	canvas_item->commands.push_back(circle);
 }
 
@@ -667,6 +836,7 @@ void VisualServerCanvas::canvas_item_add_texture_rect(RID p_item, const Rect2 &p
 	rect->texture = p_texture;
 	rect->normal_map = p_normal_map;
 	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 	canvas_item->commands.push_back(rect);
 }
 
@@ -710,6 +880,7 @@ void VisualServerCanvas::canvas_item_add_texture_rect_region(RID p_item, const R
 	}
 
 	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	canvas_item->commands.push_back(rect);
 }
@@ -733,6 +904,7 @@ void VisualServerCanvas::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_r
 	style->axis_x = p_x_axis_mode;
 	style->axis_y = p_y_axis_mode;
 	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	canvas_item->commands.push_back(style);
 }
@@ -749,6 +921,7 @@ void VisualServerCanvas::canvas_item_add_primitive(RID p_item, const Vector<Poin
 	prim->colors = p_colors;
 	prim->width = p_width;
 	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	canvas_item->commands.push_back(prim);
 }
@@ -779,6 +952,7 @@ void VisualServerCanvas::canvas_item_add_polygon(RID p_item, const Vector<Point2
 	polygon->antialiased = p_antialiased;
 	polygon->antialiasing_use_indices = false;
 	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	canvas_item->commands.push_back(polygon);
 }
@@ -824,6 +998,7 @@ void VisualServerCanvas::canvas_item_add_triangle_array(RID p_item, const Vector
 	polygon->antialiased = p_antialiased;
 	polygon->antialiasing_use_indices = p_antialiasing_use_indices;
 	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 
 	canvas_item->commands.push_back(polygon);
 }
@@ -836,6 +1011,9 @@ void VisualServerCanvas::canvas_item_add_set_transform(RID p_item, const Transfo
 	ERR_FAIL_COND(!tr);
 	tr->xform = p_transform;
 
+	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
+
 	canvas_item->commands.push_back(tr);
 }
 
@@ -851,6 +1029,9 @@ void VisualServerCanvas::canvas_item_add_mesh(RID p_item, const RID &p_mesh, con
 	m->transform = p_transform;
 	m->modulate = p_modulate;
 
+	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
+
 	canvas_item->commands.push_back(m);
 }
 void VisualServerCanvas::canvas_item_add_particles(RID p_item, RID p_particles, RID p_texture, RID p_normal) {
@@ -867,6 +1048,7 @@ void VisualServerCanvas::canvas_item_add_particles(RID p_item, RID p_particles,
 	VSG::storage->particles_request_process(p_particles);
 
 	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 	canvas_item->commands.push_back(part);
 }
 
@@ -881,6 +1063,7 @@ void VisualServerCanvas::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p
 	mm->normal_map = p_normal_map;
 
 	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 	canvas_item->commands.push_back(mm);
 }
 
@@ -922,6 +1105,8 @@ void VisualServerCanvas::canvas_item_attach_skeleton(RID p_item, RID p_skeleton)
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->skeleton = p_skeleton;
+	canvas_item->rect_dirty = true;
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 }
 
 void VisualServerCanvas::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_enable, const Rect2 &p_rect) {
@@ -940,6 +1125,8 @@ void VisualServerCanvas::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_e
 		canvas_item->copy_back_buffer->rect = p_rect;
 		canvas_item->copy_back_buffer->full = p_rect == Rect2();
 	}
+
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 }
 
 void VisualServerCanvas::canvas_item_clear(RID p_item) {
@@ -947,6 +1134,7 @@ void VisualServerCanvas::canvas_item_clear(RID p_item) {
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->clear();
+	_mark_subtree_rect_dirty(canvas_item, canvas_item_owner);
 }
 void VisualServerCanvas::canvas_item_set_draw_index(RID p_item, int p_index) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
@@ -1332,6 +1520,8 @@ bool VisualServerCanvas::free(RID p_rid) {
 				if (item_owner->sort_y) {
 					_mark_ysort_dirty(item_owner, canvas_item_owner);
 				}
+
+				_mark_subtree_rect_dirty(item_owner, canvas_item_owner, true);
 			}
 		}
 
@@ -31,6 +31,8 @@
 #ifndef VISUALSERVERCANVAS_H
 #define VISUALSERVERCANVAS_H
 
+#include "core/local_vector.h"
+#include "core/safe_refcount.h"
 #include "rasterizer.h"
 #include "visual_server_viewport.h"
 
@@ -53,6 +55,14 @@ public:
 		Vector2 ysort_pos;
 		int ysort_index;
 
+		// Bounds of the item and its visible descendants in the parent's space, so subtrees
+		// entirely outside the viewport can be skipped without being walked.
+		Rect2 subtree_rect;
+		bool subtree_rect_dirty;
+		bool subtree_has_rect;
+		bool subtree_always_visit;
+		bool subtree_has_multimesh;
+
 		Vector<Item *> child_items;
 
 		Item() {
@@ -69,6 +79,10 @@ public:
 			ysort_xform = Transform2D();
 			ysort_pos = Vector2();
 			ysort_index = 0;
+			subtree_rect_dirty = true;
+			subtree_has_rect = false;
+			subtree_always_visit = false;
+			subtree_has_multimesh = false;
 		}
 	};
 
@@ -139,6 +153,14 @@ public:
 				child_items.remove(idx);
 			}
 		}
+		bool has_mirror() const {
+			for (int i = 0; i < child_items.size(); i++) {
+				if (child_items[i].mirror.x || child_items[i].mirror.y) {
+					return true;
+				}
+			}
+			return false;
+		}
 
 		Canvas() {
 			modulate = Color(1, 1, 1, 1);
@@ -157,13 +179,37 @@ private:
 	void _render_canvas_item_tree(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights);
 	void _render_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner);
 	void _light_mask_canvas_items(int p_z, RasterizerCanvas::Item *p_canvas_item, RasterizerCanvas::Light *p_masked_lights, int p_canvas_layer_id);
+	void _update_subtree_rect(Item *p_item);
+	void _cull_canvas(Canvas *p_canvas, const Transform2D &p_transform, const Rect2 &p_clip_rect, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list);
 
 	RasterizerCanvas::Item **z_list;
 	RasterizerCanvas::Item **z_last_list;
 
+	// The item trees of the canvas layers in a viewport don't share items, so they can be traversed
+	// into their own z-lists on worker threads before the layers are drawn one after another.
+	struct PrecullCanvas {
+		Canvas *canvas = nullptr;
+		Transform2D transform;
+		Rect2 clip_rect;
+	};
+
+	LocalVector<PrecullCanvas> precull_canvas_list;
+	LocalVector<RasterizerCanvas::Item *> precull_z_lists;
+	uint32_t precull_canvas_count = 0;
+
+	// Items asking to be updated when visible may be reached from worker threads.
+	SafeFlag redraw_requested;
+
+	void _precull_canvas(uint32_t p_index, void *p_userdata);
+	void _flush_redraw_request();
+
 public:
 	void render_canvas(Canvas *p_canvas, const Transform2D &p_transform, RasterizerCanvas::Light *p_lights, RasterizerCanvas::Light *p_masked_lights, const Rect2 &p_clip_rect, int p_canvas_layer_id);
 
+	void precull_canvas_add(Canvas *p_canvas, const Transform2D &p_transform, const Rect2 &p_clip_rect);
+	void precull_canvases();
+	void precull_clear();
+
 	RID canvas_create();
 	void canvas_set_item_mirroring(RID p_canvas, RID p_item, const Point2 &p_mirroring);
 	void canvas_set_modulate(RID p_canvas, const Color &p_color);
@@ -115,6 +115,7 @@ void VisualServerRaster::draw(bool p_swap_buffers, double frame_step) {
 
 	VSG::viewport->draw_viewports();
 	VSG::scene->render_probes();
+	VSG::scene->end_frame();
 	_draw_margins();
 	VSG::rasterizer->end_frame(p_swap_buffers);
 
@@ -164,7 +165,16 @@ void VisualServerRaster::finish() {
 /* STATUS INFORMATION */
 
 uint64_t VisualServerRaster::get_render_info(RenderInfo p_info) {
-	return VSG::storage->get_render_info(p_info);
+	switch (p_info) {
+		case INFO_OCCLUSION_CULLED_IN_FRAME:
+			return VSG::scene->get_occlusion_culled_in_frame();
+		case INFO_SHADOW_CASTER_CACHE_HITS_IN_FRAME:
+			return VSG::scene->get_shadow_caster_cache_hits_in_frame();
+		case INFO_SHADOW_CASTER_CACHE_MISSES_IN_FRAME:
+			return VSG::scene->get_shadow_caster_cache_misses_in_frame();
+		default:
+			return VSG::storage->get_render_info(p_info);
+	}
 }
 
 String VisualServerRaster::get_video_adapter_name() const {
@@ -32,6 +32,7 @@
 
 #include "core/math/transform_interpolator.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 #include "visual_server_globals.h"
 #include "visual_server_raster.h"
 
@@ -159,6 +160,10 @@ VisualServerScene::SpatialPartitioningScene_BVH::SpatialPartitioningScene_BVH()
 	_bvh.params_set_pairing_expansion(GLOBAL_GET("rendering/quality/spatial_partitioning/bvh_collision_margin"));
 
 	_dummy_cull_object = memnew(Instance);
+
+	_dummy_concurrent_cull_object = memnew(Instance);
+	_dummy_concurrent_cull_object->bvh_pairable_mask = 0xFFFFFFFF;
+	_dummy_concurrent_cull_object->bvh_pairable_type = 0;
 }
 
 VisualServerScene::SpatialPartitioningScene_BVH::~SpatialPartitioningScene_BVH() {
@@ -166,6 +171,10 @@ VisualServerScene::SpatialPartitioningScene_BVH::~SpatialPartitioningScene_BVH()
 		memdelete(_dummy_cull_object);
 		_dummy_cull_object = nullptr;
 	}
+	if (_dummy_concurrent_cull_object) {
+		memdelete(_dummy_concurrent_cull_object);
+		_dummy_concurrent_cull_object = nullptr;
+	}
 }
 
 VisualServerScene::SpatialPartitionID VisualServerScene::SpatialPartitioningScene_BVH::create(Instance *p_userdata, const AABB &p_aabb, int p_subindex, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
@@ -247,6 +256,11 @@ int VisualServerScene::SpatialPartitioningScene_BVH::cull_segment(const Vector3
 	return _bvh.cull_segment(p_from, p_to, p_result_array, p_result_max, _dummy_cull_object, 0xFFFFFFFF, p_subindex_array);
 }
 
+int VisualServerScene::SpatialPartitioningScene_BVH::cull_convex_concurrent(const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max) {
+	// The tree isn't modified while the cameras are culled, so the threads don't need to take turns on the lock.
+	return _bvh.cull_convex_concurrent(p_convex, p_result_array, p_result_max, _dummy_concurrent_cull_object);
+}
+
 void VisualServerScene::SpatialPartitioningScene_BVH::set_pair_callback(PairCallback p_callback, void *p_userdata) {
 	_bvh.set_pair_callback(p_callback, p_userdata);
 }
@@ -334,7 +348,7 @@ void *VisualServerScene::_instance_pair(void *p_self, SpatialPartitionID, Instan
 		List<InstanceLightData::PairInfo>::Element *E = light->geometries.push_back(pinfo);
 
 		if (geom->can_cast_shadows) {
-			light->shadow_dirty = true;
+			light->shadow_casters_changed();
 		}
 		geom->lighting_dirty = true;
 
@@ -406,7 +420,7 @@ void VisualServerScene::_instance_unpair(void *p_self, SpatialPartitionID, Insta
 		light->geometries.erase(E);
 
 		if (geom->can_cast_shadows) {
-			light->shadow_dirty = true;
+			light->shadow_casters_changed();
 		}
 		geom->lighting_dirty = true;
 
@@ -555,6 +569,8 @@ void VisualServerScene::instance_set_base(RID p_instance, RID p_base) {
 
 	Scenario *scenario = instance->scenario;
 
+	instance->occluder_dirty = true;
+
 	if (instance->base_type != VS::INSTANCE_NONE) {
 		//free anything related to that base
 
@@ -719,6 +735,10 @@ void VisualServerScene::instance_set_scenario(RID p_instance, RID p_scenario) {
 	if (instance->scenario) {
 		instance->scenario->instances.remove(&instance->scenario_item);
 
+		if (instance->occluder_item.in_list()) {
+			instance->scenario->occluders.remove(&instance->occluder_item);
+		}
+
 		if (instance->spatial_partition_id) {
 			instance->scenario->sps->erase(instance->spatial_partition_id);
 			instance->spatial_partition_id = 0;
@@ -766,6 +786,10 @@ void VisualServerScene::instance_set_scenario(RID p_instance, RID p_scenario) {
 
 		scenario->instances.add(&instance->scenario_item);
 
+		if (instance->occluder) {
+			scenario->occluders.add(&instance->occluder_item);
+		}
+
 		switch (instance->base_type) {
 			case VS::INSTANCE_LIGHT: {
 				InstanceLightData *light = static_cast<InstanceLightData *>(instance->base_data);
@@ -1132,7 +1156,7 @@ void VisualServerScene::instance_set_visible(RID p_instance, bool p_visible) {
 		if (geom->can_cast_shadows) {
 			for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
 				InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
-				light->shadow_dirty = true;
+				light->shadow_casters_changed();
 			}
 		}
 	}
@@ -1844,23 +1868,50 @@ Vector<ObjectID> VisualServerScene::instances_cull_convex(const Vector<Plane> &p
 }
 
 // thin wrapper to allow rooms / portals to take over culling if active
-int VisualServerScene::_cull_convex_from_point(Scenario *p_scenario, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max, int32_t &r_previous_room_id_hint, uint32_t p_mask) {
-	int res = -1;
-	if (p_scenario->_portal_renderer.is_active()) {
-		// Note that the portal renderer ASSUMES that the planes exactly match the convention in
-		// CameraMatrix of enum Planes (6 planes, in order, near, far etc)
-		// If this is not the case, it should not be used.
-		res = p_scenario->_portal_renderer.cull_convex(p_cam_transform, p_cam_projection, p_convex, (VSInstance **)p_result_array, p_result_max, p_mask, r_previous_room_id_hint);
+int VisualServerScene::_cull_convex_from_point(Scenario *p_scenario, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, const Vector<Plane> &p_convex, LocalVector<Instance *> &r_result, int32_t &r_previous_room_id_hint, uint32_t p_mask) {
+	if (r_result.empty()) {
+		r_result.resize(INSTANCE_CULL_INITIAL_SIZE);
 	}
 
-	// fallback to BVH  / octree if portals not active
-	if (res == -1) {
-		res = p_scenario->sps->cull_convex(p_convex, p_result_array, p_result_max, p_mask);
+	while (true) {
+		int res = -1;
+		bool portals = false;
+		if (p_scenario->_portal_renderer.is_active()) {
+			// Note that the portal renderer ASSUMES that the planes exactly match the convention in
+			// CameraMatrix of enum Planes (6 planes, in order, near, far etc)
+			// If this is not the case, it should not be used.
+			res = p_scenario->_portal_renderer.cull_convex(p_cam_transform, p_cam_projection, p_convex, (VSInstance **)r_result.ptr(), r_result.size(), p_mask, r_previous_room_id_hint);
+			portals = res != -1;
+		}
+
+		// fallback to BVH  / octree if portals not active
+		if (!portals) {
+			res = p_scenario->sps->cull_convex(p_convex, r_result.ptr(), r_result.size(), p_mask);
+		}
+
+		if (res >= (int)r_result.size()) {
+			// Results were probably cut short, grow and cull again.
+			r_result.resize(r_result.size() * 2);
+			continue;
+		}
 
 		// Opportunity for occlusion culling on the main scene. This will be a noop if no occluders.
-		if (p_scenario->_portal_renderer.occlusion_is_active()) {
-			res = p_scenario->_portal_renderer.occlusion_cull(p_cam_transform, p_cam_projection, p_convex, (VSInstance **)p_result_array, res);
+		if (!portals && p_scenario->_portal_renderer.occlusion_is_active()) {
+			res = p_scenario->_portal_renderer.occlusion_cull(p_cam_transform, p_cam_projection, p_convex, (VSInstance **)r_result.ptr(), res);
 		}
+		return res;
+	}
+}
+
+int VisualServerScene::_cull_convex(Scenario *p_scenario, const Vector<Plane> &p_convex, LocalVector<Instance *> &r_result, uint32_t p_mask) {
+	if (r_result.empty()) {
+		r_result.resize(INSTANCE_CULL_INITIAL_SIZE);
+	}
+
+	int res = p_scenario->sps->cull_convex(p_convex, r_result.ptr(), r_result.size(), p_mask);
+	while (res >= (int)r_result.size()) {
+		r_result.resize(r_result.size() * 2);
+		res = p_scenario->sps->cull_convex(p_convex, r_result.ptr(), r_result.size(), p_mask);
 	}
 	return res;
 }
@@ -1895,6 +1946,17 @@ void VisualServerScene::instance_geometry_set_flag(RID p_instance, VS::InstanceF
 			instance->redraw_if_visible = p_enabled;
 
 		} break;
+		case VS::INSTANCE_FLAG_OCCLUDER: {
+			instance->occluder = p_enabled;
+
+			if (instance->scenario) {
+				if (p_enabled && !instance->occluder_item.in_list()) {
+					instance->scenario->occluders.add(&instance->occluder_item);
+				} else if (!p_enabled && instance->occluder_item.in_list()) {
+					instance->scenario->occluders.remove(&instance->occluder_item);
+				}
+			}
+		} break;
 		default: {
 		}
 	}
@@ -1958,7 +2020,7 @@ void VisualServerScene::_update_instance(Instance *p_instance) {
 		InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
 		VSG::scene_render->light_instance_set_transform(light->instance, *instance_xform);
-		light->shadow_dirty = true;
+		light->shadow_casters_changed();
 	}
 
 	if (p_instance->base_type == VS::INSTANCE_REFLECTION_PROBE) {
@@ -1990,7 +2052,7 @@ void VisualServerScene::_update_instance(Instance *p_instance) {
 		if (geom->can_cast_shadows) {
 			for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
 				InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
-				light->shadow_dirty = true;
+				light->shadow_casters_changed();
 			}
 		}
 
@@ -2358,6 +2420,71 @@ void VisualServerScene::_update_instance_lightmap_captures(Instance *p_instance)
 	p_instance->lightmap_capture_data.write[0].a = interior ? 0.0f : 1.0f;
 }
 
+bool VisualServerScene::_light_is_paired(Instance *p_light, Instance *p_geometry) const {
+	const InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(p_geometry->base_data);
+	for (const List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
+		if (E->get() == p_light) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Finds the shadow casters for one pass of an omni or spot light. These don't depend on the camera,
+// so unless rooms and portals or occluders are involved, the result is reused (across frames and
+// viewports) until the light or a caster paired with it changes.
+// Only casters paired with the light get to invalidate its caches when they change or are freed, so the
+// cache must not hold anything else. The cull volumes reach past the light's AABB, which the pairing uses,
+// but whatever lies beyond it is out of the light's range and can't cast a visible shadow.
+int VisualServerScene::_light_cull_shadow_casters(Instance *p_light, int p_pass, const Transform &p_transform, const CameraMatrix &p_projection, const Vector<Plane> &p_planes, bool p_from_point, Scenario *p_scenario, Instance **&r_casters, bool &r_animated) {
+	InstanceLightData *light = static_cast<InstanceLightData *>(p_light->base_data);
+	InstanceLightData::ShadowCasterCache &cache = light->shadow_caster_cache[p_pass];
+
+	bool cacheable = !p_scenario->_portal_renderer.is_active() && !p_scenario->_portal_renderer.occlusion_is_active();
+	if (cacheable && cache.valid) {
+		shadow_caster_cache_hits++;
+		r_casters = cache.casters.ptr();
+		r_animated = cache.animated;
+		return cache.casters.size();
+	}
+
+	shadow_caster_cache_misses++;
+
+	int cull_count;
+	if (p_from_point) {
+		cull_count = _cull_convex_from_point(p_scenario, p_transform, p_projection, p_planes, instance_shadow_cull_result, light->previous_room_id_hint, VS::INSTANCE_GEOMETRY_MASK);
+	} else {
+		cull_count = _cull_convex(p_scenario, p_planes, instance_shadow_cull_result, VS::INSTANCE_GEOMETRY_MASK);
+	}
+
+	r_animated = false;
+	for (int j = 0; j < cull_count; j++) {
+		Instance *instance = instance_shadow_cull_result[j];
+		if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || (cacheable && !_light_is_paired(p_light, instance))) {
+			cull_count--;
+			SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
+			j--;
+		} else if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
+			r_animated = true;
+		}
+	}
+
+	if (!cacheable) {
+		r_casters = instance_shadow_cull_result.ptr();
+		return cull_count;
+	}
+
+	cache.casters.resize(cull_count);
+	for (int j = 0; j < cull_count; j++) {
+		cache.casters[j] = instance_shadow_cull_result[j];
+	}
+	cache.animated = r_animated;
+	cache.valid = true;
+
+	r_casters = cache.casters.ptr();
+	return cull_count;
+}
+
 bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario) {
 	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
@@ -2381,7 +2508,7 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 			if (depth_range_mode == VS::LIGHT_DIRECTIONAL_SHADOW_DEPTH_RANGE_OPTIMIZED) {
 				//optimize min/max
 				Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
-				int cull_count = p_scenario->sps->cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+				int cull_count = _cull_convex(p_scenario, planes, instance_shadow_cull_result, VS::INSTANCE_GEOMETRY_MASK);
 				Plane base(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2));
 				//check distance max and min
 
@@ -2585,7 +2712,7 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 				light_frustum_planes.write[4] = Plane(z_vec, z_max + 1e6);
 				light_frustum_planes.write[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
 
-				int cull_count = p_scenario->sps->cull_convex(light_frustum_planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+				int cull_count = _cull_convex(p_scenario, light_frustum_planes, instance_shadow_cull_result, VS::INSTANCE_GEOMETRY_MASK);
 
 				// a pre pass will need to be needed to determine the actual z-near to be used
 
@@ -2623,7 +2750,7 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 					VSG::scene_render->light_instance_set_shadow_transform(light->instance, ortho_camera, ortho_transform, 0, distances[i + 1], i, bias_scale);
 				}
 
-				VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+				VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result.ptr(), cull_count);
 			}
 
 		} break;
@@ -2646,27 +2773,19 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 					planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
 					planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
 
-					int cull_count = p_scenario->sps->cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
-					Plane near_plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
+					Instance **casters = nullptr;
+					bool animated = false;
+					int cull_count = _light_cull_shadow_casters(p_instance, i, light_transform, CameraMatrix(), planes, false, p_scenario, casters, animated);
+					animated_material_found = animated_material_found || animated;
 
+					Plane near_plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
 					for (int j = 0; j < cull_count; j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-							cull_count--;
-							SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-							j--;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-
-							instance->depth = near_plane.distance_to(instance->transform.origin);
-							instance->depth_layer = 0;
-						}
+						casters[j]->depth = near_plane.distance_to(casters[j]->transform.origin);
+						casters[j]->depth_layer = 0;
 					}
 
 					VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, i);
-					VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+					VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)casters, cull_count);
 				}
 			} else { //shadow cube
 
@@ -2698,26 +2817,19 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 					Vector<Plane> planes = cm.get_projection_planes(xform);
 
-					int cull_count = _cull_convex_from_point(p_scenario, light_transform, cm, planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, light->previous_room_id_hint, VS::INSTANCE_GEOMETRY_MASK);
+					Instance **casters = nullptr;
+					bool animated = false;
+					int cull_count = _light_cull_shadow_casters(p_instance, i, light_transform, cm, planes, true, p_scenario, casters, animated);
+					animated_material_found = animated_material_found || animated;
 
 					Plane near_plane(xform.origin, -xform.basis.get_axis(2));
 					for (int j = 0; j < cull_count; j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-							cull_count--;
-							SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-							j--;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-							instance->depth = near_plane.distance_to(instance->transform.origin);
-							instance->depth_layer = 0;
-						}
+						casters[j]->depth = near_plane.distance_to(casters[j]->transform.origin);
+						casters[j]->depth_layer = 0;
 					}
 
 					VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, xform, radius, 0, i);
-					VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+					VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)casters, cull_count);
 				}
 
 				//restore the regular DP matrix
@@ -2733,26 +2845,19 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 			cm.set_perspective(angle * 2.0, 1.0, 0.01, radius);
 
 			Vector<Plane> planes = cm.get_projection_planes(light_transform);
-			int cull_count = _cull_convex_from_point(p_scenario, light_transform, cm, planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, light->previous_room_id_hint, VS::INSTANCE_GEOMETRY_MASK);
+			Instance **casters = nullptr;
+			bool animated = false;
+			int cull_count = _light_cull_shadow_casters(p_instance, 0, light_transform, cm, planes, true, p_scenario, casters, animated);
+			animated_material_found = animated_material_found || animated;
 
 			Plane near_plane(light_transform.origin, -light_transform.basis.get_axis(2));
 			for (int j = 0; j < cull_count; j++) {
-				Instance *instance = instance_shadow_cull_result[j];
-				if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-					cull_count--;
-					SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-					j--;
-				} else {
-					if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-						animated_material_found = true;
-					}
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
-				}
+				casters[j]->depth = near_plane.distance_to(casters[j]->transform.origin);
+				casters[j]->depth_layer = 0;
 			}
 
 			VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0);
-			VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, 0, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+			VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, 0, (RasterizerScene::InstanceBase **)casters, cull_count);
 
 		} break;
 	}
@@ -2760,48 +2865,151 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 	return animated_material_found;
 }
 
-void VisualServerScene::render_camera(RID p_camera, RID p_scenario, Size2 p_viewport_size, RID p_shadow_atlas) {
-// render to mono camera
-#ifndef _3D_DISABLED
-
-	Camera *camera = camera_owner.getornull(p_camera);
-	ERR_FAIL_COND(!camera);
-
-	/* STEP 1 - SETUP CAMERA */
-	CameraMatrix camera_matrix;
-	bool ortho = false;
-
-	switch (camera->type) {
+void VisualServerScene::_camera_get_projection(const Camera *p_camera, const Size2 &p_viewport_size, CameraMatrix &r_projection, bool &r_ortho) const {
+	switch (p_camera->type) {
 		case Camera::ORTHOGONAL: {
-			camera_matrix.set_orthogonal(
-					camera->size,
+			r_projection.set_orthogonal(
+					p_camera->size,
 					p_viewport_size.width / (float)p_viewport_size.height,
-					camera->znear,
-					camera->zfar,
-					camera->vaspect);
-			ortho = true;
+					p_camera->znear,
+					p_camera->zfar,
+					p_camera->vaspect);
+			r_ortho = true;
 		} break;
 		case Camera::PERSPECTIVE: {
-			camera_matrix.set_perspective(
-					camera->fov,
+			r_projection.set_perspective(
+					p_camera->fov,
 					p_viewport_size.width / (float)p_viewport_size.height,
-					camera->znear,
-					camera->zfar,
-					camera->vaspect);
-			ortho = false;
+					p_camera->znear,
+					p_camera->zfar,
+					p_camera->vaspect);
+			r_ortho = false;
 
 		} break;
 		case Camera::FRUSTUM: {
-			camera_matrix.set_frustum(
-					camera->size,
+			r_projection.set_frustum(
+					p_camera->size,
 					p_viewport_size.width / (float)p_viewport_size.height,
-					camera->offset,
-					camera->znear,
-					camera->zfar,
-					camera->vaspect);
-			ortho = false;
+					p_camera->offset,
+					p_camera->znear,
+					p_camera->zfar,
+					p_camera->vaspect);
+			r_ortho = false;
 		} break;
 	}
+}
+
+static bool _camera_matrix_equal(const CameraMatrix &p_a, const CameraMatrix &p_b) {
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			if (p_a.matrix[i][j] != p_b.matrix[i][j]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void VisualServerScene::precull_add_camera(RID p_camera, RID p_scenario, Size2 p_viewport_size) {
+	Camera *camera = camera_owner.getornull(p_camera);
+	Scenario *scenario = scenario_owner.getornull(p_scenario);
+	if (!camera || !scenario) {
+		return;
+	}
+
+	// Rooms and portals and the occluder system keep state while culling, leave those to _prepare_scene().
+	if (scenario->_portal_renderer.is_active() || scenario->_portal_renderer.occlusion_is_active()) {
+		return;
+	}
+
+	CameraMatrix projection;
+	bool ortho = false;
+	_camera_get_projection(camera, p_viewport_size, projection, ortho);
+	Transform cam_transform = camera->get_transform();
+
+	// Viewports showing the same camera share the result.
+	for (uint32_t i = 0; i < precull_view_count; i++) {
+		const PrecullView &view = precull_views[i];
+		if (view.scenario == scenario && view.cam_transform == cam_transform && _camera_matrix_equal(view.cam_projection, projection)) {
+			return;
+		}
+	}
+
+	if (precull_views.size() <= precull_view_count) {
+		precull_views.resize(precull_view_count + 1);
+	}
+
+	PrecullView &view = precull_views[precull_view_count++];
+	view.scenario = scenario;
+	view.cam_transform = cam_transform;
+	view.cam_projection = projection;
+	view.planes = projection.get_projection_planes(cam_transform);
+	view.result_count = -1;
+}
+
+void VisualServerScene::_precull_view(uint32_t p_index, void *p_userdata) {
+	PrecullView &view = precull_views[p_index];
+	if (view.result.empty()) {
+		view.result.resize(INSTANCE_CULL_INITIAL_SIZE);
+	}
+
+	int res = view.scenario->sps->cull_convex_concurrent(view.planes, view.result.ptr(), view.result.size());
+	while (res >= (int)view.result.size()) {
+		view.result.resize(view.result.size() * 2);
+		res = view.scenario->sps->cull_convex_concurrent(view.planes, view.result.ptr(), view.result.size());
+	}
+
+	// -1 when the partitioning can't be culled concurrently, _prepare_scene() will cull as usual.
+	view.result_count = res;
+}
+
+void VisualServerScene::precull_cameras() {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (precull_view_count < 2 || !pool || pool->get_thread_count() < 2) {
+		// Nothing to gain, each camera is culled when its viewport is drawn.
+		precull_view_count = 0;
+		return;
+	}
+
+	WorkerThreadPool::TaskID task = pool->add_template_group_task(this, &VisualServerScene::_precull_view, (void *)nullptr, precull_view_count);
+	pool->wait_for_task_completion(task);
+}
+
+void VisualServerScene::precull_clear() {
+	precull_view_count = 0;
+}
+
+bool VisualServerScene::_precull_get_result(Scenario *p_scenario, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection) {
+	for (uint32_t i = 0; i < precull_view_count; i++) {
+		const PrecullView &view = precull_views[i];
+		if (view.result_count < 0 || view.scenario != p_scenario || view.cam_transform != p_cam_transform || !_camera_matrix_equal(view.cam_projection, p_cam_projection)) {
+			continue;
+		}
+
+		if (instance_cull_result.size() < (uint32_t)view.result_count) {
+			instance_cull_result.resize(view.result_count);
+		}
+		if (view.result_count) {
+			memcpy(instance_cull_result.ptr(), view.result.ptr(), sizeof(Instance *) * view.result_count);
+		}
+		instance_cull_count = view.result_count;
+		return true;
+	}
+
+	return false;
+}
+
+void VisualServerScene::render_camera(RID p_camera, RID p_scenario, Size2 p_viewport_size, RID p_shadow_atlas) {
+// render to mono camera
+#ifndef _3D_DISABLED
+
+	Camera *camera = camera_owner.getornull(p_camera);
+	ERR_FAIL_COND(!camera);
+
+	/* STEP 1 - SETUP CAMERA */
+	CameraMatrix camera_matrix;
+	bool ortho = false;
+	_camera_get_projection(camera, p_viewport_size, camera_matrix, ortho);
 
 	// This getter allows optional fixed timestep interpolation for the camera.
 	Transform camera_transform = camera->get_transform();
@@ -2895,6 +3103,222 @@ void VisualServerScene::render_camera(Ref<ARVRInterface> &p_interface, ARVRInter
 	_render_scene(cam_transform, camera_matrix, p_eye, false, camera->env, p_scenario, p_shadow_atlas, RID(), -1);
 };
 
+void VisualServerScene::_update_instance_geometry_dependencies(Instance *p_instance) {
+	InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(p_instance->base_data);
+
+	if (geom->lighting_dirty) {
+		int l = 0;
+		//only called when lights AABB enter/exit this geometry
+		p_instance->light_instances.resize(geom->lighting.size());
+
+		for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
+			InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
+
+			p_instance->light_instances.write[l++] = light->instance;
+		}
+
+		geom->lighting_dirty = false;
+	}
+
+	if (geom->reflection_dirty) {
+		int l = 0;
+		//only called when reflection probe AABB enter/exit this geometry
+		p_instance->reflection_probe_instances.resize(geom->reflection_probes.size());
+
+		for (List<Instance *>::Element *E = geom->reflection_probes.front(); E; E = E->next()) {
+			InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(E->get()->base_data);
+
+			p_instance->reflection_probe_instances.write[l++] = reflection_probe->instance;
+		}
+
+		geom->reflection_dirty = false;
+	}
+
+	if (geom->gi_probes_dirty) {
+		int l = 0;
+		//only called when reflection probe AABB enter/exit this geometry
+		p_instance->gi_probe_instances.resize(geom->gi_probes.size());
+
+		for (List<Instance *>::Element *E = geom->gi_probes.front(); E; E = E->next()) {
+			InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(E->get()->base_data);
+
+			p_instance->gi_probe_instances.write[l++] = gi_probe->probe_instance;
+		}
+
+		geom->gi_probes_dirty = false;
+	}
+}
+
+void VisualServerScene::_update_occluder_data(Instance *p_instance) {
+	p_instance->occluder_dirty = false;
+	p_instance->occluder_vertices.clear();
+	p_instance->occluder_indices.clear();
+
+	if (p_instance->base_type != VS::INSTANCE_MESH) {
+		return;
+	}
+
+	// Goes through the VisualServer so compressed vertex formats are decoded.
+	int surface_count = VSG::storage->mesh_get_surface_count(p_instance->base);
+	for (int i = 0; i < surface_count; i++) {
+		if (VSG::storage->mesh_surface_get_primitive_type(p_instance->base, i) != VS::PRIMITIVE_TRIANGLES) {
+			continue;
+		}
+
+		Array arrays = VisualServer::get_singleton()->mesh_surface_get_arrays(p_instance->base, i);
+		if (arrays.size() != VS::ARRAY_MAX) {
+			continue;
+		}
+
+		PoolVector<Vector3> vertices = arrays[VS::ARRAY_VERTEX];
+		PoolVector<int> indices = arrays[VS::ARRAY_INDEX];
+		uint32_t base_index = p_instance->occluder_vertices.size();
+
+		PoolVector<Vector3>::Read vr = vertices.read();
+		for (int j = 0; j < vertices.size(); j++) {
+			p_instance->occluder_vertices.push_back(vr[j]);
+		}
+
+		if (indices.size()) {
+			PoolVector<int>::Read ir = indices.read();
+			for (int j = 0; j < indices.size(); j++) {
+				p_instance->occluder_indices.push_back(base_index + ir[j]);
+			}
+		} else {
+			for (int j = 0; j < vertices.size(); j++) {
+				p_instance->occluder_indices.push_back(base_index + j);
+			}
+		}
+	}
+}
+
+void VisualServerScene::_update_occlusion_buffer(Scenario *p_scenario, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, const Vector<Plane> &p_planes, uint32_t p_layer_mask) {
+	occlusion_buffer.clear();
+
+	if (!p_scenario || !p_scenario->occluders.first() || !PortalRenderer::use_occlusion_culling) {
+		return;
+	}
+
+	occlusion_buffer.begin(p_cam_transform, p_cam_projection, occlusion_buffer_width);
+
+	for (SelfList<Instance> *E = p_scenario->occluders.first(); E; E = E->next()) {
+		Instance *ins = E->self();
+
+		// Only what the camera actually draws may hide anything.
+		if (!ins->visible || (ins->layer_mask & p_layer_mask) == 0 || ins->cast_shadows == VS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
+			continue;
+		}
+
+		// Cheap rejection of occluders outside the view, before touching their triangles.
+		const AABB &aabb = ins->transformed_aabb;
+		Vector3 half_extents = aabb.size * 0.5;
+		Vector3 center = aabb.position + half_extents;
+		bool outside = false;
+		for (int i = 0; i < p_planes.size(); i++) {
+			const Plane &plane = p_planes[i];
+			Vector3 closest = center - Vector3(SGN(plane.normal.x) * half_extents.x, SGN(plane.normal.y) * half_extents.y, SGN(plane.normal.z) * half_extents.z);
+			if (plane.is_point_over(closest)) {
+				outside = true;
+				break;
+			}
+		}
+		if (outside) {
+			continue;
+		}
+
+		if (ins->occluder_dirty) {
+			_update_occluder_data(ins);
+		}
+
+		occlusion_buffer.add_occluder(ins->transform, ins->occluder_vertices.ptr(), ins->occluder_vertices.size(), ins->occluder_indices.ptr(), ins->occluder_indices.size());
+	}
+
+	occlusion_buffer.finish();
+}
+
+// Filters one chunk of the cull results. Only touches the instances of the chunk and the chunk
+// itself, so chunks can run on any thread. Anything that needs the rasterizer or shared lists
+// is left in the deferred list of the chunk.
+void VisualServerScene::_prepare_cull_chunk(uint32_t p_chunk, void *p_userdata) {
+	PrepareCullChunk &chunk = prepare_cull_chunks[p_chunk];
+	chunk.geometry.clear();
+	chunk.deferred.clear();
+	chunk.redraw = false;
+	chunk.occluded = 0;
+
+	uint32_t from = p_chunk * PREPARE_CULL_CHUNK_SIZE;
+	uint32_t to = MIN(from + PREPARE_CULL_CHUNK_SIZE, (uint32_t)instance_cull_count);
+
+	for (uint32_t i = from; i < to; i++) {
+		Instance *ins = instance_cull_result[i];
+
+		// Kept instances are marked again once the chunks are merged.
+		ins->last_render_pass = 0;
+
+		if ((prepare_cull_layer_mask & ins->layer_mask) == 0 || !ins->visible) {
+			continue;
+		}
+
+		switch (ins->base_type) {
+			case VS::INSTANCE_LIGHT:
+			case VS::INSTANCE_REFLECTION_PROBE:
+			case VS::INSTANCE_GI_PROBE: {
+				chunk.deferred.push_back(ins);
+			} break;
+			case VS::INSTANCE_PARTICLES: {
+				if (ins->cast_shadows != VS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
+					chunk.deferred.push_back(ins);
+				}
+			} break;
+			default: {
+				if (((1 << ins->base_type) & VS::INSTANCE_GEOMETRY_MASK) && ins->cast_shadows != VS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
+					// Occluders are not tested, their own depth could hide them through float error.
+					if (!ins->occluder && occlusion_buffer.is_occluded(ins->transformed_aabb)) {
+						chunk.occluded++;
+						break;
+					}
+
+					if (ins->redraw_if_visible) {
+						chunk.redraw = true;
+					}
+
+					_update_instance_geometry_dependencies(ins);
+
+					chunk.geometry.push_back(ins);
+					ins->last_render_pass = render_pass;
+				}
+			} break;
+		}
+	}
+}
+
+void VisualServerScene::_prepare_depth_chunk(uint32_t p_chunk, void *p_userdata) {
+	uint32_t from = p_chunk * PREPARE_CULL_CHUNK_SIZE;
+	uint32_t to = MIN(from + PREPARE_CULL_CHUNK_SIZE, (uint32_t)instance_cull_count);
+
+	for (uint32_t i = from; i < to; i++) {
+		Instance *ins = instance_cull_result[i];
+
+		if (((1 << ins->base_type) & VS::INSTANCE_GEOMETRY_MASK) && ins->visible && ins->cast_shadows != VS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
+			Vector3 aabb_center = ins->transformed_aabb.position + (ins->transformed_aabb.size * 0.5);
+			ins->depth = prepare_near_plane.distance_to(aabb_center);
+			ins->depth_layer = CLAMP(int(ins->depth * 16 / prepare_z_far), 0, 15);
+		}
+	}
+}
+
+void VisualServerScene::_run_prepare_chunks(void (VisualServerScene::*p_method)(uint32_t, void *), uint32_t p_chunk_count) {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 1 && p_chunk_count > 1) {
+		WorkerThreadPool::TaskID task = pool->add_template_group_task(this, p_method, (void *)nullptr, p_chunk_count);
+		pool->wait_for_task_completion(task);
+	} else {
+		for (uint32_t i = 0; i < p_chunk_count; i++) {
+			(this->*p_method)(i, nullptr);
+		}
+	}
+}
+
 void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int32_t &r_previous_room_id_hint) {
 	// Note, in stereo rendering:
 	// - p_cam_transform will be a transform in the middle of our two eyes
@@ -2915,7 +3339,9 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 	float z_far = p_cam_projection.get_z_far();
 
 	/* STEP 2 - CULL */
-	instance_cull_count = _cull_convex_from_point(scenario, p_cam_transform, p_cam_projection, planes, instance_cull_result, MAX_INSTANCE_CULL, r_previous_room_id_hint);
+	if (!_precull_get_result(scenario, p_cam_transform, p_cam_projection)) {
+		instance_cull_count = _cull_convex_from_point(scenario, p_cam_transform, p_cam_projection, planes, instance_cull_result, r_previous_room_id_hint);
+	}
 	light_cull_count = 0;
 
 	reflection_probe_cull_count = 0;
@@ -2934,136 +3360,110 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 
 	/* STEP 4 - REMOVE FURTHER CULLED OBJECTS, ADD LIGHTS */
 
-	for (int i = 0; i < instance_cull_count; i++) {
-		Instance *ins = instance_cull_result[i];
+	uint32_t chunk_count = (instance_cull_count + PREPARE_CULL_CHUNK_SIZE - 1) / PREPARE_CULL_CHUNK_SIZE;
+	if (prepare_cull_chunks.size() < chunk_count) {
+		prepare_cull_chunks.resize(chunk_count);
+	}
 
-		bool keep = false;
+	_update_occlusion_buffer(scenario, p_cam_transform, p_cam_projection, planes, camera_layer_mask);
 
-		if ((camera_layer_mask & ins->layer_mask) == 0) {
-			//failure
-		} else if (ins->base_type == VS::INSTANCE_LIGHT && ins->visible) {
-			if (light_cull_count < MAX_LIGHTS_CULLED) {
-				InstanceLightData *light = static_cast<InstanceLightData *>(ins->base_data);
+	prepare_cull_layer_mask = camera_layer_mask;
+	_run_prepare_chunks(&VisualServerScene::_prepare_cull_chunk, chunk_count);
 
-				if (!light->geometries.empty()) {
-					//do not add this light if no geometry is affected by it..
-					light_cull_result[light_cull_count] = ins;
-					light_instance_cull_result[light_cull_count] = light->instance;
-					if (p_shadow_atlas.is_valid() && VSG::storage->light_has_shadow(ins->base)) {
-						VSG::scene_render->light_instance_mark_visible(light->instance); //mark it visible for shadow allocation later
-					}
+	// Merge the geometry kept by each chunk, in order. Chunks never read past their own range,
+	// so the results can be written back to the start of the cull buffer.
+	instance_cull_count = 0;
+	bool redraw = false;
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		PrepareCullChunk &chunk = prepare_cull_chunks[i];
+		for (uint32_t j = 0; j < chunk.geometry.size(); j++) {
+			instance_cull_result[instance_cull_count++] = chunk.geometry[j];
+		}
+		redraw = redraw || chunk.redraw;
+		occlusion_culled_count += chunk.occluded;
+	}
 
-					light_cull_count++;
-				}
-			}
-		} else if (ins->base_type == VS::INSTANCE_REFLECTION_PROBE && ins->visible) {
-			if (reflection_probe_cull_count < MAX_REFLECTION_PROBES_CULLED) {
-				InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(ins->base_data);
+	if (redraw) {
+		VisualServerRaster::redraw_request(false);
+	}
 
-				if (p_reflection_probe != reflection_probe->instance) {
-					//avoid entering The Matrix
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		PrepareCullChunk &chunk = prepare_cull_chunks[i];
 
-					if (!reflection_probe->geometries.empty()) {
-						//do not add this light if no geometry is affected by it..
+		for (uint32_t j = 0; j < chunk.deferred.size(); j++) {
+			Instance *ins = chunk.deferred[j];
 
-						if (reflection_probe->reflection_dirty || VSG::scene_render->reflection_probe_instance_needs_redraw(reflection_probe->instance)) {
-							if (!reflection_probe->update_list.in_list()) {
-								reflection_probe->render_step = 0;
-								reflection_probe_render_list.add_last(&reflection_probe->update_list);
-							}
+			if (ins->base_type == VS::INSTANCE_LIGHT) {
+				if (light_cull_count < MAX_LIGHTS_CULLED) {
+					InstanceLightData *light = static_cast<InstanceLightData *>(ins->base_data);
 
-							reflection_probe->reflection_dirty = false;
+					if (!light->geometries.empty()) {
+						//do not add this light if no geometry is affected by it..
+						light_cull_result[light_cull_count] = ins;
+						light_instance_cull_result[light_cull_count] = light->instance;
+						if (p_shadow_atlas.is_valid() && VSG::storage->light_has_shadow(ins->base)) {
+							VSG::scene_render->light_instance_mark_visible(light->instance); //mark it visible for shadow allocation later
 						}
 
-						if (VSG::scene_render->reflection_probe_instance_has_reflection(reflection_probe->instance)) {
-							reflection_probe_instance_cull_result[reflection_probe_cull_count] = reflection_probe->instance;
-							reflection_probe_cull_count++;
-						}
+						light_cull_count++;
 					}
 				}
-			}
+			} else if (ins->base_type == VS::INSTANCE_REFLECTION_PROBE) {
+				if (reflection_probe_cull_count < MAX_REFLECTION_PROBES_CULLED) {
+					InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(ins->base_data);
 
-		} else if (ins->base_type == VS::INSTANCE_GI_PROBE && ins->visible) {
-			InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(ins->base_data);
-			if (!gi_probe->update_element.in_list()) {
-				gi_probe_update_list.add(&gi_probe->update_element);
-			}
+					if (p_reflection_probe != reflection_probe->instance) {
+						//avoid entering The Matrix
 
-		} else if (((1 << ins->base_type) & VS::INSTANCE_GEOMETRY_MASK) && ins->visible && ins->cast_shadows != VS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
-			keep = true;
+						if (!reflection_probe->geometries.empty()) {
+							//do not add this light if no geometry is affected by it..
 
-			InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(ins->base_data);
+							if (reflection_probe->reflection_dirty || VSG::scene_render->reflection_probe_instance_needs_redraw(reflection_probe->instance)) {
+								if (!reflection_probe->update_list.in_list()) {
+									reflection_probe->render_step = 0;
+									reflection_probe_render_list.add_last(&reflection_probe->update_list);
+								}
 
-			if (ins->redraw_if_visible) {
-				VisualServerRaster::redraw_request(false);
-			}
+								reflection_probe->reflection_dirty = false;
+							}
 
-			if (ins->base_type == VS::INSTANCE_PARTICLES) {
-				//particles visible? process them
-				if (VSG::storage->particles_is_inactive(ins->base)) {
-					//but if nothing is going on, don't do it.
-					keep = false;
-				} else {
-					if (OS::get_singleton()->is_update_pending(true)) {
-						VSG::storage->particles_request_process(ins->base);
-						//particles visible? request redraw
-						VisualServerRaster::redraw_request(false);
+							if (VSG::scene_render->reflection_probe_instance_has_reflection(reflection_probe->instance)) {
+								reflection_probe_instance_cull_result[reflection_probe_cull_count] = reflection_probe->instance;
+								reflection_probe_cull_count++;
+							}
+						}
 					}
 				}
-			}
-
-			if (geom->lighting_dirty) {
-				int l = 0;
-				//only called when lights AABB enter/exit this geometry
-				ins->light_instances.resize(geom->lighting.size());
-
-				for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
-					InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
 
-					ins->light_instances.write[l++] = light->instance;
+			} else if (ins->base_type == VS::INSTANCE_GI_PROBE) {
+				InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(ins->base_data);
+				if (!gi_probe->update_element.in_list()) {
+					gi_probe_update_list.add(&gi_probe->update_element);
 				}
 
-				geom->lighting_dirty = false;
-			}
-
-			if (geom->reflection_dirty) {
-				int l = 0;
-				//only called when reflection probe AABB enter/exit this geometry
-				ins->reflection_probe_instances.resize(geom->reflection_probes.size());
-
-				for (List<Instance *>::Element *E = geom->reflection_probes.front(); E; E = E->next()) {
-					InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(E->get()->base_data);
-
-					ins->reflection_probe_instances.write[l++] = reflection_probe->instance;
+			} else if (ins->base_type == VS::INSTANCE_PARTICLES) {
+				if (ins->redraw_if_visible) {
+					VisualServerRaster::redraw_request(false);
 				}
 
-				geom->reflection_dirty = false;
-			}
+				_update_instance_geometry_dependencies(ins);
 
-			if (geom->gi_probes_dirty) {
-				int l = 0;
-				//only called when reflection probe AABB enter/exit this geometry
-				ins->gi_probe_instances.resize(geom->gi_probes.size());
-
-				for (List<Instance *>::Element *E = geom->gi_probes.front(); E; E = E->next()) {
-					InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(E->get()->base_data);
+				//particles visible? process them
+				if (VSG::storage->particles_is_inactive(ins->base)) {
+					//but if nothing is going on, don't do it.
+					continue;
+				}
 
-					ins->gi_probe_instances.write[l++] = gi_probe->probe_instance;
+				if (OS::get_singleton()->is_update_pending(true)) {
+					VSG::storage->particles_request_process(ins->base);
+					//particles visible? request redraw
+					VisualServerRaster::redraw_request(false);
 				}
 
-				geom->gi_probes_dirty = false;
+				instance_cull_result[instance_cull_count++] = ins;
+				ins->last_render_pass = render_pass;
 			}
 		}
-
-		if (!keep) {
-			// remove, no reason to keep
-			instance_cull_count--;
-			SWAP(instance_cull_result[i], instance_cull_result[instance_cull_count]);
-			i--;
-			ins->last_render_pass = 0; // make invalid
-		} else {
-			ins->last_render_pass = render_pass;
-		}
 	}
 
 	/* STEP 5 - PROCESS LIGHTS */
@@ -3203,15 +3603,9 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 	}
 
 	// Calculate instance->depth from the camera, after shadow calculation has stopped overwriting instance->depth
-	for (int i = 0; i < instance_cull_count; i++) {
-		Instance *ins = instance_cull_result[i];
-
-		if (((1 << ins->base_type) & VS::INSTANCE_GEOMETRY_MASK) && ins->visible && ins->cast_shadows != VS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
-			Vector3 aabb_center = ins->transformed_aabb.position + (ins->transformed_aabb.size * 0.5);
-			ins->depth = near_plane.distance_to(aabb_center);
-			ins->depth_layer = CLAMP(int(ins->depth * 16 / z_far), 0, 15);
-		}
-	}
+	prepare_near_plane = near_plane;
+	prepare_z_far = z_far;
+	_run_prepare_chunks(&VisualServerScene::_prepare_depth_chunk, (instance_cull_count + PREPARE_CULL_CHUNK_SIZE - 1) / PREPARE_CULL_CHUNK_SIZE);
 }
 
 void VisualServerScene::_render_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, const int p_eye, bool p_cam_orthogonal, RID p_force_environment, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass) {
@@ -3230,7 +3624,7 @@ void VisualServerScene::_render_scene(const Transform p_cam_transform, const Cam
 
 	/* PROCESS GEOMETRY AND DRAW SCENE */
 
-	VSG::scene_render->render_scene(p_cam_transform, p_cam_projection, p_eye, p_cam_orthogonal, (RasterizerScene::InstanceBase **)instance_cull_result, instance_cull_count, light_instance_cull_result, light_cull_count + directional_light_count, reflection_probe_instance_cull_result, reflection_probe_cull_count, environment, p_shadow_atlas, scenario->reflection_atlas, p_reflection_probe, p_reflection_probe_pass);
+	VSG::scene_render->render_scene(p_cam_transform, p_cam_projection, p_eye, p_cam_orthogonal, (RasterizerScene::InstanceBase **)instance_cull_result.ptr(), instance_cull_count, light_instance_cull_result, light_cull_count + directional_light_count, reflection_probe_instance_cull_result, reflection_probe_cull_count, environment, p_shadow_atlas, scenario->reflection_atlas, p_reflection_probe, p_reflection_probe_pass);
 }
 
 void VisualServerScene::render_empty_scene(RID p_scenario, RID p_shadow_atlas) {
@@ -4175,6 +4569,15 @@ bool VisualServerScene::_check_gi_probe(Instance *p_gi_probe) {
 	return !all_equal || probe_data->dynamic.light_cache_changes.size() != probe_data->dynamic.light_cache.size();
 }
 
+void VisualServerScene::end_frame() {
+	occlusion_culled_in_frame = occlusion_culled_count;
+	occlusion_culled_count = 0;
+	shadow_caster_cache_hits_in_frame = shadow_caster_cache_hits;
+	shadow_caster_cache_hits = 0;
+	shadow_caster_cache_misses_in_frame = shadow_caster_cache_misses;
+	shadow_caster_cache_misses = 0;
+}
+
 void VisualServerScene::render_probes() {
 	/* REFLECTION PROBES */
 
@@ -4423,11 +4826,12 @@ void VisualServerScene::_update_dirty_instance(Instance *p_instance) {
 				is_animated = is_animated || VSG::storage->material_is_animated(p_instance->material_overlay);
 			}
 
-			if (can_cast_shadows != geom->can_cast_shadows) {
+			if (can_cast_shadows != geom->can_cast_shadows || is_animated != geom->material_is_animated) {
 				//ability to cast shadows change, let lights now
+				//(the shadow caster caches also remember whether any caster is animated)
 				for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
 					InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
-					light->shadow_dirty = true;
+					light->shadow_casters_changed();
 				}
 
 				geom->can_cast_shadows = can_cast_shadows;
@@ -4555,6 +4959,7 @@ VisualServerScene::VisualServerScene() {
 	_use_bvh = GLOBAL_DEF("rendering/quality/spatial_partitioning/use_bvh", true);
 	GLOBAL_DEF("rendering/quality/spatial_partitioning/bvh_collision_margin", 0.1);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/spatial_partitioning/bvh_collision_margin", PropertyInfo(Variant::REAL, "rendering/quality/spatial_partitioning/bvh_collision_margin", PROPERTY_HINT_RANGE, "0.0,2.0,0.01"));
+	occlusion_buffer_width = GLOBAL_GET("rendering/misc/occlusion_culling/depth_buffer_width");
 
 	_visual_server_callbacks = nullptr;
 }
@@ -33,6 +33,7 @@
 
 #include "servers/visual/rasterizer.h"
 
+#include "core/local_vector.h"
 #include "core/math/bvh.h"
 #include "core/math/geometry.h"
 #include "core/math/octree.h"
@@ -40,6 +41,7 @@
 #include "core/os/thread.h"
 #include "core/safe_refcount.h"
 #include "core/self_list.h"
+#include "occlusion_buffer.h"
 #include "portals/portal_renderer.h"
 #include "servers/arvr/arvr_interface.h"
 
@@ -47,7 +49,8 @@ class VisualServerScene {
 public:
 	enum {
 
-		MAX_INSTANCE_CULL = 65536,
+		INSTANCE_CULL_INITIAL_SIZE = 8192,
+		PREPARE_CULL_CHUNK_SIZE = 512,
 		MAX_LIGHTS_CULLED = 4096,
 		MAX_REFLECTION_PROBES_CULLED = 4096,
 		MAX_ROOM_CULL = 32,
@@ -150,6 +153,10 @@ public:
 		virtual int cull_aabb(const AABB &p_aabb, Instance **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF) = 0;
 		virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF) = 0;
 
+		// Same as cull_convex() with the default mask, but may be called from several threads at once,
+		// as long as nothing modifies the partitioning meanwhile. Returns -1 if not supported.
+		virtual int cull_convex_concurrent(const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max) { return -1; }
+
 		typedef void *(*PairCallback)(void *, uint32_t, Instance *, int, uint32_t, Instance *, int);
 		typedef void (*UnpairCallback)(void *, uint32_t, Instance *, int, uint32_t, Instance *, int, void *);
 
@@ -232,6 +239,8 @@ public:
 		// Note that SpatialPartitionIDs are +1 based when stored in visual server, to enable 0 to indicate invalid ID.
 		BVH_Manager<Instance, 2, true, 256, UserPairTestFunction<Instance>, UserCullTestFunction<Instance>> _bvh;
 		Instance *_dummy_cull_object;
+		// never modified after construction, so it can be shared by concurrent culls
+		Instance *_dummy_concurrent_cull_object;
 
 	public:
 		SpatialPartitioningScene_BVH();
@@ -248,6 +257,7 @@ public:
 		int cull_convex(const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
 		int cull_aabb(const AABB &p_aabb, Instance **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF);
 		int cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF);
+		int cull_convex_concurrent(const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max);
 		void set_pair_callback(PairCallback p_callback, void *p_userdata);
 		void set_unpair_callback(UnpairCallback p_callback, void *p_userdata);
 
@@ -269,6 +279,7 @@ public:
 		RID reflection_atlas;
 
 		SelfList<Instance>::List instances;
+		SelfList<Instance>::List occluders;
 
 		bool is_physics_interpolation_enabled() const { return _interpolation_data.interpolation_enabled; }
 
@@ -327,6 +338,13 @@ public:
 		Scenario *scenario;
 		SelfList<Instance> scenario_item;
 
+		// software occlusion culling, triangles are extracted from the mesh when first needed
+		bool occluder;
+		bool occluder_dirty;
+		SelfList<Instance> occluder_item;
+		LocalVector<Vector3> occluder_vertices;
+		LocalVector<uint32_t> occluder_indices;
+
 		//aabb stuff
 		bool update_aabb;
 		bool update_materials;
@@ -337,7 +355,7 @@ public:
 		AABB transformed_aabb;
 		AABB *custom_aabb; // <Zylann> would using aabb directly with a bool be better?
 		float extra_margin;
-		uint32_t object_id;
+		ObjectID object_id;
 
 		float lod_begin;
 		float lod_end;
@@ -362,6 +380,9 @@ public:
 		}
 
 		virtual void base_changed(bool p_aabb, bool p_materials) {
+			if (p_aabb) {
+				occluder_dirty = true;
+			}
 			singleton->_instance_queue_update(this, p_aabb, p_materials);
 		}
 
@@ -369,10 +390,14 @@ public:
 
 		Instance() :
 				scenario_item(this),
+				occluder_item(this),
 				update_item(this) {
 			spatial_partition_id = 0;
 			scenario = nullptr;
 
+			occluder = false;
+			occluder_dirty = true;
+
 			update_aabb = false;
 			update_materials = false;
 
@@ -469,17 +494,39 @@ public:
 			Instance *geometry;
 		};
 
+		// Shadow casters found for one pass (cube face or paraboloid) of an omni or spot light.
+		// They only depend on the light and the casters paired with it, so they are kept
+		// until one of those changes.
+		struct ShadowCasterCache {
+			LocalVector<Instance *> casters;
+			bool animated = false;
+			bool valid = false;
+		};
+
+		enum {
+			MAX_SHADOW_PASSES = 6,
+		};
+
 		RID instance;
 		uint64_t last_version;
 		List<Instance *>::Element *D; // directional light in scenario
 
 		bool shadow_dirty;
+		ShadowCasterCache shadow_caster_cache[MAX_SHADOW_PASSES];
 
 		List<PairInfo> geometries;
 
 		Instance *baked_light;
 		int32_t previous_room_id_hint;
 
+		// The light or a caster in its volume changed, shadows must be culled and drawn again.
+		void shadow_casters_changed() {
+			shadow_dirty = true;
+			for (int i = 0; i < MAX_SHADOW_PASSES; i++) {
+				shadow_caster_cache[i].valid = false;
+			}
+		}
+
 		InstanceLightData() {
 			shadow_dirty = true;
 			D = nullptr;
@@ -604,9 +651,10 @@ public:
 		}
 	};
 
+	// Grown by the culling functions whenever they fill up.
 	int instance_cull_count;
-	Instance *instance_cull_result[MAX_INSTANCE_CULL];
-	Instance *instance_shadow_cull_result[MAX_INSTANCE_CULL]; //used for generating shadowmaps
+	LocalVector<Instance *> instance_cull_result;
+	LocalVector<Instance *> instance_shadow_cull_result; //used for generating shadowmaps
 	Instance *light_cull_result[MAX_LIGHTS_CULLED];
 	RID light_instance_cull_result[MAX_LIGHTS_CULLED];
 	int light_cull_count;
@@ -664,7 +712,7 @@ public:
 	struct Ghost : RID_Data {
 		// all interactions with actual ghosts are indirect, as the ghost is part of the scenario
 		Scenario *scenario = nullptr;
-		uint32_t object_id = 0;
+		ObjectID object_id = 0;
 		RGhostHandle rghost_handle = 0; // handle in occlusion system (or 0)
 		AABB aabb;
 		virtual ~Ghost() {
@@ -813,7 +861,8 @@ public:
 	virtual Vector<ObjectID> instances_cull_convex(const Vector<Plane> &p_convex, RID p_scenario = RID()) const;
 
 	// internal (uses portals when available)
-	int _cull_convex_from_point(Scenario *p_scenario, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max, int32_t &r_previous_room_id_hint, uint32_t p_mask = 0xFFFFFFFF);
+	int _cull_convex_from_point(Scenario *p_scenario, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, const Vector<Plane> &p_convex, LocalVector<Instance *> &r_result, int32_t &r_previous_room_id_hint, uint32_t p_mask = 0xFFFFFFFF);
+	int _cull_convex(Scenario *p_scenario, const Vector<Plane> &p_convex, LocalVector<Instance *> &r_result, uint32_t p_mask);
 	void _rooms_instance_update(Instance *p_instance, const AABB &p_aabb);
 
 	virtual void instance_geometry_set_flag(RID p_instance, VS::InstanceFlags p_flags, bool p_enabled);
@@ -829,8 +878,66 @@ public:
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 
+	bool _light_is_paired(Instance *p_light, Instance *p_geometry) const;
+	int _light_cull_shadow_casters(Instance *p_light, int p_pass, const Transform &p_transform, const CameraMatrix &p_projection, const Vector<Plane> &p_planes, bool p_from_point, Scenario *p_scenario, Instance **&r_casters, bool &r_animated);
 	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario);
 
+	// The post-cull pass of _prepare_scene() runs in chunks, on worker threads when there are enough
+	// instances. Results are merged in chunk order, so they don't depend on thread scheduling.
+	struct PrepareCullChunk {
+		LocalVector<Instance *> geometry;
+		// Lights, probes and particles, handled afterwards on the calling thread.
+		LocalVector<Instance *> deferred;
+		bool redraw = false;
+		uint32_t occluded = 0;
+	};
+
+	LocalVector<PrepareCullChunk> prepare_cull_chunks;
+	uint32_t prepare_cull_layer_mask = 0;
+	Plane prepare_near_plane;
+	float prepare_z_far = 0;
+
+	OcclusionBuffer occlusion_buffer;
+	int occlusion_buffer_width = 256;
+	uint32_t occlusion_culled_count = 0;
+	uint32_t occlusion_culled_in_frame = 0;
+
+	uint32_t shadow_caster_cache_hits = 0;
+	uint32_t shadow_caster_cache_misses = 0;
+	uint32_t shadow_caster_cache_hits_in_frame = 0;
+	uint32_t shadow_caster_cache_misses_in_frame = 0;
+
+	void _update_occluder_data(Instance *p_instance);
+	void _update_occlusion_buffer(Scenario *p_scenario, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, const Vector<Plane> &p_planes, uint32_t p_layer_mask);
+
+	_FORCE_INLINE_ void _update_instance_geometry_dependencies(Instance *p_instance);
+	void _prepare_cull_chunk(uint32_t p_chunk, void *p_userdata);
+	void _prepare_depth_chunk(uint32_t p_chunk, void *p_userdata);
+	void _run_prepare_chunks(void (VisualServerScene::*p_method)(uint32_t, void *), uint32_t p_chunk_count);
+
+	// The frustum culls of all cameras drawn in a frame can run up front, one job per camera, before
+	// the viewports are drawn one after another. _prepare_scene() then takes the result matching its
+	// camera instead of culling again.
+	struct PrecullView {
+		Scenario *scenario = nullptr;
+		Transform cam_transform;
+		CameraMatrix cam_projection;
+		Vector<Plane> planes;
+		LocalVector<Instance *> result;
+		int result_count = -1;
+	};
+
+	LocalVector<PrecullView> precull_views;
+	uint32_t precull_view_count = 0;
+
+	void _camera_get_projection(const Camera *p_camera, const Size2 &p_viewport_size, CameraMatrix &r_projection, bool &r_ortho) const;
+	void _precull_view(uint32_t p_index, void *p_userdata);
+	bool _precull_get_result(Scenario *p_scenario, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection);
+
+	void precull_add_camera(RID p_camera, RID p_scenario, Size2 p_viewport_size);
+	void precull_cameras();
+	void precull_clear();
+
 	void _prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int32_t &r_previous_room_id_hint);
 	void _render_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, const int p_eye, bool p_cam_orthogonal, RID p_force_environment, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass);
 	void render_empty_scene(RID p_scenario, RID p_shadow_atlas);
@@ -888,6 +995,11 @@ public:
 	void _setup_gi_probe(Instance *p_instance);
 
 	void render_probes();
+	void end_frame();
+
+	uint32_t get_occlusion_culled_in_frame() const { return occlusion_culled_in_frame; }
+	uint32_t get_shadow_caster_cache_hits_in_frame() const { return shadow_caster_cache_hits_in_frame; }
+	uint32_t get_shadow_caster_cache_misses_in_frame() const { return shadow_caster_cache_misses_in_frame; }
 
 	bool free(RID p_rid);
 
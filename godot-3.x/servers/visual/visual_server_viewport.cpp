@@ -175,6 +175,13 @@ void VisualServerViewport::_draw_viewport(Viewport *p_viewport, ARVRInterface::E
 			canvas_map[Viewport::CanvasKey(E->key(), E->get().layer, E->get().sublayer)] = &E->get();
 		}
 
+		//gather the items of all layers at once, they are still drawn in order below
+		for (Map<Viewport::CanvasKey, Viewport::CanvasData *>::Element *E = canvas_map.front(); E; E = E->next()) {
+			VisualServerCanvas::Canvas *canvas = static_cast<VisualServerCanvas::Canvas *>(E->get()->canvas);
+			VSG::canvas->precull_canvas_add(canvas, _canvas_get_transform(p_viewport, canvas, E->get(), clip_rect.size), clip_rect);
+		}
+		VSG::canvas->precull_canvases();
+
 		if (lights_with_shadow) {
 			//update shadows if any
 
@@ -248,6 +255,8 @@ void VisualServerViewport::_draw_viewport(Viewport *p_viewport, ARVRInterface::E
 			}
 		}
 
+		VSG::canvas->precull_clear();
+
 		if (scenario_draw_canvas_bg) {
 			if (!can_draw_3d) {
 				VSG::scene->render_empty_scene(p_viewport->scenario, p_viewport->shadow_atlas);
@@ -278,6 +287,27 @@ void VisualServerViewport::draw_viewports() {
 	//sort viewports
 	active_viewports.sort_custom<ViewportSort>();
 
+	//cull the cameras of all viewports drawn this frame at once, drawing itself stays serial
+	for (int i = 0; i < active_viewports.size(); i++) {
+		Viewport *vp = active_viewports[i];
+
+		if (vp->update_mode == VS::VIEWPORT_UPDATE_DISABLED || vp->use_arvr || !vp->render_target.is_valid()) {
+			continue;
+		}
+
+		if (vp->disable_3d || vp->disable_3d_by_usage || !VSG::scene->camera_owner.owns(vp->camera)) {
+			continue;
+		}
+
+		bool visible = vp->viewport_to_screen_rect != Rect2() || vp->update_mode == VS::VIEWPORT_UPDATE_ALWAYS || vp->update_mode == VS::VIEWPORT_UPDATE_ONCE || (vp->update_mode == VS::VIEWPORT_UPDATE_WHEN_VISIBLE && VSG::storage->render_target_was_used(vp->render_target));
+		visible = visible && vp->size.x > 1 && vp->size.y > 1;
+
+		if (visible) {
+			VSG::scene->precull_add_camera(vp->camera, vp->scenario, vp->size);
+		}
+	}
+	VSG::scene->precull_cameras();
+
 	//draw viewports
 	for (int i = 0; i < active_viewports.size(); i++) {
 		Viewport *vp = active_viewports[i];
@@ -370,6 +400,8 @@ void VisualServerViewport::draw_viewports() {
 		}
 		VSG::scene_render->set_debug_draw_mode(VS::VIEWPORT_DEBUG_DRAW_DISABLED);
 	}
+
+	VSG::scene->precull_clear();
 }
 
 RID VisualServerViewport::viewport_create() {
@@ -2431,6 +2431,7 @@ void VisualServer::_bind_methods() {
 
 	BIND_ENUM_CONSTANT(INSTANCE_FLAG_USE_BAKED_LIGHT);
 	BIND_ENUM_CONSTANT(INSTANCE_FLAG_DRAW_NEXT_FRAME_IF_VISIBLE);
+	BIND_ENUM_CONSTANT(INSTANCE_FLAG_OCCLUDER);
 	BIND_ENUM_CONSTANT(INSTANCE_FLAG_MAX);
 
 	BIND_ENUM_CONSTANT(SHADOW_CASTING_SETTING_OFF);
@@ -2470,6 +2471,9 @@ void VisualServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_VIDEO_MEM_USED);
 	BIND_ENUM_CONSTANT(INFO_TEXTURE_MEM_USED);
 	BIND_ENUM_CONSTANT(INFO_VERTEX_MEM_USED);
+	BIND_ENUM_CONSTANT(INFO_OCCLUSION_CULLED_IN_FRAME);
+	BIND_ENUM_CONSTANT(INFO_SHADOW_CASTER_CACHE_HITS_IN_FRAME);
+	BIND_ENUM_CONSTANT(INFO_SHADOW_CASTER_CACHE_MISSES_IN_FRAME);
 
 	BIND_ENUM_CONSTANT(FEATURE_SHADERS);
 	BIND_ENUM_CONSTANT(FEATURE_MULTITHREADED);
@@ -2724,6 +2728,8 @@ VisualServer::VisualServer() {
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/misc/occlusion_culling/max_active_spheres", PropertyInfo(Variant::INT, "rendering/misc/occlusion_culling/max_active_spheres", PROPERTY_HINT_RANGE, "0,64"));
 	GLOBAL_DEF("rendering/misc/occlusion_culling/max_active_polygons", 8);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/misc/occlusion_culling/max_active_polygons", PropertyInfo(Variant::INT, "rendering/misc/occlusion_culling/max_active_polygons", PROPERTY_HINT_RANGE, "0,64"));
+	GLOBAL_DEF("rendering/misc/occlusion_culling/depth_buffer_width", 256);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/misc/occlusion_culling/depth_buffer_width", PropertyInfo(Variant::INT, "rendering/misc/occlusion_culling/depth_buffer_width", PROPERTY_HINT_RANGE, "32,1024,1"));
 
 	// Async. compilation and caching
 #ifdef DEBUG_ENABLED
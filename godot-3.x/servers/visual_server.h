@@ -969,6 +969,7 @@ public:
 	enum InstanceFlags {
 		INSTANCE_FLAG_USE_BAKED_LIGHT,
 		INSTANCE_FLAG_DRAW_NEXT_FRAME_IF_VISIBLE,
+		INSTANCE_FLAG_OCCLUDER,
 		INSTANCE_FLAG_MAX
 	};
 
@@ -1150,6 +1151,9 @@ public:
 		INFO_VIDEO_MEM_USED,
 		INFO_TEXTURE_MEM_USED,
 		INFO_VERTEX_MEM_USED,
+		INFO_OCCLUSION_CULLED_IN_FRAME,
+		INFO_SHADOW_CASTER_CACHE_HITS_IN_FRAME,
+		INFO_SHADOW_CASTER_CACHE_MISSES_IN_FRAME,
 	};
 
 	virtual uint64_t get_render_info(RenderInfo p_info) = 0;